@@ -21,15 +21,25 @@ struct AlertCooldown {
                       spread_alert_active(false), funding_alert_active(false) {}
 };
 
-static AlertCooldown g_alert_cooldowns[3];  // One per symbol
+static AlertCooldown g_alert_cooldowns[MAX_SYMBOLS];  // One per symbol
 static int g_active_alert_count = 0;
+static TaskHandle_t g_alert_task = NULL;
+
+// Streamed funding update over the threshold: check now instead of at the next interval
+static void on_funding_update(int idx, const Funding& funding) {
+    (void)idx;
+    if (g_alert_task != NULL && fixed_abs(funding.rate) > fixed_from_double(config_get_funding_alert_pct())) {
+        xTaskNotifyGive(g_alert_task);
+    }
+}
 
 void alerts_init() {
     // Reset all cooldowns
-    for (int i = 0; i < 3; i++) {
+    for (int i = 0; i < MAX_SYMBOLS; i++) {
         g_alert_cooldowns[i] = AlertCooldown();
     }
     g_active_alert_count = 0;
+    model_set_funding_listener(on_funding_update);
     
     DEBUG_PRINTLN("[ALERTS] Alert engine initialized");
     DEBUG_PRINTF("[ALERTS] Cooldown: %lu ms, Check interval: %lu ms\n", 
@@ -59,11 +69,14 @@ static bool check_spread_alert(int symbol_idx, const SymbolState& state, unsigne
         return cooldown.spread_alert_active;  // Still in cooldown
     }
     
-    // Check threshold
-    if (state.spread_valid && state.spread_pct > config_get_spread_alert_pct()) {
+    // Check threshold against the widest spread between any two venues
+    const SpreadMatrix& spreads = state.spreads;
+    if (spreads.widest_valid && spreads.widest_pct > (float)config_get_spread_alert_pct()) {
         // Threshold exceeded - trigger alert
-        DEBUG_PRINTF("[ALERTS] %s spread alert: %.2f%% exceeds threshold %.2f%%\n",
-                     state.symbol_name, state.spread_pct, config_get_spread_alert_pct());
+        DEBUG_PRINTF("[ALERTS] %s spread alert: %.2f%% (%s -> %s) exceeds threshold %.2f%%\n",
+                     state.symbol_name, spreads.widest_pct,
+                     quote_venue_name(spreads.widest_low), quote_venue_name(spreads.widest_high),
+                     config_get_spread_alert_pct());
         
         // Trigger beep (200ms on, 100ms off, 2 times)
         hw_alert_beep(200, 100, 2);
@@ -96,10 +109,10 @@ static bool check_funding_alert(int symbol_idx, const SymbolState& state, unsign
     }
     
     // Check threshold (absolute value for both positive and negative rates)
-    if (state.funding.valid && fabs(state.funding.rate) > config_get_funding_alert_pct()) {
+    if (state.funding.valid && fixed_abs(state.funding.rate) > fixed_from_double(config_get_funding_alert_pct())) {
         // Threshold exceeded - trigger alert
         DEBUG_PRINTF("[ALERTS] %s funding alert: %.4f%% exceeds threshold %.4f%%\n",
-                     state.symbol_name, state.funding.rate * 100.0, 
+                     state.symbol_name, fixed_to_double(state.funding.rate) * 100.0, 
                      config_get_funding_alert_pct() * 100.0);
         
         // Trigger beep (300ms on, 150ms off, 3 times)
@@ -119,23 +132,26 @@ static bool check_funding_alert(int symbol_idx, const SymbolState& state, unsign
 
 void alert_task(void* pvParameters) {
     DEBUG_PRINTLN("[ALERTS] Alert task started");
+    g_alert_task = xTaskGetCurrentTaskHandle();
     
     while (true) {
-        // Get current state snapshot
-        AppState snapshot = model_snapshot();
+        // Get current state snapshot; static keeps the ~6 KB copy off the
+        // task stack (only alert_task uses it)
+        static AppState snapshot;
+        model_snapshot(&snapshot);
         unsigned long now = millis();
         
         // Suppress alerts if data is stale (Task 8.2)
         if (snapshot.data_stale) {
             // Clear all active alert flags during stale data
             g_active_alert_count = 0;
-            vTaskDelay(pdMS_TO_TICKS(ALERT_CHECK_INTERVAL_MS));
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ALERT_CHECK_INTERVAL_MS));
             continue;
         }
         
         // Check each symbol for threshold violations
         int active_count = 0;
-        for (int i = 0; i < config_get_num_symbols(); i++) {
+        for (int i = 0; i < config_get_num_symbols() && i < MAX_SYMBOLS; i++) {
             const SymbolState& state = snapshot.symbols[i];
             
             bool spread_active = check_spread_alert(i, state, now);
@@ -148,7 +164,7 @@ void alert_task(void* pvParameters) {
         
         g_active_alert_count = active_count;
         
-        // Yield to other tasks
-        vTaskDelay(pdMS_TO_TICKS(ALERT_CHECK_INTERVAL_MS));
+        // Sleep until the next check, or until a streamed funding update arrives
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ALERT_CHECK_INTERVAL_MS));
     }
 }
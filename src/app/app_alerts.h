@@ -13,7 +13,8 @@ void alerts_init();
 
 /**
  * @brief Alert monitoring task (runs in FreeRTOS task)
- * Checks model snapshot every 300ms for threshold violations
+ * Checks model snapshot every 300ms for threshold violations, and right
+ * away when a streamed funding rate crosses its threshold
  * Implements per-symbol cooldown to prevent spam
  * @param pvParameters Task parameters (unused)
  */
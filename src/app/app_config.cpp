@@ -1,6 +1,12 @@
 #include "app_config.h"
 #include "../config.h"
+#ifdef ARDUINO
 #include "../hw/hw_storage.h"
+#else
+// Host builds (unit tests, replay benchmarks) have no NVS: always start from defaults
+static bool hw_storage_load_config(AppConfig*) { return false; }
+static bool hw_storage_save_config(const AppConfig*) { return false; }
+#endif
 
 // Global configuration instance
 static AppConfig g_config;
@@ -13,18 +19,21 @@ void config_init() {
     g_config.symbols[0].display_name = "BTC/USDT";
     g_config.symbols[0].binance_symbol = "BTCUSDT";
     g_config.symbols[0].coinbase_product = "BTC-USD";
+    g_config.symbols[0].kraken_pair = "XXBTZUSD";
     g_config.symbols[0].enabled = true;
     
     // ETH
     g_config.symbols[1].display_name = "ETH/USDT";
     g_config.symbols[1].binance_symbol = "ETHUSDT";
     g_config.symbols[1].coinbase_product = "ETH-USD";
+    g_config.symbols[1].kraken_pair = "XETHZUSD";
     g_config.symbols[1].enabled = true;
     
     // SOL
     g_config.symbols[2].display_name = "SOL/USDT";
     g_config.symbols[2].binance_symbol = "SOLUSDT";
     g_config.symbols[2].coinbase_product = "SOL-USD";
+    g_config.symbols[2].kraken_pair = "SOLUSD";
     g_config.symbols[2].enabled = true;
     
     // Disabled symbols (available but not tracked by default)
@@ -32,49 +41,60 @@ void config_init() {
     g_config.symbols[3].display_name = "XRP/USDT";
     g_config.symbols[3].binance_symbol = "XRPUSDT";
     g_config.symbols[3].coinbase_product = "XRP-USD";
+    g_config.symbols[3].kraken_pair = "XXRPZUSD";
     g_config.symbols[3].enabled = false;
     
     // ADA
     g_config.symbols[4].display_name = "ADA/USDT";
     g_config.symbols[4].binance_symbol = "ADAUSDT";
     g_config.symbols[4].coinbase_product = "ADA-USD";
+    g_config.symbols[4].kraken_pair = "ADAUSD";
     g_config.symbols[4].enabled = false;
     
     // DOGE
     g_config.symbols[5].display_name = "DOGE/USDT";
     g_config.symbols[5].binance_symbol = "DOGEUSDT";
     g_config.symbols[5].coinbase_product = "DOGE-USD";
+    g_config.symbols[5].kraken_pair = "XDGUSD";
     g_config.symbols[5].enabled = false;
     
     // MATIC
     g_config.symbols[6].display_name = "MATIC/USDT";
     g_config.symbols[6].binance_symbol = "MATICUSDT";
     g_config.symbols[6].coinbase_product = "MATIC-USD";
+    g_config.symbols[6].kraken_pair = "MATICUSD";
     g_config.symbols[6].enabled = false;
     
     // DOT
     g_config.symbols[7].display_name = "DOT/USDT";
     g_config.symbols[7].binance_symbol = "DOTUSDT";
     g_config.symbols[7].coinbase_product = "DOT-USD";
+    g_config.symbols[7].kraken_pair = "DOTUSD";
     g_config.symbols[7].enabled = false;
     
     // LINK
     g_config.symbols[8].display_name = "LINK/USDT";
     g_config.symbols[8].binance_symbol = "LINKUSDT";
     g_config.symbols[8].coinbase_product = "LINK-USD";
+    g_config.symbols[8].kraken_pair = "LINKUSD";
     g_config.symbols[8].enabled = false;
     
     // AVAX
     g_config.symbols[9].display_name = "AVAX/USDT";
     g_config.symbols[9].binance_symbol = "AVAXUSDT";
     g_config.symbols[9].coinbase_product = "AVAX-USD";
+    g_config.symbols[9].kraken_pair = "AVAXUSD";
     g_config.symbols[9].enabled = false;
     
     g_config.num_symbols = MAX_SYMBOLS;
     
     // Refresh intervals
     g_config.price_refresh_ms = 5000;      // 5 seconds
-    g_config.funding_refresh_ms = 60000;   // 60 seconds
+    g_config.funding_refresh_ms = 60000;   // 60 seconds (interval mode / epoch unknown)
+    
+    // Funding scheduling: refetch after each funding epoch, no predicted polling
+    g_config.funding_schedule = FUNDING_SCHEDULE_EPOCH;
+    g_config.predicted_funding_refresh_ms = 0;
     
     // Alert thresholds
     g_config.spread_alert_pct = 0.5;       // 0.5% spread
@@ -96,6 +116,9 @@ void config_init() {
     DEBUG_PRINTF("[CONFIG]   Symbols: %d total, %d enabled\n", g_config.num_symbols, enabled_count);
     DEBUG_PRINTF("[CONFIG]   Price refresh: %lu ms\n", g_config.price_refresh_ms);
     DEBUG_PRINTF("[CONFIG]   Funding refresh: %lu ms\n", g_config.funding_refresh_ms);
+    DEBUG_PRINTF("[CONFIG]   Funding schedule: %s (predicted every %lu ms)\n",
+                 g_config.funding_schedule == FUNDING_SCHEDULE_EPOCH ? "epoch" : "interval",
+                 g_config.predicted_funding_refresh_ms);
     DEBUG_PRINTF("[CONFIG]   Spread alert: %.2f%%\n", g_config.spread_alert_pct);
     DEBUG_PRINTF("[CONFIG]   Funding alert: %.4f%%\n", g_config.funding_alert_pct);
     DEBUG_PRINTF("[CONFIG]   Stale threshold: %lu ms\n", g_config.stale_ms);
@@ -120,14 +143,28 @@ bool config_load() {
     }
 }
 
+static ConfigChangeListener g_change_listener = nullptr;
+
+void config_set_change_listener(ConfigChangeListener listener) {
+    g_change_listener = listener;
+}
+
+static void notify_change() {
+    if (g_change_listener) {
+        g_change_listener();
+    }
+}
+
 bool config_save() {
-    if (hw_storage_save_config(&g_config)) {
+    bool saved = hw_storage_save_config(&g_config);
+    if (saved) {
         DEBUG_PRINTLN("[CONFIG] Configuration saved successfully");
-        return true;
     } else {
         DEBUG_PRINTLN("[CONFIG] ERROR: Failed to save configuration");
-        return false;
     }
+    // The values in RAM apply whether or not they were persisted
+    notify_change();
+    return saved;
 }
 
 const AppConfig& config_get() {
@@ -153,6 +190,14 @@ uint32_t config_get_funding_refresh_ms() {
     return g_config.funding_refresh_ms;
 }
 
+FundingScheduleMode config_get_funding_schedule() {
+    return g_config.funding_schedule;
+}
+
+uint32_t config_get_predicted_funding_refresh_ms() {
+    return g_config.predicted_funding_refresh_ms;
+}
+
 double config_get_spread_alert_pct() {
     return g_config.spread_alert_pct;
 }
@@ -168,11 +213,26 @@ uint32_t config_get_stale_ms() {
 void config_set_price_refresh_ms(uint32_t ms) {
     g_config.price_refresh_ms = ms;
     DEBUG_PRINTF("[CONFIG] Price refresh updated to %lu ms\n", ms);
+    notify_change();
 }
 
 void config_set_funding_refresh_ms(uint32_t ms) {
     g_config.funding_refresh_ms = ms;
     DEBUG_PRINTF("[CONFIG] Funding refresh updated to %lu ms\n", ms);
+    notify_change();
+}
+
+void config_set_funding_schedule(FundingScheduleMode mode) {
+    g_config.funding_schedule = mode;
+    DEBUG_PRINTF("[CONFIG] Funding schedule updated to %s\n",
+                 mode == FUNDING_SCHEDULE_EPOCH ? "epoch" : "interval");
+    notify_change();
+}
+
+void config_set_predicted_funding_refresh_ms(uint32_t ms) {
+    g_config.predicted_funding_refresh_ms = ms;
+    DEBUG_PRINTF("[CONFIG] Predicted funding refresh updated to %lu ms\n", ms);
+    notify_change();
 }
 
 void config_set_spread_alert_pct(double pct) {
@@ -1,7 +1,11 @@
 #ifndef APP_CONFIG_H
 #define APP_CONFIG_H
 
+#ifdef ARDUINO
 #include <Arduino.h>
+#else
+#include <stdint.h>
+#endif
 #include "../hw/hw_power.h"
 
 // Application configuration - defaults and settings (Task 3.2)
@@ -9,11 +13,18 @@
 // Maximum number of symbols supported
 #define MAX_SYMBOLS 10
 
+// When funding data is refetched
+enum FundingScheduleMode {
+    FUNDING_SCHEDULE_INTERVAL = 0,  // Every funding_refresh_ms
+    FUNDING_SCHEDULE_EPOCH = 1      // Right after each symbol's funding epoch (+ optional predicted polling)
+};
+
 // Symbol configuration
 struct SymbolConfig {
     const char* display_name;      // e.g., "BTC/USDT"
     const char* binance_symbol;    // e.g., "BTCUSDT"
     const char* coinbase_product;  // e.g., "BTC-USD"
+    const char* kraken_pair;       // e.g., "XXBTZUSD" (result key, "" if not listed)
     bool enabled;                  // Whether this symbol is active
 };
 
@@ -27,6 +38,10 @@ struct AppConfig {
     uint32_t price_refresh_ms;
     uint32_t funding_refresh_ms;
     
+    // Funding scheduling
+    FundingScheduleMode funding_schedule;
+    uint32_t predicted_funding_refresh_ms;  // Predicted-rate polling between epochs (0 = off)
+    
     // Alert thresholds
     double spread_alert_pct;     // Alert when spread exceeds this percentage
     double funding_alert_pct;    // Alert when funding rate exceeds this percentage
@@ -40,6 +55,8 @@ struct AppConfig {
     AppConfig() : num_symbols(MAX_SYMBOLS),
                   price_refresh_ms(5000),
                   funding_refresh_ms(60000),
+                  funding_schedule(FUNDING_SCHEDULE_EPOCH),
+                  predicted_funding_refresh_ms(0),
                   spread_alert_pct(0.5),
                   funding_alert_pct(0.01),
                   stale_ms(15000),
@@ -69,6 +86,8 @@ int config_get_prev_enabled_symbol(int current_idx);
 const SymbolConfig* config_get_symbol(int idx);
 uint32_t config_get_price_refresh_ms();
 uint32_t config_get_funding_refresh_ms();
+FundingScheduleMode config_get_funding_schedule();
+uint32_t config_get_predicted_funding_refresh_ms();
 double config_get_spread_alert_pct();
 double config_get_funding_alert_pct();
 uint32_t config_get_stale_ms();
@@ -76,9 +95,15 @@ uint32_t config_get_stale_ms();
 // Set configuration values (setters for future use)
 void config_set_price_refresh_ms(uint32_t ms);
 void config_set_funding_refresh_ms(uint32_t ms);
+void config_set_funding_schedule(FundingScheduleMode mode);
+void config_set_predicted_funding_refresh_ms(uint32_t ms);
 void config_set_spread_alert_pct(double pct);
 void config_set_funding_alert_pct(double pct);
 PowerMode config_get_power_mode();
 void config_set_power_mode(PowerMode mode);
 
+// Called after config_save() and the refresh setters (e.g. to wake the net task)
+typedef void (*ConfigChangeListener)();
+void config_set_change_listener(ConfigChangeListener listener);
+
 #endif // APP_CONFIG_H
@@ -0,0 +1,113 @@
+#include "app_exchange.h"
+#include <string.h>
+
+static ExchangeAdapter* g_adapters[EXCHANGE_MAX];
+static int g_num_adapters = 0;
+
+bool exchange_register(ExchangeAdapter* adapter) {
+    if (!adapter || g_num_adapters >= EXCHANGE_MAX) {
+        return false;
+    }
+    g_adapters[g_num_adapters++] = adapter;
+    return true;
+}
+
+void exchange_reset() {
+    g_num_adapters = 0;
+}
+
+int exchange_count() {
+    return g_num_adapters;
+}
+
+ExchangeAdapter* exchange_get(int k) {
+    return (k >= 0 && k < g_num_adapters) ? g_adapters[k] : nullptr;
+}
+
+// Requests needed for n markets on a venue
+static int plan_requests(const ExchangeAdapter* adapter, int n, bool batched) {
+    if (!batched) {
+        return n;
+    }
+    int per_request = adapter->batch_max() > 0 ? adapter->batch_max() : 1;
+    return (n + per_request - 1) / per_request;
+}
+
+int exchange_plan_build(ExchangePlan* plan, const SymbolConfig* symbols,
+                        const int* due, int num_due, uint32_t now_ms) {
+    if (!plan) {
+        return 0;
+    }
+    if (!symbols || !due || num_due < 0) {
+        num_due = 0;
+    }
+    if (num_due > MAX_SYMBOLS) {
+        num_due = MAX_SYMBOLS;
+    }
+    plan->num_due = num_due;
+    plan->num_venues = g_num_adapters;
+    plan->requests = 0;
+    for (int k = 0; k < num_due; k++) {
+        plan->due[k] = due[k];
+    }
+
+    for (int v = 0; v < g_num_adapters; v++) {
+        ExchangePlanVenue& venue = plan->venues[v];
+        ExchangeAdapter* adapter = g_adapters[v];
+        uint8_t caps = adapter->capabilities();
+        venue.adapter = adapter;
+        venue.num = 0;
+        venue.streamed = 0;
+
+        for (int k = 0; k < num_due; k++) {
+            int i = due[k];
+            const char* market = adapter->market(symbols[i]);
+            if (!market || !market[0]) {
+                plan->slot[k][v] = EXCHANGE_SLOT_UNLISTED;
+            } else if ((caps & EXCHANGE_CAP_STREAM) && adapter->streamed(i, now_ms)) {
+                plan->slot[k][v] = EXCHANGE_SLOT_STREAMED;
+                venue.streamed++;
+            } else {
+                plan->slot[k][v] = venue.num;
+                venue.markets[venue.num++] = market;
+            }
+        }
+
+        // A single market is cheaper on its own (smaller response)
+        venue.batched = (caps & EXCHANGE_CAP_BATCH_QUOTES) && venue.num > 1;
+        venue.requests = plan_requests(adapter, venue.num, venue.batched);
+        plan->requests += venue.requests;
+    }
+    return plan->requests;
+}
+
+int exchange_plan_begin(ExchangePlan* plan) {
+    int issued = 0;
+    for (int v = 0; plan && v < plan->num_venues; v++) {
+        ExchangePlanVenue& venue = plan->venues[v];
+        memset(venue.quotes, 0, sizeof(venue.quotes));
+        if (venue.num > 0) {
+            issued += venue.adapter->begin_quotes(venue.markets, venue.num, venue.batched, venue.quotes);
+        }
+    }
+    return issued;
+}
+
+int exchange_plan_end(ExchangePlan* plan) {
+    int valid = 0;
+    for (int v = 0; plan && v < plan->num_venues; v++) {
+        ExchangePlanVenue& venue = plan->venues[v];
+        if (venue.num > 0) {
+            valid += venue.adapter->end_quotes();
+        }
+    }
+    return valid;
+}
+
+const ExchangeQuote* exchange_plan_quote(const ExchangePlan* plan, int k, int v) {
+    if (!plan || k < 0 || k >= plan->num_due || v < 0 || v >= plan->num_venues) {
+        return nullptr;
+    }
+    int slot = plan->slot[k][v];
+    return slot >= 0 ? &plan->venues[v].quotes[slot] : nullptr;
+}
@@ -0,0 +1,143 @@
+#ifndef APP_EXCHANGE_H
+#define APP_EXCHANGE_H
+
+#include <stdint.h>
+#include "app_config.h"
+#include "app_fixed.h"
+#include "app_model.h"
+
+/**
+ * @file app_exchange.h
+ * @brief Exchange adapter registry and capability-driven quote planning
+ *
+ * Each venue is an ExchangeAdapter registered once at startup. It names
+ * the symbol's market on the venue (or nullptr when not listed there) and
+ * declares what it can do (EXCHANGE_CAP_*). Every price cycle the
+ * scheduler builds an ExchangePlan from the registry:
+ * - quotes arriving over a live stream are not requested
+ * - a batch-capable venue covers all of its polled markets in one request
+ *   (per-market only when a single market is due)
+ * - other venues get one request per polled market
+ * so a new batch-capable venue adds one request per cycle, not one per
+ * symbol.
+ *
+ * Execution is two-phase so requests of all venues run concurrently:
+ * exchange_plan_begin() lets each adapter queue its requests (or perform
+ * them, in blocking builds), the caller drives the HTTP engine, then
+ * exchange_plan_end() lets each adapter parse its responses.
+ *
+ * Arduino-independent; tested on the host with mock adapters (test_exchange).
+ */
+
+// Adapters kept in the registry
+#define EXCHANGE_MAX 4
+
+// Capability bits (ExchangeAdapter::capabilities())
+#define EXCHANGE_CAP_BATCH_QUOTES 0x01  // Several markets per request
+#define EXCHANGE_CAP_BOOK         0x02  // Quotes carry best bid/ask
+#define EXCHANGE_CAP_STREAM       0x04  // Quotes may arrive over a market stream
+#define EXCHANGE_CAP_FUNDING      0x08  // Perpetual funding rates
+
+// Market slot of a due symbol on a venue (ExchangePlan::slot)
+#define EXCHANGE_SLOT_UNLISTED (-2)     // Not traded on the venue
+#define EXCHANGE_SLOT_STREAMED (-1)     // Quote kept from the stream
+
+// Quote of one market; bid/ask 0 = mid price only
+struct ExchangeQuote {
+    Fixed price;
+    Fixed bid;
+    Fixed ask;
+    bool valid;
+};
+
+class ExchangeAdapter {
+public:
+    virtual ~ExchangeAdapter() {}
+
+    // Short venue name for logs ("binance")
+    virtual const char* name() const = 0;
+
+    // Model slot the venue's quotes are stored in
+    virtual QuoteVenue venue() const = 0;
+
+    // EXCHANGE_CAP_* bits
+    virtual uint8_t capabilities() const = 0;
+
+    // Markets per batched request (EXCHANGE_CAP_BATCH_QUOTES)
+    virtual int batch_max() const { return MAX_SYMBOLS; }
+
+    // The symbol's market on this venue, nullptr (or "") if not listed
+    virtual const char* market(const SymbolConfig& sym) const = 0;
+
+    // True while symbol idx's quote arrives over the venue's stream
+    virtual bool streamed(int idx, uint32_t now_ms) const {
+        (void)idx;
+        (void)now_ms;
+        return false;
+    }
+
+    /**
+     * @brief Start fetching quotes for markets[0..n)
+     * batched: one request per batch_max() markets, else one per market.
+     * Results are written to out[0..n) by end_quotes() at the latest.
+     * @return Requests issued
+     */
+    virtual int begin_quotes(const char* const* markets, int n, bool batched, ExchangeQuote* out) = 0;
+
+    /**
+     * @brief Complete the requests of the last begin_quotes()
+     * @return Markets with a valid quote
+     */
+    virtual int end_quotes() = 0;
+};
+
+// Register an adapter (not owned); false if the registry is full
+bool exchange_register(ExchangeAdapter* adapter);
+
+// Remove all adapters
+void exchange_reset();
+
+int exchange_count();
+ExchangeAdapter* exchange_get(int k);
+
+// Polled markets of one venue in a plan
+struct ExchangePlanVenue {
+    ExchangeAdapter* adapter;
+    const char* markets[MAX_SYMBOLS];
+    ExchangeQuote quotes[MAX_SYMBOLS];
+    int num;                    // Polled markets
+    int streamed;               // Markets skipped because streamed
+    bool batched;
+    int requests;               // Planned requests
+};
+
+// Request plan of one price cycle
+struct ExchangePlan {
+    int due[MAX_SYMBOLS];                   // Config index of each due symbol
+    int num_due;
+    ExchangePlanVenue venues[EXCHANGE_MAX]; // Registry order
+    int num_venues;
+    int slot[MAX_SYMBOLS][EXCHANGE_MAX];    // Index into venues[v].markets, or EXCHANGE_SLOT_*
+    int requests;                           // Planned requests, all venues
+};
+
+/**
+ * @brief Plan the quote requests for symbols[due[0..num_due)]
+ * @return Planned requests
+ */
+int exchange_plan_build(ExchangePlan* plan, const SymbolConfig* symbols,
+                        const int* due, int num_due, uint32_t now_ms);
+
+// Start every venue's requests; returns requests issued
+int exchange_plan_begin(ExchangePlan* plan);
+
+// Complete every venue's requests; returns valid quotes
+int exchange_plan_end(ExchangePlan* plan);
+
+/**
+ * @brief Quote of due symbol k on venue v
+ * @return nullptr if the market is not listed on the venue or streamed
+ */
+const ExchangeQuote* exchange_plan_quote(const ExchangePlan* plan, int k, int v);
+
+#endif // APP_EXCHANGE_H
@@ -0,0 +1,178 @@
+#include "app_fixed.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 10^0 .. 10^FIXED_DECIMALS
+static const int64_t POW10[FIXED_DECIMALS + 1] = {
+    1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL, 100000000LL
+};
+
+// Largest whole part that still fits (INT64_MAX / FIXED_SCALE)
+static const int64_t WHOLE_MAX = INT64_MAX / FIXED_SCALE;
+
+bool fixed_parse(const char* s, size_t len, Fixed* out) {
+    if (!s || !out || len == 0) {
+        return false;
+    }
+    size_t i = 0;
+    bool negative = false;
+    if (s[0] == '-') {
+        negative = true;
+        i++;
+    }
+
+    int64_t whole = 0;
+    int64_t frac = 0;
+    int decimals = 0;
+    bool any_digit = false;
+    bool point = false;
+    bool round_up = false;
+    for (; i < len; i++) {
+        char c = s[i];
+        if (c == '.') {
+            if (point) {
+                return false;
+            }
+            point = true;
+            continue;
+        }
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        any_digit = true;
+        int digit = c - '0';
+        if (!point) {
+            if (whole > (WHOLE_MAX - digit) / 10) {
+                return false;
+            }
+            whole = whole * 10 + digit;
+        } else if (decimals < FIXED_DECIMALS) {
+            frac = frac * 10 + digit;
+            decimals++;
+        } else if (decimals == FIXED_DECIMALS) {
+            round_up = digit >= 5;      // First dropped digit decides
+            decimals++;
+        }
+    }
+    if (!any_digit) {
+        return false;
+    }
+
+    int kept = decimals < FIXED_DECIMALS ? decimals : FIXED_DECIMALS;
+    int64_t frac_units = frac * POW10[FIXED_DECIMALS - kept];
+    if (frac_units > INT64_MAX - whole * FIXED_SCALE) {
+        return false;
+    }
+    Fixed v = whole * FIXED_SCALE + frac_units;
+    if (round_up) {
+        if (v == INT64_MAX) {
+            return false;
+        }
+        v++;
+    }
+    *out = negative ? -v : v;
+    return true;
+}
+
+Fixed fixed_from_string(const char* s) {
+    if (!s) {
+        return 0;
+    }
+    Fixed v;
+    if (fixed_parse(s, strlen(s), &v)) {
+        return v;
+    }
+    return fixed_from_double(strtod(s, nullptr));
+}
+
+Fixed fixed_from_double(double v) {
+    if (isnan(v)) {
+        return 0;
+    }
+    double scaled = v * (double)FIXED_SCALE;
+    if (scaled >= 9.2e18) {
+        return INT64_MAX;
+    }
+    if (scaled <= -9.2e18) {
+        return -INT64_MAX;
+    }
+    return (Fixed)llround(scaled);
+}
+
+double fixed_to_double(Fixed v) {
+    // Whole and fractional parts separately: both exact in a double
+    return (double)(v / FIXED_SCALE) + (double)(v % FIXED_SCALE) / (double)FIXED_SCALE;
+}
+
+float fixed_to_float(Fixed v) {
+    return (float)(v / FIXED_SCALE) + (float)(v % FIXED_SCALE) / (float)FIXED_SCALE;
+}
+
+Fixed fixed_mid(Fixed a, Fixed b) {
+    // Halves first so the sum cannot overflow; exact mid = halves + rest / 2
+    Fixed halves = a / 2 + b / 2;
+    Fixed rest = a % 2 + b % 2;     // -2 .. 2
+    if (rest == 1) {
+        return halves >= 0 ? halves + 1 : halves;   // halves + .5, away from zero
+    }
+    if (rest == -1) {
+        return halves <= 0 ? halves - 1 : halves;   // halves - .5, away from zero
+    }
+    return halves + rest / 2;
+}
+
+float fixed_pct(Fixed num, Fixed den) {
+    if (den == 0) {
+        return 0.0f;
+    }
+    return fixed_to_float(num) / fixed_to_float(den) * 100.0f;
+}
+
+int fixed_format(Fixed v, int decimals, char* out, size_t cap) {
+    if (!out || cap == 0) {
+        return 0;
+    }
+    if (decimals < 0) {
+        decimals = 0;
+    } else if (decimals > FIXED_DECIMALS) {
+        decimals = FIXED_DECIMALS;
+    }
+
+    // Magnitude rounded to the requested decimals (unsigned: -INT64_MAX is fine)
+    bool negative = v < 0;
+    uint64_t mag = negative ? (uint64_t)(-(v + 1)) + 1 : (uint64_t)v;
+    uint64_t unit = (uint64_t)POW10[FIXED_DECIMALS - decimals];
+    mag = (mag + unit / 2) / unit;
+    uint64_t frac_div = (uint64_t)POW10[decimals];
+    uint64_t whole = mag / frac_div;
+    uint64_t frac = mag % frac_div;
+
+    // Digits are written backwards into tmp
+    char tmp[32];
+    int n = 0;
+    for (int d = 0; d < decimals; d++) {
+        tmp[n++] = (char)('0' + frac % 10);
+        frac /= 10;
+    }
+    if (decimals > 0) {
+        tmp[n++] = '.';
+    }
+    do {
+        tmp[n++] = (char)('0' + whole % 10);
+        whole /= 10;
+    } while (whole > 0);
+    if (negative && mag > 0) {
+        tmp[n++] = '-';     // "-0.00" is printed as "0.00"
+    }
+
+    if ((size_t)n + 1 > cap) {
+        out[0] = '\0';
+        return 0;
+    }
+    for (int k = 0; k < n; k++) {
+        out[k] = tmp[n - 1 - k];
+    }
+    out[n] = '\0';
+    return n;
+}
@@ -0,0 +1,71 @@
+#ifndef APP_FIXED_H
+#define APP_FIXED_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @file app_fixed.h
+ * @brief Fixed-point decimals for prices, spreads and funding rates
+ *
+ * The ESP32's FPU is single precision only: every double operation runs in
+ * software. Prices are therefore kept as an int64 count of 1e-8 units
+ * (Binance quotes 8 decimals, Coinbase fewer), parsed straight from the
+ * exchange's decimal strings without rounding, and added, subtracted,
+ * compared and formatted with integer arithmetic. Ratios (spread and
+ * basis percentages) are computed in hardware single precision floats.
+ *
+ * Range: +/- 92,233,720,368.54775807. Arduino-independent, unit tested on
+ * the host and the device (test_fixed, including a double vs fixed
+ * benchmark).
+ */
+
+// Value * FIXED_SCALE (e.g. 43250.5 -> 4325050000000)
+typedef int64_t Fixed;
+
+#define FIXED_DECIMALS 8
+#define FIXED_SCALE 100000000LL
+
+// Whole units (e.g. FIXED_UNITS(100) == 100.00000000)
+#define FIXED_UNITS(n) ((Fixed)(n) * FIXED_SCALE)
+
+/**
+ * @brief Parse a plain decimal string ("43250.50000000", "-0.00012")
+ * Exact up to FIXED_DECIMALS decimals; further decimals are rounded half
+ * away from zero.
+ * @return false on an empty string, exponent, stray character or a value
+ *         out of range
+ */
+bool fixed_parse(const char* s, size_t len, Fixed* out);
+
+/**
+ * @brief Parse a NUL-terminated exchange string (drop-in for atof)
+ * Exact decimal parse, falling back to strtod() for other number forms.
+ * @return 0 if s is null or not a number
+ */
+Fixed fixed_from_string(const char* s);
+
+// Nearest fixed value of a double (0 for NaN, saturated out of range)
+Fixed fixed_from_double(double v);
+
+// Conversions for display, JSON and ratios
+double fixed_to_double(Fixed v);
+float fixed_to_float(Fixed v);
+
+// Mid of two values, rounded half away from zero
+Fixed fixed_mid(Fixed a, Fixed b);
+
+// Absolute value
+inline Fixed fixed_abs(Fixed v) { return v < 0 ? -v : v; }
+
+// num / den * 100 in single precision (0 if den is 0)
+float fixed_pct(Fixed num, Fixed den);
+
+/**
+ * @brief Format like printf("%.*f", decimals, v) with integer arithmetic
+ * Rounded half away from zero; decimals is clamped to 0..FIXED_DECIMALS.
+ * @return Characters written (excluding NUL), 0 if out is too small
+ */
+int fixed_format(Fixed v, int decimals, char* out, size_t cap);
+
+#endif // APP_FIXED_H
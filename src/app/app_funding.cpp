@@ -0,0 +1,42 @@
+#include "app_funding.h"
+
+void funding_schedule_reset(FundingSchedule* s) {
+    s->fetched = false;
+    s->last_fetch_ms = 0;
+    s->epoch_known = false;
+    s->epoch_ms = 0;
+}
+
+void funding_schedule_on_fetch(FundingSchedule* s, uint32_t now_ms, int64_t ms_to_epoch) {
+    s->fetched = true;
+    s->last_fetch_ms = now_ms;
+    s->epoch_known = ms_to_epoch > 0 && ms_to_epoch <= (int64_t)FUNDING_EPOCH_MAX_MS;
+    s->epoch_ms = s->epoch_known ? now_ms + (uint32_t)ms_to_epoch : 0;
+}
+
+// Time left until start_ms + period_ms (0 if passed); wrap-safe
+static uint32_t remaining_ms(uint32_t start_ms, uint32_t period_ms, uint32_t now_ms) {
+    uint32_t elapsed = now_ms - start_ms;
+    return elapsed >= period_ms ? 0 : period_ms - elapsed;
+}
+
+uint32_t funding_schedule_wait_ms(const FundingSchedule* s, FundingScheduleMode mode,
+                                  uint32_t interval_ms, uint32_t predicted_ms, uint32_t now_ms) {
+    if (!s->fetched) {
+        return 0;
+    }
+    if (mode != FUNDING_SCHEDULE_EPOCH || !s->epoch_known) {
+        return remaining_ms(s->last_fetch_ms, interval_ms, now_ms);
+    }
+
+    // Epoch is measured from the last fetch, so the same wrap-safe helper applies
+    uint32_t wait = remaining_ms(s->last_fetch_ms, s->epoch_ms - s->last_fetch_ms + FUNDING_SETTLE_DELAY_MS,
+                                 now_ms);
+    if (predicted_ms > 0) {
+        uint32_t predicted_wait = remaining_ms(s->last_fetch_ms, predicted_ms, now_ms);
+        if (predicted_wait < wait) {
+            wait = predicted_wait;
+        }
+    }
+    return wait;
+}
@@ -0,0 +1,59 @@
+#ifndef APP_FUNDING_H
+#define APP_FUNDING_H
+
+#include <stdint.h>
+#include "app_config.h"
+
+/**
+ * @file app_funding.h
+ * @brief Funding-epoch aware scheduling of funding fetches
+ *
+ * Binance perpetuals settle funding at fixed epochs (every 8 h for most
+ * symbols). Instead of refetching every funding_refresh_ms, the scheduler
+ * in FUNDING_SCHEDULE_EPOCH mode fetches each symbol once right after its
+ * next epoch, plus optional slower polling of the predicted rate.
+ *
+ * The time to the next epoch comes from the exchange itself
+ * (nextFundingTime - server time), so no NTP sync is needed; it is kept
+ * on the millis() clock. Arduino-independent, unit tested on the host.
+ */
+
+// Delay after an epoch before refetching, so the new period is published
+#define FUNDING_SETTLE_DELAY_MS 15000
+
+// Epochs further away than this are treated as unknown (bad data)
+#define FUNDING_EPOCH_MAX_MS (24UL * 60 * 60 * 1000)
+
+struct FundingSchedule {
+    bool fetched;               // At least one successful fetch
+    uint32_t last_fetch_ms;     // millis() of the last successful fetch
+    bool epoch_known;           // epoch_ms is valid
+    uint32_t epoch_ms;          // millis() of the next funding epoch
+};
+
+// Forget all state (next check is due immediately)
+void funding_schedule_reset(FundingSchedule* s);
+
+/**
+ * @brief Record a successful fetch
+ * @param now_ms millis() of the fetch
+ * @param ms_to_epoch Time to the next funding epoch as reported by the
+ *        exchange (nextFundingTime - server time); <= 0 if unknown or not
+ *        yet rolled over, in which case interval polling is used
+ */
+void funding_schedule_on_fetch(FundingSchedule* s, uint32_t now_ms, int64_t ms_to_epoch);
+
+/**
+ * @brief Milliseconds until the symbol is due for a funding fetch
+ *
+ * INTERVAL mode (or epoch unknown): interval_ms after the last fetch.
+ * EPOCH mode: FUNDING_SETTLE_DELAY_MS after the next epoch, or
+ * predicted_ms after the last fetch if that comes first (0 = no
+ * predicted polling).
+ *
+ * @return 0 if due now
+ */
+uint32_t funding_schedule_wait_ms(const FundingSchedule* s, FundingScheduleMode mode,
+                                  uint32_t interval_ms, uint32_t predicted_ms, uint32_t now_ms);
+
+#endif // APP_FUNDING_H
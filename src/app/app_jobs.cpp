@@ -0,0 +1,176 @@
+#include "app_jobs.h"
+
+// Wrap-safe: a is before b on the millis() clock
+static inline bool time_before(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+}
+
+static bool valid_type(int type) {
+    return type >= 0 && type < JOB_TYPE_COUNT;
+}
+
+// Heap order: earliest deadline, then lowest priority value, then type
+static bool job_before(const JobQueue* q, uint8_t a, uint8_t b) {
+    const Job& ja = q->jobs[a];
+    const Job& jb = q->jobs[b];
+    if (ja.deadline_ms != jb.deadline_ms) {
+        return time_before(ja.deadline_ms, jb.deadline_ms);
+    }
+    if (ja.priority != jb.priority) {
+        return ja.priority < jb.priority;
+    }
+    return a < b;
+}
+
+static void heap_swap(JobQueue* q, int i, int j) {
+    uint8_t t = q->heap[i];
+    q->heap[i] = q->heap[j];
+    q->heap[j] = t;
+    q->pos[q->heap[i]] = (int8_t)i;
+    q->pos[q->heap[j]] = (int8_t)j;
+}
+
+static void sift_up(JobQueue* q, int i) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!job_before(q, q->heap[i], q->heap[parent])) {
+            break;
+        }
+        heap_swap(q, i, parent);
+        i = parent;
+    }
+}
+
+static void sift_down(JobQueue* q, int i) {
+    while (true) {
+        int first = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+        if (left < q->size && job_before(q, q->heap[left], q->heap[first])) {
+            first = left;
+        }
+        if (right < q->size && job_before(q, q->heap[right], q->heap[first])) {
+            first = right;
+        }
+        if (first == i) {
+            return;
+        }
+        heap_swap(q, i, first);
+        i = first;
+    }
+}
+
+// Restore the heap after the key at index i changed either way
+static void heap_fix(JobQueue* q, int i) {
+    if (i > 0 && job_before(q, q->heap[i], q->heap[(i - 1) / 2])) {
+        sift_up(q, i);
+    } else {
+        sift_down(q, i);
+    }
+}
+
+void job_queue_init(JobQueue* q) {
+    q->size = 0;
+    for (int t = 0; t < JOB_TYPE_COUNT; t++) {
+        q->jobs[t].type = (uint8_t)t;
+        q->jobs[t].priority = 0;
+        q->jobs[t].deadline_ms = 0;
+        q->jobs[t].interval_ms = 0;
+        q->pos[t] = -1;
+    }
+}
+
+bool job_queue_schedule(JobQueue* q, JobType type, uint8_t priority,
+                        uint32_t deadline_ms, uint32_t interval_ms) {
+    if (!q || !valid_type(type)) {
+        return false;
+    }
+    Job& job = q->jobs[type];
+    job.priority = priority;
+    job.deadline_ms = deadline_ms;
+    job.interval_ms = interval_ms;
+
+    int i = q->pos[type];
+    if (i < 0) {
+        i = q->size++;
+        q->heap[i] = (uint8_t)type;
+        q->pos[type] = (int8_t)i;
+    }
+    heap_fix(q, i);
+    return true;
+}
+
+void job_queue_cancel(JobQueue* q, JobType type) {
+    if (!q || !valid_type(type) || q->pos[type] < 0) {
+        return;
+    }
+    int i = q->pos[type];
+    int last = --q->size;
+    if (i != last) {
+        heap_swap(q, i, last);
+    }
+    q->pos[type] = -1;
+    if (i != last) {
+        heap_fix(q, i);
+    }
+}
+
+bool job_queue_armed(const JobQueue* q, JobType type) {
+    return q && valid_type(type) && q->pos[type] >= 0;
+}
+
+void job_queue_set_interval(JobQueue* q, JobType type, uint32_t interval_ms, uint32_t now_ms) {
+    if (!job_queue_armed(q, type)) {
+        return;
+    }
+    Job& job = q->jobs[type];
+    if (job.interval_ms == interval_ms) {
+        return;
+    }
+    if (job.interval_ms > 0) {
+        uint32_t last_start = job.deadline_ms - job.interval_ms;
+        uint32_t next = last_start + interval_ms;
+        job.deadline_ms = time_before(next, now_ms) ? now_ms : next;
+    }
+    job.interval_ms = interval_ms;
+    heap_fix(q, q->pos[type]);
+}
+
+static uint32_t wait_until(uint32_t deadline_ms, uint32_t now_ms) {
+    return time_before(now_ms, deadline_ms) ? deadline_ms - now_ms : 0;
+}
+
+uint32_t job_queue_wait_ms(const JobQueue* q, uint32_t now_ms) {
+    if (!q || q->size == 0) {
+        return JOB_WAIT_FOREVER;
+    }
+    return wait_until(q->jobs[q->heap[0]].deadline_ms, now_ms);
+}
+
+uint32_t job_queue_wait_type_ms(const JobQueue* q, JobType type, uint32_t now_ms) {
+    if (!job_queue_armed(q, type)) {
+        return JOB_WAIT_FOREVER;
+    }
+    return wait_until(q->jobs[type].deadline_ms, now_ms);
+}
+
+bool job_queue_pop_due(JobQueue* q, uint32_t now_ms, Job* out) {
+    if (!q || q->size == 0 || job_queue_wait_ms(q, now_ms) > 0) {
+        return false;
+    }
+    JobType type = (JobType)q->heap[0];
+    Job& job = q->jobs[type];
+    if (out) {
+        *out = job;
+    }
+
+    if (job.interval_ms == 0) {
+        job_queue_cancel(q, type);
+        return true;
+    }
+    // Next period after now, keeping the phase of the original deadline
+    uint32_t late = now_ms - job.deadline_ms;
+    job.deadline_ms += (late / job.interval_ms + 1) * job.interval_ms;
+    sift_down(q, 0);
+    return true;
+}
@@ -0,0 +1,93 @@
+#ifndef APP_JOBS_H
+#define APP_JOBS_H
+
+#include <stdint.h>
+
+/**
+ * @file app_jobs.h
+ * @brief Deadline-ordered queue of the scheduler's periodic jobs
+ *
+ * Each job type (price fetch, funding fetch, stale check, stability log)
+ * is armed at most once with an absolute deadline, an optional period
+ * and a priority. The queue is a binary min-heap on the deadline, so the
+ * task can sleep exactly until the earliest one instead of waking every
+ * second to compare timestamps. Jobs due at the same time run in
+ * priority order (lower value first).
+ *
+ * Periodic jobs are re-armed from their previous deadline, not from the
+ * time they ran, so a slow fetch does not push the schedule back; if a
+ * run overshoots whole periods they are skipped rather than run back to
+ * back. Jobs whose next time depends on their result (funding epochs)
+ * are armed with period 0 and re-armed by the caller.
+ *
+ * Deadlines are millis() values and compared wrap-safe, so they must lie
+ * within ~24 days of each other. Arduino-independent, unit tested on the
+ * host with a virtual clock (test_jobs).
+ */
+
+enum JobType {
+    JOB_PRICES = 0,         // Spot quotes of every venue
+    JOB_FUNDING,            // Funding rates of the symbols due
+    JOB_STALE_CHECK,        // Mark data stale once the oldest symbol ages out
+    JOB_STABILITY_LOG,      // Heap, pool, DNS, TLS and task metrics
+    JOB_TYPE_COUNT
+};
+
+// Nothing armed (job_queue_wait_ms)
+#define JOB_WAIT_FOREVER 0xFFFFFFFFu
+
+struct Job {
+    uint8_t type;           // JobType
+    uint8_t priority;       // Tie-break between jobs due together (0 = first)
+    uint32_t deadline_ms;
+    uint32_t interval_ms;   // Period, 0 = one-shot
+};
+
+struct JobQueue {
+    Job jobs[JOB_TYPE_COUNT];       // Indexed by type
+    uint8_t heap[JOB_TYPE_COUNT];   // Types ordered as a min-heap
+    int8_t pos[JOB_TYPE_COUNT];     // Heap index of each type, -1 if not armed
+    int size;
+};
+
+void job_queue_init(JobQueue* q);
+
+/**
+ * @brief Arm (or re-arm) a job type
+ * @param interval_ms Period after each run, 0 for a one-shot job
+ * @return false for an invalid type
+ */
+bool job_queue_schedule(JobQueue* q, JobType type, uint8_t priority,
+                        uint32_t deadline_ms, uint32_t interval_ms);
+
+// Disarm a job type
+void job_queue_cancel(JobQueue* q, JobType type);
+
+bool job_queue_armed(const JobQueue* q, JobType type);
+
+/**
+ * @brief Change a periodic job's period, keeping its last start
+ * The next run moves to (deadline - old period + new period), or now if
+ * that has already passed.
+ */
+void job_queue_set_interval(JobQueue* q, JobType type, uint32_t interval_ms, uint32_t now_ms);
+
+/**
+ * @brief Milliseconds until the earliest deadline
+ * @return 0 if a job is due, JOB_WAIT_FOREVER if nothing is armed
+ */
+uint32_t job_queue_wait_ms(const JobQueue* q, uint32_t now_ms);
+
+// Milliseconds until one job type is due (JOB_WAIT_FOREVER if not armed)
+uint32_t job_queue_wait_type_ms(const JobQueue* q, JobType type, uint32_t now_ms);
+
+/**
+ * @brief Take the most urgent due job
+ * A periodic job is re-armed for its next period before it is returned,
+ * so the caller may still re-arm or cancel it while running it. A
+ * one-shot job is disarmed.
+ * @return false if nothing is due at now_ms
+ */
+bool job_queue_pop_due(JobQueue* q, uint32_t now_ms, Job* out);
+
+#endif // APP_JOBS_H
@@ -36,3 +36,12 @@ bool calc_spread(double p_binance, double p_coinbase, double* spread_abs, double
     
     return true;
 }
+
+bool calc_spread(Fixed p_binance, Fixed p_coinbase, Fixed* spread_abs, float* spread_pct) {
+    if (!spread_abs || !spread_pct || p_binance <= 0 || p_coinbase <= 0) {
+        return false;
+    }
+    *spread_abs = p_coinbase - p_binance;
+    *spread_pct = fixed_pct(*spread_abs, fixed_mid(p_binance, p_coinbase));
+    return true;
+}
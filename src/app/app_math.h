@@ -1,7 +1,7 @@
 #ifndef APP_MATH_H
 #define APP_MATH_H
 
-#include <Arduino.h>
+#include "app_fixed.h"
 
 /**
  * @file app_math.h
@@ -32,4 +32,19 @@
  */
 bool calc_spread(double p_binance, double p_coinbase, double* spread_abs, double* spread_pct);
 
+/**
+ * @brief Direction of an executable cross-venue spread
+ */
+enum SpreadDirection {
+    SPREAD_BUY_BINANCE = 0,   // Buy at Binance ask, sell at Coinbase bid
+    SPREAD_BUY_COINBASE = 1   // Buy at Coinbase ask, sell at Binance bid
+};
+
+/**
+ * @brief calc_spread() on fixed-point prices (used by the model)
+ * spread_abs is exact; spread_pct is computed in single precision.
+ * @return false if either price is <= 0 or an output pointer is null
+ */
+bool calc_spread(Fixed p_binance, Fixed p_coinbase, Fixed* spread_abs, float* spread_pct);
+
 #endif // APP_MATH_H
@@ -1,6 +1,9 @@
 #include "app_model.h"
 #include "app_config.h"
+#include "app_math.h"
 #include "../config.h"
+
+#ifdef ARDUINO
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
 
@@ -8,7 +11,31 @@
 static AppState g_app_state;
 static SemaphoreHandle_t g_model_mutex = NULL;
 
+static bool model_lock() {
+    return g_model_mutex != NULL && xSemaphoreTake(g_model_mutex, portMAX_DELAY) == pdTRUE;
+}
+
+static void model_unlock() {
+    xSemaphoreGive(g_model_mutex);
+}
+#else
+// Host builds (unit tests, replay benchmarks): statically initialized pthread mutex
+#include <pthread.h>
+
+static AppState g_app_state;
+static pthread_mutex_t g_model_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static bool model_lock() {
+    return pthread_mutex_lock(&g_model_mutex) == 0;
+}
+
+static void model_unlock() {
+    pthread_mutex_unlock(&g_model_mutex);
+}
+#endif
+
 void model_init() {
+#ifdef ARDUINO
     // Create mutex FIRST before any other operations
     if (g_model_mutex == NULL) {
         g_model_mutex = xSemaphoreCreateMutex();
@@ -17,6 +44,7 @@ void model_init() {
             return;
         }
     }
+#endif
     
     // Get config data BEFORE acquiring mutex to avoid nested locks
     const AppConfig& cfg = config_get();
@@ -59,15 +87,48 @@ void model_init() {
 
 AppState model_snapshot() {
     AppState snapshot;
-    
-    if (g_model_mutex != NULL && xSemaphoreTake(g_model_mutex, portMAX_DELAY) == pdTRUE) {
-        snapshot = g_app_state;  // Copy entire state
-        xSemaphoreGive(g_model_mutex);
+    model_snapshot(&snapshot);
+    return snapshot;
+}
+
+void model_snapshot(AppState* out) {
+    if (model_lock()) {
+        *out = g_app_state;  // Copy entire state
+        model_unlock();
     } else {
         DEBUG_PRINTLN("[MODEL] WARNING: Failed to acquire mutex for snapshot");
     }
+}
+
+bool model_get_symbol(int idx, SymbolState* out) {
+    if (idx < 0 || idx >= MAX_SYMBOLS) {
+        DEBUG_PRINTF("[MODEL] ERROR: Invalid symbol index %d\n", idx);
+        return false;
+    }
     
-    return snapshot;
+    if (!model_lock()) {
+        DEBUG_PRINTLN("[MODEL] WARNING: Failed to acquire mutex for get_symbol");
+        return false;
+    }
+    *out = g_app_state.symbols[idx];
+    model_unlock();
+    return true;
+}
+
+// Append the Binance price to the symbol's history (caller holds the lock)
+static void append_history(int idx) {
+    SymbolState& s = g_app_state.symbols[idx];
+    if (!s.binance_quote.valid || s.binance_quote.price <= 0) {
+        return;
+    }
+    int head = s.history_head;
+    s.price_history[head] = s.binance_quote.price;
+    s.history_head = (head + 1) % PRICE_HISTORY_SIZE;
+    if (s.history_count < PRICE_HISTORY_SIZE) {
+        s.history_count++;
+    }
+    DEBUG_PRINTF("[MODEL] Added price %.2f to history[%d/%d] head=%d count=%d\n", 
+                  fixed_to_double(s.binance_quote.price), idx, head, s.history_head, s.history_count);
 }
 
 void model_update_symbol(int idx, const SymbolState& s) {
@@ -76,14 +137,14 @@ void model_update_symbol(int idx, const SymbolState& s) {
         return;
     }
     
-    if (g_model_mutex != NULL && xSemaphoreTake(g_model_mutex, portMAX_DELAY) == pdTRUE) {
+    if (model_lock()) {
         // Preserve configuration strings
         const char* name = g_app_state.symbols[idx].symbol_name;
         const char* binance_sym = g_app_state.symbols[idx].binance_symbol;
         const char* coinbase_prod = g_app_state.symbols[idx].coinbase_product;
         
         // Preserve history before update
-        double old_history[PRICE_HISTORY_SIZE];
+        Fixed old_history[PRICE_HISTORY_SIZE];
         int old_count = g_app_state.symbols[idx].history_count;
         int old_head = g_app_state.symbols[idx].history_head;
         for (int i = 0; i < PRICE_HISTORY_SIZE; i++) {
@@ -106,19 +167,9 @@ void model_update_symbol(int idx, const SymbolState& s) {
         g_app_state.symbols[idx].history_head = old_head;
         
         // Add current price to history if valid
-        if (s.binance_quote.valid && s.binance_quote.price > 0) {
-            g_app_state.symbols[idx].price_history[old_head] = s.binance_quote.price;
-            g_app_state.symbols[idx].history_head = (old_head + 1) % PRICE_HISTORY_SIZE;
-            if (old_count < PRICE_HISTORY_SIZE) {
-                g_app_state.symbols[idx].history_count = old_count + 1;
-            }
-            DEBUG_PRINTF("[MODEL] Added price %.2f to history[%d/%d] head=%d count=%d\n", 
-                          s.binance_quote.price, idx, old_head, 
-                          g_app_state.symbols[idx].history_head, 
-                          g_app_state.symbols[idx].history_count);
-        }
+        append_history(idx);
         
-        xSemaphoreGive(g_model_mutex);
+        model_unlock();
         
         DEBUG_PRINTF("[MODEL] Updated symbol[%d]: %s\n", idx, name);
     } else {
@@ -132,9 +183,9 @@ void model_set_selected(int idx) {
         return;
     }
     
-    if (g_model_mutex != NULL && xSemaphoreTake(g_model_mutex, portMAX_DELAY) == pdTRUE) {
+    if (model_lock()) {
         g_app_state.selected_symbol_idx = idx;
-        xSemaphoreGive(g_model_mutex);
+        model_unlock();
     } else {
         DEBUG_PRINTLN("[MODEL] WARNING: Failed to acquire mutex for set_selected");
     }
@@ -143,9 +194,9 @@ void model_set_selected(int idx) {
 int model_get_selected() {
     int idx = 0;
     
-    if (g_model_mutex != NULL && xSemaphoreTake(g_model_mutex, portMAX_DELAY) == pdTRUE) {
+    if (model_lock()) {
         idx = g_app_state.selected_symbol_idx;
-        xSemaphoreGive(g_model_mutex);
+        model_unlock();
     } else {
         DEBUG_PRINTLN("[MODEL] WARNING: Failed to acquire mutex for get_selected");
     }
@@ -153,25 +204,164 @@ int model_get_selected() {
     return idx;
 }
 
+unsigned long model_get_last_update(int idx) {
+    if (idx < 0 || idx >= MAX_SYMBOLS) {
+        return 0;
+    }
+    
+    unsigned long ms = 0;
+    if (model_lock()) {
+        ms = g_app_state.symbols[idx].last_update_ms;
+        model_unlock();
+    } else {
+        DEBUG_PRINTLN("[MODEL] WARNING: Failed to acquire mutex for get_last_update");
+    }
+    
+    return ms;
+}
+
+bool model_get_stale() {
+    bool stale = true;
+    
+    if (model_lock()) {
+        stale = g_app_state.data_stale;
+        model_unlock();
+    } else {
+        DEBUG_PRINTLN("[MODEL] WARNING: Failed to acquire mutex for get_stale");
+    }
+    
+    return stale;
+}
+
 void model_update_wifi(bool connected, int rssi) {
-    if (g_model_mutex != NULL && xSemaphoreTake(g_model_mutex, portMAX_DELAY) == pdTRUE) {
+    if (model_lock()) {
         g_app_state.wifi_connected = connected;
         g_app_state.wifi_rssi = rssi;
-        xSemaphoreGive(g_model_mutex);
+        model_unlock();
     }
 }
 
 void model_update_time(const char* time_str) {
-    if (g_model_mutex != NULL && xSemaphoreTake(g_model_mutex, portMAX_DELAY) == pdTRUE) {
+    if (model_lock()) {
         strncpy(g_app_state.current_time, time_str, sizeof(g_app_state.current_time) - 1);
         g_app_state.current_time[sizeof(g_app_state.current_time) - 1] = '\0';
-        xSemaphoreGive(g_model_mutex);
+        model_unlock();
     }
 }
 
 void model_set_stale(bool stale) {
-    if (g_model_mutex != NULL && xSemaphoreTake(g_model_mutex, portMAX_DELAY) == pdTRUE) {
+    if (model_lock()) {
         g_app_state.data_stale = stale;
-        xSemaphoreGive(g_model_mutex);
+        model_unlock();
+    }
+}
+
+static_assert(VENUE_COUNT <= SPREAD_VENUES_MAX, "spread matrix too small for the venues");
+
+const char* quote_venue_name(int venue) {
+    switch (venue) {
+        case VENUE_BINANCE: return "Binance";
+        case VENUE_COINBASE: return "Coinbase";
+        case VENUE_KRAKEN: return "Kraken";
+        default: return "?";
+    }
+}
+
+Quote& symbol_quote(SymbolState& s, QuoteVenue venue) {
+    switch (venue) {
+        case VENUE_COINBASE: return s.coinbase_quote;
+        case VENUE_KRAKEN: return s.kraken_quote;
+        default: return s.binance_quote;
+    }
+}
+
+void symbol_update_spreads(SymbolState& s, QuoteVenue venue) {
+    SpreadLeg legs[VENUE_COUNT];
+    for (int v = 0; v < VENUE_COUNT; v++) {
+        const Quote& q = symbol_quote(s, (QuoteVenue)v);
+        legs[v] = spread_leg(q.valid, q.price, q.bid, q.ask);
+    }
+    spread_matrix_update(&s.spreads, legs, VENUE_COUNT, venue);
+    
+    // Binance/Coinbase cell (dashboard, chart, alerts history)
+    const SpreadLeg& b = legs[VENUE_BINANCE];
+    const SpreadLeg& c = legs[VENUE_COINBASE];
+    s.spread_valid = spread_matrix_mid_valid(s.spreads, VENUE_BINANCE, VENUE_COINBASE);
+    if (s.spread_valid) {
+        s.spread_abs = c.mid - b.mid;
+        s.spread_pct = s.spreads.mid_pct[VENUE_BINANCE][VENUE_COINBASE];
+    }
+    
+    // Executable spread: the better Binance/Coinbase direction in $
+    int buy;
+    s.exec_spread_valid = spread_matrix_pair_exec(s.spreads, legs, VENUE_BINANCE, VENUE_COINBASE,
+                                                  &buy, &s.exec_spread_abs, &s.exec_spread_pct);
+    if (s.exec_spread_valid) {
+        s.exec_direction = buy == VENUE_BINANCE ? SPREAD_BUY_BINANCE : SPREAD_BUY_COINBASE;
+    }
+}
+
+void model_apply_quote(int idx, QuoteVenue venue, Fixed bid, Fixed ask, unsigned long now_ms) {
+    if (idx < 0 || idx >= MAX_SYMBOLS) {
+        return;
+    }
+    
+    // Called for every streamed message: update in place, no snapshot copy
+    if (model_lock()) {
+        SymbolState& s = g_app_state.symbols[idx];
+        Quote& q = symbol_quote(s, venue);
+        q.bid = bid;
+        q.ask = ask;
+        q.price = fixed_mid(bid, ask);
+        q.valid = true;
+        q.last_update_ms = now_ms;
+        symbol_update_spreads(s, venue);
+        s.last_update_ms = now_ms;
+        model_unlock();
+    }
+}
+
+void funding_update_basis(Funding& f) {
+    f.basis_valid = f.mark_price > 0 && f.index_price > 0;
+    if (f.basis_valid) {
+        f.basis_abs = f.mark_price - f.index_price;
+        f.basis_pct = fixed_pct(f.basis_abs, f.index_price);
+    } else {
+        f.basis_abs = 0;
+        f.basis_pct = 0.0f;
+    }
+}
+
+static ModelFundingListener g_funding_listener = nullptr;
+
+void model_set_funding_listener(ModelFundingListener listener) {
+    g_funding_listener = listener;
+}
+
+void model_apply_funding(int idx, Fixed rate, Fixed mark_price, Fixed index_price,
+                         uint64_t next_funding_ms, unsigned long now_ms) {
+    if (idx < 0 || idx >= MAX_SYMBOLS) {
+        return;
+    }
+    
+    Funding applied;
+    if (model_lock()) {
+        Funding& f = g_app_state.symbols[idx].funding;
+        f.rate = rate;
+        f.mark_price = mark_price;
+        f.index_price = index_price;
+        if (next_funding_ms > 0) {
+            f.next_funding_ms = next_funding_ms;
+        }
+        f.valid = true;
+        f.last_update_ms = now_ms;
+        funding_update_basis(f);
+        applied = f;
+        model_unlock();
+    }
+    
+    // Outside the lock: the listener may take a snapshot
+    if (g_funding_listener && applied.valid) {
+        g_funding_listener(idx, applied);
     }
 }
@@ -1,7 +1,15 @@
 #ifndef APP_MODEL_H
 #define APP_MODEL_H
 
+#ifdef ARDUINO
 #include <Arduino.h>
+#else
+#include <stdint.h>
+#include <string.h>
+#endif
+
+#include "app_fixed.h"
+#include "app_spread_matrix.h"
 
 // Application model - Thread-safe state management (Task 3.1)
 
@@ -10,19 +18,31 @@
 
 // Data structures
 struct Quote {
-    double price;
+    Fixed price;                    // Mid of bid/ask when the book is known
+    Fixed bid;                      // Best bid (0 if unknown)
+    Fixed ask;                      // Best ask (0 if unknown)
     bool valid;
     unsigned long last_update_ms;
     
-    Quote() : price(0.0), valid(false), last_update_ms(0) {}
+    Quote() : price(0), bid(0), ask(0), valid(false), last_update_ms(0) {}
 };
 
 struct Funding {
-    double rate;
+    Fixed rate;                     // Current (predicted) funding rate
+    Fixed mark_price;               // Perpetual mark price (0 if unknown)
+    Fixed index_price;              // Underlying index price (0 if unknown)
+    uint64_t next_funding_ms;       // Next settlement, Unix epoch ms (0 if unknown)
     bool valid;
     unsigned long last_update_ms;
     
-    Funding() : rate(0.0), valid(false), last_update_ms(0) {}
+    // Basis: perpetual mark over the underlying index
+    Fixed basis_abs;                // mark_price - index_price
+    float basis_pct;                // basis_abs relative to index_price, in percent
+    bool basis_valid;               // Both prices known
+    
+    Funding() : rate(0), mark_price(0), index_price(0), next_funding_ms(0),
+                valid(false), last_update_ms(0),
+                basis_abs(0), basis_pct(0.0f), basis_valid(false) {}
 };
 
 struct SymbolState {
@@ -32,15 +52,26 @@ struct SymbolState {
     
     Quote binance_quote;
     Quote coinbase_quote;
+    Quote kraken_quote;
     Funding funding;
     
     // Computed values
-    double spread_abs;
-    double spread_pct;
+    Fixed spread_abs;
+    float spread_pct;
     bool spread_valid;
     
+    // Executable cross-venue spread (buy at ask on one venue, sell at bid on the other)
+    Fixed exec_spread_abs;
+    float exec_spread_pct;
+    uint8_t exec_direction;         // SpreadDirection (app_math.h)
+    bool exec_spread_valid;
+    
+    // Spreads between every pair of venues (indexed by QuoteVenue); the
+    // fields above are its Binance/Coinbase cell
+    SpreadMatrix spreads;
+    
     // Price history for charts
-    double price_history[PRICE_HISTORY_SIZE];
+    Fixed price_history[PRICE_HISTORY_SIZE];
     int history_count;  // Number of valid entries (0 to PRICE_HISTORY_SIZE)
     int history_head;   // Index for next write (circular buffer)
     
@@ -48,11 +79,13 @@ struct SymbolState {
     unsigned long last_update_ms;
     
     SymbolState() : symbol_name(""), binance_symbol(""), coinbase_product(""),
-                    spread_abs(0.0), spread_pct(0.0), spread_valid(false),
+                    spread_abs(0), spread_pct(0.0f), spread_valid(false),
+                    exec_spread_abs(0), exec_spread_pct(0.0f), exec_direction(0),
+                    exec_spread_valid(false),
                     history_count(0), history_head(0),
                     last_update_ms(0) {
         for (int i = 0; i < PRICE_HISTORY_SIZE; i++) {
-            price_history[i] = 0.0;
+            price_history[i] = 0;
         }
     }
 };
@@ -83,6 +116,14 @@ void model_init();
 // Get a complete snapshot of the current state (thread-safe, returns copy)
 AppState model_snapshot();
 
+// Copy the complete state into *out (thread-safe); AppState is several KB,
+// so callers on small task stacks keep *out in static storage
+void model_snapshot(AppState* out);
+
+// Copy one symbol's state into *out (thread-safe)
+// Returns: false if idx is out of range or the model is locked
+bool model_get_symbol(int idx, SymbolState* out);
+
 // Update a specific symbol's data (thread-safe)
 void model_update_symbol(int idx, const SymbolState& s);
 
@@ -92,6 +133,12 @@ void model_set_selected(int idx);
 // Get currently selected symbol index (thread-safe)
 int model_get_selected();
 
+// Time of a symbol's last update, 0 if never or idx is out of range (thread-safe)
+unsigned long model_get_last_update(int idx);
+
+// Whether the data is currently marked stale (thread-safe)
+bool model_get_stale();
+
 // Get symbol name by index (thread-safe)
 const char* model_get_symbol_name(int idx);
 
@@ -104,4 +151,39 @@ void model_update_time(const char* time_str);
 // Mark data as stale/fresh (thread-safe)
 void model_set_stale(bool stale);
 
+// Venue of a streamed quote
+enum QuoteVenue {
+    VENUE_BINANCE = 0,
+    VENUE_COINBASE = 1,
+    VENUE_KRAKEN = 2,
+    VENUE_COUNT
+};
+
+// Display name of a venue ("Binance")
+const char* quote_venue_name(int venue);
+
+// The symbol's quote on a venue
+Quote& symbol_quote(SymbolState& s, QuoteVenue venue);
+
+// Recompute the spreads involving venue after its quote changed (row and
+// column of the spread matrix, then the Binance/Coinbase fields)
+void symbol_update_spreads(SymbolState& s, QuoteVenue venue);
+
+// Apply one streamed top-of-book update in place (thread-safe)
+// Only the venue's quote, the spreads and the timestamp change; the price
+// history keeps being sampled by model_update_symbol() on each fetch cycle.
+void model_apply_quote(int idx, QuoteVenue venue, Fixed bid, Fixed ask, unsigned long now_ms);
+
+// Recompute the basis from the funding entry's mark and index price
+void funding_update_basis(Funding& f);
+
+// Apply one streamed funding/mark update in place (thread-safe)
+// next_funding_ms = 0 keeps the known settlement time
+void model_apply_funding(int idx, Fixed rate, Fixed mark_price, Fixed index_price,
+                         uint64_t next_funding_ms, unsigned long now_ms);
+
+// Called after every model_apply_funding() with the stored values (e.g. to wake the alert task)
+typedef void (*ModelFundingListener)(int idx, const Funding& funding);
+void model_set_funding_listener(ModelFundingListener listener);
+
 #endif // APP_MODEL_H
@@ -4,14 +4,36 @@
 #include "app_model.h"
 #include "app_math.h"
 #include "app_alerts.h"
+#include "app_funding.h"
+#include "app_exchange.h"
+#include "app_venues.h"
+#include "app_task_load.h"
+#include "app_jobs.h"
+#if ENABLE_MARKET_STREAMS
+#include "app_stream.h"
+#endif
 #include "../net/net_wifi.h"
+#include "../net/net_http.h"
+#include "../net/net_async.h"
+#include "../net/net_dns.h"
+#include "../net/net_pool.h"
+#include "../net/net_timing.h"
+#if ENABLE_HTTPS
+#include "../net/net_tls.h"
+#endif
 #include "../net/net_binance.h"
 #include "../net/net_coinbase.h"
+#if ENABLE_KRAKEN
+#include "../net/net_kraken.h"
+#endif
 #include "../hw/hw_alert.h"
 #include "../hw/hw_storage.h"
 #if ENABLE_POWER_MANAGEMENT
 #include "../hw/hw_power.h"
 #endif
+#if ENABLE_HTTP_RECORD
+#include <SPIFFS.h>
+#endif
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 
@@ -50,22 +72,80 @@ struct BackoffState {
 
 static BackoffState price_backoff[MAX_SYMBOLS];    // One per symbol
 static BackoffState funding_backoff[MAX_SYMBOLS];  // One per symbol
+static FundingSchedule funding_schedule[MAX_SYMBOLS];  // Next funding fetch per symbol
 
 // Performance tracking for stability monitoring (Task 11.1)
 struct PerformanceMetrics {
     unsigned long last_price_fetch_duration_ms;
     unsigned long last_funding_fetch_duration_ms;
     unsigned long last_stability_log_ms;
+    uint32_t funding_requests;
     uint32_t min_free_heap;
     
     PerformanceMetrics() : last_price_fetch_duration_ms(0),
                           last_funding_fetch_duration_ms(0),
                           last_stability_log_ms(0),
+                          funding_requests(0),
                           min_free_heap(0xFFFFFFFF) {}
 };
 
 static PerformanceMetrics perf_metrics;
 
+// Per-task CPU load needs the kernel's run-time counters (ESP-IDF sdkconfig)
+#define TASK_LOAD_AVAILABLE (configUSE_TRACE_FACILITY && configGENERATE_RUN_TIME_STATS)
+
+#if TASK_LOAD_AVAILABLE
+// Kernel task list and load between stability logs (kept off the task stack)
+static TaskStatus_t task_status[TASK_LOAD_MAX];
+static TaskLoadSample task_samples[TASK_LOAD_MAX];
+static TaskLoadTracker task_load;
+#endif
+
+/**
+ * @brief Log CPU load, placement and stack headroom of every task
+ * Load covers the time since the previous call (the stability interval).
+ */
+static void log_task_load() {
+#if TASK_LOAD_AVAILABLE
+    uint32_t total = 0;
+    UBaseType_t n = uxTaskGetSystemState(task_status, TASK_LOAD_MAX, &total);
+    if (n == 0) {
+        DEBUG_PRINTF("[STABILITY] More than %d tasks, load not sampled\n", TASK_LOAD_MAX);
+        return;
+    }
+    for (UBaseType_t k = 0; k < n; k++) {
+        const TaskStatus_t& status = task_status[k];
+        TaskLoadSample& sample = task_samples[k];
+        sample.name = status.pcTaskName;
+        sample.run_time = status.ulRunTimeCounter;
+#if configTASKLIST_INCLUDE_COREID
+        sample.core = status.xCoreID == tskNO_AFFINITY ? TASK_LOAD_ANY_CORE : (int8_t)status.xCoreID;
+#else
+        sample.core = TASK_LOAD_ANY_CORE;
+#endif
+        sample.priority = (uint8_t)status.uxCurrentPriority;
+        sample.stack_free = status.usStackHighWaterMark;
+    }
+    if (task_load_update(&task_load, task_samples, (int)n, total) == 0) {
+        return;     // First sample: load known from the next log on
+    }
+    for (int k = 0; k < task_load.num; k++) {
+        const TaskLoad& task = task_load.tasks[k];
+        if (!task.measured) {
+            continue;
+        }
+        const char* core = task.core == TASK_LOAD_ANY_CORE ? "*" : task.core == 0 ? "0" : "1";
+        DEBUG_PRINTF("[STABILITY] Task %-16s core %s prio %2u cpu %5.1f%% stack free %lu\n",
+                     task.name, core, task.priority, task.cpu_pct, (unsigned long)task.stack_free);
+    }
+#else
+    // No run-time counters in this core build: stack headroom of the scheduler's tasks
+    DEBUG_PRINTF("[STABILITY] Task net_task stack free %lu, alert_task stack free %lu\n",
+                 (unsigned long)uxTaskGetStackHighWaterMark(net_task_handle),
+                 (unsigned long)uxTaskGetStackHighWaterMark(alert_task_handle));
+#endif
+}
+
 /**
  * @brief Log stability metrics (Task 11.1)
  * Called periodically to monitor system health
@@ -83,13 +163,158 @@ static void log_stability_metrics() {
     DEBUG_PRINTF("[STABILITY] Free heap: %u bytes (min: %u)\n", free_heap, perf_metrics.min_free_heap);
     DEBUG_PRINTF("[STABILITY] Wi-Fi RSSI: %d dBm\n", rssi);
     DEBUG_PRINTF("[STABILITY] Last price fetch: %lu ms\n", perf_metrics.last_price_fetch_duration_ms);
-    DEBUG_PRINTF("[STABILITY] Last funding fetch: %lu ms\n", perf_metrics.last_funding_fetch_duration_ms);
+    DEBUG_PRINTF("[STABILITY] Last funding fetch: %lu ms (%lu funding requests)\n",
+                 perf_metrics.last_funding_fetch_duration_ms, perf_metrics.funding_requests);
+    
+    HttpPoolStats pool = http_pool_get_stats();
+    DEBUG_PRINTF("[STABILITY] HTTP pool: %lu requests, %lu reused, %lu handshakes, %lu connect failures\n",
+                 pool.acquires, pool.reused, pool.handshakes, pool.connect_failures);
+    DEBUG_PRINTF("[STABILITY] HTTP pool evictions: %lu idle, %lu dead, %lu discarded\n",
+                 pool.idle_evictions, pool.dead_evictions, pool.discarded);
+    HttpAsyncStats async = http_async_get_stats();
+    DEBUG_PRINTF("[STABILITY] HTTP async: %lu requests, %lu ok, %lu failed (%lu timeouts), peak %lu in flight\n",
+                 async.submitted, async.completed_ok, async.failed, async.timeouts, async.max_in_flight);
+    DEBUG_PRINTF("[STABILITY] HTTP async connections: %lu opened, %lu reused, %lu stale retries\n",
+                 async.connects, async.reused, async.stale_retries);
+    DnsStats dns = dns_get_stats();
+    DEBUG_PRINTF("[STABILITY] DNS cache: %lu lookups, %lu hits, %lu negative, %lu stale served\n",
+                 dns.lookups, dns.hits, dns.negative_hits, dns.stale_served);
+    DEBUG_PRINTF("[STABILITY] DNS resolver: %lu queries, %lu failures, last %lu ms\n",
+                 dns.resolves, dns.failures, dns.last_resolve_ms);
+#if ENABLE_HTTPS
+    TlsSessionStats tls = tls_get_stats();
+    DEBUG_PRINTF("[STABILITY] TLS sessions: %lu hits, %lu misses, %lu resumed, %lu rejected, %lu failures\n",
+                 tls.hits, tls.misses, tls.resumed, tls.rejected, tls.handshake_failures);
+    DEBUG_PRINTF("[STABILITY] TLS handshake: full %lu ms, resumed %lu ms (last)\n",
+                 tls.full_handshake_ms, tls.resumed_handshake_ms);
+#endif
+#if ENABLE_MARKET_STREAMS
+    stream_log_stats();
+#endif
+    // Per-host request phase latencies (p50/p95/p99)
+    http_timing_log();
+    log_task_load();
     DEBUG_PRINTF("[STABILITY] Uptime: %lu seconds\n", millis() / 1000);
     DEBUG_PRINTLN("======================================");
 }
 
 /**
- * @brief Fetch and update spot prices for all symbols
+ * @brief Store a top-of-book quote; price is the mid so both venues share one basis
+ */
+static void set_book_quote(Quote* quote, bool ok, Fixed bid, Fixed ask) {
+    if (ok) {
+        quote->bid = bid;
+        quote->ask = ask;
+        quote->price = fixed_mid(bid, ask);
+        quote->valid = true;
+        quote->last_update_ms = millis();
+    } else {
+        quote->valid = false;
+    }
+}
+
+/**
+ * @brief Store a mid-only quote (exchange-rates batch): bid/ask unknown
+ */
+static void set_mid_quote(Quote* quote, Fixed price) {
+    quote->price = price;
+    quote->bid = 0;
+    quote->ask = 0;
+    quote->valid = true;
+    quote->last_update_ms = millis();
+}
+
+/**
+ * @brief True while symbol i's funding and mark price arrive over the futures stream
+ * Its premiumIndex fetch is skipped; polling takes over once the stream
+ * has been quiet for STREAM_QUOTE_MAX_AGE_MS.
+ */
+static bool funding_streamed(int i, unsigned long now) {
+#if ENABLE_MARKET_STREAMS
+    return stream_is_live(STREAM_BINANCE_MARK, i, now);
+#else
+    (void)i;
+    (void)now;
+    return false;
+#endif
+}
+
+/**
+ * @brief Apply one due symbol's planned quotes to the model
+ * Updates quotes, mid and executable spreads, timestamps and the symbol's
+ * price backoff. A streamed quote is already in the model and kept.
+ * @param k Index into plan.due
+ * @return true if every venue listing the symbol has a valid quote
+ */
+static bool apply_price_quotes(const ExchangePlan& plan, int k, const SymbolConfig* sym) {
+    int i = plan.due[k];
+    
+    // Get current state to preserve other fields
+    // CRITICAL: Copy ONCE per symbol, and only this symbol (not the whole AppState)
+    SymbolState state;
+    model_get_symbol(i, &state);
+    
+    // Set symbol names from config (these are const char* pointers)
+    state.symbol_name = sym->display_name;
+    state.binance_symbol = sym->binance_symbol;
+    state.coinbase_product = sym->coinbase_product;
+    
+    bool all_ok = true;
+    bool any_ok = false;
+    for (int v = 0; v < plan.num_venues; v++) {
+        if (plan.slot[k][v] == EXCHANGE_SLOT_UNLISTED) {
+            continue;
+        }
+        QuoteVenue venue = plan.venues[v].adapter->venue();
+        Quote& quote = symbol_quote(state, venue);
+        const ExchangeQuote* fetched = exchange_plan_quote(&plan, k, v);
+        if (fetched) {
+            if (!fetched->valid) {
+                quote.valid = false;
+            } else if (fetched->bid <= 0) {
+                // Exchange-rates price: spread only, no executable spread
+                set_mid_quote(&quote, fetched->price);
+            } else {
+                set_book_quote(&quote, true, fetched->bid, fetched->ask);
+            }
+            // Row and column of this venue in the spread matrix
+            symbol_update_spreads(state, venue);
+        }
+        all_ok = all_ok && quote.valid;
+        any_ok = any_ok || quote.valid;
+    }
+    
+    // Update timestamp if at least one quote is valid (Task 8.2)
+    if (any_ok) {
+        state.last_update_ms = millis();
+    }
+    
+    // Update model with fetched data
+    model_update_symbol(i, state);
+    
+    // Update backoff: reset on success, increase on failure
+    if (all_ok) {
+        price_backoff[i].reset();
+        return true;
+    }
+    price_backoff[i].increase();
+    DEBUG_PRINTF("[SCHEDULER] Price fetch failed for %s, backing off to %lums\n",
+                 sym->display_name, price_backoff[i].current_delay_ms);
+    return false;
+}
+
+// Request plan of the current price cycle (large: kept off the task stack)
+static ExchangePlan price_plan;
+
+/**
+ * @brief Fetch and update top-of-book quotes for all symbols
+ *
+ * The request plan comes from the registered venue adapters
+ * (app_exchange.h): streamed quotes are skipped and every batch-capable
+ * venue covers its polled symbols in one request. With ENABLE_ASYNC_HTTP
+ * the requests of all venues run concurrently, so the cycle takes as long
+ * as the slowest request rather than the sum of all of them.
+ *
  * @return Number of successful fetches
  */
 static int fetch_all_prices() {
@@ -97,90 +322,48 @@ static int fetch_all_prices() {
     unsigned long now = millis();
     int success_count = 0;
     
+    // Symbols due this cycle (config index)
+    int due[MAX_SYMBOLS];
+    int num_due = 0;
+    
     // Get config ONCE outside the loop to avoid repeated calls
     const AppConfig& cfg = config_get();
     
-    // Process each symbol
     for (int i = 0; i < cfg.num_symbols; i++) {
-        // Skip disabled symbols
-        if (!cfg.symbols[i].enabled) {
+        // Skip disabled symbols and symbols in backoff
+        if (!cfg.symbols[i].enabled || !price_backoff[i].should_retry(now)) {
             continue;
         }
-        
-        // Check if we should retry this symbol (backoff)
-        if (!price_backoff[i].should_retry(now)) {
-            continue;
-        }
-        
-        const SymbolConfig* sym = &cfg.symbols[i];
         price_backoff[i].mark_attempt(now);
-        
-        // Get current state to preserve other fields
-        // CRITICAL: Snapshot ONCE per symbol, not repeatedly
-        AppState snapshot = model_snapshot();
-        SymbolState state = snapshot.symbols[i];
-        
-        // Set symbol names from config (these are const char* pointers)
-        state.symbol_name = sym->display_name;
-        state.binance_symbol = sym->binance_symbol;
-        state.coinbase_product = sym->coinbase_product;
-        
-        bool binance_ok = false;
-        bool coinbase_ok = false;
-        
-        // Fetch Binance spot price
-        double binance_price = 0.0;
-        if (net_binance::fetch_spot(sym->binance_symbol, &binance_price)) {
-            state.binance_quote.price = binance_price;
-            state.binance_quote.valid = true;
-            state.binance_quote.last_update_ms = millis();
-            binance_ok = true;
-        } else {
-            state.binance_quote.valid = false;
-        }
-        
-        // Fetch Coinbase spot price
-        double coinbase_price = 0.0;
-        if (net_coinbase::fetch_spot(sym->coinbase_product, &coinbase_price)) {
-            state.coinbase_quote.price = coinbase_price;
-            state.coinbase_quote.valid = true;
-            state.coinbase_quote.last_update_ms = millis();
-            coinbase_ok = true;
-        } else {
-            state.coinbase_quote.valid = false;
-        }
-        
-        // Calculate spread if both prices are valid
-        if (state.binance_quote.valid && state.coinbase_quote.valid) {
-            double spread_abs, spread_pct;
-            if (calc_spread(state.binance_quote.price, state.coinbase_quote.price, 
-                          &spread_abs, &spread_pct)) {
-                state.spread_abs = spread_abs;
-                state.spread_pct = spread_pct;
-                state.spread_valid = true;
-            } else {
-                state.spread_valid = false;
-            }
-        } else {
-            state.spread_valid = false;
+        due[num_due++] = i;
+    }
+    
+    int planned = exchange_plan_build(&price_plan, cfg.symbols, due, num_due, now);
+    for (int v = 0; v < price_plan.num_venues; v++) {
+        const ExchangePlanVenue& venue = price_plan.venues[v];
+        if (venue.streamed > 0) {
+            DEBUG_PRINTF("[SCHEDULER] %s: %d streamed, %d polled in %d requests\n",
+                         venue.adapter->name(), venue.streamed, venue.num, venue.requests);
         }
-        
-        // Update timestamp if at least one quote is valid (Task 8.2)
-        if (binance_ok || coinbase_ok) {
-            state.last_update_ms = millis();
+    }
+    
+    if (planned > 0) {
+        exchange_plan_begin(&price_plan);
+#if ENABLE_ASYNC_HTTP && !ENABLE_HTTP_RECORD
+        // Wait for the slowest one (every job has its own deadline)
+        int pending = http_async_run(VENUE_REQUEST_TIMEOUT_MS + 1000);
+        if (pending > 0) {
+            DEBUG_PRINTF("[SCHEDULER] %d price requests still pending, aborting\n", pending);
+            http_async_close_all();
         }
-        
-        // Update model with fetched data
-        model_update_symbol(i, state);
-        
-        // Update backoff: reset on success, increase on failure
-        if (binance_ok && coinbase_ok) {
-            price_backoff[i].reset();
+#endif
+        exchange_plan_end(&price_plan);
+    }
+    
+    // Apply results
+    for (int k = 0; k < price_plan.num_due; k++) {
+        if (apply_price_quotes(price_plan, k, &cfg.symbols[price_plan.due[k]])) {
             success_count++;
-        } else {
-            price_backoff[i].increase();
-            DEBUG_PRINTF("[SCHEDULER] Price fetch failed for %s, backing off to %lums\n",
-                         sym->display_name, price_backoff[i].current_delay_ms);
         }
     }
     
@@ -191,14 +374,47 @@ static int fetch_all_prices() {
 }
 
 /**
- * @brief Fetch and update funding rates for all symbols
- * @return Number of successful fetches
+ * @brief Milliseconds until the next symbol is due for a funding fetch
+ * @return 0 if at least one enabled symbol is due now
+ */
+static uint32_t funding_wait_ms(unsigned long now) {
+    const AppConfig& cfg = config_get();
+    uint32_t wait = UINT32_MAX;
+    
+    for (int i = 0; i < cfg.num_symbols; i++) {
+        if (!cfg.symbols[i].enabled) {
+            continue;
+        }
+        uint32_t w = funding_schedule_wait_ms(&funding_schedule[i], cfg.funding_schedule,
+                                              cfg.funding_refresh_ms, cfg.predicted_funding_refresh_ms, now);
+        if (w < wait) {
+            wait = w;
+        }
+    }
+    return wait;
+}
+
+/**
+ * @brief Fetch and update funding rates for all due symbols
+ *
+ * One premiumIndex request covers every due symbol and also fills in
+ * mark price, index price and next funding time. In epoch mode a symbol
+ * is due right after its funding epoch (see app_funding.h). Symbols
+ * whose funding is streamed are skipped and checked again after
+ * funding_refresh_ms.
+ *
+ * @return Number of successful fetches, -1 if no request was made
  */
 static int fetch_all_funding() {
     unsigned long fetch_start = millis();
     unsigned long now = millis();
     int success_count = 0;
     
+    // Symbols due this cycle (config index + Binance symbol)
+    int due_index[MAX_SYMBOLS];
+    const char* due_binance[MAX_SYMBOLS];
+    int num_due = 0;
+    
     // Get config ONCE outside the loop
     const AppConfig& cfg = config_get();
     
@@ -208,26 +424,64 @@ static int fetch_all_funding() {
             continue;
         }
         
+        // Not due yet (interval / funding epoch)
+        if (funding_schedule_wait_ms(&funding_schedule[i], cfg.funding_schedule, cfg.funding_refresh_ms,
+                                     cfg.predicted_funding_refresh_ms, now) > 0) {
+            continue;
+        }
+        
+        // Live from the markPrice stream: nothing to fetch
+        if (funding_streamed(i, now)) {
+            funding_schedule_on_fetch(&funding_schedule[i], now, 0);
+            continue;
+        }
+        
         // Check if we should retry this symbol (backoff)
         if (!funding_backoff[i].should_retry(now)) {
             continue;
         }
         
-        const SymbolConfig* sym = &cfg.symbols[i];
         funding_backoff[i].mark_attempt(now);
+        due_index[num_due] = i;
+        due_binance[num_due] = cfg.symbols[i].binance_symbol;
+        num_due++;
+    }
+    if (num_due == 0) {
+        return -1;  // Due symbols are all streamed or backing off
+    }
+    
+    // Fetch Binance funding and mark data for all due symbols at once
+    DEBUG_PRINTF("[SCHEDULER] Fetching funding rates for %d symbols...\n", num_due);
+    net_binance::PremiumIndex premium[MAX_SYMBOLS];
+    net_binance::fetch_premium_index(due_binance, num_due, premium);
+    perf_metrics.funding_requests++;
+    
+    for (int k = 0; k < num_due; k++) {
+        int i = due_index[k];
+        const SymbolConfig* sym = &cfg.symbols[i];
         
         // Get current state to preserve other fields
-        // CRITICAL: Snapshot ONCE per symbol
-        AppState snapshot = model_snapshot();
-        SymbolState state = snapshot.symbols[i];
+        // CRITICAL: Copy ONCE per symbol, and only this symbol; premium[] and
+        // the TLS handshake below share this frame on the net_task stack
+        SymbolState state;
+        model_get_symbol(i, &state);
         
-        // Fetch Binance funding rate
-        double funding_rate = 0.0;
-        if (net_binance::fetch_funding(sym->binance_symbol, &funding_rate)) {
-            state.funding.rate = funding_rate;
+        if (premium[k].valid) {
+            state.funding.rate = premium[k].funding_rate;
+            state.funding.mark_price = premium[k].mark_price;
+            state.funding.index_price = premium[k].index_price;
+            state.funding.next_funding_ms = premium[k].next_funding_ms;
             state.funding.valid = true;
             state.funding.last_update_ms = millis();
+            funding_update_basis(state.funding);
             funding_backoff[i].reset();
+            
+            // Time to the next epoch on the exchange's own clock
+            int64_t ms_to_epoch = 0;
+            if (premium[k].next_funding_ms > 0 && premium[k].server_time_ms > 0) {
+                ms_to_epoch = (int64_t)(premium[k].next_funding_ms - premium[k].server_time_ms);
+            }
+            funding_schedule_on_fetch(&funding_schedule[i], now, ms_to_epoch);
             success_count++;
         } else {
             state.funding.valid = false;
@@ -246,22 +500,131 @@ static int fetch_all_funding() {
     return success_count;
 }
 
+/**
+ * @brief Mark the model stale once an enabled symbol ages out (Task 8.2)
+ * @return Milliseconds until the next fresh symbol would age out
+ *         (stale_ms if none is fresh)
+ */
+static uint32_t check_stale(unsigned long now) {
+    const AppConfig& cfg = config_get();
+    bool any_stale = false;
+    uint32_t stale_threshold_ms = config_get_stale_ms();
+    uint32_t wait = stale_threshold_ms;
+    
+    for (int i = 0; i < MAX_SYMBOLS; i++) {
+        // Skip disabled symbols - they won't be updated
+        if (!cfg.symbols[i].enabled) continue;
+        
+        unsigned long last_update_ms = model_get_last_update(i);
+        if (last_update_ms == 0) {
+            // Never updated - consider stale (but don't log every time)
+            any_stale = true;
+        } else {
+            // Check age, handling millis() rollover correctly
+            unsigned long age_ms = now - last_update_ms;
+            // Only log and mark stale if age exceeds threshold
+            if (age_ms > stale_threshold_ms && age_ms < 4000000000UL) {
+                // Updated but too old (and not wrapped around)
+                any_stale = true;
+                DEBUG_PRINTF("[SCHEDULER] %s data is stale (age: %lu ms)\n",
+                             cfg.symbols[i].display_name, age_ms);
+            } else if (age_ms <= stale_threshold_ms) {
+                uint32_t w = stale_threshold_ms - age_ms + 1;
+                if (w < wait) {
+                    wait = w;
+                }
+            }
+        }
+    }
+    
+    if (any_stale && !model_get_stale()) {
+        DEBUG_PRINTLN("[SCHEDULER] Marking data as STALE");
+        model_set_stale(true);
+    }
+    return wait;
+}
+
+// Jobs due at the same time run in this order
+static const uint8_t JOB_PRIORITY_PRICES = 0;
+static const uint8_t JOB_PRIORITY_FUNDING = 1;
+static const uint8_t JOB_PRIORITY_STALE_CHECK = 2;
+static const uint8_t JOB_PRIORITY_STABILITY_LOG = 3;
+
+static const uint32_t STABILITY_LOG_INTERVAL_MS = 60000;  // Log every 60 seconds (Task 11.1)
+static const uint32_t FUNDING_RETRY_MS = 1000;    // Due symbols held back by backoff or Wi-Fi
+#if ENABLE_MARKET_STREAMS
+static const uint32_t STREAM_POLL_SLICE_MS = 1000;  // Longest select(): bounds config change latency
+#endif
+
+static JobQueue net_jobs;  // Owned by net_task
+
+// Arm the funding job for the next symbol due (none enabled: disarmed until a config change)
+static void arm_funding(unsigned long now) {
+    uint32_t wait = funding_wait_ms(now);
+    if (wait == UINT32_MAX) {
+        job_queue_cancel(&net_jobs, JOB_FUNDING);
+        return;
+    }
+    if (wait < FUNDING_RETRY_MS) {
+        wait = FUNDING_RETRY_MS;
+    }
+    job_queue_schedule(&net_jobs, JOB_FUNDING, JOB_PRIORITY_FUNDING, now + wait, 0);
+}
+
+// Settings saved: new price period from the last fetch, funding and stale times recomputed
+static void on_config_changed(unsigned long now) {
+    DEBUG_PRINTLN("[SCHEDULER] Configuration changed, rescheduling jobs");
+    job_queue_set_interval(&net_jobs, JOB_PRICES, config_get_price_refresh_ms(), now);
+    arm_funding(now);
+    job_queue_schedule(&net_jobs, JOB_STALE_CHECK, JOB_PRIORITY_STALE_CHECK, now, 0);
+}
+
+// Config listener, called from the UI or dashboard task
+static void notify_config_change() {
+    if (net_task_handle != NULL) {
+        xTaskNotifyGive(net_task_handle);
+    }
+}
+
+/**
+ * @brief Block until the next job is due or the configuration changes
+ * While streaming, select() on the feed sockets applies streamed quotes
+ * in slices of STREAM_POLL_SLICE_MS.
+ * @return true if woken by a configuration change
+ */
+static bool wait_for_jobs(uint32_t wait_ms, bool streaming) {
+#if ENABLE_MARKET_STREAMS
+    if (streaming) {
+        uint32_t slice = wait_ms < STREAM_POLL_SLICE_MS ? wait_ms : STREAM_POLL_SLICE_MS;
+        unsigned long wait_start = millis();
+        stream_poll(slice);
+        unsigned long waited = millis() - wait_start;
+        // No feed socket open (reconnecting): sleep the rest of the slice
+        wait_ms = waited < slice ? slice - waited : 0;
+    }
+#else
+    (void)streaming;
+#endif
+    TickType_t ticks = wait_ms == JOB_WAIT_FOREVER ? portMAX_DELAY : pdMS_TO_TICKS(wait_ms);
+    return ulTaskNotifyTake(pdTRUE, ticks) > 0;
+}
+
 /**
  * @brief Network task - periodic data fetching
  * 
  * Runs independently from UI loop. Fetches:
  * - Spot prices every PRICE_REFRESH_MS
- * - Funding rates every FUNDING_REFRESH_MS
+ * - Funding rates after each funding epoch (or every FUNDING_REFRESH_MS)
  * 
- * Implements exponential backoff on failures per symbol.
+ * Each job sits in a deadline-ordered queue (app_jobs.h) and the task
+ * sleeps until the earliest one is due, or until config_save() notifies
+ * it. Implements exponential backoff on failures per symbol.
  */
 static void net_task(void* parameter) {
     DEBUG_PRINTLN("[SCHEDULER] Net task started");
     
-    unsigned long last_price_fetch = 0;
-    unsigned long last_funding_fetch = 0;
-    unsigned long last_stability_log = 0;  // Task 11.1
-    const uint32_t STABILITY_LOG_INTERVAL_MS = 60000;  // Log every 60 seconds
+    bool dns_warm = false;  // Exchange hosts pre-resolved since the last Wi-Fi connect
+    bool streams_started = false;  // Market streams opened since the last Wi-Fi connect
     
     // Wait for Wi-Fi to connect before starting (with timeout)
     int wifi_wait_count = 0;
@@ -278,98 +641,129 @@ static void net_task(void* parameter) {
         DEBUG_PRINTLN("[SCHEDULER] Wi-Fi connected, starting periodic fetches");
     }
     
+    unsigned long start = millis();
+    job_queue_init(&net_jobs);
+    job_queue_schedule(&net_jobs, JOB_PRICES, JOB_PRIORITY_PRICES, start, config_get_price_refresh_ms());
+    arm_funding(start);
+    job_queue_schedule(&net_jobs, JOB_STALE_CHECK, JOB_PRIORITY_STALE_CHECK, start, 0);
+    job_queue_schedule(&net_jobs, JOB_STABILITY_LOG, JOB_PRIORITY_STABILITY_LOG,
+                       start + STABILITY_LOG_INTERVAL_MS, STABILITY_LOG_INTERVAL_MS);
+    
     while (true) {
+        uint32_t wait = job_queue_wait_ms(&net_jobs, millis());
+        if (wait > 0) {
+            if (wait_for_jobs(wait, streams_started)) {
+                on_config_changed(millis());
+            }
+            continue;
+        }
         unsigned long now = millis();
+        bool online = net_wifi_is_connected();
         
-        // Only fetch if Wi-Fi is connected
-        if (net_wifi_is_connected()) {
-            // Fetch prices based on configured interval
-            if (now - last_price_fetch >= config_get_price_refresh_ms()) {
-                last_price_fetch = now;
-                DEBUG_PRINTLN("[SCHEDULER] Fetching prices...");
-                int success = fetch_all_prices();
-                DEBUG_PRINTF("[SCHEDULER] Price fetch: %d/%d successful\n", 
-                            success, config_get_num_symbols());
-                
-                // Mark data as fresh if at least one fetch succeeded
-                if (success > 0) {
-                    model_set_stale(false);
-                }
+        if (online) {
+#if ENABLE_DNS_PRERESOLVE
+            // Resolve every exchange host up front so the first fetch skips DNS
+            if (!dns_warm) {
+                dns_warm = true;
+                int resolved = dns_preresolve_all();
+                DEBUG_PRINTF("[SCHEDULER] Pre-resolved %d exchange hosts\n", resolved);
             }
-            
-            // Fetch funding rates based on configured interval
-            if (now - last_funding_fetch >= config_get_funding_refresh_ms()) {
-                last_funding_fetch = now;
-                DEBUG_PRINTLN("[SCHEDULER] Fetching funding rates...");
-                int success = fetch_all_funding();
-                DEBUG_PRINTF("[SCHEDULER] Funding fetch: %d/%d successful\n",
-                            success, config_get_num_symbols());
+#endif
+#if ENABLE_MARKET_STREAMS
+            // Streams reconnect on their own; polling covers them while down
+            if (!streams_started) {
+                streams_started = true;
+                int feeds = stream_start();
+                DEBUG_PRINTF("[SCHEDULER] Started %d market streams\n", feeds);
             }
+#endif
+            // Drop keep-alive connections the server has likely timed out
+            http_pool_evict_idle(now);
+            http_async_evict_idle();
         } else {
             DEBUG_PRINTLN("[SCHEDULER] Wi-Fi disconnected, skipping fetch");
+            // Pooled sockets do not survive a Wi-Fi drop
+            http_pool_close_all();
+            http_async_close_all();
+            dns_warm = false;
+#if ENABLE_MARKET_STREAMS
+            if (streams_started) {
+                stream_stop();
+                streams_started = false;
+            }
+#endif
         }
         
-        // Stale data detection (Task 8.2)
-        // Check if any ENABLED symbol data is older than STALE_MS threshold
-        AppState snapshot = model_snapshot();
-        const AppConfig& cfg = config_get();
-        bool any_stale = false;
-        uint32_t stale_threshold_ms = config_get_stale_ms();
-        
-        for (int i = 0; i < MAX_SYMBOLS; i++) {
-            // Skip disabled symbols - they won't be updated
-            if (!cfg.symbols[i].enabled) continue;
-            
-            if (snapshot.symbols[i].last_update_ms == 0) {
-                // Never updated - consider stale (but don't log every time)
-                any_stale = true;
-            } else {
-                // Check age, handling millis() rollover correctly
-                unsigned long age_ms = now - snapshot.symbols[i].last_update_ms;
-                // Only log and mark stale if age exceeds threshold
-                if (age_ms > stale_threshold_ms && age_ms < 4000000000UL) {
-                    // Updated but too old (and not wrapped around)
-                    any_stale = true;
-                    DEBUG_PRINTF("[SCHEDULER] %s data is stale (age: %lu ms)\n",
-                                 snapshot.symbols[i].symbol_name, age_ms);
+        // Only the jobs due at this wake-up; a run that overshoots the next
+        // deadline is picked up by the next pass
+        Job job;
+        while (job_queue_pop_due(&net_jobs, now, &job)) {
+            switch (job.type) {
+                case JOB_PRICES:
+                    if (online) {
+                        DEBUG_PRINTLN("[SCHEDULER] Fetching prices...");
+                        int success = fetch_all_prices();
+                        DEBUG_PRINTF("[SCHEDULER] Price fetch: %d/%d successful\n", 
+                                    success, config_get_num_symbols());
+                        
+                        // Mark data as fresh if at least one fetch succeeded
+                        if (success > 0) {
+                            model_set_stale(false);
+                        }
+                    }
+                    break;
+                    
+                case JOB_FUNDING:
+                    // Fetch funding rates for symbols that are due (interval or funding epoch)
+                    if (online) {
+                        int success = fetch_all_funding();
+                        if (success >= 0) {
+                            DEBUG_PRINTF("[SCHEDULER] Funding fetch: %d/%d successful\n",
+                                        success, config_get_num_symbols());
+                        }
+                    }
+                    arm_funding(millis());
+                    break;
+                    
+                case JOB_STALE_CHECK: {
+                    unsigned long checked = millis();
+                    job_queue_schedule(&net_jobs, JOB_STALE_CHECK, JOB_PRIORITY_STALE_CHECK,
+                                       checked + check_stale(checked), 0);
+                    break;
                 }
+                    
+                case JOB_STABILITY_LOG:
+                    log_stability_metrics();
+                    break;
             }
         }
         
-        if (any_stale && !snapshot.data_stale) {
-            DEBUG_PRINTLN("[SCHEDULER] Marking data as STALE");
-            model_set_stale(true);
-        }
-        
-        // Periodic stability logging (Task 11.1)
-        if (now - last_stability_log >= STABILITY_LOG_INTERVAL_MS) {
-            last_stability_log = now;
-            log_stability_metrics();
-        }
-        
 #if ENABLE_POWER_MANAGEMENT
         // Power management: Deep sleep mode support
         PowerMode power_mode = config_get_power_mode();
-        if (power_mode == POWER_DEEP_SLEEP && net_wifi_is_connected()) {
+        if (power_mode == POWER_DEEP_SLEEP && online) {
             // Calculate time until next update needed
-            uint32_t time_until_price = config_get_price_refresh_ms() - (now - last_price_fetch);
-            uint32_t time_until_funding = config_get_funding_refresh_ms() - (now - last_funding_fetch);
+            unsigned long after = millis();
+            uint32_t time_until_price = job_queue_wait_type_ms(&net_jobs, JOB_PRICES, after);
+            uint32_t time_until_funding = job_queue_wait_type_ms(&net_jobs, JOB_FUNDING, after);
             uint32_t sleep_duration = min(time_until_price, time_until_funding);
             
             // Only sleep if there's significant time before next update (> 5 seconds)
-            if (sleep_duration > 5000) {
+            if (sleep_duration > 5000 && sleep_duration != JOB_WAIT_FOREVER) {
                 DEBUG_PRINTF("[SCHEDULER] Deep sleep mode: sleeping for %lu ms\n", sleep_duration);
                 power_deep_sleep(sleep_duration);
                 // Note: Device will restart after deep sleep, so we never reach here
             }
         }
 #endif
-        
-        // Yield to other tasks - check every second
-        vTaskDelay(pdMS_TO_TICKS(1000));
     }
 }
 
+// Core argument of xTaskCreatePinnedToCore() for a *_TASK_CORE setting
+static BaseType_t task_core(int core) {
+    return core < 0 ? tskNO_AFFINITY : (BaseType_t)core;
+}
+
 void scheduler_init() {
     DEBUG_PRINTLN("[SCHEDULER] Initializing task scheduler...");
     
@@ -386,6 +780,33 @@ void scheduler_init() {
     // Initialize alert engine (Task 9.1)
     alerts_init();
     
+    // Initialize HTTP keep-alive connection pool
+    http_init();
+    
+#if ENABLE_HTTP_RECORD
+    // Tee all adapter traffic into a replay file (pull it off SPIFFS and
+    // load it with ReplayTransport on the host)
+    if (SPIFFS.begin(true)) {
+        static RecordingTransport recorder(http_wifi_transport(), HTTP_RECORD_PATH);
+        if (recorder.is_open()) {
+            http_transport_set(&recorder);
+            DEBUG_PRINTF("[SCHEDULER] Recording HTTP exchanges to %s\n", HTTP_RECORD_PATH);
+        }
+    }
+#endif
+    
+    // Resolve exchange endpoints once (requests are pre-rendered per symbol)
+    net_binance::init();
+    net_coinbase::init();
+#if ENABLE_KRAKEN
+    net_kraken::init();
+#endif
+    venues_register();
+#if ENABLE_MARKET_STREAMS
+    // Feeds share the async engine's stream factory (TLS) and clock
+    stream_init(http_async_factory(), http_async_clock());
+#endif
+    
 #if ENABLE_POWER_MANAGEMENT
     // Initialize power management system
     power_init();
@@ -396,15 +817,19 @@ void scheduler_init() {
     DEBUG_PRINTF("[SCHEDULER] Power mode applied: %d\n", saved_mode);
 #endif
     
+    // Settings changes wake net_task to reschedule its jobs
+    config_set_change_listener(notify_config_change);
+    
     // Create network task with reasonable stack size
-    // Priority 1 = lower than default (UI should have priority)
-    BaseType_t result = xTaskCreate(
+    // Pinned away from the UI core by default (NET_TASK_CORE, config.h)
+    BaseType_t result = xTaskCreatePinnedToCore(
         net_task,
         "net_task",
-        12288,  // 12KB stack (TLS/HTTP buffers + multiple symbols)
+        12288,  // 12KB stack (mbedTLS handshake + HTTP buffers; model copies are one SymbolState)
         NULL,
-        1,     // Low priority (UI is higher)
-        &net_task_handle
+        NET_TASK_PRIORITY,
+        &net_task_handle,
+        task_core(NET_TASK_CORE)
     );
     
     if (result != pdPASS) {
@@ -414,14 +839,14 @@ void scheduler_init() {
     }
     
     // Create alert monitoring task (Task 9.1)
-    // Priority 1 = same as net_task
-    result = xTaskCreate(
+    result = xTaskCreatePinnedToCore(
         alert_task,
         "alert_task",
-        6144,  // 6KB stack (increased for MAX_SYMBOLS=10)
+        8192,  // 8KB stack (AppState snapshot is static in alert_task; alert checks + logging)
         NULL,
-        1,     // Low priority
-        &alert_task_handle
+        ALERT_TASK_PRIORITY,
+        &alert_task_handle,
+        task_core(ALERT_TASK_CORE)
     );
     
     if (result != pdPASS) {
@@ -17,9 +17,13 @@
  * 
  * Creates FreeRTOS tasks for:
  * - net_task: Periodic fetch of spot prices and funding rates
+ * - alert_task: Threshold checks on model updates
  * 
  * Tasks run independently from the main LVGL/UI loop to prevent blocking.
  * All network operations happen in net_task with proper delays and backoff.
+ * Core affinity and priorities come from config.h (NET_TASK_CORE, ...).
+ * net_task sleeps until its next job is due (app_jobs.h); config changes
+ * wake it through config_set_change_listener().
  */
 void scheduler_init();
 
@@ -0,0 +1,157 @@
+#include "app_spread_matrix.h"
+#include "app_math.h"
+
+SpreadLeg spread_leg(bool valid, Fixed price, Fixed bid, Fixed ask) {
+    SpreadLeg leg;
+    leg.valid = valid && price > 0;
+    leg.mid = leg.valid ? price : 0;
+    bool book = leg.valid && bid > 0 && ask > 0 && bid <= ask;
+    leg.bid = book ? bid : 0;
+    leg.ask = book ? ask : 0;
+    return leg;
+}
+
+static inline uint16_t cell_bit(int i, int j) {
+    return (uint16_t)(1u << (i * SPREAD_VENUES_MAX + j));
+}
+
+// Mid and executable spread of buying on venue i and selling on venue j
+static void update_cell(SpreadMatrix* m, const SpreadLeg* legs, int i, int j) {
+    uint16_t bit = cell_bit(i, j);
+
+    Fixed mid_abs;
+    float mid_pct;
+    if (legs[i].valid && legs[j].valid && calc_spread(legs[i].mid, legs[j].mid, &mid_abs, &mid_pct)) {
+        m->mid_pct[i][j] = mid_pct;
+        m->mid_valid |= bit;
+    } else {
+        m->mid_pct[i][j] = 0.0f;
+        m->mid_valid &= ~bit;
+    }
+
+    if (legs[i].ask > 0 && legs[j].bid > 0) {
+        m->exec_pct[i][j] = fixed_pct(legs[j].bid - legs[i].ask, legs[i].ask);
+        m->exec_valid |= bit;
+    } else {
+        m->exec_pct[i][j] = 0.0f;
+        m->exec_valid &= ~bit;
+    }
+}
+
+// Widest mid spread: cheapest to dearest venue (one pass over the legs)
+static void update_widest(SpreadMatrix* m, const SpreadLeg* legs, int n) {
+    int low = -1;
+    for (int v = 0; v < n; v++) {
+        if (legs[v].valid && (low < 0 || legs[v].mid < legs[low].mid)) {
+            low = v;
+        }
+    }
+    int high = -1;
+    for (int v = 0; v < n; v++) {
+        if (v != low && legs[v].valid && (high < 0 || legs[v].mid > legs[high].mid)) {
+            high = v;
+        }
+    }
+
+    m->widest_valid = high >= 0 && spread_matrix_mid_valid(*m, low, high);
+    m->widest_low = (int8_t)(m->widest_valid ? low : -1);
+    m->widest_high = (int8_t)(m->widest_valid ? high : -1);
+    m->widest_abs = m->widest_valid ? legs[high].mid - legs[low].mid : 0;
+    m->widest_pct = m->widest_valid ? m->mid_pct[low][high] : 0.0f;
+}
+
+// Best round trip: lowest ask and highest bid on two different venues
+static void update_best(SpreadMatrix* m, const SpreadLeg* legs, int n) {
+    int ask1 = -1, ask2 = -1;       // Lowest and second lowest ask
+    int bid1 = -1, bid2 = -1;       // Highest and second highest bid
+    for (int v = 0; v < n; v++) {
+        if (legs[v].ask <= 0) {
+            continue;
+        }
+        if (ask1 < 0 || legs[v].ask < legs[ask1].ask) {
+            ask2 = ask1;
+            ask1 = v;
+        } else if (ask2 < 0 || legs[v].ask < legs[ask2].ask) {
+            ask2 = v;
+        }
+        if (bid1 < 0 || legs[v].bid > legs[bid1].bid) {
+            bid2 = bid1;
+            bid1 = v;
+        } else if (bid2 < 0 || legs[v].bid > legs[bid2].bid) {
+            bid2 = v;
+        }
+    }
+
+    int buy = -1, sell = -1;
+    if (ask1 >= 0 && bid1 >= 0 && ask1 != bid1) {
+        buy = ask1;
+        sell = bid1;
+    } else if (ask1 >= 0) {
+        // Same venue is cheapest and dearest: the better of the runner-ups (by $)
+        bool has_a = bid2 >= 0;
+        bool has_b = ask2 >= 0;
+        if (has_a && (!has_b || legs[bid2].bid - legs[ask1].ask >= legs[bid1].bid - legs[ask2].ask)) {
+            buy = ask1;
+            sell = bid2;
+        } else if (has_b) {
+            buy = ask2;
+            sell = bid1;
+        }
+    }
+
+    m->best_valid = buy >= 0;
+    m->best_buy = (int8_t)buy;
+    m->best_sell = (int8_t)sell;
+    m->best_abs = m->best_valid ? legs[sell].bid - legs[buy].ask : 0;
+    m->best_pct = m->best_valid ? m->exec_pct[buy][sell] : 0.0f;
+}
+
+int spread_matrix_update(SpreadMatrix* m, const SpreadLeg* legs, int n, int venue) {
+    if (!m || !legs || n > SPREAD_VENUES_MAX || venue < 0 || venue >= n) {
+        return 0;
+    }
+    int cells = 0;
+    for (int v = 0; v < n; v++) {
+        if (v == venue) {
+            continue;
+        }
+        update_cell(m, legs, venue, v);
+        update_cell(m, legs, v, venue);
+        cells += 2;
+    }
+    update_widest(m, legs, n);
+    update_best(m, legs, n);
+    return cells;
+}
+
+void spread_matrix_rebuild(SpreadMatrix* m, const SpreadLeg* legs, int n) {
+    if (!m || !legs || n > SPREAD_VENUES_MAX) {
+        return;
+    }
+    m->mid_valid = 0;
+    m->exec_valid = 0;
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            if (i != j) {
+                update_cell(m, legs, i, j);
+            }
+        }
+    }
+    update_widest(m, legs, n);
+    update_best(m, legs, n);
+}
+
+bool spread_matrix_pair_exec(const SpreadMatrix& m, const SpreadLeg* legs, int a, int b,
+                             int* buy, Fixed* spread_abs, float* spread_pct) {
+    if (!spread_matrix_exec_valid(m, a, b) || !spread_matrix_exec_valid(m, b, a)) {
+        return false;
+    }
+    Fixed buy_a = legs[b].bid - legs[a].ask;
+    Fixed buy_b = legs[a].bid - legs[b].ask;
+    int i = buy_a >= buy_b ? a : b;
+    int j = i == a ? b : a;
+    *buy = i;
+    *spread_abs = i == a ? buy_a : buy_b;
+    *spread_pct = m.exec_pct[i][j];
+    return true;
+}
@@ -0,0 +1,103 @@
+#ifndef APP_SPREAD_MATRIX_H
+#define APP_SPREAD_MATRIX_H
+
+#include <stdint.h>
+#include "app_fixed.h"
+
+/**
+ * @file app_spread_matrix.h
+ * @brief Pairwise cross-venue spreads of one symbol, updated incrementally
+ *
+ * Cell [i][j] holds two spreads between venue i and venue j:
+ * - mid:  mid_j - mid_i relative to the pair's mid (calc_spread(mid_i, mid_j))
+ * - exec: buy at venue i's ask, sell at venue j's bid: (bid_j - ask_i) / ask_i
+ *
+ * When venue v ticks only row v and column v are recomputed (2(N-1)
+ * cells, not N^2). The widest mid spread and the best executable round
+ * trip are found from the venues' prices in O(N), not from the cells:
+ * both grow with the sell price and shrink with the buy price, so the
+ * widest pair is always (cheapest, dearest) venue and the best round trip
+ * is (lowest ask, highest bid) on two different venues.
+ *
+ * Absolute spreads are not stored per cell; they are exact differences
+ * of the legs' fixed-point prices. Arduino-independent, unit tested on
+ * the host (test_spread_matrix).
+ */
+
+// Venues per matrix (QuoteVenue slots of the model)
+#define SPREAD_VENUES_MAX 3
+
+// One venue's quote as seen by the matrix
+struct SpreadLeg {
+    Fixed mid;          // Mid price (or reference price without a book)
+    Fixed bid;          // 0 if the book is unknown
+    Fixed ask;
+    bool valid;
+};
+
+struct SpreadMatrix {
+    float mid_pct[SPREAD_VENUES_MAX][SPREAD_VENUES_MAX];
+    float exec_pct[SPREAD_VENUES_MAX][SPREAD_VENUES_MAX];
+    uint16_t mid_valid;         // Bit i * SPREAD_VENUES_MAX + j
+    uint16_t exec_valid;
+
+    // Widest mid spread: buy on the cheapest venue, sell on the dearest
+    int8_t widest_low;
+    int8_t widest_high;
+    bool widest_valid;
+    float widest_pct;
+    Fixed widest_abs;
+
+    // Best executable round trip (usually negative: the venues' half-spreads)
+    int8_t best_buy;
+    int8_t best_sell;
+    bool best_valid;
+    float best_pct;
+    Fixed best_abs;
+
+    SpreadMatrix() : mid_valid(0), exec_valid(0),
+                     widest_low(-1), widest_high(-1), widest_valid(false),
+                     widest_pct(0.0f), widest_abs(0),
+                     best_buy(-1), best_sell(-1), best_valid(false),
+                     best_pct(0.0f), best_abs(0) {
+        for (int i = 0; i < SPREAD_VENUES_MAX; i++) {
+            for (int j = 0; j < SPREAD_VENUES_MAX; j++) {
+                mid_pct[i][j] = 0.0f;
+                exec_pct[i][j] = 0.0f;
+            }
+        }
+    }
+};
+
+// Leg of a quote: the book counts only if both sides are positive and not crossed
+SpreadLeg spread_leg(bool valid, Fixed price, Fixed bid, Fixed ask);
+
+/**
+ * @brief Recompute row and column of venue after it ticked, then the extremes
+ * @param legs Current legs of all n venues (legs[venue] is the new quote)
+ * @return Cells recomputed (2 * (n - 1)), 0 on invalid arguments
+ */
+int spread_matrix_update(SpreadMatrix* m, const SpreadLeg* legs, int n, int venue);
+
+// Recompute every cell (N^2); reference for the incremental update
+void spread_matrix_rebuild(SpreadMatrix* m, const SpreadLeg* legs, int n);
+
+/**
+ * @brief Better executable direction between venues a and b (by $)
+ * @param buy Output: the venue to buy on (a on a tie), sell on the other
+ * @param spread_abs Output: bid of the sell venue - ask of the buy venue
+ * @param spread_pct Output: exec cell of that direction
+ * @return false (outputs untouched) unless both directions are executable
+ */
+bool spread_matrix_pair_exec(const SpreadMatrix& m, const SpreadLeg* legs, int a, int b,
+                             int* buy, Fixed* spread_abs, float* spread_pct);
+
+inline bool spread_matrix_mid_valid(const SpreadMatrix& m, int i, int j) {
+    return (m.mid_valid >> (i * SPREAD_VENUES_MAX + j)) & 1;
+}
+
+inline bool spread_matrix_exec_valid(const SpreadMatrix& m, int i, int j) {
+    return (m.exec_valid >> (i * SPREAD_VENUES_MAX + j)) & 1;
+}
+
+#endif // APP_SPREAD_MATRIX_H
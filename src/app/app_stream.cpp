@@ -0,0 +1,353 @@
+#include "app_stream.h"
+#include "app_config.h"
+#include "app_model.h"
+#include "../config.h"
+#include "../net/net_binance.h"
+#include "../net/net_coinbase.h"
+#include "../net/net_dns.h"
+#include <string.h>
+
+// One WebSocket connection and the symbols it carries
+struct Feed {
+    StreamFeed id;
+    const char* name;
+    const char* default_url;
+    const char* url;
+    WsClient client;
+    bool enabled;                           // Started by stream_start()
+    bool started;
+    int num;                                // Symbols streamed
+    const char* symbols[MAX_SYMBOLS];       // Exchange symbol per stream slot
+    int index[MAX_SYMBOLS];                 // Config index per stream slot
+    uint32_t updated_ms[MAX_SYMBOLS];       // Last applied update per config index (0 = none)
+    int64_t sequence[MAX_SYMBOLS];          // Last applied sequence per config index (-1 = none)
+    uint32_t sequence_opens;                // Connection the sequences belong to (ws stats.opens)
+
+    // Gap and rate accounting
+    uint32_t gaps;
+    uint32_t missed;
+    uint32_t out_of_order;
+    uint32_t rate_start_ms;
+    uint32_t rate_messages;                 // ws stats.messages at rate_start_ms
+    float rate;
+};
+
+static Feed g_feeds[STREAM_FEED_COUNT];
+static AsyncClockFn g_clock = nullptr;
+static uint16_t g_enabled_mask = 0;         // Enabled symbols the feeds were started with
+
+// Bit per enabled symbol in the current config
+static uint16_t enabled_mask() {
+    const AppConfig& cfg = config_get();
+    uint16_t mask = 0;
+    for (int i = 0; i < cfg.num_symbols && i < MAX_SYMBOLS; i++) {
+        if (cfg.symbols[i].enabled) {
+            mask |= (uint16_t)(1u << i);
+        }
+    }
+    return mask;
+}
+
+static void reset_sequences(Feed* feed) {
+    for (int i = 0; i < MAX_SYMBOLS; i++) {
+        feed->sequence[i] = -1;
+    }
+}
+
+/**
+ * @brief Check a per-product sequence number before applying its message
+ * A reconnect starts over (messages missed while down are not a feed gap).
+ * @return false if the message is older than the last applied one
+ */
+static bool accept_sequence(Feed* feed, const WsClient* client, int idx, int64_t seq) {
+    if (feed->sequence_opens != client->stats.opens) {
+        feed->sequence_opens = client->stats.opens;
+        reset_sequences(feed);
+    }
+    if (seq < 0) {
+        return true;  // Not numbered
+    }
+    int64_t last = feed->sequence[idx];
+    if (last >= 0) {
+        if (seq <= last) {
+            feed->out_of_order++;
+            return false;
+        }
+        if (seq > last + 1) {
+            feed->gaps++;
+            feed->missed += (uint32_t)(seq - last - 1);
+            DEBUG_PRINTF("[STREAM] %s: gap of %ld messages on symbol %d\n", feed->name,
+                         (long)(seq - last - 1), idx);
+        }
+    }
+    feed->sequence[idx] = seq;
+    return true;
+}
+
+// Apply one message to the model; unknown messages (subscription replies) are ignored
+static void on_feed_message(WsClient* client, char* data, size_t len, void* ctx) {
+    Feed* feed = static_cast<Feed*>(ctx);
+    uint32_t now = g_clock();
+
+    switch (feed->id) {
+        case STREAM_BINANCE_BOOK: {
+            net_binance::BookTicker book;
+            int k = net_binance::parse_book_stream(data, len, feed->symbols, feed->num, &book);
+            if (k >= 0) {
+                int idx = feed->index[k];
+                model_apply_quote(idx, VENUE_BINANCE, book.bid, book.ask, now);
+                feed->updated_ms[idx] = now ? now : 1;
+            }
+            break;
+        }
+        case STREAM_BINANCE_MARK: {
+            net_binance::PremiumIndex mark;
+            int k = net_binance::parse_mark_stream(data, len, feed->symbols, feed->num, &mark);
+            if (k >= 0) {
+                int idx = feed->index[k];
+                model_apply_funding(idx, mark.funding_rate, mark.mark_price, mark.index_price,
+                                    mark.next_funding_ms, now);
+                feed->updated_ms[idx] = now ? now : 1;
+            }
+            break;
+        }
+        case STREAM_COINBASE_TICKER: {
+            net_coinbase::Ticker ticker;
+            int64_t seq = -1;
+            int k = net_coinbase::parse_ticker_stream(data, len, feed->symbols, feed->num, &ticker, &seq);
+            if (k >= 0) {
+                int idx = feed->index[k];
+                if (!accept_sequence(feed, client, idx, seq)) {
+                    break;
+                }
+                model_apply_quote(idx, VENUE_COINBASE, ticker.bid, ticker.ask, now);
+                feed->updated_ms[idx] = now ? now : 1;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void stream_init(AsyncStreamFactory factory, AsyncClockFn clock) {
+    g_clock = clock;
+    g_enabled_mask = 0;
+
+    g_feeds[STREAM_BINANCE_BOOK].name = "binance book";
+    g_feeds[STREAM_BINANCE_BOOK].default_url = net_binance::BOOK_STREAM_URL;
+    g_feeds[STREAM_COINBASE_TICKER].name = "coinbase ticker";
+    g_feeds[STREAM_COINBASE_TICKER].default_url = net_coinbase::TICKER_STREAM_URL;
+    g_feeds[STREAM_BINANCE_MARK].name = "binance mark";
+    g_feeds[STREAM_BINANCE_MARK].default_url = net_binance::MARK_STREAM_URL;
+
+    for (int f = 0; f < STREAM_FEED_COUNT; f++) {
+        Feed* feed = &g_feeds[f];
+        feed->id = (StreamFeed)f;
+        feed->url = feed->default_url;
+        feed->enabled = (feed->id != STREAM_BINANCE_MARK) || ENABLE_FUNDING_STREAM;
+        feed->started = false;
+        feed->num = 0;
+        memset(feed->updated_ms, 0, sizeof(feed->updated_ms));
+        reset_sequences(feed);
+        feed->sequence_opens = 0;
+        feed->gaps = 0;
+        feed->missed = 0;
+        feed->out_of_order = 0;
+        feed->rate_start_ms = clock();
+        feed->rate_messages = 0;
+        feed->rate = 0.0f;
+        ws_init(&feed->client, factory, clock, on_feed_message, feed);
+
+        // Resolve the stream host together with the REST hosts
+        HttpEndpoint ep;
+        if (feed->enabled && http_endpoint_init(&ep, feed->default_url, "/")) {
+            dns_register(ep.host);
+        }
+    }
+}
+
+void stream_set_enabled(StreamFeed feed, bool enabled) {
+    if (feed < 0 || feed >= STREAM_FEED_COUNT) {
+        return;
+    }
+    g_feeds[feed].enabled = enabled;
+}
+
+void stream_set_url(StreamFeed feed, const char* base_url) {
+    if (feed < 0 || feed >= STREAM_FEED_COUNT) {
+        return;
+    }
+    g_feeds[feed].url = base_url ? base_url : g_feeds[feed].default_url;
+}
+
+// Path (and subscribe message) for the feed's symbols
+static bool feed_open(Feed* feed) {
+    char path[WS_PATH_MAX];
+    switch (feed->id) {
+        case STREAM_BINANCE_BOOK:
+            if (!net_binance::book_stream_path(feed->symbols, feed->num, path, sizeof(path))) {
+                return false;
+            }
+            return ws_open(&feed->client, feed->url, path, nullptr);
+        case STREAM_BINANCE_MARK:
+            if (!net_binance::mark_stream_path(feed->symbols, feed->num, path, sizeof(path))) {
+                return false;
+            }
+            return ws_open(&feed->client, feed->url, path, nullptr);
+        case STREAM_COINBASE_TICKER: {
+            // One socket at the root; products are chosen by the subscribe message
+            char subscribe[WS_SUBSCRIBE_MAX];
+            if (!net_coinbase::ticker_subscribe_message(feed->symbols, feed->num,
+                                                        subscribe, sizeof(subscribe))) {
+                return false;
+            }
+            return ws_open(&feed->client, feed->url, "/", subscribe);
+        }
+        default:
+            return false;
+    }
+}
+
+int stream_start() {
+    if (!g_clock) {
+        return 0;
+    }
+    stream_stop();
+
+    const AppConfig& cfg = config_get();
+    g_enabled_mask = enabled_mask();
+
+    int started = 0;
+    for (int f = 0; f < STREAM_FEED_COUNT; f++) {
+        Feed* feed = &g_feeds[f];
+        feed->num = 0;
+        if (!feed->enabled) {
+            continue;
+        }
+        for (int i = 0; i < cfg.num_symbols && i < MAX_SYMBOLS; i++) {
+            if (!cfg.symbols[i].enabled) {
+                continue;
+            }
+            feed->symbols[feed->num] = (feed->id == STREAM_COINBASE_TICKER)
+                                           ? cfg.symbols[i].coinbase_product
+                                           : cfg.symbols[i].binance_symbol;
+            feed->index[feed->num] = i;
+            feed->num++;
+        }
+        if (feed->num == 0) {
+            continue;
+        }
+        if (!feed_open(feed)) {
+            DEBUG_PRINTF("[STREAM] Cannot open %s feed for %d symbols\n", feed->name, feed->num);
+            continue;
+        }
+        feed->started = true;
+        feed->rate_start_ms = g_clock();
+        feed->rate_messages = feed->client.stats.messages;
+        started++;
+        DEBUG_PRINTF("[STREAM] %s feed: %d symbols via %s\n", feed->name, feed->num, feed->url);
+    }
+    return started;
+}
+
+void stream_stop() {
+    for (int f = 0; f < STREAM_FEED_COUNT; f++) {
+        Feed* feed = &g_feeds[f];
+        if (feed->started) {
+            ws_close(&feed->client);
+            feed->started = false;
+        }
+        memset(feed->updated_ms, 0, sizeof(feed->updated_ms));
+        reset_sequences(feed);
+    }
+}
+
+// Close the rate window once it is STREAM_RATE_WINDOW_MS long
+static void update_rate(Feed* feed, uint32_t now) {
+    uint32_t elapsed = now - feed->rate_start_ms;
+    if (elapsed < STREAM_RATE_WINDOW_MS) {
+        return;
+    }
+    uint32_t messages = feed->client.stats.messages;
+    feed->rate = (float)(messages - feed->rate_messages) * 1000.0f / (float)elapsed;
+    feed->rate_messages = messages;
+    feed->rate_start_ms = now;
+}
+
+int stream_poll(uint32_t max_wait_ms) {
+    WsClient* clients[STREAM_FEED_COUNT];
+    int n = 0;
+    bool any_started = false;
+    for (int f = 0; f < STREAM_FEED_COUNT; f++) {
+        any_started = any_started || g_feeds[f].started;
+    }
+
+    // Symbols enabled or disabled from the settings: resubscribe
+    if (any_started && enabled_mask() != g_enabled_mask) {
+        DEBUG_PRINTLN("[STREAM] Symbol list changed, restarting feeds");
+        stream_start();
+    }
+
+    for (int f = 0; f < STREAM_FEED_COUNT; f++) {
+        if (g_feeds[f].started) {
+            clients[n++] = &g_feeds[f].client;
+        }
+    }
+    if (n == 0) {
+        return 0;
+    }
+    int delivered = ws_poll(clients, n, max_wait_ms);
+
+    uint32_t now = g_clock();
+    for (int f = 0; f < STREAM_FEED_COUNT; f++) {
+        update_rate(&g_feeds[f], now);
+    }
+    return delivered;
+}
+
+bool stream_is_live(StreamFeed feed, int idx, uint32_t now_ms) {
+    if (feed < 0 || feed >= STREAM_FEED_COUNT || idx < 0 || idx >= MAX_SYMBOLS) {
+        return false;
+    }
+    const Feed* f = &g_feeds[feed];
+    if (!f->started || !ws_is_open(&f->client) || f->updated_ms[idx] == 0) {
+        return false;
+    }
+    return now_ms - f->updated_ms[idx] <= STREAM_QUOTE_MAX_AGE_MS;
+}
+
+StreamStats stream_get_stats(StreamFeed feed) {
+    StreamStats stats;
+    memset(&stats, 0, sizeof(stats));
+    if (feed < 0 || feed >= STREAM_FEED_COUNT) {
+        return stats;
+    }
+    const Feed* f = &g_feeds[feed];
+    stats.ws = f->client.stats;
+    stats.gaps = f->gaps;
+    stats.missed = f->missed;
+    stats.out_of_order = f->out_of_order;
+    stats.rate = f->rate;
+    return stats;
+}
+
+void stream_log_stats() {
+    for (int f = 0; f < STREAM_FEED_COUNT; f++) {
+        const Feed* feed = &g_feeds[f];
+        if (!feed->started) {
+            continue;
+        }
+        DEBUG_PRINTF("[STABILITY] Stream %s: %s, %lu messages (%.1f/s), %lu opens, %lu failures, %lu disconnects, %lu dropped\n",
+                     feed->name, ws_state_name(feed->client.state),
+                     (unsigned long)feed->client.stats.messages, feed->rate,
+                     (unsigned long)feed->client.stats.opens,
+                     (unsigned long)feed->client.stats.failures, (unsigned long)feed->client.stats.disconnects,
+                     (unsigned long)feed->client.stats.dropped);
+        if (feed->gaps || feed->out_of_order) {
+            DEBUG_PRINTF("[STABILITY] Stream %s: %lu gaps (%lu messages missed), %lu out of order\n",
+                         feed->name, (unsigned long)feed->gaps, (unsigned long)feed->missed,
+                         (unsigned long)feed->out_of_order);
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef APP_STREAM_H
+#define APP_STREAM_H
+
+#include <stdint.h>
+#include "../net/net_ws.h"
+
+/**
+ * @file app_stream.h
+ * @brief Streamed market data pushed straight into the model
+ *
+ * Each feed is one WebSocket connection covering every enabled symbol.
+ * Messages are parsed as they arrive and applied with model_apply_quote(),
+ * so quotes are as fresh as the exchange publishes them instead of
+ * sampled every price_refresh_ms. Feeds that number their messages
+ * (Coinbase) are checked for gaps, and every feed reports its message rate.
+ *
+ * REST polling stays in place as the fallback: the scheduler skips a
+ * symbol's request only while stream_is_live() reports a recent update
+ * for it, so a dropped or silent stream is covered on the next cycle.
+ *
+ * Arduino-independent (the stream factory and clock are injected) and
+ * tested on the host against a local WebSocket stand-in.
+ * Not thread-safe: all calls are expected from net_task.
+ */
+
+// A streamed quote older than this no longer replaces the REST request
+#define STREAM_QUOTE_MAX_AGE_MS 5000
+
+// Message rate is averaged over windows of this length
+#define STREAM_RATE_WINDOW_MS 10000
+
+enum StreamFeed {
+    STREAM_BINANCE_BOOK = 0,    // Spot <symbol>@bookTicker (best bid/ask)
+    STREAM_COINBASE_TICKER,     // Exchange ticker channel (best bid/ask on every trade)
+    STREAM_BINANCE_MARK,        // Futures <symbol>@markPrice@1s (predicted funding, mark, index)
+    STREAM_FEED_COUNT
+};
+
+// Feed counters (monotonic since stream_init, except the rate)
+struct StreamStats {
+    WsStats ws;                 // Connection and message counters
+    uint32_t gaps;              // Sequence gaps (feeds with per-product sequence numbers)
+    uint32_t missed;            // Messages skipped across those gaps
+    uint32_t out_of_order;      // Messages older than the last applied one (dropped)
+    float rate;                 // Messages per second over the last complete window
+};
+
+/**
+ * @brief Initialize all feeds (closed)
+ * @param factory Stream factory shared with the async HTTP engine
+ * @param clock Millisecond clock (same base as millis() on the device)
+ */
+void stream_init(AsyncStreamFactory factory, AsyncClockFn clock);
+
+// Enable or disable a feed from the next stream_start()
+// All feeds are enabled by stream_init() except STREAM_BINANCE_MARK (ENABLE_FUNDING_STREAM)
+void stream_set_enabled(StreamFeed feed, bool enabled);
+
+// Override a feed's base URL, e.g. a local stand-in in tests (nullptr = exchange default)
+void stream_set_url(StreamFeed feed, const char* base_url);
+
+/**
+ * @brief Connect every feed for the currently enabled symbols
+ * Feeds reconnect on their own after failures until stream_stop().
+ * @return Number of feeds started
+ */
+int stream_start();
+
+// Close every feed and forget streamed timestamps
+void stream_stop();
+
+/**
+ * @brief Receive and apply messages for up to max_wait_ms
+ * Restarts the feeds first if the enabled symbol list changed.
+ * Returns early when no feed has a socket (the caller sleeps instead).
+ * @return Number of messages received
+ */
+int stream_poll(uint32_t max_wait_ms);
+
+// True if the feed is open and updated symbol idx within STREAM_QUOTE_MAX_AGE_MS
+bool stream_is_live(StreamFeed feed, int idx, uint32_t now_ms);
+
+// Counters of a feed
+StreamStats stream_get_stats(StreamFeed feed);
+
+// Print one line per feed (stability log)
+void stream_log_stats();
+
+#endif // APP_STREAM_H
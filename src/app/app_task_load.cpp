@@ -0,0 +1,92 @@
+#include "app_task_load.h"
+#include <string.h>
+
+void task_load_reset(TaskLoadTracker* t) {
+    t->num = 0;
+    t->total = 0;
+    t->primed = false;
+    t->dropped = 0;
+}
+
+static int find_index(const TaskLoadTracker* t, const char* name) {
+    for (int k = 0; k < t->num; k++) {
+        if (strncmp(t->tasks[k].name, name, TASK_LOAD_NAME_MAX - 1) == 0) {
+            return k;
+        }
+    }
+    return -1;
+}
+
+int task_load_update(TaskLoadTracker* t, const TaskLoadSample* samples, int n, uint32_t total) {
+    if (!t || (!samples && n > 0)) {
+        return 0;
+    }
+    // Wrap-safe: unsigned differences of the 32-bit counters
+    uint32_t elapsed = total - t->total;
+    bool window = t->primed && elapsed > 0;
+
+    bool seen[TASK_LOAD_MAX] = {};
+    for (int s = 0; s < n; s++) {
+        const TaskLoadSample& sample = samples[s];
+        if (!sample.name) {
+            continue;
+        }
+        int k = find_index(t, sample.name);
+        if (k >= 0 && seen[k]) {
+            continue;   // Duplicate name: keep the first
+        }
+        if (k < 0) {
+            if (t->num == TASK_LOAD_MAX) {
+                t->dropped++;
+                continue;
+            }
+            k = t->num++;
+            TaskLoad& added = t->tasks[k];
+            strncpy(added.name, sample.name, TASK_LOAD_NAME_MAX - 1);
+            added.name[TASK_LOAD_NAME_MAX - 1] = '\0';
+            added.measured = false;
+            added.cpu_pct = 0.0f;
+        } else if (window) {
+            // A task runs on one core at a time: more than the window means
+            // it was deleted and recreated under the same name
+            TaskLoad& task = t->tasks[k];
+            uint32_t ran = sample.run_time - task.run_time;
+            task.measured = ran <= elapsed;
+            task.cpu_pct = task.measured ? (float)ran * 100.0f / (float)elapsed : 0.0f;
+        }
+        TaskLoad& task = t->tasks[k];
+        task.run_time = sample.run_time;
+        task.core = sample.core;
+        task.priority = sample.priority;
+        task.stack_free = sample.stack_free;
+        seen[k] = true;
+    }
+
+    // Drop deleted tasks (order of the others is kept)
+    int kept = 0;
+    int measured = 0;
+    for (int k = 0; k < t->num; k++) {
+        if (!seen[k]) {
+            continue;
+        }
+        if (kept != k) {
+            t->tasks[kept] = t->tasks[k];
+        }
+        if (t->tasks[kept].measured) {
+            measured++;
+        }
+        kept++;
+    }
+    t->num = kept;
+    t->total = total;
+    t->primed = true;
+    return measured;
+}
+
+const TaskLoad* task_load_find(const TaskLoadTracker* t, const char* name) {
+    if (!t || !name) {
+        return nullptr;
+    }
+    int k = find_index(t, name);
+    return k >= 0 ? &t->tasks[k] : nullptr;
+}
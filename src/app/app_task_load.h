@@ -0,0 +1,71 @@
+#ifndef APP_TASK_LOAD_H
+#define APP_TASK_LOAD_H
+
+#include <stdint.h>
+
+/**
+ * @file app_task_load.h
+ * @brief Per-task CPU load from FreeRTOS run-time counters
+ *
+ * FreeRTOS keeps a run-time counter per task (configGENERATE_RUN_TIME_STATS,
+ * microseconds on the ESP32) and a total per core. Load is the share of the
+ * total a task ran since the previous sample, so two samples are needed
+ * before a task reports anything. Tasks are matched by name between
+ * samples: new tasks start unmeasured, deleted tasks are dropped.
+ *
+ * The counters are 32-bit and wrap (every ~71 min at 1 MHz); differences
+ * stay correct as long as samples are taken more often than that.
+ *
+ * Arduino-independent: the scheduler fills TaskLoadSample from
+ * uxTaskGetSystemState(); unit tested on the host (test_task_load).
+ */
+
+// Tasks tracked (the ESP32 Arduino build runs about a dozen)
+#define TASK_LOAD_MAX 20
+
+// Task name length kept, including the terminator (configMAX_TASK_NAME_LEN)
+#define TASK_LOAD_NAME_MAX 16
+
+// Core of a task without affinity (tskNO_AFFINITY)
+#define TASK_LOAD_ANY_CORE (-1)
+
+// One task as read from the kernel
+struct TaskLoadSample {
+    const char* name;
+    uint32_t run_time;          // Run-time counter (total since boot)
+    int8_t core;                // Pinned core, TASK_LOAD_ANY_CORE if none
+    uint8_t priority;
+    uint32_t stack_free;        // Stack high-water mark, bytes never used
+};
+
+struct TaskLoad {
+    char name[TASK_LOAD_NAME_MAX];
+    int8_t core;
+    uint8_t priority;
+    uint32_t stack_free;
+    uint32_t run_time;          // Counter at the last sample
+    float cpu_pct;              // Share of one core since the previous sample
+    bool measured;              // cpu_pct is valid (seen in two samples)
+};
+
+struct TaskLoadTracker {
+    TaskLoad tasks[TASK_LOAD_MAX];
+    int num;
+    uint32_t total;             // Total run time at the last sample
+    bool primed;                // At least one sample taken
+    uint32_t dropped;           // Tasks not tracked (table full)
+};
+
+void task_load_reset(TaskLoadTracker* t);
+
+/**
+ * @brief Take a sample of every task's run-time counter
+ * @param total Total run time (same clock as the task counters)
+ * @return Tasks with a valid cpu_pct after this sample
+ */
+int task_load_update(TaskLoadTracker* t, const TaskLoadSample* samples, int n, uint32_t total);
+
+// Tracked task by name, nullptr if unknown
+const TaskLoad* task_load_find(const TaskLoadTracker* t, const char* name);
+
+#endif // APP_TASK_LOAD_H
@@ -0,0 +1,440 @@
+#include "app_venues.h"
+#include "../config.h"
+#include "app_exchange.h"
+#if ENABLE_MARKET_STREAMS
+#include "app_stream.h"
+#endif
+#include "../net/net_async.h"
+#include "../net/net_binance.h"
+#include "../net/net_coinbase.h"
+#if ENABLE_KRAKEN
+#include "../net/net_kraken.h"
+#endif
+
+#define VENUES_ASYNC (ENABLE_ASYNC_HTTP && !ENABLE_HTTP_RECORD)
+
+static void set_book(ExchangeQuote* out, bool valid, Fixed bid, Fixed ask) {
+    out->valid = valid;
+    if (valid) {
+        out->bid = bid;
+        out->ask = ask;
+        out->price = fixed_mid(bid, ask);
+    }
+}
+
+static int count_valid(const ExchangeQuote* quotes, int n) {
+    int valid = 0;
+    for (int k = 0; k < n; k++) {
+        if (quotes[k].valid) {
+            valid++;
+        }
+    }
+    return valid;
+}
+
+#if VENUES_ASYNC
+// One in-flight quote request; the body lands in a fixed buffer
+template <size_t BODY_MAX>
+struct QuoteFetch {
+    HttpAsyncJob job;
+    HttpBufferSink sink;
+    char body[BODY_MAX];
+};
+
+template <size_t BODY_MAX>
+static void submit_quote(QuoteFetch<BODY_MAX>& fetch, const HttpRequest* req) {
+    fetch.job.status = HTTP_ASYNC_IDLE;
+    fetch.sink = HttpBufferSink(fetch.body, sizeof(fetch.body));
+    if (req) {
+        http_async_submit(&fetch.job, req, VENUE_REQUEST_TIMEOUT_MS,
+                          http_buffer_sink, &fetch.sink, nullptr, nullptr);
+    }
+}
+
+template <size_t BODY_MAX>
+static bool quote_ok(QuoteFetch<BODY_MAX>& fetch) {
+    if (fetch.job.status != HTTP_ASYNC_OK) {
+        if (fetch.job.status != HTTP_ASYNC_IDLE) {
+            DEBUG_PRINTF("[VENUES] %s: %s (HTTP %d, %lu ms)\n",
+                         fetch.job.request->endpoint->host,
+                         http_async_status_name(fetch.job.status),
+                         fetch.job.status_code, fetch.job.elapsed_ms);
+        }
+        return false;
+    }
+    return true;
+}
+#endif
+
+// ============================================================================
+// Binance spot
+// ============================================================================
+
+class BinanceAdapter : public ExchangeAdapter {
+public:
+    const char* name() const { return "binance"; }
+    QuoteVenue venue() const { return VENUE_BINANCE; }
+
+    uint8_t capabilities() const {
+        uint8_t caps = EXCHANGE_CAP_BATCH_QUOTES | EXCHANGE_CAP_BOOK | EXCHANGE_CAP_FUNDING;
+#if ENABLE_MARKET_STREAMS
+        caps |= EXCHANGE_CAP_STREAM;
+#endif
+        return caps;
+    }
+
+    const char* market(const SymbolConfig& sym) const { return sym.binance_symbol; }
+
+#if ENABLE_MARKET_STREAMS
+    // Polling takes over once the stream has been quiet for STREAM_QUOTE_MAX_AGE_MS
+    bool streamed(int idx, uint32_t now_ms) const { return stream_is_live(STREAM_BINANCE_BOOK, idx, now_ms); }
+#endif
+
+    int begin_quotes(const char* const* markets, int n, bool batched, ExchangeQuote* out);
+    int end_quotes();
+
+private:
+    const char* const* _markets;
+    int _num;
+    ExchangeQuote* _out;
+#if VENUES_ASYNC
+    const net_binance::SpotBatch* _batches;
+    int _num_batches;
+#endif
+};
+
+#if VENUES_ASYNC
+static QuoteFetch<net_binance::BOOK_BODY_MAX> binance_fetch[MAX_SYMBOLS];
+static QuoteFetch<net_binance::BOOK_BATCH_BODY_MAX> binance_batch_fetch[net_binance::SPOT_BATCH_MAX_REQUESTS];
+
+int BinanceAdapter::begin_quotes(const char* const* markets, int n, bool batched, ExchangeQuote* out) {
+    _markets = markets;
+    _num = n;
+    _out = out;
+
+    // One batched request for all polled symbols (split only if the URL gets too long)
+    _num_batches = batched ? net_binance::book_batch_requests(markets, n, &_batches) : 0;
+    if (_num_batches > 0) {
+        for (int b = 0; b < _num_batches; b++) {
+            submit_quote(binance_batch_fetch[b], &_batches[b].request);
+        }
+        return _num_batches;
+    }
+    for (int k = 0; k < n; k++) {
+        submit_quote(binance_fetch[k], net_binance::book_request(markets[k]));
+    }
+    return n;
+}
+
+int BinanceAdapter::end_quotes() {
+    // Scatter books to the polled symbols
+    net_binance::BookTicker books[MAX_SYMBOLS] = {};
+    if (_num_batches > 0) {
+        for (int b = 0; b < _num_batches; b++) {
+            QuoteFetch<net_binance::BOOK_BATCH_BODY_MAX>& fetch = binance_batch_fetch[b];
+            const net_binance::SpotBatch& batch = _batches[b];
+            if (quote_ok(fetch)) {
+                net_binance::parse_book_batch(fetch.body, fetch.sink.len,
+                                              _markets + batch.first, batch.count,
+                                              books + batch.first);
+            }
+        }
+    } else {
+        for (int k = 0; k < _num; k++) {
+            QuoteFetch<net_binance::BOOK_BODY_MAX>& fetch = binance_fetch[k];
+            if (quote_ok(fetch)) {
+                net_binance::parse_book(fetch.body, fetch.sink.len, _markets[k], &books[k]);
+            }
+        }
+    }
+    for (int k = 0; k < _num; k++) {
+        set_book(&_out[k], books[k].valid, books[k].bid, books[k].ask);
+    }
+    return count_valid(_out, _num);
+}
+#else
+int BinanceAdapter::begin_quotes(const char* const* markets, int n, bool batched, ExchangeQuote* out) {
+    _markets = markets;
+    _num = n;
+    _out = out;
+
+    net_binance::BookTicker books[MAX_SYMBOLS] = {};
+    int requests = n;
+    if (batched) {
+        net_binance::fetch_book_batch(markets, n, books);
+        requests = 1;
+    } else {
+        for (int k = 0; k < n; k++) {
+            net_binance::fetch_book(markets[k], &books[k]);
+        }
+    }
+    for (int k = 0; k < n; k++) {
+        set_book(&out[k], books[k].valid, books[k].bid, books[k].ask);
+    }
+    return requests;
+}
+
+int BinanceAdapter::end_quotes() {
+    return count_valid(_out, _num);
+}
+#endif
+
+// ============================================================================
+// Coinbase
+// ============================================================================
+
+class CoinbaseAdapter : public ExchangeAdapter {
+public:
+    const char* name() const { return "coinbase"; }
+    QuoteVenue venue() const { return VENUE_COINBASE; }
+
+    uint8_t capabilities() const {
+        uint8_t caps = EXCHANGE_CAP_BOOK;
+#if ENABLE_MARKET_STREAMS
+        caps |= EXCHANGE_CAP_STREAM;
+#endif
+#if ENABLE_COINBASE_RATES
+        caps |= EXCHANGE_CAP_BATCH_QUOTES;      // Exchange rates: mid price only
+#endif
+        return caps;
+    }
+
+    const char* market(const SymbolConfig& sym) const { return sym.coinbase_product; }
+
+#if ENABLE_MARKET_STREAMS
+    // Polling takes over once the stream has been quiet for STREAM_QUOTE_MAX_AGE_MS
+    bool streamed(int idx, uint32_t now_ms) const { return stream_is_live(STREAM_COINBASE_TICKER, idx, now_ms); }
+#endif
+
+    int begin_quotes(const char* const* markets, int n, bool batched, ExchangeQuote* out);
+    int end_quotes();
+
+private:
+    const char* const* _markets;
+    int _num;
+    ExchangeQuote* _out;
+    bool _rates;                // Prices from one exchange-rates request
+};
+
+static void set_ticker(ExchangeQuote* out, const net_coinbase::Ticker& ticker) {
+    out->price = ticker.price;
+    out->bid = ticker.bid;
+    out->ask = ticker.ask;
+    out->valid = ticker.valid;
+}
+
+#if VENUES_ASYNC
+static QuoteFetch<net_coinbase::TICKER_BODY_MAX> coinbase_fetch[MAX_SYMBOLS];
+#if ENABLE_COINBASE_RATES
+static HttpAsyncJob coinbase_rates_job;
+static net_coinbase::SpotRatesScan coinbase_rates_scan;
+static Fixed coinbase_rate_prices[MAX_SYMBOLS];
+static bool coinbase_rate_ok[MAX_SYMBOLS];
+#endif
+
+int CoinbaseAdapter::begin_quotes(const char* const* markets, int n, bool batched, ExchangeQuote* out) {
+    _markets = markets;
+    _num = n;
+    _out = out;
+    _rates = false;
+
+    // One exchange-rates request filtered while streaming, else one ticker each
+#if ENABLE_COINBASE_RATES
+    if (batched &&
+        net_coinbase::spot_rates_begin(&coinbase_rates_scan, markets, n,
+                                       coinbase_rate_prices, coinbase_rate_ok)) {
+        const HttpRequest* req = net_coinbase::spot_rates_request(coinbase_rates_scan.currency);
+        coinbase_rates_job.status = HTTP_ASYNC_IDLE;
+        _rates = req && http_async_submit(&coinbase_rates_job, req, VENUE_REQUEST_TIMEOUT_MS,
+                                          net_coinbase::spot_rates_chunk, &coinbase_rates_scan,
+                                          nullptr, nullptr);
+    }
+#else
+    (void)batched;
+#endif
+    if (_rates) {
+        return 1;
+    }
+    for (int k = 0; k < n; k++) {
+        submit_quote(coinbase_fetch[k], net_coinbase::ticker_request(markets[k]));
+    }
+    return n;
+}
+
+int CoinbaseAdapter::end_quotes() {
+#if ENABLE_COINBASE_RATES
+    if (_rates) {
+        if (coinbase_rates_job.status == HTTP_ASYNC_OK &&
+            net_coinbase::spot_rates_finish(&coinbase_rates_scan) > 0) {
+            for (int k = 0; k < _num; k++) {
+                _out[k].price = coinbase_rate_prices[k];
+                _out[k].valid = coinbase_rate_ok[k];
+            }
+        } else {
+            DEBUG_PRINTF("[VENUES] Coinbase exchange rates: %s (HTTP %d, %lu ms)\n",
+                         http_async_status_name(coinbase_rates_job.status),
+                         coinbase_rates_job.status_code, coinbase_rates_job.elapsed_ms);
+        }
+        return count_valid(_out, _num);
+    }
+#endif
+    for (int k = 0; k < _num; k++) {
+        QuoteFetch<net_coinbase::TICKER_BODY_MAX>& fetch = coinbase_fetch[k];
+        net_coinbase::Ticker ticker = {};
+        if (quote_ok(fetch)) {
+            net_coinbase::parse_ticker(fetch.body, fetch.sink.len, _markets[k], &ticker);
+        }
+        set_ticker(&_out[k], ticker);
+    }
+    return count_valid(_out, _num);
+}
+#else
+int CoinbaseAdapter::begin_quotes(const char* const* markets, int n, bool batched, ExchangeQuote* out) {
+    _markets = markets;
+    _num = n;
+    _out = out;
+    _rates = false;
+
+    // One exchange-rates request for all polled symbols, else one ticker each
+#if ENABLE_COINBASE_RATES
+    if (batched) {
+        Fixed prices[MAX_SYMBOLS];
+        bool ok[MAX_SYMBOLS];
+        _rates = net_coinbase::fetch_spot_batch(markets, n, prices, ok) > 0;
+        for (int k = 0; _rates && k < n; k++) {
+            out[k].price = prices[k];
+            out[k].valid = ok[k];
+        }
+    }
+#else
+    (void)batched;
+#endif
+    if (_rates) {
+        return 1;
+    }
+    for (int k = 0; k < n; k++) {
+        net_coinbase::Ticker ticker = {};
+        net_coinbase::fetch_ticker(markets[k], &ticker);
+        set_ticker(&out[k], ticker);
+    }
+    return n;
+}
+
+int CoinbaseAdapter::end_quotes() {
+    return count_valid(_out, _num);
+}
+#endif
+
+#if ENABLE_KRAKEN
+// ============================================================================
+// Kraken
+// ============================================================================
+
+class KrakenAdapter : public ExchangeAdapter {
+public:
+    const char* name() const { return "kraken"; }
+    QuoteVenue venue() const { return VENUE_KRAKEN; }
+
+    // The Ticker endpoint takes a pair list: one request whatever the symbol count
+    uint8_t capabilities() const { return EXCHANGE_CAP_BATCH_QUOTES | EXCHANGE_CAP_BOOK; }
+
+    const char* market(const SymbolConfig& sym) const { return sym.kraken_pair; }
+
+    int begin_quotes(const char* const* markets, int n, bool batched, ExchangeQuote* out);
+    int end_quotes();
+
+private:
+    int _num;
+    ExchangeQuote* _out;
+    net_kraken::Ticker _tickers[MAX_SYMBOLS];
+#if VENUES_ASYNC
+    const net_kraken::TickerBatch* _batches;
+    int _num_batches;
+#endif
+};
+
+static void set_kraken_ticker(ExchangeQuote* out, const net_kraken::Ticker& ticker) {
+    out->price = ticker.price;
+    out->bid = ticker.bid;
+    out->ask = ticker.ask;
+    out->valid = ticker.valid;
+}
+
+#if VENUES_ASYNC
+static HttpAsyncJob kraken_jobs[net_kraken::TICKER_MAX_REQUESTS];
+static net_kraken::TickerScan kraken_scans[net_kraken::TICKER_MAX_REQUESTS];
+
+int KrakenAdapter::begin_quotes(const char* const* markets, int n, bool batched, ExchangeQuote* out) {
+    (void)batched;      // A single pair is the same request with a one-entry list
+    _num = n;
+    _out = out;
+
+    // Bodies are filtered while they arrive, nothing is buffered
+    _num_batches = net_kraken::ticker_requests(markets, n, &_batches);
+    for (int b = 0; b < _num_batches; b++) {
+        const net_kraken::TickerBatch& batch = _batches[b];
+        net_kraken::ticker_begin(&kraken_scans[b], markets + batch.first, batch.count,
+                                 _tickers + batch.first);
+        kraken_jobs[b].status = HTTP_ASYNC_IDLE;
+        http_async_submit(&kraken_jobs[b], &batch.request, VENUE_REQUEST_TIMEOUT_MS,
+                          net_kraken::ticker_chunk, &kraken_scans[b], nullptr, nullptr);
+    }
+    return _num_batches;
+}
+
+int KrakenAdapter::end_quotes() {
+    for (int b = 0; b < _num_batches; b++) {
+        HttpAsyncJob& job = kraken_jobs[b];
+        if (job.status == HTTP_ASYNC_OK) {
+            net_kraken::ticker_finish(&kraken_scans[b]);
+            continue;
+        }
+        if (job.status != HTTP_ASYNC_IDLE) {
+            DEBUG_PRINTF("[VENUES] Kraken ticker: %s (HTTP %d, %lu ms)\n",
+                         http_async_status_name(job.status), job.status_code, job.elapsed_ms);
+        }
+        const net_kraken::TickerBatch& batch = _batches[b];
+        for (int k = batch.first; k < batch.first + batch.count; k++) {
+            _tickers[k].valid = false;
+        }
+    }
+    for (int k = 0; k < _num; k++) {
+        set_kraken_ticker(&_out[k], _tickers[k]);
+    }
+    return count_valid(_out, _num);
+}
+#else
+int KrakenAdapter::begin_quotes(const char* const* markets, int n, bool batched, ExchangeQuote* out) {
+    (void)batched;
+    _num = n;
+    _out = out;
+
+    const net_kraken::TickerBatch* batches = nullptr;
+    int requests = net_kraken::ticker_requests(markets, n, &batches);
+    net_kraken::fetch_tickers(markets, n, _tickers);
+    for (int k = 0; k < n; k++) {
+        set_kraken_ticker(&out[k], _tickers[k]);
+    }
+    return requests;
+}
+
+int KrakenAdapter::end_quotes() {
+    return count_valid(_out, _num);
+}
+#endif
+#endif // ENABLE_KRAKEN
+
+static BinanceAdapter g_binance;
+static CoinbaseAdapter g_coinbase;
+#if ENABLE_KRAKEN
+static KrakenAdapter g_kraken;
+#endif
+
+void venues_register() {
+    exchange_reset();
+    exchange_register(&g_binance);
+    exchange_register(&g_coinbase);
+#if ENABLE_KRAKEN
+    exchange_register(&g_kraken);
+#endif
+}
@@ -0,0 +1,28 @@
+#ifndef APP_VENUES_H
+#define APP_VENUES_H
+
+#include <stdint.h>
+
+/**
+ * @file app_venues.h
+ * @brief Exchange adapters of the supported venues (app_exchange.h)
+ *
+ * - Binance spot: batched bookTicker, bookTicker stream, funding
+ * - Coinbase: Exchange ticker per product, ticker channel stream, and one
+ *   exchange-rates request for all products if ENABLE_COINBASE_RATES
+ *   (mid price only)
+ * - Kraken (ENABLE_KRAKEN): every symbol's Ticker in one request, filtered
+ *   while streaming
+ *
+ * With ENABLE_ASYNC_HTTP the adapters queue their requests on the async
+ * engine and parse the buffered bodies in end_quotes(); otherwise each
+ * request is performed in begin_quotes().
+ */
+
+// Timeout of each quote request
+#define VENUE_REQUEST_TIMEOUT_MS 10000
+
+// Register the venue adapters, in model order (scheduler_init)
+void venues_register();
+
+#endif // APP_VENUES_H
@@ -26,11 +26,57 @@
 // Note: HTTP is less secure but functional for public API endpoints
 // WARNING: Binance and Coinbase APIs require HTTPS (return 301 on HTTP)
 #define ENABLE_HTTPS 1
+
+// Fetch all venue prices concurrently (non-blocking sockets, see net_async.h)
+// Cost when enabled: ~4 concurrent connections worth of TLS buffers during a cycle
+// Disable to fall back to one blocking request at a time
+#define ENABLE_ASYNC_HTTP 1
+
+// Resolve all exchange hostnames as soon as Wi-Fi connects (see net_dns.h)
+// Disable to resolve lazily on the first request to each host
+#define ENABLE_DNS_PRERESOLVE 1
+
+// Poll Coinbase with one exchange-rates request for every symbol (filtered while streaming)
+// instead of one Exchange ticker request each. Rates carry no bid/ask, so the
+// Coinbase quote is a mid price only and the executable spread is unavailable
+#define ENABLE_COINBASE_RATES 0
+
+// Poll Kraken as a third venue: top of book of every symbol in one Ticker request
+// Cost when enabled: one more TLS connection per price cycle (~3 KB body, filtered while streaming)
+#define ENABLE_KRAKEN 1
+
+// Stream quotes over WebSocket instead of polling them (see app_stream.h)
+// REST polling still covers any symbol whose stream is down or silent
+// Cost when enabled: one persistent TLS connection per feed (streams are wss only, needs ENABLE_HTTPS)
+#define ENABLE_MARKET_STREAMS 1
+
+// Also stream predicted funding, mark and index price every second (Binance futures <symbol>@markPrice@1s)
+// Funding REST fetches are skipped while the stream is live; alerts react within a second
+// Cost when enabled: one more persistent TLS connection (needs ENABLE_MARKET_STREAMS)
+#define ENABLE_FUNDING_STREAM 0
+
+// Record every adapter request/response to SPIFFS for host-side replay (see net_transport.h)
+// Price fetches run sequentially while recording (the async engine bypasses the transport)
+#define ENABLE_HTTP_RECORD 0
+#define HTTP_RECORD_PATH "/spiffs/http_record.txt"
+
+// ============================================================================
+// Task Placement - core affinity (-1 = either core) and FreeRTOS priority
+// ============================================================================
+// Core 0 runs the Wi-Fi/lwIP stack, core 1 the Arduino loop (LVGL, touch,
+// web dashboard). All HTTP, TLS and WebSocket work happens in net_task
+// (one async engine multiplexes every venue), so pinning it to core 0
+// keeps crypto off the UI core. Per-task CPU load is in the stability log.
+#define NET_TASK_CORE 0
+#define NET_TASK_PRIORITY 1        // Below the Wi-Fi and lwIP tasks on core 0
+#define ALERT_TASK_CORE 1
+#define ALERT_TASK_PRIORITY 1      // Same as the Arduino loop (round robin)
+
 // ============================================================================
 // Serial Debug Wrapper
 // ============================================================================
 
-#if ENABLE_SERIAL
+#if ENABLE_SERIAL && defined(ARDUINO)
     // Serial is enabled - use normal Serial object
     #define DEBUG_PRINT(...) Serial.print(__VA_ARGS__)
     #define DEBUG_PRINTLN(...) Serial.println(__VA_ARGS__)
@@ -40,7 +86,7 @@
     // LOG macro with F() for flash string storage (saves RAM)
     #define LOG(msg) Serial.println(F(msg))
 #else
-    // Serial is disabled - use dummy implementations (compile to nothing)
+    // Serial is disabled (or host unit-test build without Serial) - compile to nothing
     #define DEBUG_PRINT(...) ((void)0)
     #define DEBUG_PRINTLN(...) ((void)0)
     #define DEBUG_PRINTF(...) ((void)0)
@@ -1,7 +1,11 @@
 #ifndef HW_POWER_H
 #define HW_POWER_H
 
+#ifdef ARDUINO
 #include <Arduino.h>
+#else
+#include <stdint.h>
+#endif
 
 // Power management modes
 enum PowerMode {
@@ -14,6 +14,8 @@ static const char* KEY_FUNDING_REFRESH = "fund_ms";
 static const char* KEY_SPREAD_ALERT = "spread_pct";
 static const char* KEY_FUNDING_ALERT = "fund_pct";
 static const char* KEY_STALE_MS = "stale_ms";
+static const char* KEY_FUNDING_MODE = "fund_mode";
+static const char* KEY_PREDICTED_REFRESH = "pred_ms";
 
 // Preferences instance
 static Preferences prefs;
@@ -50,6 +52,9 @@ bool hw_storage_load_config(AppConfig* config) {
     config->spread_alert_pct = prefs.getDouble(KEY_SPREAD_ALERT, config->spread_alert_pct);
     config->funding_alert_pct = prefs.getDouble(KEY_FUNDING_ALERT, config->funding_alert_pct);
     config->stale_ms = prefs.getUInt(KEY_STALE_MS, config->stale_ms);
+    config->funding_schedule = (FundingScheduleMode)prefs.getUChar(KEY_FUNDING_MODE, config->funding_schedule);
+    config->predicted_funding_refresh_ms = prefs.getUInt(KEY_PREDICTED_REFRESH,
+                                                         config->predicted_funding_refresh_ms);
     
     prefs.end();
     
@@ -59,6 +64,8 @@ bool hw_storage_load_config(AppConfig* config) {
     DEBUG_PRINTF("[STORAGE]   Spread alert: %.2f%%\n", config->spread_alert_pct);
     DEBUG_PRINTF("[STORAGE]   Funding alert: %.4f%%\n", config->funding_alert_pct);
     DEBUG_PRINTF("[STORAGE]   Stale threshold: %lu ms\n", config->stale_ms);
+    DEBUG_PRINTF("[STORAGE]   Funding schedule: %d (predicted %lu ms)\n",
+                 config->funding_schedule, config->predicted_funding_refresh_ms);
     
     return true;
 }
@@ -84,6 +91,8 @@ bool hw_storage_save_config(const AppConfig* config) {
     prefs.putDouble(KEY_SPREAD_ALERT, config->spread_alert_pct);
     prefs.putDouble(KEY_FUNDING_ALERT, config->funding_alert_pct);
     prefs.putUInt(KEY_STALE_MS, config->stale_ms);
+    prefs.putUChar(KEY_FUNDING_MODE, (uint8_t)config->funding_schedule);
+    prefs.putUInt(KEY_PREDICTED_REFRESH, config->predicted_funding_refresh_ms);
     
     prefs.end();
     
@@ -93,6 +102,8 @@ bool hw_storage_save_config(const AppConfig* config) {
     DEBUG_PRINTF("[STORAGE]   Spread alert: %.2f%%\n", config->spread_alert_pct);
     DEBUG_PRINTF("[STORAGE]   Funding alert: %.4f%%\n", config->funding_alert_pct);
     DEBUG_PRINTF("[STORAGE]   Stale threshold: %lu ms\n", config->stale_ms);
+    DEBUG_PRINTF("[STORAGE]   Funding schedule: %d (predicted %lu ms)\n",
+                 config->funding_schedule, config->predicted_funding_refresh_ms);
     
     return true;
 }
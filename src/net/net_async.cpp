@@ -0,0 +1,614 @@
+#include "net_async.h"
+#include "net_dns.h"
+#include "net_timing.h"
+#include "../config.h"
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <lwip/sockets.h>
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#ifdef MSG_NOSIGNAL
+#define ASYNC_SEND_FLAGS MSG_NOSIGNAL
+#else
+#define ASYNC_SEND_FLAGS 0
+#endif
+
+// Longest select() sleep, bounds how late a deadline is noticed
+#define ASYNC_POLL_MS 20
+
+// ============================================================================
+// Sockets
+// ============================================================================
+
+int async_socket_open(const char* host, uint16_t port) {
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (!dns_resolve(host, &addr.sin_addr.s_addr)) {
+        DEBUG_PRINTF("[ASYNC] DNS lookup failed for %s\n", host);
+        return ASYNC_SOCKET_NO_ADDRESS;
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (fd < 0) {
+        return -1;
+    }
+
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    int ret = ::connect(fd, (struct sockaddr*)&addr, sizeof(addr));
+    if (ret != 0 && errno != EINPROGRESS) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int async_socket_check(int fd) {
+    if (fd < 0) {
+        return -1;
+    }
+    fd_set wfds;
+    FD_ZERO(&wfds);
+    FD_SET(fd, &wfds);
+    struct timeval tv = { 0, 0 };
+    int ret = select(fd + 1, nullptr, &wfds, nullptr, &tv);
+    if (ret < 0) {
+        return -1;
+    }
+    if (ret == 0) {
+        return 0;
+    }
+    int err = 0;
+    socklen_t err_len = sizeof(err);
+    if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &err_len) != 0 || err != 0) {
+        return -1;
+    }
+    return 1;
+}
+
+SocketStream::SocketStream() : _fd(-1) {}
+
+SocketStream::~SocketStream() {
+    close();
+}
+
+bool SocketStream::begin(const char* host, uint16_t port) {
+    close();
+    _fd = async_socket_open(host, port);
+    return _fd >= 0;
+}
+
+int SocketStream::step_connect() {
+    int r = async_socket_check(_fd);
+    return r < 0 ? ASYNC_CONNECT_TCP_FAILED : r;
+}
+
+int SocketStream::send(const uint8_t* data, size_t len) {
+    if (_fd < 0) {
+        return -1;
+    }
+    int n = ::send(_fd, data, len, ASYNC_SEND_FLAGS);
+    if (n >= 0) {
+        return n;
+    }
+    return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+}
+
+int SocketStream::recv(uint8_t* buf, size_t len) {
+    if (_fd < 0) {
+        return -1;
+    }
+    int n = ::recv(_fd, buf, len, 0);
+    if (n > 0) {
+        return n;
+    }
+    if (n == 0) {
+        return -1;  // Peer closed
+    }
+    return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+}
+
+void SocketStream::close() {
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+}
+
+// ============================================================================
+// Engine
+// ============================================================================
+
+enum AsyncPhase {
+    PHASE_QUEUED = 0,
+    PHASE_CONNECTING,
+    PHASE_SENDING,
+    PHASE_RECEIVING
+};
+
+// Connection slot: stream objects are created once and reopened in place
+struct AsyncConn {
+    AsyncStream* plain;
+    AsyncStream* secure;
+    AsyncStream* active;        // nullptr while closed
+    char host[HTTP_POOL_HOST_MAX];
+    uint16_t port;
+    bool tls;
+    HttpAsyncJob* job;          // nullptr while idle
+    uint32_t last_used_ms;
+};
+
+static AsyncConn g_conns[HTTP_ASYNC_MAX_CONNS];
+static AsyncStreamFactory g_factory = nullptr;
+static AsyncClockFn g_clock = nullptr;
+static HttpAsyncStats g_stats;
+
+// Submitted jobs (queued and in flight), in submission order
+static HttpAsyncJob* g_head = nullptr;
+static HttpAsyncJob* g_tail = nullptr;
+static int g_pending = 0;
+
+// Shared receive buffer - jobs are serviced one at a time
+static uint8_t g_scratch[HTTP_READ_CHUNK_SIZE];
+
+static void conn_close(AsyncConn& conn) {
+    if (conn.active) {
+        conn.active->close();
+        conn.active = nullptr;
+    }
+}
+
+static bool conn_matches(const AsyncConn& conn, const HttpEndpoint* ep) {
+    return conn.active && conn.port == ep->port && conn.tls == ep->tls &&
+           strcmp(conn.host, ep->host) == 0;
+}
+
+static void job_unlink(HttpAsyncJob* job) {
+    HttpAsyncJob* prev = nullptr;
+    for (HttpAsyncJob* j = g_head; j; prev = j, j = j->next) {
+        if (j == job) {
+            if (prev) {
+                prev->next = j->next;
+            } else {
+                g_head = j->next;
+            }
+            if (g_tail == j) {
+                g_tail = prev;
+            }
+            j->next = nullptr;
+            g_pending--;
+            return;
+        }
+    }
+}
+
+// Finish a job and release (or close) its connection
+static void job_complete(HttpAsyncJob* job, HttpAsyncStatus status) {
+    job->status = status;
+    job->status_code = job->parser.status_code;
+    job->elapsed_ms = g_clock() - job->start_ms;
+
+    if (status == HTTP_ASYNC_OK || status == HTTP_ASYNC_HTTP_ERROR) {
+        const char* host = job->request->endpoint->host;
+        http_timing_record(host, HTTP_PHASE_BODY, g_clock() - job->phase_ms);
+        http_timing_record(host, HTTP_PHASE_TOTAL, job->elapsed_ms);
+    }
+
+    if (job->conn >= 0) {
+        AsyncConn& conn = g_conns[job->conn];
+        conn.job = nullptr;
+        conn.last_used_ms = g_clock();
+        bool reusable = (status == HTTP_ASYNC_OK || status == HTTP_ASYNC_HTTP_ERROR) &&
+                        http_parser_keep_alive(&job->parser);
+        if (!reusable) {
+            conn_close(conn);
+        }
+        job->conn = -1;
+    }
+
+    if (status == HTTP_ASYNC_OK) {
+        g_stats.completed_ok++;
+    } else {
+        g_stats.failed++;
+        if (status == HTTP_ASYNC_TIMEOUT) {
+            g_stats.timeouts++;
+        }
+    }
+
+    job_unlink(job);
+    if (job->on_done) {
+        job->on_done(job, job->done_ctx);
+    }
+}
+
+// Open a new connection on conn for the job's endpoint
+static bool conn_open(AsyncConn& conn, HttpAsyncJob* job) {
+    const HttpEndpoint* ep = job->request->endpoint;
+    conn_close(conn);
+
+    AsyncStream*& stream = ep->tls ? conn.secure : conn.plain;
+    if (!stream) {
+        stream = g_factory(ep->tls);
+    }
+    if (!stream) {
+        return false;
+    }
+
+    strncpy(conn.host, ep->host, sizeof(conn.host) - 1);
+    conn.host[sizeof(conn.host) - 1] = '\0';
+    conn.port = ep->port;
+    conn.tls = ep->tls;
+
+    g_stats.connects++;
+    if (!stream->begin(ep->host, ep->port)) {
+        stream->close();
+        return false;
+    }
+    conn.active = stream;
+    return true;
+}
+
+static void job_start_on(HttpAsyncJob* job, int idx, bool reused) {
+    AsyncConn& conn = g_conns[idx];
+    conn.job = job;
+    job->conn = (int8_t)idx;
+    job->reused = reused;
+    job->sent = 0;
+    job->received = 0;
+    http_parser_init(&job->parser);
+
+    if (reused) {
+        g_stats.reused++;
+        job->phase = PHASE_SENDING;
+    } else if (conn_open(conn, job)) {
+        job->phase = PHASE_CONNECTING;
+        job->phase_ms = g_clock();
+    } else {
+        job_complete(job, HTTP_ASYNC_CONNECT_FAILED);
+    }
+}
+
+// Kept-alive connection was closed by the server before any response byte:
+// reconnect once (nothing has reached the body callback yet)
+static bool job_retry_if_stale(HttpAsyncJob* job) {
+    if (!job->reused || job->retried || job->received > 0) {
+        return false;
+    }
+    g_stats.stale_retries++;
+    job->retried = true;
+    int idx = job->conn;
+    g_conns[idx].job = nullptr;
+    conn_close(g_conns[idx]);
+    job_start_on(job, idx, false);
+    return true;
+}
+
+// Bind queued jobs to connections
+static void assign_jobs() {
+    HttpAsyncJob* job = g_head;
+    while (job) {
+        HttpAsyncJob* next = job->next;  // job may complete (and unlink) below
+        if (job->phase != PHASE_QUEUED) {
+            job = next;
+            continue;
+        }
+        const HttpEndpoint* ep = job->request->endpoint;
+        int reuse = -1, empty = -1, victim = -1;
+        for (int i = 0; i < HTTP_ASYNC_MAX_CONNS; i++) {
+            AsyncConn& conn = g_conns[i];
+            if (conn.job) {
+                continue;
+            }
+            if (conn_matches(conn, ep)) {
+                reuse = i;
+                break;
+            }
+            if (!conn.active) {
+                if (empty < 0) empty = i;
+            } else if (victim < 0 || conn.last_used_ms < g_conns[victim].last_used_ms) {
+                victim = i;
+            }
+        }
+
+        if (reuse >= 0) {
+            job_start_on(job, reuse, true);
+        } else if (empty >= 0) {
+            job_start_on(job, empty, false);
+        } else if (victim >= 0) {
+            job_start_on(job, victim, false);
+        }
+        job = next;
+    }
+
+    uint32_t in_flight = 0;
+    for (int i = 0; i < HTTP_ASYNC_MAX_CONNS; i++) {
+        if (g_conns[i].job) in_flight++;
+    }
+    if (in_flight > g_stats.max_in_flight) {
+        g_stats.max_in_flight = in_flight;
+    }
+}
+
+// Advance one in-flight job as far as it goes without blocking
+static void service(HttpAsyncJob* job) {
+    AsyncStream* stream = g_conns[job->conn].active;
+
+    if (job->phase == PHASE_CONNECTING) {
+        int r = stream->step_connect();
+        if (r == ASYNC_CONNECT_TCP_FAILED) {
+            // Cached address may have moved: resolve again next time
+            dns_invalidate(g_conns[job->conn].host);
+        }
+        if (r < 0) {
+            job_complete(job, HTTP_ASYNC_CONNECT_FAILED);
+            return;
+        }
+        if (r == 0) {
+            return;
+        }
+        // TLS streams time their TCP connect and handshake themselves
+        if (!g_conns[job->conn].tls) {
+            http_timing_record(g_conns[job->conn].host, HTTP_PHASE_CONNECT, g_clock() - job->phase_ms);
+        }
+        job->phase = PHASE_SENDING;
+    }
+
+    if (job->phase == PHASE_SENDING) {
+        const HttpRequest* req = job->request;
+        int n = stream->send((const uint8_t*)req->data + job->sent, req->len - job->sent);
+        if (n < 0) {
+            if (!job_retry_if_stale(job)) {
+                job_complete(job, HTTP_ASYNC_IO_ERROR);
+            }
+            return;
+        }
+        job->sent += n;
+        if (job->sent < req->len) {
+            return;
+        }
+        job->phase = PHASE_RECEIVING;
+        job->phase_ms = g_clock();
+    }
+
+    // PHASE_RECEIVING: drain what is available
+    while (true) {
+        int n = stream->recv(g_scratch, sizeof(g_scratch));
+        if (n == 0) {
+            return;
+        }
+        if (n < 0) {
+            if (job_retry_if_stale(job)) {
+                return;
+            }
+            http_parser_eof(&job->parser);
+        } else {
+            if (job->received == 0) {
+                uint32_t now = g_clock();
+                http_timing_record(job->request->endpoint->host, HTTP_PHASE_TTFB, now - job->phase_ms);
+                job->phase_ms = now;
+            }
+            job->received += n;
+            http_parser_feed(&job->parser, g_scratch, (size_t)n, job->on_body, job->body_ctx);
+        }
+
+        if (http_parser_done(&job->parser)) {
+            job_complete(job, job->parser.status_code == 200 ? HTTP_ASYNC_OK : HTTP_ASYNC_HTTP_ERROR);
+            return;
+        }
+        if (http_parser_failed(&job->parser)) {
+            job_complete(job, job->parser.aborted ? HTTP_ASYNC_ABORTED : HTTP_ASYNC_IO_ERROR);
+            return;
+        }
+    }
+}
+
+void http_async_init(AsyncStreamFactory factory, AsyncClockFn clock) {
+    http_async_close_all();
+    for (int i = 0; i < HTTP_ASYNC_MAX_CONNS; i++) {
+        AsyncConn& conn = g_conns[i];
+        delete conn.plain;
+        delete conn.secure;
+        conn.plain = nullptr;
+        conn.secure = nullptr;
+        conn.active = nullptr;
+        conn.host[0] = '\0';
+        conn.port = 0;
+        conn.tls = false;
+        conn.job = nullptr;
+        conn.last_used_ms = 0;
+    }
+    g_factory = factory;
+    g_clock = clock;
+    memset(&g_stats, 0, sizeof(g_stats));
+}
+
+bool http_async_submit(HttpAsyncJob* job, const HttpRequest* req, uint32_t timeout_ms,
+                       HttpChunkCallback on_body, void* body_ctx,
+                       HttpAsyncDoneCallback on_done, void* done_ctx) {
+    if (!g_factory || !g_clock || !job || !req || !req->endpoint || req->len == 0) {
+        return false;
+    }
+    // Re-submitting a job that is still in the queue would corrupt the list
+    for (HttpAsyncJob* j = g_head; j; j = j->next) {
+        if (j == job) {
+            return false;
+        }
+    }
+
+    job->request = req;
+    job->on_body = on_body;
+    job->body_ctx = body_ctx;
+    job->on_done = on_done;
+    job->done_ctx = done_ctx;
+    job->timeout_ms = timeout_ms;
+    job->status = HTTP_ASYNC_PENDING;
+    job->status_code = 0;
+    job->elapsed_ms = 0;
+    job->phase = PHASE_QUEUED;
+    job->conn = -1;
+    job->reused = false;
+    job->retried = false;
+    job->sent = 0;
+    job->received = 0;
+    job->start_ms = g_clock();
+    job->phase_ms = job->start_ms;
+    job->next = nullptr;
+    http_parser_init(&job->parser);
+
+    if (g_tail) {
+        g_tail->next = job;
+    } else {
+        g_head = job;
+    }
+    g_tail = job;
+    g_pending++;
+    g_stats.submitted++;
+    return true;
+}
+
+int http_async_run(uint32_t max_wait_ms) {
+    if (!g_clock) {
+        return g_pending;
+    }
+    uint32_t start_ms = g_clock();
+
+    while (g_pending > 0) {
+        assign_jobs();
+
+        // Deadlines
+        uint32_t now = g_clock();
+        HttpAsyncJob* job = g_head;
+        while (job) {
+            HttpAsyncJob* next = job->next;
+            if (now - job->start_ms > job->timeout_ms) {
+                job_complete(job, HTTP_ASYNC_TIMEOUT);
+            }
+            job = next;
+        }
+
+        if (g_pending == 0) {
+            break;
+        }
+        uint32_t waited = now - start_ms;
+        if (waited >= max_wait_ms) {
+            break;
+        }
+
+        // Wait for any in-flight connection to make progress
+        fd_set rfds, wfds;
+        FD_ZERO(&rfds);
+        FD_ZERO(&wfds);
+        int max_fd = -1;
+        bool ready_now = false;
+        for (int i = 0; i < HTTP_ASYNC_MAX_CONNS; i++) {
+            AsyncConn& conn = g_conns[i];
+            if (!conn.job || !conn.active) {
+                continue;
+            }
+            if (conn.active->has_buffered()) {
+                ready_now = true;
+            }
+            int fd = conn.active->fd();
+            if (fd < 0) {
+                continue;
+            }
+            uint8_t phase = conn.job->phase;
+            bool want_write = phase == PHASE_SENDING ||
+                              (phase == PHASE_CONNECTING && conn.active->wants_write());
+            FD_SET(fd, want_write ? &wfds : &rfds);
+            if (fd > max_fd) max_fd = fd;
+        }
+
+        uint32_t wait_ms = max_wait_ms - waited;
+        if (wait_ms > ASYNC_POLL_MS) wait_ms = ASYNC_POLL_MS;
+        if (ready_now) wait_ms = 0;
+        struct timeval tv;
+        tv.tv_sec = wait_ms / 1000;
+        tv.tv_usec = (wait_ms % 1000) * 1000;
+        if (max_fd >= 0) {
+            select(max_fd + 1, &rfds, &wfds, nullptr, &tv);
+        } else if (wait_ms > 0) {
+            // Nothing to wait on (all jobs queued behind busy connections)
+            select(0, nullptr, nullptr, nullptr, &tv);
+        }
+
+        // Service every in-flight job; non-blocking calls return at once if idle
+        for (int i = 0; i < HTTP_ASYNC_MAX_CONNS; i++) {
+            if (g_conns[i].job && g_conns[i].active) {
+                service(g_conns[i].job);
+            }
+        }
+    }
+
+    return g_pending;
+}
+
+int http_async_evict_idle() {
+    if (!g_clock) {
+        return 0;
+    }
+    uint32_t now = g_clock();
+    int evicted = 0;
+    for (int i = 0; i < HTTP_ASYNC_MAX_CONNS; i++) {
+        AsyncConn& conn = g_conns[i];
+        if (!conn.job && conn.active && now - conn.last_used_ms > HTTP_ASYNC_IDLE_TIMEOUT_MS) {
+            conn_close(conn);
+            evicted++;
+        }
+    }
+    return evicted;
+}
+
+void http_async_close_all() {
+    while (g_head) {
+        job_complete(g_head, HTTP_ASYNC_ABORTED);
+    }
+    for (int i = 0; i < HTTP_ASYNC_MAX_CONNS; i++) {
+        conn_close(g_conns[i]);
+    }
+}
+
+AsyncStreamFactory http_async_factory() {
+    return g_factory;
+}
+
+AsyncClockFn http_async_clock() {
+    return g_clock;
+}
+
+HttpAsyncStats http_async_get_stats() {
+    return g_stats;
+}
+
+void http_async_reset_stats() {
+    memset(&g_stats, 0, sizeof(g_stats));
+}
+
+const char* http_async_status_name(HttpAsyncStatus status) {
+    switch (status) {
+        case HTTP_ASYNC_IDLE:           return "idle";
+        case HTTP_ASYNC_PENDING:        return "pending";
+        case HTTP_ASYNC_OK:             return "ok";
+        case HTTP_ASYNC_HTTP_ERROR:     return "http error";
+        case HTTP_ASYNC_CONNECT_FAILED: return "connect failed";
+        case HTTP_ASYNC_IO_ERROR:       return "io error";
+        case HTTP_ASYNC_TIMEOUT:        return "timeout";
+        case HTTP_ASYNC_ABORTED:        return "aborted";
+    }
+    return "?";
+}
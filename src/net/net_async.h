@@ -0,0 +1,214 @@
+#ifndef NET_ASYNC_H
+#define NET_ASYNC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "net_endpoint.h"
+#include "net_http_parser.h"
+
+/**
+ * @file net_async.h
+ * @brief Concurrent non-blocking HTTP engine (several requests in flight from one task)
+ *
+ * Jobs are submitted with http_async_submit() and driven by
+ * http_async_run(), which multiplexes all connections with select() on
+ * non-blocking sockets. A price cycle therefore takes as long as its
+ * slowest request instead of the sum of all of them.
+ *
+ * Completion is reported through an optional callback and through the job
+ * itself (a caller-owned future: check status once http_async_done()).
+ * Connections are kept alive per endpoint and reused by later jobs.
+ *
+ * The engine only depends on the AsyncStream interface and the BSD socket
+ * API (lwIP on the ESP32, POSIX on Linux), so it is tested on the host
+ * against a local stand-in server with injected latency. TLS streams are
+ * provided by net_tls on the device.
+ *
+ * Not thread-safe: all calls are expected from net_task.
+ */
+
+// Connections open at the same time (each TLS one holds its own mbedTLS buffers)
+#define HTTP_ASYNC_MAX_CONNS 4
+
+// Close idle keep-alive connections after this long (matches the sync pool)
+#define HTTP_ASYNC_IDLE_TIMEOUT_MS 30000
+
+// step_connect() failures. Only a failed TCP connect says the cached
+// address may be wrong; a failed handshake does not.
+#define ASYNC_CONNECT_TCP_FAILED (-1)
+#define ASYNC_CONNECT_TLS_FAILED (-2)
+
+/**
+ * @brief Non-blocking byte stream (plain TCP or TLS) driven by the engine
+ *
+ * The object is owned by a connection slot and reopened in place.
+ */
+class AsyncStream {
+public:
+    virtual ~AsyncStream() {}
+
+    // Start connecting; false if the attempt failed immediately (e.g. DNS)
+    virtual bool begin(const char* host, uint16_t port) = 0;
+
+    // Advance connect / handshake: 1 = established, 0 = in progress,
+    // ASYNC_CONNECT_TCP_FAILED or ASYNC_CONNECT_TLS_FAILED (< 0)
+    virtual int step_connect() = 0;
+
+    // >0 bytes transferred, 0 = would block, -1 = error / peer closed
+    virtual int send(const uint8_t* data, size_t len) = 0;
+    virtual int recv(uint8_t* buf, size_t len) = 0;
+
+    // Socket to wait on, -1 when closed
+    virtual int fd() const = 0;
+
+    // While connecting: wait for writability (true) or readability (false)
+    virtual bool wants_write() const = 0;
+
+    // Decoded bytes are buffered (TLS) - recv() succeeds without socket activity
+    virtual bool has_buffered() const { return false; }
+
+    virtual void close() = 0;
+};
+
+// Creates a stream object for plain (tls=false) or TLS (tls=true) use
+typedef AsyncStream* (*AsyncStreamFactory)(bool tls);
+
+// Monotonic millisecond clock
+typedef uint32_t (*AsyncClockFn)();
+
+/**
+ * @brief Plain TCP stream on a non-blocking BSD socket
+ */
+class SocketStream : public AsyncStream {
+public:
+    SocketStream();
+    ~SocketStream();
+
+    bool begin(const char* host, uint16_t port);
+    int step_connect();
+    int send(const uint8_t* data, size_t len);
+    int recv(uint8_t* buf, size_t len);
+    int fd() const { return _fd; }
+    bool wants_write() const { return true; }
+    void close();
+
+private:
+    int _fd;
+};
+
+// async_socket_open(): host did not resolve (no address was tried)
+#define ASYNC_SOCKET_NO_ADDRESS (-2)
+
+// Open a non-blocking TCP socket to host:port (connect in progress), -1 on
+// failure. The address comes from the DNS cache (net_dns.h).
+int async_socket_open(const char* host, uint16_t port);
+
+// Check a connecting socket: 1 = connected, 0 = in progress, -1 = failed
+int async_socket_check(int fd);
+
+enum HttpAsyncStatus {
+    HTTP_ASYNC_IDLE = 0,        // Not submitted
+    HTTP_ASYNC_PENDING,         // Queued or in flight
+    HTTP_ASYNC_OK,              // 200 with complete body
+    HTTP_ASYNC_HTTP_ERROR,      // Complete response with non-200 status
+    HTTP_ASYNC_CONNECT_FAILED,  // DNS / TCP / TLS failure
+    HTTP_ASYNC_IO_ERROR,        // Connection lost or malformed response
+    HTTP_ASYNC_TIMEOUT,         // Deadline passed
+    HTTP_ASYNC_ABORTED          // Body callback returned false
+};
+
+struct HttpAsyncJob;
+
+// Called once when a job completes (any status)
+typedef void (*HttpAsyncDoneCallback)(HttpAsyncJob* job, void* ctx);
+
+/**
+ * @brief One request and its result (caller-owned, must outlive the run)
+ */
+struct HttpAsyncJob {
+    // Request
+    const HttpRequest* request;
+    HttpChunkCallback on_body;
+    void* body_ctx;
+    HttpAsyncDoneCallback on_done;
+    void* done_ctx;
+    uint32_t timeout_ms;
+
+    // Result (valid once status != HTTP_ASYNC_PENDING)
+    HttpAsyncStatus status;
+    int status_code;
+    uint32_t elapsed_ms;
+
+    // Engine state
+    uint8_t phase;
+    int8_t conn;
+    bool reused;
+    bool retried;
+    uint16_t sent;
+    uint32_t received;
+    uint32_t start_ms;
+    uint32_t phase_ms;          // Start of the current phase (net_timing.h)
+    HttpAsyncJob* next;
+    HttpResponseParser parser;
+};
+
+// Engine counters (monotonic since init or http_async_reset_stats())
+struct HttpAsyncStats {
+    uint32_t submitted;
+    uint32_t completed_ok;
+    uint32_t failed;
+    uint32_t timeouts;
+    uint32_t connects;          // New connections opened
+    uint32_t reused;            // Jobs served on a kept-alive connection
+    uint32_t stale_retries;     // Kept-alive connection found closed, retried
+    uint32_t max_in_flight;     // Peak concurrent jobs on connections
+};
+
+/**
+ * @brief Initialize (or re-initialize) the engine
+ * @param factory Creates stream objects on demand
+ * @param clock Millisecond clock used for deadlines and idle eviction
+ */
+void http_async_init(AsyncStreamFactory factory, AsyncClockFn clock);
+
+/**
+ * @brief Queue a GET request
+ *
+ * @param job Caller-owned job (reset by this call)
+ * @param req Pre-rendered request (must outlive the job)
+ * @param on_body Receives body chunks of a 200 response (may be nullptr)
+ * @param on_done Called once on completion (may be nullptr)
+ * @return false if the engine is not initialized or the job is already pending
+ */
+bool http_async_submit(HttpAsyncJob* job, const HttpRequest* req, uint32_t timeout_ms,
+                       HttpChunkCallback on_body, void* body_ctx,
+                       HttpAsyncDoneCallback on_done, void* done_ctx);
+
+/**
+ * @brief Drive all submitted jobs until they complete or max_wait_ms passes
+ * @return Number of jobs still pending (0 = everything finished)
+ */
+int http_async_run(uint32_t max_wait_ms);
+
+// True once the job has a final status
+inline bool http_async_done(const HttpAsyncJob* job) {
+    return job->status != HTTP_ASYNC_PENDING && job->status != HTTP_ASYNC_IDLE;
+}
+
+// Close keep-alive connections idle longer than HTTP_ASYNC_IDLE_TIMEOUT_MS
+int http_async_evict_idle();
+
+// Fail pending jobs (HTTP_ASYNC_ABORTED) and close every connection
+void http_async_close_all();
+
+// Stream factory and clock passed to http_async_init() (shared with net_ws.h clients)
+AsyncStreamFactory http_async_factory();
+AsyncClockFn http_async_clock();
+
+HttpAsyncStats http_async_get_stats();
+void http_async_reset_stats();
+
+// Human-readable status name for logs
+const char* http_async_status_name(HttpAsyncStatus status);
+
+#endif // NET_ASYNC_H
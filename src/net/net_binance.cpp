@@ -1,10 +1,47 @@
 #include "net_binance.h"
 #include "../config.h"
-#include "net_http.h"
+#include "net_dns.h"
+#include "net_json_filter.h"
+#include "net_json_scan.h"
+#include "net_json_stream.h"
+#include "net_transport.h"
 #include <ArduinoJson.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 namespace net_binance {
 
+// Response fields read by the parsers; everything else is dropped while parsing
+static JsonFilter<JSON_OBJECT_SIZE(2) + 16> g_spot_filter("{\"symbol\":true,\"price\":true}");
+static JsonFilter<JSON_ARRAY_SIZE(1) + JSON_OBJECT_SIZE(2) + 16> g_spot_batch_filter(
+    "[{\"symbol\":true,\"price\":true}]");
+static JsonFilter<JSON_OBJECT_SIZE(3) + 32> g_book_filter(
+    "{\"symbol\":true,\"bidPrice\":true,\"askPrice\":true}");
+static JsonFilter<JSON_ARRAY_SIZE(1) + JSON_OBJECT_SIZE(3) + 32> g_book_batch_filter(
+    "[{\"symbol\":true,\"bidPrice\":true,\"askPrice\":true}]");
+static JsonFilter<JSON_OBJECT_SIZE(1) + JSON_OBJECT_SIZE(3) + 16> g_book_stream_filter(
+    "{\"data\":{\"s\":true,\"b\":true,\"a\":true}}");
+static JsonFilter<JSON_OBJECT_SIZE(1) + JSON_OBJECT_SIZE(6) + 24> g_mark_stream_filter(
+    "{\"data\":{\"s\":true,\"p\":true,\"i\":true,\"r\":true,\"T\":true,\"E\":true}}");
+static JsonFilter<JSON_ARRAY_SIZE(1) + JSON_OBJECT_SIZE(2) + 24> g_funding_filter(
+    "[{\"symbol\":true,\"fundingRate\":true}]");
+
+// Filtered documents: members only (bodies are parsed in place, strings are not copied).
+// Batch bodies hold at most BODY_MAX / (shortest entry) entries.
+static const size_t SPOT_DOC_SIZE = JSON_OBJECT_SIZE(2);
+static const size_t SPOT_BATCH_ENTRIES = SPOT_BATCH_BODY_MAX / 40;
+static const size_t SPOT_BATCH_DOC_SIZE = JSON_ARRAY_SIZE(SPOT_BATCH_ENTRIES) +
+                                          SPOT_BATCH_ENTRIES * JSON_OBJECT_SIZE(2);
+static const size_t BOOK_DOC_SIZE = JSON_OBJECT_SIZE(3);
+static const size_t BOOK_BATCH_ENTRIES = BOOK_BATCH_BODY_MAX / 80;
+static const size_t BOOK_BATCH_DOC_SIZE = JSON_ARRAY_SIZE(BOOK_BATCH_ENTRIES) +
+                                          BOOK_BATCH_ENTRIES * JSON_OBJECT_SIZE(3);
+static const size_t BOOK_STREAM_DOC_SIZE = JSON_OBJECT_SIZE(1) + JSON_OBJECT_SIZE(3);
+static const size_t MARK_STREAM_DOC_SIZE = JSON_OBJECT_SIZE(1) + JSON_OBJECT_SIZE(6);
+static const size_t FUNDING_DOC_SIZE = JSON_ARRAY_SIZE(1) + JSON_OBJECT_SIZE(2);
+
 // Binance API base URLs - use HTTP or HTTPS based on config
 #if ENABLE_HTTPS
 static const char* BINANCE_API_BASE = "https://api.binance.com";
@@ -14,28 +51,197 @@ static const char* BINANCE_API_BASE = "http://api.binance.com";
 static const char* BINANCE_FAPI_BASE = "http://fapi.binance.com";
 #endif
 
-bool fetch_spot(const char* symbol, double* out_price) {
+// Endpoints resolved once in init(); requests rendered once per symbol
+static HttpEndpoint g_spot_endpoint;
+static HttpEndpoint g_funding_endpoint;
+static HttpEndpoint g_spot_batch_endpoint;
+static HttpEndpoint g_book_endpoint;
+static HttpEndpoint g_book_batch_endpoint;
+static HttpEndpoint g_premium_endpoint;
+static HttpRequest g_premium_request;
+static HttpRequestCache g_spot_requests;
+static HttpRequestCache g_funding_requests;
+static HttpRequestCache g_book_requests;
+static bool g_initialized = false;
+
+// Symbol lists of the batch endpoints are URL-encoded JSON arrays
+static const HttpListFormat JSON_ARRAY_FORMAT = { "%5B", "%22", "%5D" };
+
+// Batched requests per endpoint for the last symbol list
+static HttpRequestBatches g_spot_batches;
+static HttpRequestBatches g_book_batches;
+
+void init() {
+    http_endpoint_init(&g_spot_endpoint, BINANCE_API_BASE, "/api/v3/ticker/price?symbol=" HTTP_PATH_ARG);
+    http_endpoint_init(&g_funding_endpoint, BINANCE_FAPI_BASE,
+                       "/fapi/v1/fundingRate?symbol=" HTTP_PATH_ARG "&limit=1");
+    // Argument is a URL-encoded JSON array: %5B%22BTCUSDT%22,%22ETHUSDT%22%5D
+    http_endpoint_init(&g_spot_batch_endpoint, BINANCE_API_BASE,
+                       "/api/v3/ticker/price?symbols=" HTTP_PATH_ARG);
+    http_endpoint_init(&g_book_endpoint, BINANCE_API_BASE, "/api/v3/ticker/bookTicker?symbol=" HTTP_PATH_ARG);
+    http_endpoint_init(&g_book_batch_endpoint, BINANCE_API_BASE,
+                       "/api/v3/ticker/bookTicker?symbols=" HTTP_PATH_ARG);
+    http_endpoint_init(&g_premium_endpoint, BINANCE_FAPI_BASE, "/fapi/v1/premiumIndex");
+    http_request_render(&g_premium_request, &g_premium_endpoint, nullptr);
+    http_request_cache_init(&g_spot_requests, &g_spot_endpoint);
+    http_request_cache_init(&g_funding_requests, &g_funding_endpoint);
+    http_request_cache_init(&g_book_requests, &g_book_endpoint);
+    dns_register(g_spot_endpoint.host);
+    dns_register(g_funding_endpoint.host);
+    http_request_batches_init(&g_spot_batches, &g_spot_batch_endpoint, &JSON_ARRAY_FORMAT,
+                              SPOT_BATCH_MAX_REQUESTS);
+    http_request_batches_init(&g_book_batches, &g_book_batch_endpoint, &JSON_ARRAY_FORMAT,
+                              SPOT_BATCH_MAX_REQUESTS);
+    g_initialized = true;
+}
+
+const HttpRequest* spot_request(const char* symbol) {
+    if (!symbol) {
+        return nullptr;
+    }
+    if (!g_initialized) {
+        init();
+    }
+    return http_request_cache_get(&g_spot_requests, symbol);
+}
+
+int spot_batch_requests(const char* const* symbols, int n, const SpotBatch** out_batches) {
+    if (!symbols || n <= 0 || n > 255 || !out_batches) {
+        return 0;
+    }
+    if (!g_initialized) {
+        init();
+    }
+    return http_request_batches(&g_spot_batches, symbols, n, out_batches);
+}
+
+int parse_spot_batch(char* body, size_t len, const char* const* symbols, int n,
+                     Fixed* out_prices, bool* out_ok) {
+    if (!body || !symbols || !out_prices || !out_ok || n <= 0) {
+        return 0;
+    }
+    for (int k = 0; k < n; k++) {
+        out_ok[k] = false;
+    }
+    
+    // Parse JSON response: [{"symbol":"BTCUSDT","price":"43250.50"},...]
+    StaticJsonDocument<SPOT_BATCH_DOC_SIZE> doc;
+    DeserializationError error = deserializeJson(doc, body, len, g_spot_batch_filter.option());
+    
+    if (error) {
+        DEBUG_PRINTF("[BINANCE] JSON parse error: %s\n", error.c_str());
+        return 0;
+    }
+    
+    if (!doc.is<JsonArray>()) {
+        DEBUG_PRINTLN("[BINANCE] Batch response is not an array");
+        return 0;
+    }
+    
+    // Single pass over the response, scattering each price to its symbol
+    int found = 0;
+    for (JsonObject item : doc.as<JsonArray>()) {
+        const char* resp_symbol = item["symbol"];
+        const char* price_str = item["price"];
+        if (!resp_symbol || !price_str) {
+            continue;
+        }
+        for (int k = 0; k < n; k++) {
+            if (out_ok[k] || !symbols[k] || strcmp(symbols[k], resp_symbol) != 0) {
+                continue;
+            }
+            Fixed price = fixed_from_string(price_str);
+            if (price <= 0) {
+                DEBUG_PRINTF("[BINANCE] Invalid price for %s: %s\n", resp_symbol, price_str);
+                break;
+            }
+            out_prices[k] = price;
+            out_ok[k] = true;
+            found++;
+            break;
+        }
+    }
+    
+    if (found < n) {
+        DEBUG_PRINTF("[BINANCE] Batch response had %d of %d symbols\n", found, n);
+    }
+    return found;
+}
+
+int fetch_spot_batch(const char* const* symbols, int n, Fixed* out_prices, bool* out_ok) {
+    if (!symbols || !out_prices || !out_ok || n <= 0) {
+        DEBUG_PRINTLN("[BINANCE] ERROR: Invalid parameters");
+        return 0;
+    }
+    for (int k = 0; k < n; k++) {
+        out_ok[k] = false;
+    }
+    
+    const SpotBatch* batches = nullptr;
+    int num_batches = spot_batch_requests(symbols, n, &batches);
+    if (num_batches == 0) {
+        return 0;
+    }
+    
+    DEBUG_PRINTF("[BINANCE] Fetching %d spot prices in %d request(s)...\n", n, num_batches);
+    
+    int found = 0;
+    char body[SPOT_BATCH_BODY_MAX];
+    for (int b = 0; b < num_batches; b++) {
+        const SpotBatch& batch = batches[b];
+        size_t body_len = 0;
+        if (!http_transport_request_buf(&batch.request, body, sizeof(body), &body_len, 10000)) {
+            DEBUG_PRINTLN("[BINANCE] HTTP request failed");
+            continue;
+        }
+        found += parse_spot_batch(body, body_len, symbols + batch.first, batch.count,
+                                  out_prices + batch.first, out_ok + batch.first);
+    }
+    return found;
+}
+
+bool fetch_spot(const char* symbol, Fixed* out_price) {
     if (!symbol || !out_price) {
         DEBUG_PRINTLN("[BINANCE] ERROR: Invalid parameters");
         return false;
     }
     
-    // Build URL
-    char url[128];
-    snprintf(url, sizeof(url), "%s/api/v3/ticker/price?symbol=%s", BINANCE_API_BASE, symbol);
+    const HttpRequest* req = spot_request(symbol);
+    if (!req) {
+        DEBUG_PRINTF("[BINANCE] ERROR: Cannot build request for %s\n", symbol);
+        return false;
+    }
     
     DEBUG_PRINTF("[BINANCE] Fetching spot price for %s...\n", symbol);
     
     // Fetch data
-    String response;
-    if (!http_get(url, response, 10000)) {
+    char body[SPOT_BODY_MAX];
+    size_t body_len = 0;
+    if (!http_transport_request_buf(req, body, sizeof(body), &body_len, 10000)) {
         DEBUG_PRINTLN("[BINANCE] HTTP request failed");
         return false;
     }
     
+    return parse_spot(body, body_len, symbol, out_price);
+}
+
+bool parse_spot(char* body, size_t len, const char* symbol, Fixed* out_price) {
+    if (!body || !symbol || !out_price) {
+        return false;
+    }
+    
+    // Fast path: scan the fixed shape in place, ArduinoJson below on anything unexpected
+    Fixed price;
+    if (json_scan_shape(body, len) == '{' && json_scan_equals(body, len, "symbol", symbol) &&
+        json_scan_fixed_field(body, len, "price", &price) && price > 0) {
+        *out_price = price;
+        DEBUG_PRINTF("[BINANCE] %s spot price: $%.2f\n", symbol, fixed_to_double(price));
+        return true;
+    }
+    
     // Parse JSON response: {"symbol":"BTCUSDT","price":"43250.50"}
-    StaticJsonDocument<256> doc;
-    DeserializationError error = deserializeJson(doc, response);
+    StaticJsonDocument<SPOT_DOC_SIZE> doc;
+    DeserializationError error = deserializeJson(doc, body, len, g_spot_filter.option());
     
     if (error) {
         DEBUG_PRINTF("[BINANCE] JSON parse error: %s\n", error.c_str());
@@ -62,40 +268,474 @@ bool fetch_spot(const char* symbol, double* out_price) {
         return false;
     }
     
-    *out_price = atof(price_str);
+    *out_price = fixed_from_string(price_str);
     
-    if (*out_price <= 0.0) {
+    if (*out_price <= 0) {
         DEBUG_PRINTF("[BINANCE] Invalid price: %s\n", price_str);
         return false;
     }
     
-    DEBUG_PRINTF("[BINANCE] %s spot price: $%.2f\n", symbol, *out_price);
+    DEBUG_PRINTF("[BINANCE] %s spot price: $%.2f\n", symbol, fixed_to_double(*out_price));
+    return true;
+}
+
+const HttpRequest* book_request(const char* symbol) {
+    if (!symbol) {
+        return nullptr;
+    }
+    if (!g_initialized) {
+        init();
+    }
+    return http_request_cache_get(&g_book_requests, symbol);
+}
+
+// Bid/ask of one bookTicker object; false if either side is missing or not positive
+static bool read_book(JsonObject item, BookTicker* out) {
+    const char* bid_str = item["bidPrice"];
+    const char* ask_str = item["askPrice"];
+    if (!bid_str || !ask_str) {
+        return false;
+    }
+    Fixed bid = fixed_from_string(bid_str);
+    Fixed ask = fixed_from_string(ask_str);
+    if (bid <= 0 || ask <= 0) {
+        DEBUG_PRINTF("[BINANCE] Invalid book: bid %s ask %s\n", bid_str, ask_str);
+        return false;
+    }
+    out->bid = bid;
+    out->ask = ask;
+    out->valid = true;
+    return true;
+}
+
+bool parse_book(char* body, size_t len, const char* symbol, BookTicker* out) {
+    if (!body || !symbol || !out) {
+        return false;
+    }
+    out->valid = false;
+    
+    // Parse JSON response:
+    // {"symbol":"BTCUSDT","bidPrice":"43250.49","bidQty":"1.2","askPrice":"43250.50","askQty":"0.8"}
+    StaticJsonDocument<BOOK_DOC_SIZE> doc;
+    DeserializationError error = deserializeJson(doc, body, len, g_book_filter.option());
+    
+    if (error) {
+        DEBUG_PRINTF("[BINANCE] JSON parse error: %s\n", error.c_str());
+        return false;
+    }
+    
+    const char* resp_symbol = doc["symbol"];
+    if (!resp_symbol || strcmp(resp_symbol, symbol) != 0) {
+        DEBUG_PRINTF("[BINANCE] Symbol mismatch: expected %s, got %s\n", symbol,
+                     resp_symbol ? resp_symbol : "(none)");
+        return false;
+    }
+    
+    if (!read_book(doc.as<JsonObject>(), out)) {
+        DEBUG_PRINTLN("[BINANCE] Missing bid/ask in book ticker");
+        return false;
+    }
+    
+    DEBUG_PRINTF("[BINANCE] %s bid $%.2f ask $%.2f\n", symbol,
+                 fixed_to_double(out->bid), fixed_to_double(out->ask));
+    return true;
+}
+
+bool fetch_book(const char* symbol, BookTicker* out) {
+    if (!symbol || !out) {
+        DEBUG_PRINTLN("[BINANCE] ERROR: Invalid parameters");
+        return false;
+    }
+    out->valid = false;
+    
+    const HttpRequest* req = book_request(symbol);
+    if (!req) {
+        DEBUG_PRINTF("[BINANCE] ERROR: Cannot build book request for %s\n", symbol);
+        return false;
+    }
+    
+    DEBUG_PRINTF("[BINANCE] Fetching book ticker for %s...\n", symbol);
+    
+    char body[BOOK_BODY_MAX];
+    size_t body_len = 0;
+    if (!http_transport_request_buf(req, body, sizeof(body), &body_len, 10000)) {
+        DEBUG_PRINTLN("[BINANCE] HTTP request failed");
+        return false;
+    }
+    
+    return parse_book(body, body_len, symbol, out);
+}
+
+int book_batch_requests(const char* const* symbols, int n, const SpotBatch** out_batches) {
+    if (!symbols || n <= 0 || n > 255 || !out_batches) {
+        return 0;
+    }
+    if (!g_initialized) {
+        init();
+    }
+    return http_request_batches(&g_book_batches, symbols, n, out_batches);
+}
+
+int parse_book_batch(char* body, size_t len, const char* const* symbols, int n, BookTicker* out) {
+    if (!body || !symbols || !out || n <= 0) {
+        return 0;
+    }
+    for (int k = 0; k < n; k++) {
+        out[k].valid = false;
+    }
+    
+    // Parse JSON response: [{"symbol":"BTCUSDT","bidPrice":"...","bidQty":"...","askPrice":"...","askQty":"..."},...]
+    StaticJsonDocument<BOOK_BATCH_DOC_SIZE> doc;
+    DeserializationError error = deserializeJson(doc, body, len, g_book_batch_filter.option());
+    
+    if (error) {
+        DEBUG_PRINTF("[BINANCE] JSON parse error: %s\n", error.c_str());
+        return 0;
+    }
+    
+    if (!doc.is<JsonArray>()) {
+        DEBUG_PRINTLN("[BINANCE] Batch response is not an array");
+        return 0;
+    }
+    
+    // Single pass over the response, scattering each book to its symbol
+    int found = 0;
+    for (JsonObject item : doc.as<JsonArray>()) {
+        const char* resp_symbol = item["symbol"];
+        if (!resp_symbol) {
+            continue;
+        }
+        for (int k = 0; k < n; k++) {
+            if (out[k].valid || !symbols[k] || strcmp(symbols[k], resp_symbol) != 0) {
+                continue;
+            }
+            if (read_book(item, &out[k])) {
+                found++;
+            }
+            break;
+        }
+    }
+    
+    if (found < n) {
+        DEBUG_PRINTF("[BINANCE] Batch response had %d of %d books\n", found, n);
+    }
+    return found;
+}
+
+int fetch_book_batch(const char* const* symbols, int n, BookTicker* out) {
+    if (!symbols || !out || n <= 0) {
+        DEBUG_PRINTLN("[BINANCE] ERROR: Invalid parameters");
+        return 0;
+    }
+    for (int k = 0; k < n; k++) {
+        out[k].valid = false;
+    }
+    
+    const SpotBatch* batches = nullptr;
+    int num_batches = book_batch_requests(symbols, n, &batches);
+    if (num_batches == 0) {
+        return 0;
+    }
+    
+    DEBUG_PRINTF("[BINANCE] Fetching %d book tickers in %d request(s)...\n", n, num_batches);
+    
+    int found = 0;
+    char body[BOOK_BATCH_BODY_MAX];
+    for (int b = 0; b < num_batches; b++) {
+        const SpotBatch& batch = batches[b];
+        size_t body_len = 0;
+        if (!http_transport_request_buf(&batch.request, body, sizeof(body), &body_len, 10000)) {
+            DEBUG_PRINTLN("[BINANCE] HTTP request failed");
+            continue;
+        }
+        found += parse_book_batch(body, body_len, symbols + batch.first, batch.count, out + batch.first);
+    }
+    return found;
+}
+
+// /stream?streams=<symbol><suffix>/<symbol><suffix>/... (stream names are lowercase)
+static bool combined_stream_path(const char* const* symbols, int n, const char* suffix,
+                                 char* out, size_t cap) {
+    if (!symbols || n <= 0 || !out || cap == 0) {
+        return false;
+    }
+    static const char* PREFIX = "/stream?streams=";
+    size_t suffix_len = strlen(suffix);
+    size_t pos = strlen(PREFIX);
+    if (pos >= cap) {
+        return false;
+    }
+    memcpy(out, PREFIX, pos);
+    for (int k = 0; k < n; k++) {
+        if (!symbols[k] || !symbols[k][0]) {
+            return false;
+        }
+        size_t need = (k > 0 ? 1 : 0) + strlen(symbols[k]) + suffix_len;
+        if (pos + need >= cap) {
+            DEBUG_PRINTF("[BINANCE] Stream path too long for %d symbols\n", n);
+            return false;
+        }
+        if (k > 0) {
+            out[pos++] = '/';
+        }
+        for (const char* c = symbols[k]; *c; c++) {
+            out[pos++] = (char)tolower((unsigned char)*c);
+        }
+        memcpy(out + pos, suffix, suffix_len);
+        pos += suffix_len;
+    }
+    out[pos] = '\0';
+    return true;
+}
+
+bool book_stream_path(const char* const* symbols, int n, char* out, size_t cap) {
+    return combined_stream_path(symbols, n, "@bookTicker", out, cap);
+}
+
+int parse_book_stream(char* msg, size_t len, const char* const* symbols, int n, BookTicker* out) {
+    if (!msg || !symbols || n <= 0 || !out) {
+        return -1;
+    }
+    out->valid = false;
+    
+    StaticJsonDocument<BOOK_STREAM_DOC_SIZE> doc;
+    DeserializationError error = deserializeJson(doc, msg, len, g_book_stream_filter.option());
+    if (error) {
+        DEBUG_PRINTF("[BINANCE] Stream JSON parse error: %s\n", error.c_str());
+        return -1;
+    }
+    
+    JsonObject data = doc["data"];
+    const char* resp_symbol = data["s"];
+    const char* bid_str = data["b"];
+    const char* ask_str = data["a"];
+    if (!resp_symbol || !bid_str || !ask_str) {
+        return -1;  // Subscription reply or another event type
+    }
+    
+    for (int k = 0; k < n; k++) {
+        if (!symbols[k] || strcmp(symbols[k], resp_symbol) != 0) {
+            continue;
+        }
+        Fixed bid = fixed_from_string(bid_str);
+        Fixed ask = fixed_from_string(ask_str);
+        if (bid <= 0 || ask <= 0) {
+            DEBUG_PRINTF("[BINANCE] Invalid streamed book: bid %s ask %s\n", bid_str, ask_str);
+            return -1;
+        }
+        out->bid = bid;
+        out->ask = ask;
+        out->valid = true;
+        return k;
+    }
+    return -1;
+}
+
+bool mark_stream_path(const char* const* symbols, int n, char* out, size_t cap) {
+    return combined_stream_path(symbols, n, "@markPrice@1s", out, cap);
+}
+
+int parse_mark_stream(char* msg, size_t len, const char* const* symbols, int n, PremiumIndex* out) {
+    if (!msg || !symbols || n <= 0 || !out) {
+        return -1;
+    }
+    out->valid = false;
+    
+    StaticJsonDocument<MARK_STREAM_DOC_SIZE> doc;
+    DeserializationError error = deserializeJson(doc, msg, len, g_mark_stream_filter.option());
+    if (error) {
+        DEBUG_PRINTF("[BINANCE] Stream JSON parse error: %s\n", error.c_str());
+        return -1;
+    }
+    
+    JsonObject data = doc["data"];
+    const char* resp_symbol = data["s"];
+    const char* mark_str = data["p"];
+    const char* rate_str = data["r"];
+    if (!resp_symbol || !mark_str || !rate_str) {
+        return -1;  // Subscription reply or another event type
+    }
+    
+    for (int k = 0; k < n; k++) {
+        if (!symbols[k] || strcmp(symbols[k], resp_symbol) != 0) {
+            continue;
+        }
+        Fixed mark = fixed_from_string(mark_str);
+        if (mark <= 0) {
+            DEBUG_PRINTF("[BINANCE] Invalid streamed mark price: %s\n", mark_str);
+            return -1;
+        }
+        const char* index_str = data["i"];
+        out->mark_price = mark;
+        out->index_price = index_str ? fixed_from_string(index_str) : 0;
+        out->funding_rate = fixed_from_string(rate_str);
+        out->next_funding_ms = data["T"] | (uint64_t)0;
+        out->server_time_ms = data["E"] | (uint64_t)0;
+        out->valid = true;
+        return k;
+    }
+    return -1;
+}
+
+// Streaming filter state for fetch_premium_index()
+struct PremiumIndexScan {
+    JsonStreamParser parser;
+    const char* const* symbols;
+    int n;
+    PremiumIndex* out;
+    int found;
+    
+    // Array entry being parsed
+    PremiumIndex entry;
+    int match;                      // Index into symbols, -1 if not wanted
+};
+
+static bool premium_index_token(const JsonStreamToken* tok, void* ctx) {
+    PremiumIndexScan* scan = static_cast<PremiumIndexScan*>(ctx);
+    
+    // Entries are the objects of the top level array
+    if (tok->depth == 1 && tok->event == JSON_EVENT_OBJECT_START) {
+        memset(&scan->entry, 0, sizeof(scan->entry));
+        scan->match = -1;
+        return true;
+    }
+    if (tok->depth == 1 && tok->event == JSON_EVENT_OBJECT_END) {
+        if (scan->match >= 0 && !scan->out[scan->match].valid && scan->entry.mark_price > 0) {
+            scan->entry.valid = true;
+            scan->out[scan->match] = scan->entry;
+            scan->found++;
+        }
+        return true;
+    }
+    if (tok->depth != 2 || tok->event != JSON_EVENT_VALUE || !tok->key) {
+        return true;
+    }
+    
+    // {"symbol":"BTCUSDT","markPrice":"43260.1","indexPrice":"43255.4",
+    //  "lastFundingRate":"0.00010000","nextFundingTime":1597392000000,"time":1597370495002,...}
+    const char* key = tok->key;
+    if (strcmp(key, "symbol") == 0) {
+        for (int k = 0; k < scan->n; k++) {
+            if (scan->symbols[k] && strcmp(scan->symbols[k], tok->value) == 0) {
+                scan->match = k;
+                break;
+            }
+        }
+    } else if (strcmp(key, "markPrice") == 0) {
+        scan->entry.mark_price = fixed_from_string(tok->value);
+    } else if (strcmp(key, "indexPrice") == 0) {
+        scan->entry.index_price = fixed_from_string(tok->value);
+    } else if (strcmp(key, "lastFundingRate") == 0) {
+        scan->entry.funding_rate = fixed_from_string(tok->value);
+    } else if (strcmp(key, "nextFundingTime") == 0) {
+        scan->entry.next_funding_ms = strtoull(tok->value, nullptr, 10);
+    } else if (strcmp(key, "time") == 0) {
+        scan->entry.server_time_ms = strtoull(tok->value, nullptr, 10);
+    }
     return true;
 }
 
-bool fetch_funding(const char* symbol, double* out_rate) {
+static bool premium_index_chunk(const uint8_t* data, size_t len, void* ctx) {
+    PremiumIndexScan* scan = static_cast<PremiumIndexScan*>(ctx);
+    return json_stream_feed(&scan->parser, (const char*)data, len);
+}
+
+int fetch_premium_index(const char* const* symbols, int n, PremiumIndex* out) {
+    if (!symbols || !out || n <= 0) {
+        DEBUG_PRINTLN("[BINANCE] ERROR: Invalid parameters for premium index");
+        return 0;
+    }
+    for (int k = 0; k < n; k++) {
+        memset(&out[k], 0, sizeof(out[k]));
+    }
+    
+    if (!g_initialized) {
+        init();
+    }
+    HttpTransport* transport = http_transport_get();
+    if (!transport || g_premium_request.len == 0) {
+        DEBUG_PRINTLN("[BINANCE] ERROR: Cannot send premium index request");
+        return 0;
+    }
+    
+    DEBUG_PRINTF("[BINANCE] Fetching premium index for %d symbols...\n", n);
+    
+    PremiumIndexScan scan;
+    scan.symbols = symbols;
+    scan.n = n;
+    scan.out = out;
+    scan.found = 0;
+    scan.match = -1;
+    json_stream_init(&scan.parser, premium_index_token, &scan);
+    
+    bool ok = transport->request(&g_premium_request, premium_index_chunk, &scan, 15000);
+    if (!ok || !json_stream_done(&scan.parser)) {
+        DEBUG_PRINTF("[BINANCE] Premium index request failed (%s after %lu bytes)\n",
+                     json_stream_failed(&scan.parser) ? "malformed" : "incomplete",
+                     (unsigned long)scan.parser.bytes);
+        for (int k = 0; k < n; k++) {
+            out[k].valid = false;
+        }
+        return 0;
+    }
+    
+    for (int k = 0; k < n; k++) {
+        if (out[k].valid) {
+            DEBUG_PRINTF("[BINANCE] %s funding %.4f%%, mark $%.2f, index $%.2f\n", symbols[k],
+                         fixed_to_double(out[k].funding_rate) * 100.0,
+                         fixed_to_double(out[k].mark_price), fixed_to_double(out[k].index_price));
+        } else {
+            DEBUG_PRINTF("[BINANCE] %s not in premium index\n", symbols[k] ? symbols[k] : "(null)");
+        }
+    }
+    return scan.found;
+}
+
+bool fetch_funding(const char* symbol, Fixed* out_rate) {
     if (!symbol || !out_rate) {
         DEBUG_PRINTLN("[BINANCE] ERROR: Invalid parameters for funding rate");
         return false;
     }
     
-    // Build URL for futures API
-    char url[128];
-    snprintf(url, sizeof(url), "%s/fapi/v1/fundingRate?symbol=%s&limit=1", BINANCE_FAPI_BASE, symbol);
+    if (!g_initialized) {
+        init();
+    }
+    const HttpRequest* req = http_request_cache_get(&g_funding_requests, symbol);
+    if (!req) {
+        DEBUG_PRINTF("[BINANCE] ERROR: Cannot build funding request for %s\n", symbol);
+        return false;
+    }
     
     DEBUG_PRINTF("[BINANCE] Fetching funding rate for %s...\n", symbol);
     
     // Fetch data
-    String response;
-    if (!http_get(url, response, 10000)) {
+    char body[512];
+    size_t body_len = 0;
+    if (!http_transport_request_buf(req, body, sizeof(body), &body_len, 10000)) {
         DEBUG_PRINTLN("[BINANCE] HTTP request failed");
         return false;
     }
     
+    return parse_funding(body, body_len, symbol, out_rate);
+}
+
+bool parse_funding(char* body, size_t len, const char* symbol, Fixed* out_rate) {
+    if (!body || !symbol || !out_rate) {
+        return false;
+    }
+    
+    // Fast path: scan the fixed shape in place, ArduinoJson below on anything unexpected
+    if (json_scan_shape(body, len) == '[' &&
+        json_scan_equals(body, len, "symbol", symbol) &&
+        json_scan_fixed_field(body, len, "fundingRate", out_rate)) {
+        DEBUG_PRINTF("[BINANCE] %s funding rate: %.4f%%\n", symbol, fixed_to_double(*out_rate) * 100.0);
+        return true;
+    }
+    
     // Parse JSON response: [{"symbol":"BTCUSDT","fundingRate":"0.00010000","fundingTime":1609459200000}]
     // Response is an array with most recent funding rate first
-    StaticJsonDocument<512> doc;
-    DeserializationError error = deserializeJson(doc, response);
+    StaticJsonDocument<FUNDING_DOC_SIZE> doc;
+    DeserializationError error = deserializeJson(doc, body, len, g_funding_filter.option());
     
     if (error) {
         DEBUG_PRINTF("[BINANCE] JSON parse error: %s\n", error.c_str());
@@ -139,16 +779,16 @@ bool fetch_funding(const char* symbol, double* out_rate) {
         return false;
     }
     
-    *out_rate = atof(rate_str);
+    *out_rate = fixed_from_string(rate_str);
     
     // Funding rate can be negative, so we don't check for <= 0
     // Just validate it's a reasonable value (typically between -1% and +1%)
-    if (*out_rate < -0.01 || *out_rate > 0.01) {
-        DEBUG_PRINTF("[BINANCE] WARNING: Unusual funding rate: %s (%.6f)\n", rate_str, *out_rate);
+    if (fixed_abs(*out_rate) > FIXED_SCALE / 100) {
+        DEBUG_PRINTF("[BINANCE] WARNING: Unusual funding rate: %s\n", rate_str);
         // Still return true as this is a valid (if unusual) rate
     }
     
-    DEBUG_PRINTF("[BINANCE] %s funding rate: %.4f%% (%s)\n", symbol, *out_rate * 100.0, rate_str);
+    DEBUG_PRINTF("[BINANCE] %s funding rate: %s\n", symbol, rate_str);
     return true;
 }
 
@@ -1,21 +1,161 @@
 #ifndef NET_BINANCE_H
 #define NET_BINANCE_H
 
+#ifdef ARDUINO
 #include <Arduino.h>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#endif
+#include "net_endpoint.h"
+#include "../app/app_fixed.h"
 
 // Binance API integration (Task 6.1, 6.3)
 // Fetches spot prices and funding rates from Binance REST API
 
 namespace net_binance {
+    // Resolve API endpoints (called from scheduler_init, or lazily on first fetch)
+    // Requests per symbol are rendered once and reused (see net_endpoint.h)
+    void init();
+    
+    // Largest spot ticker body accepted (bytes, incl. NUL)
+    const size_t SPOT_BODY_MAX = 256;
+    
+    // Pre-rendered spot ticker request for a symbol (for http_async_submit)
+    // Returns nullptr if the symbol is invalid
+    const HttpRequest* spot_request(const char* symbol);
+    
+    // Parse a spot ticker body (parsed in place, body is modified)
+    // Returns: true with price in out_price if valid and the symbol matches
+    bool parse_spot(char* body, size_t len, const char* symbol, Fixed* out_price);
+    
+    // Largest batched ticker body accepted (bytes, incl. NUL)
+    const size_t SPOT_BATCH_BODY_MAX = 768;
+    
+    // Batched requests kept at most (a long symbol list is split so each
+    // request fits in HTTP_REQUEST_MAX; the default 3 symbols need one)
+    const int SPOT_BATCH_MAX_REQUESTS = 4;
+    
+    // One batched ticker request and the symbols it covers
+    typedef HttpRequestBatch SpotBatch;
+    
+    // Pre-rendered batched ticker requests covering symbols[0..n)
+    // Uses: /api/v3/ticker/price?symbols=["BTCUSDT","ETHUSDT",...]
+    // Requests are rendered again only when the symbol list changes; they
+    // stay valid until the next call with a different list.
+    // Returns: number of requests in *out_batches, 0 on error
+    int spot_batch_requests(const char* const* symbols, int n, const SpotBatch** out_batches);
+    
+    // Parse a batched ticker body (parsed in place, body is modified)
+    // Each array entry is matched to symbols[0..n) and its price scattered
+    // into out_prices/out_ok in one pass; symbols missing from the body
+    // are left with out_ok = false
+    // Returns: number of symbols with a valid price
+    int parse_spot_batch(char* body, size_t len, const char* const* symbols, int n,
+                         Fixed* out_prices, bool* out_ok);
+    
+    // Fetch spot prices for symbols[0..n) with as few requests as possible
+    // Returns: number of symbols with a valid price (out_ok per symbol)
+    int fetch_spot_batch(const char* const* symbols, int n, Fixed* out_prices, bool* out_ok);
+    
     // Fetch spot price for a symbol (e.g., "BTCUSDT")
     // Uses: https://api.binance.com/api/v3/ticker/price?symbol=BTCUSDT
     // Returns: true on success with price in out_price, false on any error
-    bool fetch_spot(const char* symbol, double* out_price);
+    bool fetch_spot(const char* symbol, Fixed* out_price);
+    
+    // Best bid/ask of one symbol (bookTicker entry)
+    struct BookTicker {
+        Fixed bid;
+        Fixed ask;
+        bool valid;
+    };
+    
+    // Largest book ticker body accepted (bytes, incl. NUL)
+    const size_t BOOK_BODY_MAX = 384;
+    
+    // Largest batched book ticker body accepted (bytes, incl. NUL)
+    // Entries carry bid/ask quantities too, ~2x a price ticker entry
+    const size_t BOOK_BATCH_BODY_MAX = 1024;
+    
+    // Pre-rendered book ticker request for a symbol (for http_async_submit)
+    // Returns nullptr if the symbol is invalid
+    const HttpRequest* book_request(const char* symbol);
+    
+    // Parse a book ticker body (parsed in place, body is modified)
+    // Returns: true with bid/ask in out if both are positive and the symbol matches
+    bool parse_book(char* body, size_t len, const char* symbol, BookTicker* out);
+    
+    // Fetch best bid/ask for a symbol
+    // Uses: https://api.binance.com/api/v3/ticker/bookTicker?symbol=BTCUSDT
+    bool fetch_book(const char* symbol, BookTicker* out);
+    
+    // Pre-rendered batched book ticker requests covering symbols[0..n)
+    // Uses: /api/v3/ticker/bookTicker?symbols=["BTCUSDT","ETHUSDT",...]
+    // Split and cached the same way as spot_batch_requests()
+    int book_batch_requests(const char* const* symbols, int n, const SpotBatch** out_batches);
+    
+    // Parse a batched book ticker body in one pass (see parse_spot_batch)
+    // Returns: number of symbols with a valid book (out[k].valid per symbol)
+    int parse_book_batch(char* body, size_t len, const char* const* symbols, int n, BookTicker* out);
+    
+    // Fetch best bid/ask for symbols[0..n) with as few requests as possible
+    // Returns: number of symbols with a valid book
+    int fetch_book_batch(const char* const* symbols, int n, BookTicker* out);
+    
+    // Spot market-data stream (wss only)
+    const char* const BOOK_STREAM_URL = "wss://stream.binance.com:9443";
+    
+    // Combined stream path for the book tickers of symbols[0..n)
+    // e.g. /stream?streams=btcusdt@bookTicker/ethusdt@bookTicker
+    // Returns: false if a symbol is missing or the path does not fit in cap
+    bool book_stream_path(const char* const* symbols, int n, char* out, size_t cap);
+    
+    // Parse one combined-stream bookTicker message (parsed in place, msg is modified)
+    // {"stream":"btcusdt@bookTicker","data":{"u":1,"s":"BTCUSDT","b":"..","B":"..","a":"..","A":".."}}
+    // Returns: index into symbols[0..n) with its book in *out, -1 if unknown or invalid
+    int parse_book_stream(char* msg, size_t len, const char* const* symbols, int n, BookTicker* out);
+    
+    // Funding and mark data of one perpetual (premiumIndex entry)
+    struct PremiumIndex {
+        Fixed funding_rate;        // lastFundingRate: current rate, settled at next_funding_ms
+        Fixed mark_price;
+        Fixed index_price;
+        uint64_t next_funding_ms;   // Unix epoch ms
+        uint64_t server_time_ms;    // Exchange clock when the entry was produced (0 if absent)
+        bool valid;
+    };
+    
+    // Fetch funding rate, mark/index price and next funding time for
+    // symbols[0..n) with a single request covering every perpetual
+    // Uses: https://fapi.binance.com/fapi/v1/premiumIndex
+    // The response is tokenized as it streams in and only the entries of
+    // the wanted symbols are kept, so it is never buffered whole.
+    // Returns: number of symbols found (out[k].valid per symbol)
+    int fetch_premium_index(const char* const* symbols, int n, PremiumIndex* out);
+    
+    // Futures market-data stream (wss only)
+    const char* const MARK_STREAM_URL = "wss://fstream.binance.com";
+    
+    // Combined stream path for the 1 s mark price updates of symbols[0..n)
+    // e.g. /stream?streams=btcusdt@markPrice@1s/ethusdt@markPrice@1s
+    // Returns: false if a symbol is missing or the path does not fit in cap
+    bool mark_stream_path(const char* const* symbols, int n, char* out, size_t cap);
+    
+    // Parse one combined-stream markPriceUpdate message (parsed in place, msg is modified)
+    // {"stream":"btcusdt@markPrice@1s","data":{"e":"markPriceUpdate","E":1562305380000,
+    //  "s":"BTCUSDT","p":"..","i":"..","P":"..","r":"0.00038167","T":1562306400000}}
+    // funding_rate is the predicted rate of the current period (r)
+    // Returns: index into symbols[0..n) with its data in *out, -1 if unknown or invalid
+    int parse_mark_stream(char* msg, size_t len, const char* const* symbols, int n, PremiumIndex* out);
     
     // Fetch current funding rate for perpetual futures (e.g., "BTCUSDT")
     // Uses: https://fapi.binance.com/fapi/v1/fundingRate?symbol=BTCUSDT&limit=1
     // Returns: true on success with rate in out_rate, false on any error
-    bool fetch_funding(const char* symbol, double* out_rate);
+    bool fetch_funding(const char* symbol, Fixed* out_rate);
+    
+    // Parse a funding rate body (parsed in place, body is modified)
+    // Returns: true with the most recent rate in out_rate if the symbol matches
+    bool parse_funding(char* body, size_t len, const char* symbol, Fixed* out_rate);
 }
 
 #endif // NET_BINANCE_H
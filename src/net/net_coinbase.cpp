@@ -1,42 +1,123 @@
 #include "net_coinbase.h"
 #include "../config.h"
-#include "net_http.h"
+#include "net_dns.h"
+#include "net_json_filter.h"
+#include "net_json_scan.h"
+#include "net_transport.h"
 #include <ArduinoJson.h>
+#include <stdio.h>
+#include <string.h>
 
 // Coinbase API base URL - use HTTP or HTTPS based on config
 #if ENABLE_HTTPS
-static const char* COINBASE_API_BASE = "https://api.coinbase.com/v2/prices/";
+static const char* COINBASE_API_BASE = "https://api.coinbase.com";
+static const char* COINBASE_EXCHANGE_BASE = "https://api.exchange.coinbase.com";
 #else
-static const char* COINBASE_API_BASE = "http://api.coinbase.com/v2/prices/";
+static const char* COINBASE_API_BASE = "http://api.coinbase.com";
+static const char* COINBASE_EXCHANGE_BASE = "http://api.exchange.coinbase.com";
 #endif
 
 namespace net_coinbase {
 
-bool fetch_spot(const char* product, double* out_price) {
+// Response fields read by the parsers; everything else is dropped while parsing
+static JsonFilter<2 * JSON_OBJECT_SIZE(1) + 16> g_spot_filter("{\"data\":{\"amount\":true}}");
+static JsonFilter<JSON_OBJECT_SIZE(3) + 16> g_ticker_filter("{\"bid\":true,\"ask\":true,\"price\":true}");
+static JsonFilter<JSON_OBJECT_SIZE(7) + 64> g_ticker_stream_filter(
+    "{\"type\":true,\"message\":true,\"product_id\":true,\"price\":true,"
+    "\"best_bid\":true,\"best_ask\":true,\"sequence\":true}");
+
+// Filtered documents: members only (bodies are parsed in place, strings are not copied)
+static const size_t SPOT_DOC_SIZE = 2 * JSON_OBJECT_SIZE(1);
+static const size_t TICKER_DOC_SIZE = JSON_OBJECT_SIZE(3);
+static const size_t TICKER_STREAM_DOC_SIZE = JSON_OBJECT_SIZE(7);
+
+// Endpoints resolved once in init(); requests rendered once per product
+static HttpEndpoint g_spot_endpoint;
+static HttpEndpoint g_ticker_endpoint;
+static HttpEndpoint g_rates_endpoint;
+static HttpRequestCache g_spot_requests;
+static HttpRequestCache g_rates_requests;
+static HttpRequestCache g_ticker_requests;
+static bool g_initialized = false;
+
+void init() {
+    http_endpoint_init(&g_spot_endpoint, COINBASE_API_BASE, "/v2/prices/" HTTP_PATH_ARG "/spot");
+    http_endpoint_init(&g_ticker_endpoint, COINBASE_EXCHANGE_BASE, "/products/" HTTP_PATH_ARG "/ticker");
+    http_endpoint_init(&g_rates_endpoint, COINBASE_API_BASE, "/v2/exchange-rates?currency=" HTTP_PATH_ARG);
+    http_request_cache_init(&g_spot_requests, &g_spot_endpoint);
+    http_request_cache_init(&g_rates_requests, &g_rates_endpoint);
+    http_request_cache_init(&g_ticker_requests, &g_ticker_endpoint);
+    dns_register(g_spot_endpoint.host);
+    dns_register(g_ticker_endpoint.host);
+    g_initialized = true;
+}
+
+const HttpRequest* spot_request(const char* product) {
+    if (!product) {
+        return nullptr;
+    }
+    // Request: GET /v2/prices/BTC-USD/spot (rendered on first use)
+    if (!g_initialized) {
+        init();
+    }
+    return http_request_cache_get(&g_spot_requests, product);
+}
+
+bool fetch_spot(const char* product, Fixed* out_price) {
     if (!product || !out_price) {
         DEBUG_PRINTLN("[COINBASE] Invalid parameters");
         return false;
     }
 
-    // Build URL: https://api.coinbase.com/v2/prices/BTC-USD/spot
-    String url = String(COINBASE_API_BASE) + product + "/spot";
+    const HttpRequest* req = spot_request(product);
+    if (!req) {
+        DEBUG_PRINTLN("[COINBASE] Cannot build request");
+        return false;
+    }
     
     DEBUG_PRINT("[COINBASE] Fetching spot for ");
-    DEBUG_PRINT(product);
-    DEBUG_PRINT(" from ");
-    DEBUG_PRINTLN(url);
+    DEBUG_PRINTLN(product);
 
     // Make HTTP GET request
-    String response;
-    if (!http_get(url.c_str(), response, 10000)) {
+    char body[SPOT_BODY_MAX];
+    size_t body_len = 0;
+    if (!http_transport_request_buf(req, body, sizeof(body), &body_len, 10000)) {
         DEBUG_PRINTLN("[COINBASE] HTTP request failed");
         return false;
     }
 
+    return parse_spot(body, body_len, product, out_price);
+}
+
+// True if data.base and data.currency of a spot body spell product ("BTC-USD")
+static bool scan_spot_product(const char* body, size_t len, const char* product) {
+    const char* dash = strchr(product, '-');
+    size_t base_len, currency_len;
+    const char* base = json_scan_string(body, len, "base", &base_len);
+    const char* currency = json_scan_string(body, len, "currency", &currency_len);
+    return dash && base && currency &&
+           base_len == (size_t)(dash - product) && memcmp(base, product, base_len) == 0 &&
+           currency_len == strlen(dash + 1) && memcmp(currency, dash + 1, currency_len) == 0;
+}
+
+bool parse_spot(char* body, size_t len, const char* product, Fixed* out_price) {
+    if (!body || !product || !out_price) {
+        return false;
+    }
+
+    // Fast path: scan the fixed shape in place, ArduinoJson below on anything unexpected
+    Fixed amount;
+    if (json_scan_shape(body, len) == '{' && scan_spot_product(body, len, product) &&
+        json_scan_fixed_field(body, len, "amount", &amount) && amount > 0) {
+        *out_price = amount;
+        DEBUG_PRINTF("[COINBASE] SUCCESS: %s = $%.2f\n", product, fixed_to_double(amount));
+        return true;
+    }
+
     // Parse JSON response
     // Expected format: {"data":{"base":"BTC","USD","amount":"43250.50"}}
-    StaticJsonDocument<256> doc;
-    DeserializationError error = deserializeJson(doc, response);
+    StaticJsonDocument<SPOT_DOC_SIZE> doc;
+    DeserializationError error = deserializeJson(doc, body, len, g_spot_filter.option());
     
     if (error) {
         DEBUG_PRINT("[COINBASE] JSON parse failed: ");
@@ -56,19 +137,19 @@ bool fetch_spot(const char* product, double* out_price) {
         return false;
     }
 
-    // Extract price as string, then convert to double
+    // Extract price as string, then convert to fixed point
     const char* amount_str = data["amount"];
     if (!amount_str) {
         DEBUG_PRINTLN("[COINBASE] Invalid 'amount' field");
         return false;
     }
 
-    double price = atof(amount_str);
+    Fixed price = fixed_from_string(amount_str);
     
     // Validate price is positive
-    if (price <= 0.0) {
+    if (price <= 0) {
         DEBUG_PRINT("[COINBASE] Invalid price: ");
-        DEBUG_PRINTLN(price, 2);
+        DEBUG_PRINTLN(amount_str);
         return false;
     }
 
@@ -77,9 +158,320 @@ bool fetch_spot(const char* product, double* out_price) {
     DEBUG_PRINT("[COINBASE] SUCCESS: ");
     DEBUG_PRINT(product);
     DEBUG_PRINT(" = $");
-    DEBUG_PRINTLN(price, 2);
+    DEBUG_PRINTLN(amount_str);
+    
+    return true;
+}
+
+const HttpRequest* spot_rates_request(const char* currency) {
+    if (!currency) {
+        return nullptr;
+    }
+    // Request: GET /v2/exchange-rates?currency=USD (rendered on first use)
+    if (!g_initialized) {
+        init();
+    }
+    return http_request_cache_get(&g_rates_requests, currency);
+}
+
+// Split "BTC-USD" at the dash; base points into product, base_len excludes the dash
+static bool split_product(const char* product, size_t* base_len, const char** quote) {
+    const char* dash = product ? strchr(product, '-') : nullptr;
+    if (!dash || dash == product || !dash[1]) {
+        return false;
+    }
+    *base_len = (size_t)(dash - product);
+    *quote = dash + 1;
+    return true;
+}
+
+static bool spot_rates_token(const JsonStreamToken* tok, void* ctx) {
+    SpotRatesScan* scan = static_cast<SpotRatesScan*>(ctx);
+    
+    // {"data":{"currency":"USD","rates":{"BTC":"0.0000231207",...}}}
+    if (tok->depth == 2 && tok->key && strcmp(tok->key, "rates") == 0) {
+        if (tok->event == JSON_EVENT_OBJECT_START) {
+            scan->in_rates = true;
+        } else if (tok->event == JSON_EVENT_OBJECT_END) {
+            scan->in_rates = false;
+        }
+        return true;
+    }
+    if (tok->event != JSON_EVENT_VALUE || !tok->key) {
+        return true;
+    }
+    if (tok->depth == 2 && strcmp(tok->key, "currency") == 0) {
+        scan->currency_ok = strcmp(tok->value, scan->currency) == 0;
+        return true;
+    }
+    if (!scan->in_rates || tok->depth != 3 || tok->type != JSON_TYPE_STRING) {
+        return true;
+    }
+    
+    // Rate entry: match the asset against the wanted products' base
+    for (int k = 0; k < scan->n; k++) {
+        size_t base_len;
+        const char* quote;
+        if (scan->out_ok[k] || !split_product(scan->products[k], &base_len, &quote)) {
+            continue;
+        }
+        if (strcmp(quote, scan->currency) != 0 || strlen(tok->key) != base_len ||
+            strncmp(tok->key, scan->products[k], base_len) != 0) {
+            continue;
+        }
+        double rate = atof(tok->value);
+        if (rate > 0.0) {
+            scan->out_prices[k] = fixed_from_double(1.0 / rate);
+            scan->out_ok[k] = true;
+            scan->found++;
+        }
+        break;
+    }
+    return true;
+}
+
+bool spot_rates_begin(SpotRatesScan* scan, const char* const* products, int n,
+                      Fixed* out_prices, bool* out_ok) {
+    if (!scan || !products || n <= 0 || !out_prices || !out_ok) {
+        return false;
+    }
+    for (int k = 0; k < n; k++) {
+        out_ok[k] = false;
+    }
+    scan->products = products;
+    scan->n = n;
+    scan->out_prices = out_prices;
+    scan->out_ok = out_ok;
+    scan->found = 0;
+    scan->currency_ok = false;
+    scan->in_rates = false;
+    scan->currency[0] = '\0';
+    json_stream_init(&scan->parser, spot_rates_token, scan);
+    
+    size_t base_len;
+    const char* quote;
+    if (!split_product(products[0], &base_len, &quote) || strlen(quote) >= sizeof(scan->currency)) {
+        return false;
+    }
+    strcpy(scan->currency, quote);
+    return true;
+}
+
+bool spot_rates_chunk(const uint8_t* data, size_t len, void* ctx) {
+    SpotRatesScan* scan = static_cast<SpotRatesScan*>(ctx);
+    return json_stream_feed(&scan->parser, (const char*)data, len);
+}
+
+int spot_rates_finish(SpotRatesScan* scan) {
+    if (!json_stream_done(&scan->parser) || !scan->currency_ok) {
+        DEBUG_PRINTF("[COINBASE] Exchange rates body %s after %lu bytes\n",
+                     json_stream_failed(&scan->parser) ? "malformed"
+                     : json_stream_done(&scan->parser) ? "for another currency" : "incomplete",
+                     (unsigned long)scan->parser.bytes);
+        for (int k = 0; k < scan->n; k++) {
+            scan->out_ok[k] = false;
+        }
+        return 0;
+    }
+    return scan->found;
+}
+
+int fetch_spot_batch(const char* const* products, int n, Fixed* out_prices, bool* out_ok) {
+    SpotRatesScan scan;
+    if (!spot_rates_begin(&scan, products, n, out_prices, out_ok)) {
+        DEBUG_PRINTLN("[COINBASE] Invalid parameters for exchange rates");
+        return 0;
+    }
+    
+    const HttpRequest* req = spot_rates_request(scan.currency);
+    HttpTransport* transport = http_transport_get();
+    if (!req || !transport) {
+        DEBUG_PRINTLN("[COINBASE] Cannot send exchange rates request");
+        return 0;
+    }
+    
+    DEBUG_PRINTF("[COINBASE] Fetching %s exchange rates for %d products...\n", scan.currency, n);
+    if (!transport->request(req, spot_rates_chunk, &scan, 15000)) {
+        DEBUG_PRINTLN("[COINBASE] Exchange rates request failed");
+        for (int k = 0; k < n; k++) {
+            out_ok[k] = false;
+        }
+        return 0;
+    }
     
+    int found = spot_rates_finish(&scan);
+    for (int k = 0; k < n; k++) {
+        if (out_ok[k]) {
+            DEBUG_PRINTF("[COINBASE] %s = $%.2f (exchange rate)\n", products[k],
+                         fixed_to_double(out_prices[k]));
+        } else {
+            DEBUG_PRINTF("[COINBASE] %s not in exchange rates\n", products[k] ? products[k] : "(null)");
+        }
+    }
+    return found;
+}
+
+const HttpRequest* ticker_request(const char* product) {
+    if (!product) {
+        return nullptr;
+    }
+    // Request: GET /products/BTC-USD/ticker on the Exchange API (rendered on first use)
+    if (!g_initialized) {
+        init();
+    }
+    return http_request_cache_get(&g_ticker_requests, product);
+}
+
+bool fetch_ticker(const char* product, Ticker* out) {
+    if (!product || !out) {
+        DEBUG_PRINTLN("[COINBASE] Invalid parameters");
+        return false;
+    }
+    out->valid = false;
+
+    const HttpRequest* req = ticker_request(product);
+    if (!req) {
+        DEBUG_PRINTLN("[COINBASE] Cannot build ticker request");
+        return false;
+    }
+
+    DEBUG_PRINT("[COINBASE] Fetching ticker for ");
+    DEBUG_PRINTLN(product);
+
+    char body[TICKER_BODY_MAX];
+    size_t body_len = 0;
+    if (!http_transport_request_buf(req, body, sizeof(body), &body_len, 10000)) {
+        DEBUG_PRINTLN("[COINBASE] HTTP request failed");
+        return false;
+    }
+
+    return parse_ticker(body, body_len, product, out);
+}
+
+bool parse_ticker(char* body, size_t len, const char* product, Ticker* out) {
+    if (!body || !product || !out) {
+        return false;
+    }
+    out->valid = false;
+
+    // Parse JSON response
+    // Expected format: {"ask":"43250.51","bid":"43250.50","volume":"...","trade_id":...,
+    //                   "price":"43250.50","size":"...","time":"2024-01-01T00:00:00.000000Z"}
+    StaticJsonDocument<TICKER_DOC_SIZE> doc;
+    DeserializationError error = deserializeJson(doc, body, len, g_ticker_filter.option());
+
+    if (error) {
+        DEBUG_PRINT("[COINBASE] JSON parse failed: ");
+        DEBUG_PRINTLN(error.c_str());
+        return false;
+    }
+
+    // Bid and ask as strings, then convert to fixed point
+    const char* bid_str = doc["bid"];
+    const char* ask_str = doc["ask"];
+    if (!bid_str || !ask_str) {
+        DEBUG_PRINTLN("[COINBASE] Missing 'bid'/'ask' fields");
+        return false;
+    }
+
+    Fixed bid = fixed_from_string(bid_str);
+    Fixed ask = fixed_from_string(ask_str);
+    if (bid <= 0 || ask <= 0) {
+        DEBUG_PRINT("[COINBASE] Invalid book: ");
+        DEBUG_PRINT(bid_str);
+        DEBUG_PRINT(" / ");
+        DEBUG_PRINTLN(ask_str);
+        return false;
+    }
+
+    // Last trade price is optional; fall back to the mid
+    const char* price_str = doc["price"];
+    Fixed price = price_str ? fixed_from_string(price_str) : 0;
+
+    out->bid = bid;
+    out->ask = ask;
+    out->price = price > 0 ? price : fixed_mid(bid, ask);
+    out->valid = true;
+    DEBUG_PRINT("[COINBASE] SUCCESS: ");
+    DEBUG_PRINT(product);
+    DEBUG_PRINT(" bid $");
+    DEBUG_PRINT(bid_str);
+    DEBUG_PRINT(" ask $");
+    DEBUG_PRINTLN(ask_str);
+
     return true;
 }
 
+bool ticker_subscribe_message(const char* const* products, int n, char* out, size_t cap) {
+    if (!products || n <= 0 || !out || cap == 0) {
+        return false;
+    }
+    int pos = snprintf(out, cap, "{\"type\":\"subscribe\",\"product_ids\":[");
+    for (int k = 0; k < n && pos > 0 && (size_t)pos < cap; k++) {
+        if (!products[k] || !products[k][0]) {
+            return false;
+        }
+        pos += snprintf(out + pos, cap - pos, "%s\"%s\"", k > 0 ? "," : "", products[k]);
+    }
+    if (pos > 0 && (size_t)pos < cap) {
+        pos += snprintf(out + pos, cap - pos, "],\"channels\":[\"ticker\"]}");
+    }
+    if (pos <= 0 || (size_t)pos >= cap) {
+        DEBUG_PRINTF("[COINBASE] Subscribe message too long for %d products\n", n);
+        return false;
+    }
+    return true;
+}
+
+int parse_ticker_stream(char* msg, size_t len, const char* const* products, int n,
+                        Ticker* out, int64_t* out_sequence) {
+    if (!msg || !products || n <= 0 || !out || !out_sequence) {
+        return -1;
+    }
+    out->valid = false;
+    
+    StaticJsonDocument<TICKER_STREAM_DOC_SIZE> doc;
+    DeserializationError error = deserializeJson(doc, msg, len, g_ticker_stream_filter.option());
+    if (error) {
+        DEBUG_PRINTF("[COINBASE] Stream JSON parse error: %s\n", error.c_str());
+        return -1;
+    }
+    
+    const char* type = doc["type"];
+    if (!type || strcmp(type, "ticker") != 0) {
+        if (type && strcmp(type, "error") == 0) {
+            DEBUG_PRINTF("[COINBASE] Stream error: %s\n", doc["message"] | "?");
+        }
+        return -1;  // Subscription reply, heartbeat or error
+    }
+    
+    const char* product = doc["product_id"];
+    const char* bid_str = doc["best_bid"];
+    const char* ask_str = doc["best_ask"];
+    if (!product || !bid_str || !ask_str) {
+        return -1;
+    }
+    
+    for (int k = 0; k < n; k++) {
+        if (!products[k] || strcmp(products[k], product) != 0) {
+            continue;
+        }
+        Fixed bid = fixed_from_string(bid_str);
+        Fixed ask = fixed_from_string(ask_str);
+        if (bid <= 0 || ask <= 0) {
+            DEBUG_PRINTF("[COINBASE] Invalid streamed book: bid %s ask %s\n", bid_str, ask_str);
+            return -1;
+        }
+        const char* price_str = doc["price"];
+        Fixed price = price_str ? fixed_from_string(price_str) : 0;
+        out->bid = bid;
+        out->ask = ask;
+        out->price = price > 0 ? price : fixed_mid(bid, ask);
+        out->valid = true;
+        *out_sequence = doc["sequence"] | (int64_t)-1;
+        return k;
+    }
+    return -1;
+}
+
 }
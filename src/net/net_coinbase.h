@@ -1,7 +1,15 @@
 #ifndef NET_COINBASE_H
 #define NET_COINBASE_H
 
+#ifdef ARDUINO
 #include <Arduino.h>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#endif
+#include "net_endpoint.h"
+#include "../app/app_fixed.h"
+#include "net_json_stream.h"
 
 /**
  * @file net_coinbase.h
@@ -10,9 +18,41 @@
  * API endpoint: https://api.coinbase.com/v2/prices/{product}/spot
  * Example: https://api.coinbase.com/v2/prices/BTC-USD/spot
  * Response format: {"data":{"base":"BTC","currency":"USD","amount":"43250.50"}}
+ *
+ * Top of book comes from the Exchange API ticker:
+ * https://api.exchange.coinbase.com/products/{product}/ticker
+ * Response format: {"ask":"43250.51","bid":"43250.50","price":"43250.50",...}
+ *
+ * Every asset's rate against one currency in a single response:
+ * https://api.coinbase.com/v2/exchange-rates?currency=USD
+ * Response format: {"data":{"currency":"USD","rates":{"BTC":"0.0000231...",...}}}
+ * (units of the asset per 1 USD, several hundred entries, ~10 KB)
+ *
+ * Streamed top of book comes from the Exchange WebSocket ticker channel:
+ * wss://ws-feed.exchange.coinbase.com, one socket for all products
  */
 
 namespace net_coinbase {
+    /**
+     * @brief Resolve the API endpoint (called from scheduler_init, or lazily)
+     *
+     * Requests per product are rendered once and reused (see net_endpoint.h).
+     */
+    void init();
+    
+    // Largest spot price body accepted (bytes, incl. NUL)
+    const size_t SPOT_BODY_MAX = 256;
+    
+    // Pre-rendered spot request for a product (for http_async_submit)
+    // Returns nullptr if the product id is invalid
+    const HttpRequest* spot_request(const char* product);
+    
+    /**
+     * @brief Parse a spot price body (parsed in place, body is modified)
+     * @return true with price in out_price if data.amount is a positive number
+     */
+    bool parse_spot(char* body, size_t len, const char* product, Fixed* out_price);
+    
     /**
      * @brief Fetch spot price from Coinbase for a given product
      * 
@@ -25,7 +65,104 @@ namespace net_coinbase {
      * - JSON structure (data.amount exists)
      * - Price value (must be positive)
      */
-    bool fetch_spot(const char* product, double* out_price);
+    bool fetch_spot(const char* product, Fixed* out_price);
+    
+    // Pre-rendered exchange-rates request for a quote currency (e.g. "USD")
+    // Returns nullptr if the currency is invalid
+    const HttpRequest* spot_rates_request(const char* currency);
+    
+    /**
+     * @brief Streaming filter for an exchange-rates body
+     *
+     * The body is tokenized as it arrives (see net_json_stream.h) and only
+     * the rates of the wanted products are kept, so the ~10 KB response is
+     * never buffered. Feed it with spot_rates_chunk() as the
+     * HttpChunkCallback of a transport request or async job.
+     */
+    struct SpotRatesScan {
+        JsonStreamParser parser;
+        const char* const* products;
+        int n;
+        Fixed* out_prices;
+        bool* out_ok;
+        int found;
+        char currency[8];           // Quote currency requested (from products[0])
+        bool currency_ok;           // data.currency matched it
+        bool in_rates;              // Inside data.rates
+    };
+    
+    /**
+     * @brief Start a scan for products[0..n) (all out_ok cleared)
+     * Products quoted in another currency than products[0] stay invalid.
+     * @return false if products[0] is not a BASE-QUOTE product id
+     */
+    bool spot_rates_begin(SpotRatesScan* scan, const char* const* products, int n,
+                          Fixed* out_prices, bool* out_ok);
+    
+    // HttpChunkCallback feeding body bytes into a SpotRatesScan (ctx)
+    bool spot_rates_chunk(const uint8_t* data, size_t len, void* ctx);
+    
+    /**
+     * @brief Finish a scan after the whole body was fed
+     * @return Number of products with a valid price, 0 (all invalid) if the
+     *         body was malformed, incomplete or for another currency
+     */
+    int spot_rates_finish(SpotRatesScan* scan);
+    
+    /**
+     * @brief Fetch spot prices for products[0..n) with one exchange-rates request
+     * Price is 1 / rate, so it is a mid-market reference (no bid/ask).
+     * @return Number of products with a valid price (out_ok per product)
+     */
+    int fetch_spot_batch(const char* const* products, int n, Fixed* out_prices, bool* out_ok);
+    
+    /**
+     * @brief Best bid/ask and last trade price of a product
+     */
+    struct Ticker {
+        Fixed price;   // Last trade (mid of bid/ask if absent)
+        Fixed bid;
+        Fixed ask;
+        bool valid;
+    };
+    
+    // Largest Exchange ticker body accepted (bytes, incl. NUL)
+    const size_t TICKER_BODY_MAX = 512;
+    
+    // Pre-rendered Exchange ticker request for a product (for http_async_submit)
+    // Returns nullptr if the product id is invalid
+    const HttpRequest* ticker_request(const char* product);
+    
+    /**
+     * @brief Parse an Exchange ticker body (parsed in place, body is modified)
+     * @return true with bid/ask in out if both are positive numbers
+     */
+    bool parse_ticker(char* body, size_t len, const char* product, Ticker* out);
+    
+    /**
+     * @brief Fetch best bid/ask from the Coinbase Exchange ticker
+     * 
+     * @param product Product ID (e.g., "BTC-USD")
+     * @param out Bid, ask and last price
+     * @return true if fetch successful and bid/ask valid, false on any error
+     */
+    bool fetch_ticker(const char* product, Ticker* out);
+    
+    // Exchange market-data feed (wss only)
+    const char* const TICKER_STREAM_URL = "wss://ws-feed.exchange.coinbase.com";
+    
+    // Subscribe message for the ticker channel of products[0..n)
+    // e.g. {"type":"subscribe","product_ids":["BTC-USD","ETH-USD"],"channels":["ticker"]}
+    // Returns: false if a product is missing or the message does not fit in cap
+    bool ticker_subscribe_message(const char* const* products, int n, char* out, size_t cap);
+    
+    // Parse one ticker channel message (parsed in place, msg is modified)
+    // {"type":"ticker","sequence":37475248783,"product_id":"BTC-USD","price":"..",
+    //  "best_bid":"..","best_ask":"..","time":"..",...}
+    // out_sequence receives the product's feed sequence number (gap detection)
+    // Returns: index into products[0..n) with its ticker in *out, -1 if unknown or invalid
+    int parse_ticker_stream(char* msg, size_t len, const char* const* products, int n,
+                            Ticker* out, int64_t* out_sequence);
 }
 
 #endif // NET_COINBASE_H
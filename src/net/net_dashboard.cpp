@@ -3,7 +3,9 @@
 #if ENABLE_OTA
 
 #include "../app/app_model.h"
+#include "../app/app_math.h"
 #include "../app/app_config.h"
+#include "net_timing.h"
 #include <ArduinoJson.h>
 
 // Web dashboard HTML (stored in PROGMEM)
@@ -110,7 +112,7 @@ const char dashboard_html[] PROGMEM = R"====(
       font-size: 13px;
       margin-bottom: 5px;
     }
-    .setting-item input {
+    .setting-item input, .setting-item select {
       width: 100%;
       background: #0B0E11;
       border: 1px solid #2B3139;
@@ -119,7 +121,7 @@ const char dashboard_html[] PROGMEM = R"====(
       border-radius: 4px;
       font-size: 14px;
     }
-    .setting-item input:focus {
+    .setting-item input:focus, .setting-item select:focus {
       outline: none;
       border-color: #F0B90B;
     }
@@ -216,6 +218,17 @@ const char dashboard_html[] PROGMEM = R"====(
             <label>Funding Update Rate</label>
             <input type="number" id="fundingInterval" step="1" min="1">
           </div>
+          <div class="setting-item">
+            <label>Funding Schedule</label>
+            <select id="fundingSchedule">
+              <option value="epoch">After each funding epoch</option>
+              <option value="interval">Fixed interval</option>
+            </select>
+          </div>
+          <div class="setting-item">
+            <label>Predicted Funding Rate (0 = off)</label>
+            <input type="number" id="predictedInterval" step="60" min="0">
+          </div>
         </div>
       </div>
       <div class="buttons">
@@ -266,6 +279,7 @@ const char dashboard_html[] PROGMEM = R"====(
           
           const spreadClass = symbol.spread_pct >= 0 ? "spread-positive" : "spread-negative";
           const fundingClass = symbol.funding_rate >= 0 ? "funding-positive" : "funding-negative";
+          const execClass = symbol.exec_spread_pct >= 0 ? "spread-positive" : "spread-negative";
           
           card.innerHTML = 
             "<div class='crypto-name'>" + symbol.name + "</div>" +
@@ -281,6 +295,10 @@ const char dashboard_html[] PROGMEM = R"====(
               "<span class='price-label'>Spread</span>" +
               "<span class='price-value " + spreadClass + "'>" + (symbol.spread_pct >= 0 ? "+" : "") + symbol.spread_pct.toFixed(3) + "%</span>" +
             "</div>" +
+            "<div class='price-row'>" +
+              "<span class='price-label'>Executable" + (symbol.exec_buy ? " (buy " + symbol.exec_buy + ")" : "") + "</span>" +
+              "<span class='price-value " + execClass + "'>" + (symbol.exec_spread_pct >= 0 ? "+" : "") + symbol.exec_spread_pct.toFixed(3) + "%</span>" +
+            "</div>" +
             "<div class='price-row'>" +
               "<span class='price-label'>Funding Rate</span>" +
               "<span class='price-value " + fundingClass + "'>" + (symbol.funding_rate >= 0 ? "+" : "") + (symbol.funding_rate * 100).toFixed(4) + "%</span>" +
@@ -304,6 +322,8 @@ const char dashboard_html[] PROGMEM = R"====(
         document.getElementById("fundingThreshold").value = data.funding_alert_threshold;
         document.getElementById("priceInterval").value = data.price_update_interval_sec;
         document.getElementById("fundingInterval").value = data.funding_update_interval_sec;
+        document.getElementById("fundingSchedule").value = data.funding_schedule;
+        document.getElementById("predictedInterval").value = data.predicted_funding_interval_sec;
       } catch (error) {
         console.error("Failed to load settings:", error);
       }
@@ -315,7 +335,9 @@ const char dashboard_html[] PROGMEM = R"====(
         spread_alert_threshold: parseFloat(document.getElementById("spreadThreshold").value),
         funding_alert_threshold: parseFloat(document.getElementById("fundingThreshold").value),
         price_update_interval_sec: parseInt(document.getElementById("priceInterval").value),
-        funding_update_interval_sec: parseInt(document.getElementById("fundingInterval").value)
+        funding_update_interval_sec: parseInt(document.getElementById("fundingInterval").value),
+        funding_schedule: document.getElementById("fundingSchedule").value,
+        predicted_funding_interval_sec: parseInt(document.getElementById("predictedInterval").value)
       };
       
       try {
@@ -377,18 +399,69 @@ void dashboard_init(WebServer* server) {
 
     // API: Get current prices
     server->on("/api/prices", HTTP_GET, [server]() {
-        AppState state = model_snapshot();
+        // One symbol at a time; static keeps the copy off the loop task stack
+        static SymbolState s;
         StaticJsonDocument<1024> doc;
         JsonArray symbols_array = doc.createNestedArray("symbols");
         
         for (int i = 0; i < 2; i++) {  // BTC and ETH
+            if (!model_get_symbol(i, &s)) {
+                continue;
+            }
             JsonObject symbol = symbols_array.createNestedObject();
-            symbol["name"] = state.symbols[i].symbol_name;
-            symbol["binance_price"] = state.symbols[i].binance_quote.valid ? state.symbols[i].binance_quote.price : 0.0;
-            symbol["coinbase_price"] = state.symbols[i].coinbase_quote.valid ? state.symbols[i].coinbase_quote.price : 0.0;
-            symbol["spread_pct"] = state.symbols[i].spread_valid ? state.symbols[i].spread_pct : 0.0;
-            symbol["funding_rate"] = state.symbols[i].funding.valid ? state.symbols[i].funding.rate : 0.0;
+            symbol["name"] = s.symbol_name;
+            symbol["binance_price"] = s.binance_quote.valid ? fixed_to_double(s.binance_quote.price) : 0.0;
+            symbol["coinbase_price"] = s.coinbase_quote.valid ? fixed_to_double(s.coinbase_quote.price) : 0.0;
+            symbol["binance_bid"] = s.binance_quote.valid ? fixed_to_double(s.binance_quote.bid) : 0.0;
+            symbol["binance_ask"] = s.binance_quote.valid ? fixed_to_double(s.binance_quote.ask) : 0.0;
+            symbol["coinbase_bid"] = s.coinbase_quote.valid ? fixed_to_double(s.coinbase_quote.bid) : 0.0;
+            symbol["coinbase_ask"] = s.coinbase_quote.valid ? fixed_to_double(s.coinbase_quote.ask) : 0.0;
+            symbol["kraken_bid"] = s.kraken_quote.valid ? fixed_to_double(s.kraken_quote.bid) : 0.0;
+            symbol["kraken_ask"] = s.kraken_quote.valid ? fixed_to_double(s.kraken_quote.ask) : 0.0;
+            symbol["spread_pct"] = s.spread_valid ? s.spread_pct : 0.0;
+            // Executable spread and the venue to buy on ("" if unknown)
+            symbol["exec_spread_pct"] = s.exec_spread_valid ? s.exec_spread_pct : 0.0;
+            symbol["exec_buy"] = !s.exec_spread_valid ? "" :
+                                 s.exec_direction == SPREAD_BUY_COINBASE ? "coinbase" : "binance";
+            // Widest mid spread between any two venues
+            const SpreadMatrix& spreads = s.spreads;
+            symbol["widest_spread_pct"] = spreads.widest_valid ? spreads.widest_pct : 0.0;
+            symbol["widest_buy"] = spreads.widest_valid ? quote_venue_name(spreads.widest_low) : "";
+            symbol["widest_sell"] = spreads.widest_valid ? quote_venue_name(spreads.widest_high) : "";
+            symbol["funding_rate"] = s.funding.valid ? fixed_to_double(s.funding.rate) : 0.0;
+            symbol["mark_price"] = s.funding.valid ? fixed_to_double(s.funding.mark_price) : 0.0;
+            symbol["index_price"] = s.funding.valid ? fixed_to_double(s.funding.index_price) : 0.0;
+            symbol["next_funding_ms"] = s.funding.valid ? s.funding.next_funding_ms : 0;
+        }
+        
+        String response;
+        serializeJson(doc, response);
+        server->send(200, "application/json", response);
+    });
+
+    // API: Per-host HTTP phase latencies (net_timing.h)
+    server->on("/api/http-stats", HTTP_GET, [server]() {
+        DynamicJsonDocument doc(4096);
+        JsonArray hosts_array = doc.createNestedArray("hosts");
+        
+        HttpHostTiming timing;
+        for (int i = 0; http_timing_get(i, &timing); i++) {
+            JsonObject host = hosts_array.createNestedObject();
+            host["host"] = timing.host;  // char[] is copied (timing is reused)
+            JsonObject phases = host.createNestedObject("phases");
+            for (int p = 0; p < HTTP_PHASE_COUNT; p++) {
+                const LatencyHistogram& h = timing.phases[p];
+                if (h.count == 0) continue;
+                JsonObject phase = phases.createNestedObject(http_phase_name((HttpPhase)p));
+                phase["count"] = h.count;
+                phase["p50"] = latency_hist_percentile(&h, 50);
+                phase["p95"] = latency_hist_percentile(&h, 95);
+                phase["p99"] = latency_hist_percentile(&h, 99);
+                phase["max"] = h.max_ms;
+                phase["avg"] = h.sum_ms / h.count;
+            }
         }
+        doc["dropped"] = http_timing_dropped();
         
         String response;
         serializeJson(doc, response);
@@ -403,6 +476,8 @@ void dashboard_init(WebServer* server) {
         doc["funding_alert_threshold"] = cfg.funding_alert_pct;
         doc["price_update_interval_sec"] = cfg.price_refresh_ms / 1000;
         doc["funding_update_interval_sec"] = cfg.funding_refresh_ms / 1000;
+        doc["funding_schedule"] = cfg.funding_schedule == FUNDING_SCHEDULE_EPOCH ? "epoch" : "interval";
+        doc["predicted_funding_interval_sec"] = cfg.predicted_funding_refresh_ms / 1000;
         
         String response;
         serializeJson(doc, response);
@@ -412,7 +487,7 @@ void dashboard_init(WebServer* server) {
     // API: Update settings
     server->on("/api/settings", HTTP_POST, [server]() {
         if (server->hasArg("plain")) {
-            StaticJsonDocument<256> doc;
+            StaticJsonDocument<512> doc;
             DeserializationError error = deserializeJson(doc, server->arg("plain"));
             
             if (!error) {
@@ -420,6 +495,15 @@ void dashboard_init(WebServer* server) {
                 config_set_funding_alert_pct(doc["funding_alert_threshold"]);
                 config_set_price_refresh_ms(doc["price_update_interval_sec"].as<int>() * 1000);
                 config_set_funding_refresh_ms(doc["funding_update_interval_sec"].as<int>() * 1000);
+                if (doc.containsKey("funding_schedule")) {
+                    const char* mode = doc["funding_schedule"];
+                    config_set_funding_schedule(mode && strcmp(mode, "interval") == 0
+                                                ? FUNDING_SCHEDULE_INTERVAL : FUNDING_SCHEDULE_EPOCH);
+                }
+                if (doc.containsKey("predicted_funding_interval_sec")) {
+                    config_set_predicted_funding_refresh_ms(
+                        doc["predicted_funding_interval_sec"].as<int>() * 1000);
+                }
                 
                 config_save();
                 
@@ -450,6 +534,8 @@ void dashboard_init(WebServer* server) {
         config_set_funding_alert_pct(0.01);
         config_set_price_refresh_ms(5000);
         config_set_funding_refresh_ms(60000);
+        config_set_funding_schedule(FUNDING_SCHEDULE_EPOCH);
+        config_set_predicted_funding_refresh_ms(0);
         config_save();
         
         StaticJsonDocument<128> response;
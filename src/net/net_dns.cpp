@@ -0,0 +1,225 @@
+#include "net_dns.h"
+#include "net_timing.h"
+#include "../config.h"
+#include <string.h>
+
+#ifdef ARDUINO
+#include <lwip/sockets.h>
+#include <lwip/netdb.h>
+#else
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+struct DnsEntry {
+    char host[HTTP_POOL_HOST_MAX];
+    uint32_t ipv4;          // Last good address (0 = never resolved)
+    bool ok;                // Last lookup succeeded
+    uint32_t resolved_ms;   // Time of last lookup (success or failure)
+    uint32_t good_ms;       // Time of last successful lookup
+    uint32_t last_used_ms;
+};
+
+static DnsEntry g_entries[DNS_CACHE_SIZE];
+static char g_registered[DNS_MAX_REGISTERED][HTTP_POOL_HOST_MAX];
+static int g_num_registered = 0;
+static DnsResolveFn g_resolver = nullptr;
+static DnsClockFn g_clock = nullptr;
+static DnsStats g_stats;
+
+bool dns_system_resolver(const char* host, uint32_t* out_ipv4) {
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+
+    struct addrinfo* res = nullptr;
+    if (getaddrinfo(host, nullptr, &hints, &res) != 0 || !res) {
+        return false;
+    }
+    *out_ipv4 = ((struct sockaddr_in*)res->ai_addr)->sin_addr.s_addr;
+    freeaddrinfo(res);
+    return true;
+}
+
+// "a.b.c.d" -> address, without touching the resolver
+static bool parse_ipv4(const char* host, uint32_t* out_ipv4) {
+    uint32_t parts[4];
+    int n = 0;
+    const char* p = host;
+    while (n < 4) {
+        if (*p < '0' || *p > '9') return false;
+        uint32_t v = 0;
+        int digits = 0;
+        while (*p >= '0' && *p <= '9') {
+            v = v * 10 + (uint32_t)(*p++ - '0');
+            if (++digits > 3 || v > 255) return false;
+        }
+        parts[n++] = v;
+        if (n < 4) {
+            if (*p != '.') return false;
+            p++;
+        }
+    }
+    if (*p != '\0') return false;
+
+    uint8_t* b = (uint8_t*)out_ipv4;
+    for (int i = 0; i < 4; i++) b[i] = (uint8_t)parts[i];
+    return true;
+}
+
+void dns_cache_init(DnsResolveFn resolver, DnsClockFn clock) {
+    memset(g_entries, 0, sizeof(g_entries));
+    g_resolver = resolver;
+    g_clock = clock;
+    memset(&g_stats, 0, sizeof(g_stats));
+}
+
+static DnsEntry* find_entry(const char* host) {
+    for (int i = 0; i < DNS_CACHE_SIZE; i++) {
+        if (g_entries[i].host[0] != '\0' && strcmp(g_entries[i].host, host) == 0) {
+            return &g_entries[i];
+        }
+    }
+    return nullptr;
+}
+
+// Free entry, or the least recently used one
+static DnsEntry* victim_entry() {
+    DnsEntry* lru = &g_entries[0];
+    for (int i = 0; i < DNS_CACHE_SIZE; i++) {
+        if (g_entries[i].host[0] == '\0') {
+            return &g_entries[i];
+        }
+        if (g_entries[i].last_used_ms < lru->last_used_ms) {
+            lru = &g_entries[i];
+        }
+    }
+    return lru;
+}
+
+static bool resolve_cached(const char* host, uint32_t now, uint32_t* out_ipv4) {
+    DnsEntry* entry = find_entry(host);
+
+    if (entry) {
+        entry->last_used_ms = now;
+        uint32_t age = now - entry->resolved_ms;
+        if (entry->ok && age < DNS_CACHE_TTL_MS) {
+            g_stats.hits++;
+            *out_ipv4 = entry->ipv4;
+            return true;
+        }
+        if (!entry->ok && age < DNS_NEGATIVE_TTL_MS) {
+            // Recent failure: serve the last good address if still usable
+            if (entry->ipv4 != 0 && now - entry->good_ms < DNS_CACHE_TTL_MS + DNS_STALE_MAX_MS) {
+                g_stats.stale_served++;
+                *out_ipv4 = entry->ipv4;
+                return true;
+            }
+            g_stats.negative_hits++;
+            return false;
+        }
+    } else {
+        size_t len = strlen(host);
+        if (len >= HTTP_POOL_HOST_MAX) {
+            return false;
+        }
+        entry = victim_entry();
+        memset(entry, 0, sizeof(*entry));
+        memcpy(entry->host, host, len + 1);
+        entry->last_used_ms = now;
+    }
+
+    // Miss or expired: ask the resolver
+    uint32_t ip = 0;
+    uint32_t t0 = g_clock();
+    bool ok = g_resolver(host, &ip);
+    g_stats.resolves++;
+    g_stats.last_resolve_ms = g_clock() - t0;
+    entry->resolved_ms = now;
+
+    if (ok) {
+        entry->ok = true;
+        entry->ipv4 = ip;
+        entry->good_ms = now;
+        *out_ipv4 = ip;
+        return true;
+    }
+
+    g_stats.failures++;
+    entry->ok = false;
+    DEBUG_PRINTF("[DNS] Lookup failed for %s\n", host);
+
+    // Ride out a transient outage on the previous answer
+    if (entry->ipv4 != 0 && now - entry->good_ms < DNS_CACHE_TTL_MS + DNS_STALE_MAX_MS) {
+        g_stats.stale_served++;
+        *out_ipv4 = entry->ipv4;
+        return true;
+    }
+    return false;
+}
+
+bool dns_resolve(const char* host, uint32_t* out_ipv4) {
+    if (!host || !*host || !out_ipv4) {
+        return false;
+    }
+    if (parse_ipv4(host, out_ipv4)) {
+        return true;
+    }
+
+    // Not initialized: plain pass-through to the system resolver
+    if (!g_resolver || !g_clock) {
+        return dns_system_resolver(host, out_ipv4);
+    }
+
+    g_stats.lookups++;
+    uint32_t now = g_clock();
+    bool ok = resolve_cached(host, now, out_ipv4);
+    http_timing_record(host, HTTP_PHASE_DNS, g_clock() - now);
+    return ok;
+}
+
+void dns_invalidate(const char* host) {
+    if (!host) {
+        return;
+    }
+    DnsEntry* entry = find_entry(host);
+    if (entry) {
+        memset(entry, 0, sizeof(*entry));
+    }
+}
+
+void dns_register(const char* host) {
+    if (!host || !*host || strlen(host) >= HTTP_POOL_HOST_MAX) {
+        return;
+    }
+    for (int i = 0; i < g_num_registered; i++) {
+        if (strcmp(g_registered[i], host) == 0) {
+            return;
+        }
+    }
+    if (g_num_registered < DNS_MAX_REGISTERED) {
+        strcpy(g_registered[g_num_registered++], host);
+    }
+}
+
+int dns_preresolve_all() {
+    int resolved = 0;
+    for (int i = 0; i < g_num_registered; i++) {
+        uint32_t ip;
+        if (dns_resolve(g_registered[i], &ip)) {
+            resolved++;
+        }
+    }
+    return resolved;
+}
+
+DnsStats dns_get_stats() {
+    return g_stats;
+}
+
+void dns_reset_stats() {
+    memset(&g_stats, 0, sizeof(g_stats));
+}
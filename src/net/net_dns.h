@@ -0,0 +1,88 @@
+#ifndef NET_DNS_H
+#define NET_DNS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "net_pool.h"
+
+/**
+ * @file net_dns.h
+ * @brief Hostname -> IPv4 cache with TTL and negative caching
+ *
+ * Every connect used to resolve the same three exchange hostnames again.
+ * All connection paths (keep-alive pool, TlsClient, async engine) now
+ * resolve through this cache:
+ * - positive answers are reused for DNS_CACHE_TTL_MS
+ * - failures are remembered for DNS_NEGATIVE_TTL_MS (no lookup storm)
+ * - if re-resolving an expired entry fails, the last good address is
+ *   served for up to DNS_STALE_MAX_MS, riding out transient DNS outages
+ *
+ * The resolver and clock are injected, so the module is Arduino-independent
+ * and unit tested with a fake resolver. Without dns_cache_init() lookups
+ * go straight to the system resolver (no caching).
+ *
+ * Not thread-safe: all calls are expected from net_task.
+ */
+
+// Cached hostnames (exchange REST and stream hosts + spares)
+#define DNS_CACHE_SIZE 8
+
+// Reuse a successful answer this long (getaddrinfo does not report the record TTL)
+#define DNS_CACHE_TTL_MS (5UL * 60UL * 1000UL)
+
+// Don't retry a failed lookup for this long
+#define DNS_NEGATIVE_TTL_MS 5000
+
+// Serve an expired address this long past its TTL while lookups keep failing
+#define DNS_STALE_MAX_MS (60UL * 60UL * 1000UL)
+
+// Hosts remembered for dns_preresolve_all()
+#define DNS_MAX_REGISTERED 8
+
+// Resolve host to an IPv4 address (network byte order), true on success
+typedef bool (*DnsResolveFn)(const char* host, uint32_t* out_ipv4);
+
+// Monotonic millisecond clock
+typedef uint32_t (*DnsClockFn)();
+
+// Cache counters (monotonic since init or dns_reset_stats())
+struct DnsStats {
+    uint32_t lookups;           // dns_resolve() calls
+    uint32_t hits;              // Served from a fresh entry
+    uint32_t negative_hits;     // Failed fast from a cached failure
+    uint32_t stale_served;      // Expired entry served because re-resolution failed
+    uint32_t resolves;          // Resolver calls
+    uint32_t failures;          // Resolver calls that failed
+    uint32_t last_resolve_ms;   // Duration of the last resolver call
+};
+
+// System resolver (getaddrinfo on lwIP / POSIX)
+bool dns_system_resolver(const char* host, uint32_t* out_ipv4);
+
+/**
+ * @brief Initialize (or re-initialize) the cache
+ * @param resolver Lookup function (dns_system_resolver on the device)
+ * @param clock Millisecond clock for TTLs
+ */
+void dns_cache_init(DnsResolveFn resolver, DnsClockFn clock);
+
+/**
+ * @brief Resolve host through the cache
+ * Dotted-quad addresses are parsed directly and never cached.
+ * @return false if the host cannot be resolved (or failed recently)
+ */
+bool dns_resolve(const char* host, uint32_t* out_ipv4);
+
+// Forget host (e.g. after connecting to its cached address failed)
+void dns_invalidate(const char* host);
+
+// Remember host for dns_preresolve_all() (adapters register their endpoints)
+void dns_register(const char* host);
+
+// Resolve every registered host now, returns how many resolved
+int dns_preresolve_all();
+
+DnsStats dns_get_stats();
+void dns_reset_stats();
+
+#endif // NET_DNS_H
@@ -0,0 +1,267 @@
+#include "net_endpoint.h"
+#include <stdio.h>
+#include <string.h>
+
+bool http_endpoint_init(HttpEndpoint* ep, const char* base_url, const char* path_template) {
+    if (!ep || !base_url) {
+        return false;
+    }
+
+    // ws:// and wss:// (WebSocket streams, net_ws.h) map to http:// and https://
+    const char* p;
+    if (strncmp(base_url, "https://", 8) == 0) {
+        ep->tls = true;
+        p = base_url + 8;
+    } else if (strncmp(base_url, "http://", 7) == 0) {
+        ep->tls = false;
+        p = base_url + 7;
+    } else if (strncmp(base_url, "wss://", 6) == 0) {
+        ep->tls = true;
+        p = base_url + 6;
+    } else if (strncmp(base_url, "ws://", 5) == 0) {
+        ep->tls = false;
+        p = base_url + 5;
+    } else {
+        return false;
+    }
+
+    // Host runs until ':' (port), '/' (path) or end
+    size_t host_len = strcspn(p, ":/");
+    if (host_len == 0 || host_len >= sizeof(ep->host)) {
+        return false;
+    }
+    memcpy(ep->host, p, host_len);
+    ep->host[host_len] = '\0';
+    p += host_len;
+
+    ep->port = ep->tls ? 443 : 80;
+    if (*p == ':') {
+        p++;
+        unsigned long port = 0;
+        int digits = 0;
+        while (*p >= '0' && *p <= '9') {
+            port = port * 10 + (unsigned long)(*p++ - '0');
+            digits++;
+        }
+        if (digits == 0 || port == 0 || port > 65535) {
+            return false;
+        }
+        ep->port = (uint16_t)port;
+    }
+
+    if (*p != '\0' && *p != '/') {
+        return false;
+    }
+
+    if (path_template) {
+        // Base must not carry a path of its own ("host/" is fine)
+        if (*p == '/' && p[1] != '\0') {
+            return false;
+        }
+        ep->path_template = path_template;
+    } else {
+        ep->path_template = (*p == '/') ? p : "/";
+    }
+    return true;
+}
+
+// Bounded append helper for request rendering
+struct RenderBuf {
+    char* data;
+    size_t cap;
+    size_t len;
+    bool overflow;
+
+    void put(const char* s, size_t n) {
+        if (overflow || len + n >= cap) {
+            overflow = true;
+            return;
+        }
+        memcpy(data + len, s, n);
+        len += n;
+    }
+
+    void put(const char* s) { put(s, strlen(s)); }
+};
+
+bool http_request_render(HttpRequest* req, const HttpEndpoint* ep, const char* arg) {
+    if (!req || !ep || !ep->path_template) {
+        return false;
+    }
+
+    RenderBuf out = { req->data, sizeof(req->data), 0, false };
+
+    out.put("GET ");
+    const char* tpl = ep->path_template;
+    const char* slot = strstr(tpl, HTTP_PATH_ARG);
+    if (slot) {
+        out.put(tpl, (size_t)(slot - tpl));
+        if (arg) {
+            out.put(arg);
+        }
+        out.put(slot + strlen(HTTP_PATH_ARG));
+    } else {
+        out.put(tpl);
+    }
+    out.put(" HTTP/1.1\r\nHost: ");
+    out.put(ep->host);
+    if (ep->port != (ep->tls ? 443 : 80)) {
+        char port[8];
+        int n = snprintf(port, sizeof(port), ":%u", (unsigned)ep->port);
+        out.put(port, (size_t)n);
+    }
+    out.put("\r\nConnection: keep-alive\r\n"
+            "User-Agent: ESP32-CryptoDash/1.0\r\n"
+            "\r\n");
+
+    if (out.overflow) {
+        req->len = 0;
+        req->data[0] = '\0';
+        return false;
+    }
+
+    req->data[out.len] = '\0';
+    req->len = (uint16_t)out.len;
+    req->endpoint = ep;
+    return true;
+}
+
+void http_request_cache_init(HttpRequestCache* cache, const HttpEndpoint* ep) {
+    cache->endpoint = ep;
+    cache->count = 0;
+    cache->next_victim = 0;
+    cache->renders = 0;
+}
+
+const HttpRequest* http_request_cache_get(HttpRequestCache* cache, const char* arg) {
+    if (!cache || !cache->endpoint || !arg || !*arg) {
+        return nullptr;
+    }
+
+    for (uint8_t i = 0; i < cache->count; i++) {
+        if (strcmp(cache->keys[i], arg) == 0) {
+            return &cache->entries[i];
+        }
+    }
+
+    size_t key_len = strlen(arg);
+    if (key_len >= HTTP_REQUEST_KEY_MAX) {
+        return nullptr;
+    }
+
+    uint8_t idx;
+    if (cache->count < HTTP_REQUEST_CACHE_SIZE) {
+        idx = cache->count;
+    } else {
+        // Full (symbol list changed): replace round-robin
+        idx = cache->next_victim;
+        cache->next_victim = (uint8_t)((cache->next_victim + 1) % HTTP_REQUEST_CACHE_SIZE);
+    }
+
+    if (!http_request_render(&cache->entries[idx], cache->endpoint, arg)) {
+        cache->keys[idx][0] = '\0';  // Never matches (empty args are rejected)
+        return nullptr;
+    }
+    memcpy(cache->keys[idx], arg, key_len + 1);
+    if (idx == cache->count) {
+        cache->count++;
+    }
+    cache->renders++;
+    return &cache->entries[idx];
+}
+
+void http_request_batches_init(HttpRequestBatches* set, const HttpEndpoint* ep,
+                               const HttpListFormat* format, int max) {
+    set->endpoint = ep;
+    set->format = format;
+    set->max = max < HTTP_BATCH_MAX_REQUESTS ? max : HTTP_BATCH_MAX_REQUESTS;
+    set->num = 0;
+    set->key[0] = '\0';
+}
+
+// Render as many items from items[0..n) per request as fit
+// Returns: number of requests, 0 if an item is invalid or they do not fit
+static int batches_render(HttpRequestBatches* set, const char* const* items, int n) {
+    const HttpListFormat* fmt = set->format;
+    size_t open_len = strlen(fmt->open);
+    size_t quote_len = strlen(fmt->quote);
+    size_t close_len = strlen(fmt->close);
+
+    int num = 0;
+    int i = 0;
+    while (i < n) {
+        if (num == set->max) {
+            return 0;
+        }
+        HttpRequestBatch& batch = set->batches[num];
+        batch.request.len = 0;
+
+        // open + items + close; the close is rewritten after each item
+        char arg[HTTP_REQUEST_MAX];
+        memcpy(arg, fmt->open, open_len);
+        size_t arg_len = open_len;
+        int count = 0;
+        while (i + count < n) {
+            const char* item = items[i + count];
+            size_t item_len = item ? strlen(item) : 0;
+            size_t prev_len = arg_len;
+            if (item_len == 0 || arg_len + 1 + 2 * quote_len + item_len + close_len >= sizeof(arg)) {
+                break;
+            }
+            if (count > 0) {
+                arg[arg_len++] = ',';
+            }
+            memcpy(arg + arg_len, fmt->quote, quote_len);
+            memcpy(arg + arg_len + quote_len, item, item_len);
+            memcpy(arg + arg_len + quote_len + item_len, fmt->quote, quote_len);
+            arg_len += 2 * quote_len + item_len;
+            memcpy(arg + arg_len, fmt->close, close_len + 1);
+
+            if (!http_request_render(&batch.request, set->endpoint, arg)) {
+                // Request full: close the list before this item
+                memcpy(arg + prev_len, fmt->close, close_len + 1);
+                break;
+            }
+            count++;
+        }
+        if (count == 0) {
+            return 0;
+        }
+        // A failed render above cleared the request
+        if (batch.request.len == 0 && !http_request_render(&batch.request, set->endpoint, arg)) {
+            return 0;
+        }
+        batch.first = (uint8_t)i;
+        batch.count = (uint8_t)count;
+        i += count;
+        num++;
+    }
+    return num;
+}
+
+int http_request_batches(HttpRequestBatches* set, const char* const* items, int n,
+                         const HttpRequestBatch** out) {
+    if (!set || !set->endpoint || !items || n <= 0 || n > 255 || !out) {
+        return 0;
+    }
+
+    // Item list key; the requests are only rendered again when it changes
+    char key[sizeof(set->key)];
+    size_t len = 0;
+    for (int k = 0; k < n && len < sizeof(key); k++) {
+        len += snprintf(key + len, sizeof(key) - len, "%s%s", k ? "," : "", items[k] ? items[k] : "");
+    }
+    bool cacheable = len < sizeof(key);
+
+    if (!cacheable || set->num == 0 || strcmp(key, set->key) != 0) {
+        set->num = batches_render(set, items, n);
+        if (cacheable && set->num > 0) {
+            memcpy(set->key, key, len + 1);
+        } else {
+            set->key[0] = '\0';
+        }
+    }
+
+    *out = set->batches;
+    return set->num;
+}
@@ -0,0 +1,133 @@
+#ifndef NET_ENDPOINT_H
+#define NET_ENDPOINT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "net_pool.h"
+
+/**
+ * @file net_endpoint.h
+ * @brief Precompiled HTTP endpoints and pre-rendered GET requests
+ *
+ * An HttpEndpoint (scheme, host, port, path template) is resolved once
+ * when an adapter is initialized instead of building and re-parsing a URL
+ * string on every fetch. The complete request for one path argument
+ * (e.g. a symbol) is rendered into an HttpRequest buffer and sent with a
+ * single write.
+ *
+ * HttpRequestCache keeps the rendered request per argument, so repeated
+ * fetches for the same symbol do no formatting and no heap allocation.
+ * HttpRequestBatches does the same for list endpoints: a list of items is
+ * split into as few requests as fit, rendered again only when it changes.
+ *
+ * Arduino-independent, unit tested on the host.
+ */
+
+// Rendered request size (request line + Host/Connection/User-Agent headers)
+#define HTTP_REQUEST_MAX 224
+
+// Placeholder replaced by the request argument in path templates
+#define HTTP_PATH_ARG "{}"
+
+// Requests cached per endpoint (one per configured symbol)
+#define HTTP_REQUEST_CACHE_SIZE 10
+
+// Longest cached argument (symbol / product id)
+#define HTTP_REQUEST_KEY_MAX 16
+
+// Requests a batch set can hold
+#define HTTP_BATCH_MAX_REQUESTS 4
+
+// Longest cached item list ("BTCUSDT,ETHUSDT,...")
+#define HTTP_BATCH_KEY_MAX 192
+
+struct HttpEndpoint {
+    bool tls;                        // https://
+    uint16_t port;                   // 443 / 80 unless given in the URL
+    char host[HTTP_POOL_HOST_MAX];
+    const char* path_template;       // e.g. "/api/v3/ticker/price?symbol={}" (not copied)
+};
+
+struct HttpRequest {
+    const HttpEndpoint* endpoint;
+    uint16_t len;                    // Bytes in data (excluding NUL)
+    char data[HTTP_REQUEST_MAX];     // "GET ... HTTP/1.1\r\n...\r\n\r\n"
+};
+
+/**
+ * @brief Resolve scheme, host and port of base_url into ep
+ *
+ * @param base_url "http[s]://host[:port][/path]" (or ws[s]:// for WebSocket streams)
+ * @param path_template Path with an optional HTTP_PATH_ARG placeholder; must
+ *        outlive ep. If nullptr, the path of base_url itself is used (then
+ *        base_url must outlive ep).
+ * @return false if the URL is malformed, the host does not fit, or both
+ *         base_url and path_template carry a path
+ */
+bool http_endpoint_init(HttpEndpoint* ep, const char* base_url, const char* path_template);
+
+/**
+ * @brief Render the full GET request for ep with arg substituted
+ * @param arg Replaces HTTP_PATH_ARG in the path template (nullptr = none)
+ * @return false if the request does not fit in HTTP_REQUEST_MAX
+ */
+bool http_request_render(HttpRequest* req, const HttpEndpoint* ep, const char* arg);
+
+// Per-endpoint cache of rendered requests, keyed by argument
+struct HttpRequestCache {
+    const HttpEndpoint* endpoint;
+    HttpRequest entries[HTTP_REQUEST_CACHE_SIZE];
+    char keys[HTTP_REQUEST_CACHE_SIZE][HTTP_REQUEST_KEY_MAX];
+    uint8_t count;
+    uint8_t next_victim;             // Round-robin replacement once full
+    uint32_t renders;                // Cache misses (requests rendered)
+};
+
+void http_request_cache_init(HttpRequestCache* cache, const HttpEndpoint* ep);
+
+/**
+ * @brief Get the rendered request for arg, rendering it on first use
+ * @return nullptr if arg is too long or the request does not fit
+ */
+const HttpRequest* http_request_cache_get(HttpRequestCache* cache, const char* arg);
+
+// Spelling of an item list in the path argument; items are separated by ','
+// e.g. {"%5B", "%22", "%5D"} renders ["A","B"] URL-encoded, {"", "", ""} A,B
+struct HttpListFormat {
+    const char* open;                // Before the first item
+    const char* quote;               // Before and after each item
+    const char* close;               // After the last item
+};
+
+// One rendered request and the items it covers
+struct HttpRequestBatch {
+    HttpRequest request;
+    uint8_t first;                   // Index of the first item in the list passed in
+    uint8_t count;                   // Number of items covered
+};
+
+// Batched requests of one list endpoint, keyed by the last item list
+struct HttpRequestBatches {
+    const HttpEndpoint* endpoint;
+    const HttpListFormat* format;    // Not copied
+    HttpRequestBatch batches[HTTP_BATCH_MAX_REQUESTS];
+    int max;                         // Requests allowed (<= HTTP_BATCH_MAX_REQUESTS)
+    int num;                         // Requests rendered for key
+    char key[HTTP_BATCH_KEY_MAX];
+};
+
+void http_request_batches_init(HttpRequestBatches* set, const HttpEndpoint* ep,
+                               const HttpListFormat* format, int max);
+
+/**
+ * @brief Requests covering items[0..n), as many items per request as fit
+ *
+ * Rendered again only when the item list changes; the requests stay valid
+ * until the next call with a different list.
+ * @return number of requests in *out, 0 if an item is empty or the list
+ *         needs more than set->max requests
+ */
+int http_request_batches(HttpRequestBatches* set, const char* const* items, int n,
+                         const HttpRequestBatch** out);
+
+#endif // NET_ENDPOINT_H
@@ -1,195 +1,340 @@
 #include "net_http.h"
+#include "net_async.h"
+#include "net_dns.h"
+#include "net_endpoint.h"
+#include "net_http_parser.h"
+#include "net_pool.h"
+#include "net_timing.h"
+#include "net_transport.h"
 #include "../config.h"
 #include <WiFi.h>
 #include <WiFiClient.h>
 #if ENABLE_HTTPS
-#include <WiFiClientSecure.h>
+#include "net_tls.h"
 #endif
 
-// Helper: Parse URL into components
-static bool parse_url(const char* url, bool& is_https, String& host, int& port, String& path) {
-    String url_str(url);
-    
-    // Determine protocol
-    if (url_str.startsWith("https://")) {
-        is_https = true;
-        url_str = url_str.substring(8);
-    } else if (url_str.startsWith("http://")) {
-        is_https = false;
-        url_str = url_str.substring(7);
-    } else {
-        DEBUG_PRINTLN("[HTTP] ERROR: URL must start with http:// or https://");
-        return false;
+// Pooled connection backed by an Arduino Client (WiFiClient for HTTP,
+// TlsClient with session resumption for HTTPS).
+// The client object is kept for the lifetime of the pool slot and
+// reconnected in place, so reconnects don't churn the heap.
+class ClientPooledConnection : public PooledConnection {
+public:
+    explicit ClientPooledConnection(bool tls) : client(nullptr), plain_client(nullptr) {
+#if ENABLE_HTTPS
+        tls_client = nullptr;
+        if (tls) {
+            tls_client = new TlsClient();
+            client = tls_client;
+            return;
+        }
+#endif
+        plain_client = new WiFiClient();
+        client = plain_client;
     }
-    
-    // Find path separator
-    int path_idx = url_str.indexOf('/');
-    String host_port;
-    if (path_idx >= 0) {
-        host_port = url_str.substring(0, path_idx);
-        path = url_str.substring(path_idx);
-    } else {
-        host_port = url_str;
-        path = "/";
+
+    ~ClientPooledConnection() {
+        delete client;
     }
-    
-    // Parse host and port
-    int port_idx = host_port.indexOf(':');
-    if (port_idx >= 0) {
-        host = host_port.substring(0, port_idx);
-        port = host_port.substring(port_idx + 1).toInt();
-    } else {
-        host = host_port;
-        port = is_https ? 443 : 80;
+
+    bool open(const char* host, uint16_t port, uint32_t timeout_ms) {
+#if ENABLE_HTTPS
+        if (tls_client) {
+            tls_client->setHandshakeTimeout(timeout_ms);
+        }
+#endif
+        bool ok;
+        if (plain_client) {
+            plain_client->setTimeout(timeout_ms / 1000); // WiFiClient uses seconds
+            // WiFiClient::connect(host) would resolve on every connect
+            uint32_t ip;
+            ok = dns_resolve(host, &ip);
+            if (ok) {
+                uint32_t start_ms = millis();
+                ok = plain_client->connect(IPAddress(ip), port);
+                if (ok) {
+                    http_timing_record(host, HTTP_PHASE_CONNECT, millis() - start_ms);
+                } else {
+                    // Cached address may have moved: resolve again next time
+                    dns_invalidate(host);
+                }
+            }
+        } else {
+            // TlsClient resolves through the cache itself (async_socket_open)
+            ok = client->connect(host, port);
+#if ENABLE_HTTPS
+            if (!ok && tls_client->tcp_failed()) {
+                dns_invalidate(host);
+            }
+#endif
+        }
+        return ok;
     }
-    
-    return true;
-}
 
-bool http_get(const char* url, String& out, uint32_t timeout_ms) {
-    out = ""; // Clear output
-    
-    // Parse URL
-    bool is_https;
-    String host, path;
-    int port;
-    if (!parse_url(url, is_https, host, port, path)) {
-        return false;
+    bool is_open() {
+        return client->connected();
     }
-    
-    // DEBUG_PRINTF("[HTTP] GET %s://%s:%d%s\n", is_https ? "https" : "http", 
-    //               host.c_str(), port, path.c_str());
-    
-    unsigned long start_ms = millis();
-    
-    // Create appropriate client
-    WiFiClient* client = nullptr;
+
+    void close() {
+        client->stop();
+    }
+
+    Client* client;
+    WiFiClient* plain_client;
 #if ENABLE_HTTPS
-    WiFiClientSecure* secure_client = nullptr;
-    
-    if (is_https) {
-        secure_client = new WiFiClientSecure();
-        // PROTOTYPE: Skip certificate validation for simplicity
-        // TODO: For production, use setCACert() with proper certificates
-        secure_client->setInsecure();
-        client = secure_client;
-        // DEBUG_PRINTLN("[HTTP] Using HTTPS (insecure mode)");
-    } else {
-        client = new WiFiClient();
+    TlsClient* tls_client;
+#endif
+};
+
+static PooledConnection* wifi_connection_factory(bool tls) {
+    return new ClientPooledConnection(tls);
+}
+
+// Streams for the concurrent engine (net_async.h)
+static AsyncStream* async_stream_factory(bool tls) {
+#if ENABLE_HTTPS
+    if (tls) {
+        return new TlsAsyncStream();
     }
 #else
-    // HTTPS disabled - always use plain HTTP
-    if (is_https) {
-        DEBUG_PRINTLN("[HTTP] ERROR: HTTPS disabled, use HTTP URLs");
-        return false;
+    if (tls) {
+        return nullptr;
     }
-    client = new WiFiClient();
 #endif
+    return new SocketStream();
+}
+
+static uint32_t async_clock() {
+    return millis();
+}
+
+// The real transport: pooled Wi-Fi / TLS connections
+class WifiHttpTransport : public HttpTransport {
+public:
+    bool request(const HttpRequest* req, HttpChunkCallback cb, void* ctx, uint32_t timeout_ms) {
+        return http_request_stream(req, cb, ctx, timeout_ms);
+    }
+};
+
+static WifiHttpTransport g_wifi_transport;
+
+HttpTransport* http_wifi_transport() {
+    return &g_wifi_transport;
+}
+
+void http_init() {
+    dns_cache_init(dns_system_resolver, async_clock);
+    http_pool_init(wifi_connection_factory);
+    http_async_init(async_stream_factory, async_clock);
+    // Keep a record/replay transport installed before init
+    if (!http_transport_get()) {
+        http_transport_set(&g_wifi_transport);
+    }
+#if ENABLE_HTTPS
+    // Seed the RNG now rather than on the first request
+    tls_init();
+#endif
+    DEBUG_PRINTF("[HTTP] Keep-alive pool ready (%d slots, idle timeout %d ms)\n",
+                 HTTP_POOL_MAX_SLOTS, HTTP_POOL_IDLE_TIMEOUT_MS);
+    DEBUG_PRINTF("[HTTP] Async engine ready (%d concurrent connections)\n", HTTP_ASYNC_MAX_CONNS);
+}
+
+// HttpByteSource over an Arduino Client (bulk reads, no buffering)
+class ClientByteSource : public HttpByteSource {
+public:
+    explicit ClientByteSource(Client* c) : client(c), received(0), first_byte_ms(0) {}
+
+    int read_some(uint8_t* buf, size_t len) {
+        int avail = client->available();
+        if (avail > 0) {
+            int n = client->read(buf, (size_t)avail < len ? (size_t)avail : len);
+            if (n <= 0) {
+                return 0;
+            }
+            if (received == 0) {
+                first_byte_ms = millis();
+            }
+            received += n;
+            return n;
+        }
+        return client->connected() ? 0 : -1;
+    }
+
+    void idle() {
+        delay(1);
+    }
+
+    uint32_t now_ms() {
+        return millis();
+    }
+
+    Client* client;
+    size_t received;         // Bytes read so far
+    uint32_t first_byte_ms;  // When the first response byte arrived
+};
+
+// Send one pre-rendered GET over an open connection and read the response.
+// Sets keep_alive when the connection is left in a reusable state.
+// Sets stale when the connection failed before any response byte arrived
+// (typical for a keep-alive socket the server closed while it was idle).
+static bool http_exchange(Client* client, const HttpRequest* req,
+                          HttpChunkCallback cb, void* ctx, uint32_t timeout_ms,
+                          bool& keep_alive, bool& stale) {
+    keep_alive = false;
+    stale = false;
+    unsigned long start_ms = millis();
     
-    // Set connection timeout
-    client->setTimeout(timeout_ms / 1000); // WiFiClient uses seconds
-    
-    // Connect to server
-    // DEBUG_PRINTF("[HTTP] Connecting to %s:%d...\n", host.c_str(), port);
-    if (!client->connect(host.c_str(), port)) {
-        DEBUG_PRINTF("[HTTP] Connection failed (elapsed: %lu ms)\n", millis() - start_ms);
-        delete client;
+    // Request line and headers go out in a single write
+    if (client->write((const uint8_t*)req->data, req->len) != req->len) {
+        stale = true;
         return false;
     }
+    uint32_t sent_ms = millis();
     
-    unsigned long connect_ms = millis() - start_ms;
-    // DEBUG_PRINTF("[HTTP] Connected (took %lu ms)\n", connect_ms);
+    // Read status, headers and body in one pass; Content-Length / chunked
+    // framing ends the read on the last body byte instead of at socket close
+    HttpResponseParser parser;
+    http_parser_init(&parser);
+    uint8_t scratch[HTTP_READ_CHUNK_SIZE];
+    ClientByteSource src(client);
     
-    // Send HTTP request
-    client->printf("GET %s HTTP/1.1\r\n", path.c_str());
-    client->printf("Host: %s\r\n", host.c_str());
-    client->println("Connection: close");
-    client->println("User-Agent: ESP32-CryptoDash/1.0");
-    client->println();
+    HttpReadResult result = http_read_response(src, &parser, cb, ctx, scratch, sizeof(scratch),
+                                               start_ms, timeout_ms);
     
-    // Wait for response with timeout
-    unsigned long wait_start = millis();
-    while (!client->available() && (millis() - wait_start) < timeout_ms) {
-        delay(1);
-        if (!client->connected()) {
-            DEBUG_PRINTLN("[HTTP] Server disconnected while waiting for response");
-            delete client;
-            return false;
-        }
+    if (result == HTTP_READ_TIMEOUT) {
+        DEBUG_PRINTLN(parser.headers_done ? "[HTTP] Timeout reading body"
+                                          : "[HTTP] Timeout waiting for response");
+        return false;
     }
-    
-    if (!client->available()) {
-        DEBUG_PRINTLN("[HTTP] Timeout waiting for response");
-        delete client;
+    if (result == HTTP_READ_ABORTED) {
         return false;
     }
-    
-    // Read status line
-    String status_line = client->readStringUntil('\n');
-    status_line.trim();
-    // DEBUG_PRINTF("[HTTP] Status: %s\n", status_line.c_str());
-    
-    // Parse status code (handle both "HTTP/1.1 200 OK" and "HTTP/1.1 200")
-    int first_space = status_line.indexOf(' ');
-    if (first_space < 0) {
-        DEBUG_PRINTLN("[HTTP] Invalid status line format");
-        delete client;
+    if (result == HTTP_READ_CLOSED) {
+        if (src.received == 0) {
+            // Closed before the first response byte
+            stale = true;
+        } else if (!parser.headers_done) {
+            DEBUG_PRINTLN("[HTTP] Malformed or truncated response headers");
+        } else {
+            DEBUG_PRINTLN("[HTTP] Connection closed mid-body");
+        }
         return false;
     }
     
-    int second_space = status_line.indexOf(' ', first_space + 1);
-    String status_code_str;
+    const char* host = req->endpoint->host;
+    http_timing_record(host, HTTP_PHASE_TTFB, src.first_byte_ms - sent_ms);
+    http_timing_record(host, HTTP_PHASE_BODY, millis() - src.first_byte_ms);
     
-    if (second_space < 0) {
-        // No second space - format is "HTTP/1.1 200" without reason phrase
-        status_code_str = status_line.substring(first_space + 1);
-    } else {
-        // Format is "HTTP/1.1 200 OK" with reason phrase
-        status_code_str = status_line.substring(first_space + 1, second_space);
-    }
+    // Non-200 bodies were drained by the parser, so the connection stays reusable
+    keep_alive = http_parser_keep_alive(&parser);
     
-    status_code_str.trim();
-    int status_code = status_code_str.toInt();
+    if (parser.status_code != 200) {
+        DEBUG_PRINTF("[HTTP] Non-200 status: %d\n", parser.status_code);
+        return false;
+    }
     
-    if (status_code != 200) {
-        DEBUG_PRINTF("[HTTP] Non-200 status: %d\n", status_code);
-        delete client;
+    return true;
+}
+
+bool http_request_stream(const HttpRequest* req, HttpChunkCallback cb, void* ctx,
+                         uint32_t timeout_ms) {
+    if (!req || !req->endpoint || req->len == 0 || !cb) {
         return false;
     }
+    const HttpEndpoint* ep = req->endpoint;
     
-    // Skip headers
-    while (client->available()) {
-        String header = client->readStringUntil('\n');
-        header.trim();
-        if (header.length() == 0) {
-            break; // Empty line = end of headers
-        }
+#if !ENABLE_HTTPS
+    // HTTPS disabled - always use plain HTTP
+    if (ep->tls) {
+        DEBUG_PRINTLN("[HTTP] ERROR: HTTPS disabled, use HTTP URLs");
+        return false;
     }
+#endif
     
-    // Read response body
-    int bytes_read = 0;
-    while (client->available() || client->connected()) {
-        if (client->available()) {
-            char c = client->read();
-            out += c;
-            bytes_read++;
-        } else {
-            delay(1);
+    unsigned long start_ms = millis();
+    
+    // A reused keep-alive connection may have been closed by the server
+    // after we last checked; retry once on a fresh connection in that case.
+    // (stale means no response byte arrived, so cb has not been called yet)
+    for (int attempt = 0; attempt < 2; attempt++) {
+        bool reused = false;
+        PooledConnection* conn = http_pool_acquire(ep->host, ep->port, ep->tls,
+                                                   timeout_ms, millis(), &reused);
+        if (!conn) {
+            DEBUG_PRINTF("[HTTP] Connection to %s failed (elapsed: %lu ms)\n",
+                         ep->host, millis() - start_ms);
+            return false;
+        }
+        
+        Client* client = static_cast<ClientPooledConnection*>(conn)->client;
+        bool keep_alive = false;
+        bool stale = false;
+        bool ok = http_exchange(client, req, cb, ctx, timeout_ms, keep_alive, stale);
+        http_pool_release(conn, ok && keep_alive, millis());
+        
+        if (ok) {
+            http_timing_record(ep->host, HTTP_PHASE_TOTAL, millis() - start_ms);
+            return true;
         }
         
-        // Timeout check
-        if (millis() - start_ms > timeout_ms) {
-            DEBUG_PRINTLN("[HTTP] Timeout reading body");
-            delete client;
+        if (!(stale && reused)) {
             return false;
         }
+        DEBUG_PRINTLN("[HTTP] Kept-alive connection was closed by server, reconnecting");
     }
     
-    unsigned long elapsed_ms = millis() - start_ms;
-    // DEBUG_PRINTF("[HTTP] Success: %d bytes in %lu ms\n", bytes_read, elapsed_ms);
-    
-    client->stop();
-    delete client;
+    return false;
+}
+
+bool http_request_buf(const HttpRequest* req, char* buf, size_t cap, size_t* out_len,
+                      uint32_t timeout_ms) {
+    if (!buf || cap == 0) {
+        return false;
+    }
     
-    return true;
+    HttpBufferSink sink(buf, cap);
+    bool ok = http_request_stream(req, http_buffer_sink, &sink, timeout_ms);
+    if (sink.overflow) {
+        DEBUG_PRINTF("[HTTP] Response larger than %u byte buffer\n", (unsigned)cap);
+    }
+    if (out_len) {
+        *out_len = sink.len;
+    }
+    return ok && !sink.overflow;
+}
+
+bool http_get_stream(const char* url, HttpChunkCallback cb, void* ctx, uint32_t timeout_ms) {
+    // Ad-hoc URL: resolve and render on the stack (adapters keep theirs precompiled)
+    HttpEndpoint ep;
+    HttpRequest req;
+    if (!http_endpoint_init(&ep, url, nullptr)) {
+        DEBUG_PRINTLN("[HTTP] ERROR: URL must be http[s]://host[:port]/path");
+        return false;
+    }
+    if (!http_request_render(&req, &ep, nullptr)) {
+        DEBUG_PRINTLN("[HTTP] ERROR: URL too long");
+        return false;
+    }
+    return http_request_stream(&req, cb, ctx, timeout_ms);
+}
+
+bool http_get_buf(const char* url, char* buf, size_t cap, size_t* out_len, uint32_t timeout_ms) {
+    HttpEndpoint ep;
+    HttpRequest req;
+    if (!http_endpoint_init(&ep, url, nullptr) || !http_request_render(&req, &ep, nullptr)) {
+        DEBUG_PRINTLN("[HTTP] ERROR: Invalid URL");
+        return false;
+    }
+    return http_request_buf(&req, buf, cap, out_len, timeout_ms);
+}
+
+// HttpChunkCallback appending to an Arduino String (compat path)
+static bool string_sink(const uint8_t* data, size_t len, void* ctx) {
+    String* out = static_cast<String*>(ctx);
+    return out->concat((const char*)data, len);
+}
+
+bool http_get(const char* url, String& out, uint32_t timeout_ms) {
+    out = ""; // Clear output
+    out.reserve(256); // Typical single-symbol response, grows for larger bodies
+    return http_get_stream(url, string_sink, &out, timeout_ms);
 }
@@ -2,12 +2,51 @@
 #define NET_HTTP_H
 
 #include <Arduino.h>
+#include "net_endpoint.h"
+#include "net_http_stream.h"
+#include "net_transport.h"
 
 // HTTP client wrapper (Task 5.2)
 // Supports both HTTP and HTTPS with configurable timeouts
-// Uses WiFiClientSecure for HTTPS (setInsecure for prototype)
+// Uses TlsClient for HTTPS (insecure for prototype, resumes cached TLS sessions)
+// Connections are kept alive and reused per host (see net_pool.h)
+// Adapters send pre-rendered requests (see net_endpoint.h); the URL based
+// calls resolve and render on the stack for ad-hoc requests
 
-// Perform HTTP GET request
+// Initialize the keep-alive connection pool and the async engine (call once before http_get)
+void http_init();
+
+// Transport backed by the pooled Wi-Fi / TLS client (see net_transport.h)
+// Installed as the active transport by http_init() unless one is already set
+HttpTransport* http_wifi_transport();
+
+// Send a pre-rendered GET request, streaming the body to a callback
+// req: Rendered by http_request_render() / http_request_cache_get()
+// cb: Receives body chunks as they arrive (return false to abort)
+// Returns: true on success (200 OK and complete body), false on any error
+bool http_request_stream(const HttpRequest* req, HttpChunkCallback cb, void* ctx,
+                         uint32_t timeout_ms = 10000);
+
+// Send a pre-rendered GET request into a caller-provided buffer (no heap use)
+// Returns: false on any error, including a body that does not fit in buf
+bool http_request_buf(const HttpRequest* req, char* buf, size_t cap, size_t* out_len,
+                      uint32_t timeout_ms = 10000);
+
+// Perform HTTP GET request, streaming the body to a callback
+// url: Full URL (http:// or https://)
+// cb: Receives body chunks as they arrive (return false to abort)
+// ctx: Passed through to cb
+// timeout_ms: Total timeout for connection + read (default 10s)
+// Returns: true on success (200 OK and complete body), false on any error
+bool http_get_stream(const char* url, HttpChunkCallback cb, void* ctx, uint32_t timeout_ms = 10000);
+
+// Perform HTTP GET request into a caller-provided buffer (no heap use)
+// buf/cap: Output buffer, always NUL-terminated
+// out_len: Optional, receives body length
+// Returns: false on any error, including a body that does not fit in buf
+bool http_get_buf(const char* url, char* buf, size_t cap, size_t* out_len, uint32_t timeout_ms = 10000);
+
+// Perform HTTP GET request (compatibility wrapper around http_get_stream)
 // url: Full URL (http:// or https://)
 // out: Response body (cleared before use)
 // timeout_ms: Total timeout for connection + read (default 10s)
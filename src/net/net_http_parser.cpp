@@ -0,0 +1,274 @@
+#include "net_http_parser.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+void http_parser_init(HttpResponseParser* p) {
+    p->state = HTTP_PARSE_STATUS;
+    p->status_code = 0;
+    p->content_length = -1;
+    p->chunked = false;
+    p->connection_close = false;
+    p->headers_done = false;
+    p->remaining = 0;
+    p->body_bytes = 0;
+    p->aborted = false;
+    p->line_len = 0;
+    p->line_overflow = false;
+}
+
+// Case-insensitive "name:" prefix match, returns pointer to the value (spaces skipped)
+static const char* header_value(const char* line, const char* name) {
+    size_t n = strlen(name);
+    if (strncasecmp(line, name, n) != 0 || line[n] != ':') {
+        return nullptr;
+    }
+    const char* v = line + n + 1;
+    while (*v == ' ' || *v == '\t') v++;
+    return v;
+}
+
+// Case-insensitive token search within a header value
+static bool value_has_token(const char* value, const char* token) {
+    size_t n = strlen(token);
+    for (const char* s = value; *s; s++) {
+        if (strncasecmp(s, token, n) == 0) return true;
+    }
+    return false;
+}
+
+// Parse "HTTP/1.x 200 OK" (reason phrase optional)
+static bool parse_status_line(HttpResponseParser* p) {
+    if (strncmp(p->line, "HTTP/1.", 7) != 0) {
+        return false;
+    }
+    const char* sp = strchr(p->line, ' ');
+    if (!sp) {
+        return false;
+    }
+    while (*sp == ' ') sp++;
+    if (!isdigit((unsigned char)sp[0]) || !isdigit((unsigned char)sp[1]) ||
+        !isdigit((unsigned char)sp[2])) {
+        return false;
+    }
+    p->status_code = (sp[0] - '0') * 100 + (sp[1] - '0') * 10 + (sp[2] - '0');
+
+    // HTTP/1.0 closes after the response unless it says otherwise
+    if (p->line[7] == '0') {
+        p->connection_close = true;
+    }
+    return true;
+}
+
+static void parse_header_line(HttpResponseParser* p) {
+    const char* v;
+    if ((v = header_value(p->line, "Content-Length")) != nullptr) {
+        char* end;
+        long n = strtol(v, &end, 10);
+        if (end != v && n >= 0) {
+            p->content_length = n;
+        }
+    } else if ((v = header_value(p->line, "Transfer-Encoding")) != nullptr) {
+        if (value_has_token(v, "chunked")) {
+            p->chunked = true;
+        }
+    } else if ((v = header_value(p->line, "Connection")) != nullptr) {
+        if (value_has_token(v, "close")) {
+            p->connection_close = true;
+        } else if (value_has_token(v, "keep-alive")) {
+            p->connection_close = false;
+        }
+    }
+}
+
+// Decide body framing once the blank line after the headers arrives
+static void headers_complete(HttpResponseParser* p) {
+    // 1xx interim response: the real response follows
+    if (p->status_code >= 100 && p->status_code < 200) {
+        bool close = p->connection_close;
+        http_parser_init(p);
+        p->connection_close = close;
+        return;
+    }
+
+    p->headers_done = true;
+
+    if (p->status_code == 204 || p->status_code == 304) {
+        p->state = HTTP_PARSE_DONE;
+    } else if (p->chunked) {
+        p->state = HTTP_PARSE_CHUNK_SIZE;
+    } else if (p->content_length >= 0) {
+        p->remaining = p->content_length;
+        p->state = p->remaining > 0 ? HTTP_PARSE_BODY_LENGTH : HTTP_PARSE_DONE;
+    } else {
+        // No framing information - body ends when the server closes
+        p->connection_close = true;
+        p->state = HTTP_PARSE_BODY_CLOSE;
+    }
+}
+
+// Handle one complete line (CRLF stripped) for line-based states
+static void process_line(HttpResponseParser* p) {
+    switch (p->state) {
+        case HTTP_PARSE_STATUS:
+            if (p->line_overflow || !parse_status_line(p)) {
+                p->state = HTTP_PARSE_ERROR;
+            } else {
+                p->state = HTTP_PARSE_HEADERS;
+            }
+            break;
+
+        case HTTP_PARSE_HEADERS:
+            if (p->line_len == 0 && !p->line_overflow) {
+                headers_complete(p);
+            } else if (!p->line_overflow) {
+                parse_header_line(p);
+            }
+            // Over-long header lines (cookies etc.) are skipped
+            break;
+
+        case HTTP_PARSE_CHUNK_SIZE: {
+            // "1a2b[;extensions]"
+            char* end;
+            long size = strtol(p->line, &end, 16);
+            if (p->line_overflow || end == p->line || size < 0) {
+                p->state = HTTP_PARSE_ERROR;
+            } else if (size == 0) {
+                p->state = HTTP_PARSE_TRAILERS;
+            } else {
+                p->remaining = size;
+                p->state = HTTP_PARSE_CHUNK_DATA;
+            }
+            break;
+        }
+
+        case HTTP_PARSE_CHUNK_DATA_END:
+            p->state = (p->line_len == 0) ? HTTP_PARSE_CHUNK_SIZE : HTTP_PARSE_ERROR;
+            break;
+
+        case HTTP_PARSE_TRAILERS:
+            if (p->line_len == 0 && !p->line_overflow) {
+                p->state = HTTP_PARSE_DONE;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Forward body bytes (2xx only), returns false if the callback aborted
+static bool deliver(HttpResponseParser* p, const uint8_t* data, size_t len,
+                    HttpChunkCallback cb, void* ctx) {
+    p->body_bytes += len;
+    if (cb && p->status_code >= 200 && p->status_code < 300) {
+        if (!cb(data, len, ctx)) {
+            p->aborted = true;
+            p->state = HTTP_PARSE_ERROR;
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t http_parser_feed(HttpResponseParser* p, const uint8_t* data, size_t len,
+                        HttpChunkCallback cb, void* ctx) {
+    size_t i = 0;
+
+    while (i < len && p->state != HTTP_PARSE_DONE && p->state != HTTP_PARSE_ERROR) {
+        switch (p->state) {
+            case HTTP_PARSE_BODY_LENGTH:
+            case HTTP_PARSE_CHUNK_DATA: {
+                size_t n = len - i;
+                if ((long)n > p->remaining) {
+                    n = (size_t)p->remaining;
+                }
+                if (!deliver(p, data + i, n, cb, ctx)) {
+                    return i + n;
+                }
+                i += n;
+                p->remaining -= n;
+                if (p->remaining == 0) {
+                    p->state = (p->state == HTTP_PARSE_BODY_LENGTH) ? HTTP_PARSE_DONE
+                                                                    : HTTP_PARSE_CHUNK_DATA_END;
+                }
+                break;
+            }
+
+            case HTTP_PARSE_BODY_CLOSE: {
+                size_t n = len - i;
+                if (!deliver(p, data + i, n, cb, ctx)) {
+                    return len;
+                }
+                i = len;
+                break;
+            }
+
+            default: {
+                // Line-based states: assemble up to '\n'
+                char c = (char)data[i++];
+                if (c == '\n') {
+                    if (p->line_len > 0 && p->line[p->line_len - 1] == '\r') {
+                        p->line_len--;
+                    }
+                    p->line[p->line_len] = '\0';
+                    process_line(p);
+                    p->line_len = 0;
+                    p->line_overflow = false;
+                } else if (p->line_len < HTTP_PARSER_LINE_MAX - 1) {
+                    p->line[p->line_len++] = c;
+                } else {
+                    p->line_overflow = true;
+                }
+                break;
+            }
+        }
+    }
+
+    return i;
+}
+
+void http_parser_eof(HttpResponseParser* p) {
+    if (p->state == HTTP_PARSE_BODY_CLOSE) {
+        p->state = HTTP_PARSE_DONE;
+    } else if (p->state != HTTP_PARSE_DONE) {
+        p->state = HTTP_PARSE_ERROR;
+    }
+}
+
+HttpReadResult http_read_response(HttpByteSource& src, HttpResponseParser* p,
+                                  HttpChunkCallback cb, void* ctx,
+                                  uint8_t* scratch, size_t scratch_len,
+                                  uint32_t start_ms, uint32_t timeout_ms) {
+    while (!http_parser_done(p)) {
+        if (http_parser_failed(p)) {
+            return p->aborted ? HTTP_READ_ABORTED : HTTP_READ_CLOSED;
+        }
+
+        // Whole-response deadline: a peer trickling bytes must not hold the caller
+        if (src.now_ms() - start_ms > timeout_ms) {
+            return HTTP_READ_TIMEOUT;
+        }
+
+        size_t want = scratch_len;
+        if (p->state == HTTP_PARSE_BODY_LENGTH && (long)want > p->remaining) {
+            want = (size_t)p->remaining;
+        }
+
+        int n = src.read_some(scratch, want);
+        if (n > 0) {
+            http_parser_feed(p, scratch, (size_t)n, cb, ctx);
+            continue;
+        }
+
+        if (n < 0) {
+            http_parser_eof(p);
+            continue;
+        }
+
+        src.idle();
+    }
+
+    return HTTP_READ_OK;
+}
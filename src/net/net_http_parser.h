@@ -0,0 +1,104 @@
+#ifndef NET_HTTP_PARSER_H
+#define NET_HTTP_PARSER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "net_http_stream.h"
+
+/**
+ * @file net_http_parser.h
+ * @brief Incremental HTTP/1.1 response parser (status, headers, framing)
+ *
+ * Push parser: bytes are fed as they arrive and body bytes are forwarded
+ * to an HttpChunkCallback. Honours Content-Length and
+ * Transfer-Encoding: chunked, so a response is complete the moment its
+ * last byte arrives instead of when the server closes the socket.
+ *
+ * Arduino-independent and allocation-free (fixed line buffer), unit
+ * tested on the host with canned byte streams.
+ */
+
+// Longest status/header line kept; longer header lines are skipped
+#define HTTP_PARSER_LINE_MAX 128
+
+enum HttpParserState {
+    HTTP_PARSE_STATUS = 0,    // Reading status line
+    HTTP_PARSE_HEADERS,       // Reading header lines
+    HTTP_PARSE_BODY_LENGTH,   // Content-Length body
+    HTTP_PARSE_BODY_CLOSE,    // Body delimited by connection close
+    HTTP_PARSE_CHUNK_SIZE,    // Chunk size line
+    HTTP_PARSE_CHUNK_DATA,    // Chunk payload
+    HTTP_PARSE_CHUNK_DATA_END,// CRLF after chunk payload
+    HTTP_PARSE_TRAILERS,      // Trailer lines after last chunk
+    HTTP_PARSE_DONE,          // Response complete
+    HTTP_PARSE_ERROR          // Malformed response
+};
+
+struct HttpResponseParser {
+    HttpParserState state;
+    int status_code;          // e.g. 200 (valid once headers are parsed)
+    long content_length;      // -1 if not sent
+    bool chunked;             // Transfer-Encoding: chunked
+    bool connection_close;    // Server asked to close (or HTTP/1.0 without keep-alive)
+    bool headers_done;        // Status line and headers parsed
+    long remaining;           // Bytes left in body / current chunk
+    uint32_t body_bytes;      // Body bytes seen (delivered or discarded)
+    bool aborted;             // Callback returned false (state is HTTP_PARSE_ERROR)
+
+    // Line assembly
+    char line[HTTP_PARSER_LINE_MAX];
+    size_t line_len;
+    bool line_overflow;
+};
+
+// Reset parser for a new response
+void http_parser_init(HttpResponseParser* p);
+
+/**
+ * @brief Feed received bytes into the parser
+ *
+ * Body bytes of 2xx responses are forwarded to cb; bodies of other
+ * responses are consumed and dropped so the connection stays reusable.
+ * Parsing stops at the end of the response: bytes after it are not
+ * consumed.
+ *
+ * @return Number of bytes consumed from data
+ */
+size_t http_parser_feed(HttpResponseParser* p, const uint8_t* data, size_t len,
+                        HttpChunkCallback cb, void* ctx);
+
+/**
+ * @brief Signal that the peer closed the connection
+ * Completes a close-delimited body; anything else still pending is an error.
+ */
+void http_parser_eof(HttpResponseParser* p);
+
+// True once the complete response has been parsed
+inline bool http_parser_done(const HttpResponseParser* p) { return p->state == HTTP_PARSE_DONE; }
+
+// True if the response was malformed or the callback aborted
+inline bool http_parser_failed(const HttpResponseParser* p) { return p->state == HTTP_PARSE_ERROR; }
+
+// True if the connection can carry another request after this response
+inline bool http_parser_keep_alive(const HttpResponseParser* p) {
+    return p->state == HTTP_PARSE_DONE && !p->connection_close;
+}
+
+/**
+ * @brief Read one complete response from src into the parser
+ *
+ * Bulk-reads through scratch and feeds the parser until the response is
+ * complete, the peer closes, the callback aborts or the timeout expires.
+ * Once the body length is known, reads are bounded by the bytes remaining.
+ * timeout_ms bounds the whole response from start_ms (checked before every
+ * read), not the gap between bytes.
+ *
+ * @return HTTP_READ_OK when the parser reached HTTP_PARSE_DONE,
+ *         HTTP_READ_CLOSED also for malformed responses
+ */
+HttpReadResult http_read_response(HttpByteSource& src, HttpResponseParser* p,
+                                  HttpChunkCallback cb, void* ctx,
+                                  uint8_t* scratch, size_t scratch_len,
+                                  uint32_t start_ms, uint32_t timeout_ms);
+
+#endif // NET_HTTP_PARSER_H
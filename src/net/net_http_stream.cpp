@@ -0,0 +1,19 @@
+#include "net_http_stream.h"
+#include <string.h>
+
+bool http_buffer_sink(const uint8_t* data, size_t len, void* ctx) {
+    HttpBufferSink* sink = static_cast<HttpBufferSink*>(ctx);
+    if (!sink || !sink->buf || sink->cap == 0) {
+        return false;
+    }
+
+    if (sink->len + len + 1 > sink->cap) {
+        sink->overflow = true;
+        return false;
+    }
+
+    memcpy(sink->buf + sink->len, data, len);
+    sink->len += len;
+    sink->buf[sink->len] = '\0';
+    return true;
+}
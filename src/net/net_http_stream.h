@@ -0,0 +1,77 @@
+#ifndef NET_HTTP_STREAM_H
+#define NET_HTTP_STREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @file net_http_stream.h
+ * @brief Byte source, chunk callback and sink of the streaming HTTP reader
+ *
+ * http_read_response() (net_http_parser.h) pulls the response off the
+ * connection in bulk chunks through a fixed scratch buffer and hands each
+ * body chunk to a callback, instead of appending one byte at a time to a
+ * String.
+ *
+ * Arduino-independent: the connection is abstracted as an HttpByteSource
+ * so the reader can be benchmarked on the host with canned payloads.
+ */
+
+// Scratch buffer size for bulk body reads (bytes per read() call)
+#define HTTP_READ_CHUNK_SIZE 512
+
+/**
+ * @brief Receives body bytes as they arrive
+ * @param data Chunk data (valid only during the call, not NUL-terminated)
+ * @param len Chunk length
+ * @param ctx Caller context
+ * @return true to continue, false to abort the request
+ */
+typedef bool (*HttpChunkCallback)(const uint8_t* data, size_t len, void* ctx);
+
+/**
+ * @brief Byte source the body reader pulls from
+ * WiFiClient/TlsClient on the device, memory or sockets on the host.
+ */
+class HttpByteSource {
+public:
+    virtual ~HttpByteSource() {}
+
+    // Read up to len bytes: >0 bytes read, 0 if no data yet, -1 once the peer closed
+    virtual int read_some(uint8_t* buf, size_t len) = 0;
+
+    // Wait briefly for more data (delay(1) on the device)
+    virtual void idle() = 0;
+
+    // Millisecond clock used for timeouts
+    virtual uint32_t now_ms() = 0;
+};
+
+// Result of http_read_response()
+enum HttpReadResult {
+    HTTP_READ_OK = 0,     // Response complete (or peer closed a close-delimited body)
+    HTTP_READ_TIMEOUT,    // Deadline passed
+    HTTP_READ_CLOSED,     // Peer closed early or the response was malformed
+    HTTP_READ_ABORTED     // Callback returned false
+};
+
+// Fixed-buffer sink for http_buffer_sink(): body is copied into buf
+struct HttpBufferSink {
+    char* buf;        // Caller-provided buffer
+    size_t cap;       // Buffer capacity (one byte is reserved for NUL)
+    size_t len;       // Bytes stored so far
+    bool overflow;    // Body did not fit
+
+    HttpBufferSink() : buf(nullptr), cap(0), len(0), overflow(false) {}
+    HttpBufferSink(char* b, size_t c) : buf(b), cap(c), len(0), overflow(false) {
+        if (buf && cap > 0) buf[0] = '\0';
+    }
+};
+
+/**
+ * @brief HttpChunkCallback that appends into an HttpBufferSink (ctx)
+ * Keeps the buffer NUL-terminated; aborts with overflow set if it is full.
+ */
+bool http_buffer_sink(const uint8_t* data, size_t len, void* ctx);
+
+#endif // NET_HTTP_STREAM_H
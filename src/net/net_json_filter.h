@@ -0,0 +1,42 @@
+#ifndef NET_JSON_FILTER_H
+#define NET_JSON_FILTER_H
+
+#include <ArduinoJson.h>
+
+/**
+ * @file net_json_filter.h
+ * @brief ArduinoJson filter documents for the exchange adapters
+ *
+ * A filter is declared once with the shape of the fields an adapter reads,
+ * e.g. {"symbol":true,"price":true}, and passed to deserializeJson() as
+ * DeserializationOption::Filter. Members outside the shape are skipped by
+ * the parser instead of being stored, so the response document only needs
+ * room for the fields that are used (see the *_DOC_SIZE constants in the
+ * adapters) whatever else the exchange adds to its responses.
+ *
+ * The shape is parsed on first use (its member names are copied, so
+ * CAPACITY covers the slots plus the names); filters are only touched by
+ * the network task.
+ */
+
+template <size_t CAPACITY>
+class JsonFilter {
+public:
+    explicit JsonFilter(const char* shape) : _shape(shape), _ready(false) {}
+
+    // Filter option for deserializeJson(doc, body, len, filter.option())
+    DeserializationOption::Filter option() {
+        if (!_ready) {
+            deserializeJson(_doc, _shape);
+            _ready = true;
+        }
+        return DeserializationOption::Filter(_doc);
+    }
+
+private:
+    const char* _shape;
+    bool _ready;
+    StaticJsonDocument<CAPACITY> _doc;
+};
+
+#endif // NET_JSON_FILTER_H
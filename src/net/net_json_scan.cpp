@@ -0,0 +1,91 @@
+#include "net_json_scan.h"
+#include <string.h>
+
+static bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+char json_scan_shape(const char* body, size_t len) {
+    if (!body) {
+        return 0;
+    }
+    size_t start = 0;
+    while (start < len && is_space(body[start])) {
+        start++;
+    }
+    size_t end = len;
+    while (end > start && is_space(body[end - 1])) {
+        end--;
+    }
+    if (end - start < 2) {
+        return 0;
+    }
+    char open = body[start];
+    char close = body[end - 1];
+    if (!((open == '{' && close == '}') || (open == '[' && close == ']'))) {
+        return 0;
+    }
+    return memchr(body + start, '\\', end - start) ? 0 : open;
+}
+
+const char* json_scan_string(const char* body, size_t len, const char* key, size_t* out_len) {
+    if (!body || !key || !out_len) {
+        return nullptr;
+    }
+    size_t key_len = strlen(key);
+    const char* end = body + len;
+    const char* p = body;
+
+    // "key" followed by ':' is a member name: a string value is never followed by ':'
+    while (p + key_len + 2 <= end) {
+        const char* quote = (const char*)memchr(p, '"', end - p);
+        if (!quote || quote + key_len + 2 > end) {
+            return nullptr;
+        }
+        const char* name = quote + 1;
+        const char* name_end = (const char*)memchr(name, '"', end - name);
+        if (!name_end) {
+            return nullptr;
+        }
+        p = name_end + 1;
+        if ((size_t)(name_end - name) != key_len || memcmp(name, key, key_len) != 0) {
+            continue;
+        }
+        while (p < end && is_space(*p)) {
+            p++;
+        }
+        if (p >= end || *p != ':') {
+            continue;   // Same text as a value, keep looking
+        }
+        p++;
+        while (p < end && is_space(*p)) {
+            p++;
+        }
+        if (p >= end || *p != '"') {
+            return nullptr;   // Number, literal or container
+        }
+        const char* value = p + 1;
+        const char* value_end = (const char*)memchr(value, '"', end - value);
+        if (!value_end) {
+            return nullptr;
+        }
+        *out_len = value_end - value;
+        return value;
+    }
+    return nullptr;
+}
+
+bool json_scan_fixed_field(const char* body, size_t len, const char* key, Fixed* out) {
+    size_t value_len;
+    const char* value = json_scan_string(body, len, key, &value_len);
+    return value && fixed_parse(value, value_len, out);
+}
+
+bool json_scan_equals(const char* body, size_t len, const char* key, const char* expected) {
+    if (!expected) {
+        return false;
+    }
+    size_t value_len;
+    const char* value = json_scan_string(body, len, key, &value_len);
+    return value && value_len == strlen(expected) && memcmp(value, expected, value_len) == 0;
+}
@@ -0,0 +1,49 @@
+#ifndef NET_JSON_SCAN_H
+#define NET_JSON_SCAN_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../app/app_fixed.h"
+
+/**
+ * @file net_json_scan.h
+ * @brief In-place field extractor for small fixed-shape JSON responses
+ *
+ * The Binance ticker, Binance funding rate and Coinbase spot responses are
+ * a handful of string members, e.g. {"symbol":"BTCUSDT","price":"43250.50"}.
+ * Instead of building a JSON document, the body is scanned for a member
+ * name and the string value is returned as a pointer into the body, and
+ * decimal strings are converted straight to Fixed (fixed_parse()).
+ *
+ * The scanner is deliberately strict: escapes, exponents, unterminated
+ * strings or a body that is not one closed object / array all make it
+ * fail, and callers fall back to ArduinoJson. Arduino-independent and
+ * allocation-free, unit tested on the host.
+ */
+
+/**
+ * @brief Check the body is one object or array with nothing the scanner skips
+ * @return '{' or '[' (the enclosing bracket), 0 on a backslash anywhere or a
+ *         body not enclosed in {} / []
+ */
+char json_scan_shape(const char* body, size_t len);
+
+/**
+ * @brief Find the string value of member name key (first occurrence)
+ * Call json_scan_shape() on the body first.
+ * @param out_len Receives the value length (without quotes)
+ * @return Pointer to the first value character inside body, nullptr if the
+ *         member is missing or its value is not a string
+ */
+const char* json_scan_string(const char* body, size_t len, const char* key, size_t* out_len);
+
+/**
+ * @brief Fixed value of the string member key (json_scan_string + fixed_parse)
+ * @return false if the member is missing, not a string or not a plain decimal
+ */
+bool json_scan_fixed_field(const char* body, size_t len, const char* key, Fixed* out);
+
+// True if the string member key equals expected (byte compare, no copy)
+bool json_scan_equals(const char* body, size_t len, const char* key, const char* expected);
+
+#endif // NET_JSON_SCAN_H
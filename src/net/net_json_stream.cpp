@@ -0,0 +1,310 @@
+#include "net_json_stream.h"
+#include <string.h>
+
+void json_stream_init(JsonStreamParser* p, JsonStreamCallback cb, void* ctx) {
+    memset(p, 0, sizeof(*p));
+    p->state = JSON_STREAM_VALUE;
+    p->cb = cb;
+    p->ctx = ctx;
+}
+
+static bool in_object(const JsonStreamParser* p) {
+    return p->depth > 0 && (p->objects & (1u << (p->depth - 1)));
+}
+
+static void fail(JsonStreamParser* p) {
+    p->state = JSON_STREAM_ERROR;
+}
+
+// Report a token; the member name it belongs to is consumed
+static bool emit(JsonStreamParser* p, JsonStreamEvent event, JsonValueType type) {
+    JsonStreamToken tok;
+    tok.event = event;
+    tok.type = type;
+    tok.depth = p->depth;
+    tok.key = p->has_key ? p->key : nullptr;
+    if (event == JSON_EVENT_VALUE) {
+        p->value[p->value_len] = '\0';
+        tok.value = p->value;
+        tok.value_len = p->value_len;
+        tok.truncated = p->truncated;
+    } else {
+        tok.value = "";
+        tok.value_len = 0;
+        tok.truncated = false;
+    }
+    p->has_key = false;
+
+    if (p->cb && !p->cb(&tok, p->ctx)) {
+        p->aborted = true;
+        fail(p);
+        return false;
+    }
+    return true;
+}
+
+static void put_value(JsonStreamParser* p, char c) {
+    if (p->value_len + 1 < sizeof(p->value)) {
+        p->value[p->value_len++] = c;
+    } else {
+        p->truncated = true;
+    }
+}
+
+static void put_key(JsonStreamParser* p, char c) {
+    // Over-long names are cut off (they never match a wanted field)
+    if (p->key_len + 1 < sizeof(p->key)) {
+        p->key[p->key_len++] = c;
+    }
+}
+
+// State after a value completed at the current depth
+static void value_done(JsonStreamParser* p) {
+    p->state = p->depth == 0 ? JSON_STREAM_DONE : JSON_STREAM_AFTER_VALUE;
+}
+
+static bool open_container(JsonStreamParser* p, bool object) {
+    if (p->depth >= JSON_STREAM_DEPTH_MAX) {
+        fail(p);
+        return false;
+    }
+    if (!emit(p, object ? JSON_EVENT_OBJECT_START : JSON_EVENT_ARRAY_START, JSON_TYPE_NONE)) {
+        return false;
+    }
+    if (object) {
+        p->objects |= (uint16_t)(1u << p->depth);
+    } else {
+        p->objects &= (uint16_t)~(1u << p->depth);
+    }
+    p->depth++;
+    p->just_opened = true;
+    p->state = object ? JSON_STREAM_KEY : JSON_STREAM_VALUE;
+    return true;
+}
+
+static bool close_container(JsonStreamParser* p, char c) {
+    bool object = in_object(p);
+    if (p->depth == 0 || c != (object ? '}' : ']')) {
+        fail(p);
+        return false;
+    }
+    p->depth--;
+    p->has_key = false;
+    if (!emit(p, object ? JSON_EVENT_OBJECT_END : JSON_EVENT_ARRAY_END, JSON_TYPE_NONE)) {
+        return false;
+    }
+    value_done(p);
+    return true;
+}
+
+// Classify and report a completed number / literal
+static bool finish_scalar(JsonStreamParser* p) {
+    p->value[p->value_len] = '\0';
+    JsonValueType type;
+    if (strcmp(p->value, "true") == 0) {
+        type = JSON_TYPE_TRUE;
+    } else if (strcmp(p->value, "false") == 0) {
+        type = JSON_TYPE_FALSE;
+    } else if (strcmp(p->value, "null") == 0) {
+        type = JSON_TYPE_NULL;
+    } else if (p->value[0] == '-' || (p->value[0] >= '0' && p->value[0] <= '9')) {
+        type = JSON_TYPE_NUMBER;
+    } else {
+        fail(p);
+        return false;
+    }
+    if (!emit(p, JSON_EVENT_VALUE, type)) {
+        return false;
+    }
+    value_done(p);
+    return true;
+}
+
+static int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// One character inside a string; returns false when the string is malformed
+static bool string_char(JsonStreamParser* p, char c, bool is_key, bool* closed) {
+    *closed = false;
+    char out;
+    if (p->unicode_left > 0) {
+        int d = hex_digit(c);
+        if (d < 0) {
+            return false;
+        }
+        p->unicode = (uint16_t)((p->unicode << 4) | d);
+        if (--p->unicode_left > 0) {
+            return true;
+        }
+        // Only ASCII is decoded; other code points become '?'
+        out = p->unicode < 0x80 ? (char)p->unicode : '?';
+    } else if (p->escape) {
+        p->escape = false;
+        switch (c) {
+            case '"': out = '"'; break;
+            case '\\': out = '\\'; break;
+            case '/': out = '/'; break;
+            case 'b': out = '\b'; break;
+            case 'f': out = '\f'; break;
+            case 'n': out = '\n'; break;
+            case 'r': out = '\r'; break;
+            case 't': out = '\t'; break;
+            case 'u':
+                p->unicode_left = 4;
+                p->unicode = 0;
+                return true;
+            default:
+                return false;
+        }
+    } else if (c == '\\') {
+        p->escape = true;
+        return true;
+    } else if (c == '"') {
+        *closed = true;
+        return true;
+    } else if ((unsigned char)c < 0x20) {
+        return false;
+    } else {
+        out = c;
+    }
+
+    if (is_key) {
+        put_key(p, out);
+    } else {
+        put_value(p, out);
+    }
+    return true;
+}
+
+static bool is_space(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+static bool is_scalar_char(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           c == '-' || c == '+' || c == '.';
+}
+
+bool json_stream_feed(JsonStreamParser* p, const char* data, size_t len) {
+    size_t i = 0;
+    while (i < len) {
+        if (p->state == JSON_STREAM_ERROR) {
+            return false;
+        }
+        if (p->state == JSON_STREAM_DONE) {
+            return true;
+        }
+
+        char c = data[i];
+        bool closed = false;
+
+        switch (p->state) {
+            case JSON_STREAM_STRING:
+            case JSON_STREAM_KEY_STRING: {
+                bool is_key = p->state == JSON_STREAM_KEY_STRING;
+                if (!string_char(p, c, is_key, &closed)) {
+                    fail(p);
+                    break;
+                }
+                if (closed) {
+                    if (is_key) {
+                        p->key[p->key_len] = '\0';
+                        p->has_key = true;
+                        p->state = JSON_STREAM_COLON;
+                    } else if (emit(p, JSON_EVENT_VALUE, JSON_TYPE_STRING)) {
+                        value_done(p);
+                    }
+                }
+                break;
+            }
+
+            case JSON_STREAM_SCALAR:
+                if (is_scalar_char(c)) {
+                    put_value(p, c);
+                    break;
+                }
+                // Delimiter: report the scalar, then handle c in the new state
+                if (finish_scalar(p)) {
+                    continue;
+                }
+                break;
+
+            case JSON_STREAM_VALUE:
+                if (is_space(c)) {
+                    break;
+                }
+                if (c == ']' && p->just_opened && !in_object(p)) {
+                    close_container(p, c);
+                    break;
+                }
+                p->just_opened = false;
+                p->value_len = 0;
+                p->truncated = false;
+                if (c == '{' || c == '[') {
+                    open_container(p, c == '{');
+                } else if (c == '"') {
+                    p->escape = false;
+                    p->unicode_left = 0;
+                    p->state = JSON_STREAM_STRING;
+                } else if (is_scalar_char(c)) {
+                    put_value(p, c);
+                    p->state = JSON_STREAM_SCALAR;
+                } else {
+                    fail(p);
+                }
+                break;
+
+            case JSON_STREAM_KEY:
+                if (is_space(c)) {
+                    break;
+                }
+                if (c == '}' && p->just_opened) {
+                    close_container(p, c);
+                } else if (c == '"') {
+                    p->just_opened = false;
+                    p->key_len = 0;
+                    p->escape = false;
+                    p->unicode_left = 0;
+                    p->state = JSON_STREAM_KEY_STRING;
+                } else {
+                    fail(p);
+                }
+                break;
+
+            case JSON_STREAM_COLON:
+                if (is_space(c)) {
+                    break;
+                }
+                if (c == ':') {
+                    p->state = JSON_STREAM_VALUE;
+                } else {
+                    fail(p);
+                }
+                break;
+
+            case JSON_STREAM_AFTER_VALUE:
+                if (is_space(c)) {
+                    break;
+                }
+                if (c == ',') {
+                    p->state = in_object(p) ? JSON_STREAM_KEY : JSON_STREAM_VALUE;
+                } else if (c == '}' || c == ']') {
+                    close_container(p, c);
+                } else {
+                    fail(p);
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        i++;
+        p->bytes++;
+    }
+    return p->state != JSON_STREAM_ERROR;
+}
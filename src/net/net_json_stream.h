@@ -0,0 +1,113 @@
+#ifndef NET_JSON_STREAM_H
+#define NET_JSON_STREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @file net_json_stream.h
+ * @brief Incremental (SAX-style) JSON tokenizer
+ *
+ * Push parser: body chunks are fed as they arrive and every value is
+ * reported through a callback together with its member name, so a large
+ * response (e.g. Binance premiumIndex for every listed symbol) can be
+ * filtered on the fly instead of being buffered and deserialized whole.
+ *
+ * Strings and scalars are collected in fixed buffers; longer ones are cut
+ * off and flagged as truncated. Arduino-independent and allocation-free,
+ * unit tested on the host with byte-by-byte feeds.
+ */
+
+// Longest member name kept (incl. NUL)
+#define JSON_STREAM_KEY_MAX 32
+
+// Longest string / number value kept (incl. NUL)
+#define JSON_STREAM_VALUE_MAX 48
+
+// Deepest container nesting accepted
+#define JSON_STREAM_DEPTH_MAX 16
+
+enum JsonStreamEvent {
+    JSON_EVENT_OBJECT_START = 0,
+    JSON_EVENT_OBJECT_END,
+    JSON_EVENT_ARRAY_START,
+    JSON_EVENT_ARRAY_END,
+    JSON_EVENT_VALUE            // String, number or literal
+};
+
+enum JsonValueType {
+    JSON_TYPE_NONE = 0,         // Container events
+    JSON_TYPE_STRING,
+    JSON_TYPE_NUMBER,
+    JSON_TYPE_TRUE,
+    JSON_TYPE_FALSE,
+    JSON_TYPE_NULL
+};
+
+struct JsonStreamToken {
+    JsonStreamEvent event;
+    JsonValueType type;
+    uint8_t depth;              // Containers enclosing the token (top level array = 1 for its items)
+    const char* key;            // Member name, nullptr for array items and the top level
+    const char* value;          // NUL-terminated text of a VALUE, "" otherwise
+    size_t value_len;
+    bool truncated;             // Value longer than JSON_STREAM_VALUE_MAX - 1
+};
+
+/**
+ * @brief Receives tokens as they are parsed
+ * Pointers in tok are only valid during the call.
+ * @return true to continue, false to stop parsing (parser fails)
+ */
+typedef bool (*JsonStreamCallback)(const JsonStreamToken* tok, void* ctx);
+
+enum JsonStreamState {
+    JSON_STREAM_VALUE = 0,      // Expecting a value
+    JSON_STREAM_KEY,            // Expecting a member name
+    JSON_STREAM_COLON,          // Expecting ':' after a member name
+    JSON_STREAM_AFTER_VALUE,    // Expecting ',' or a closing bracket
+    JSON_STREAM_KEY_STRING,     // Inside a member name
+    JSON_STREAM_STRING,         // Inside a string value
+    JSON_STREAM_SCALAR,         // Inside a number or literal
+    JSON_STREAM_DONE,           // Top level value complete
+    JSON_STREAM_ERROR           // Malformed input or callback stopped
+};
+
+struct JsonStreamParser {
+    JsonStreamState state;
+    JsonStreamCallback cb;
+    void* ctx;
+    uint8_t depth;
+    uint16_t objects;           // Bit d set: container at depth d + 1 is an object
+    bool just_opened;           // Closing bracket allowed without a value
+    bool escape;                // Previous string character was a backslash
+    uint8_t unicode_left;       // Hex digits left in a \uXXXX escape
+    uint16_t unicode;
+    bool aborted;               // Callback returned false
+    uint32_t bytes;             // Bytes consumed
+
+    char key[JSON_STREAM_KEY_MAX];
+    size_t key_len;
+    bool has_key;
+    char value[JSON_STREAM_VALUE_MAX];
+    size_t value_len;
+    bool truncated;
+};
+
+// Reset parser for a new document
+void json_stream_init(JsonStreamParser* p, JsonStreamCallback cb, void* ctx);
+
+/**
+ * @brief Feed the next chunk of the document
+ * Bytes after the end of the top level value are ignored.
+ * @return false once the document is malformed or the callback stopped
+ */
+bool json_stream_feed(JsonStreamParser* p, const char* data, size_t len);
+
+// True once the top level object / array has been closed
+inline bool json_stream_done(const JsonStreamParser* p) { return p->state == JSON_STREAM_DONE; }
+
+// True if the document was malformed or the callback stopped parsing
+inline bool json_stream_failed(const JsonStreamParser* p) { return p->state == JSON_STREAM_ERROR; }
+
+#endif // NET_JSON_STREAM_H
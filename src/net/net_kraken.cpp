@@ -0,0 +1,198 @@
+#include "net_kraken.h"
+#include "../config.h"
+#include "net_dns.h"
+#include "net_transport.h"
+#include <stdio.h>
+#include <string.h>
+
+// Kraken API base URL - use HTTP or HTTPS based on config
+#if ENABLE_HTTPS
+static const char* KRAKEN_API_BASE = "https://api.kraken.com";
+#else
+static const char* KRAKEN_API_BASE = "http://api.kraken.com";
+#endif
+
+namespace net_kraken {
+
+// Endpoint resolved once in init(); requests rendered once per pair list
+static HttpEndpoint g_ticker_endpoint;
+static HttpRequestBatches g_batches;
+static bool g_initialized = false;
+
+// Pairs are a plain comma-separated list: XXBTZUSD,XETHZUSD
+static const HttpListFormat PAIR_LIST_FORMAT = { "", "", "" };
+
+void init() {
+    http_endpoint_init(&g_ticker_endpoint, KRAKEN_API_BASE, "/0/public/Ticker?pair=" HTTP_PATH_ARG);
+    dns_register(g_ticker_endpoint.host);
+    http_request_batches_init(&g_batches, &g_ticker_endpoint, &PAIR_LIST_FORMAT, TICKER_MAX_REQUESTS);
+    g_initialized = true;
+}
+
+int ticker_requests(const char* const* pairs, int n, const TickerBatch** out_batches) {
+    if (!pairs || n <= 0 || n > 255 || !out_batches) {
+        return 0;
+    }
+    if (!g_initialized) {
+        init();
+    }
+    return http_request_batches(&g_batches, pairs, n, out_batches);
+}
+
+static bool ticker_token(const JsonStreamToken* tok, void* ctx) {
+    TickerScan* scan = static_cast<TickerScan*>(ctx);
+
+    // {"error":["EQuery:Unknown asset pair"],"result":{}}
+    if (tok->depth == 2 && !tok->key && tok->event == JSON_EVENT_VALUE) {
+        DEBUG_PRINTF("[KRAKEN] API error: %s\n", tok->value);
+        scan->errors++;
+        return true;
+    }
+
+    // "result":{"XXBTZUSD":{...},...}: match the result key against the wanted pairs
+    if (tok->depth == 2 && tok->key) {
+        if (tok->event == JSON_EVENT_OBJECT_START) {
+            scan->pair = -1;
+            for (int k = 0; k < scan->n; k++) {
+                if (scan->pairs[k] && strcmp(scan->pairs[k], tok->key) == 0) {
+                    scan->pair = k;
+                    break;
+                }
+            }
+        } else if (tok->event == JSON_EVENT_OBJECT_END) {
+            scan->pair = -1;
+        }
+        return true;
+    }
+    if (scan->pair < 0) {
+        return true;
+    }
+
+    // "a":[price, whole lot volume, lot volume], "b": same, "c":[price, lot volume]
+    if (tok->depth == 3 && tok->key) {
+        if (tok->event == JSON_EVENT_ARRAY_START && tok->key[0] && !tok->key[1] &&
+            strchr("abc", tok->key[0])) {
+            scan->field = tok->key[0];
+            scan->item = 0;
+        } else if (tok->event == JSON_EVENT_ARRAY_END) {
+            scan->field = 0;
+        }
+        return true;
+    }
+    if (tok->depth != 4 || !scan->field || tok->event != JSON_EVENT_VALUE) {
+        return true;
+    }
+    if (scan->item++ != 0 || tok->type != JSON_TYPE_STRING || tok->truncated) {
+        return true;
+    }
+
+    Fixed value;
+    if (!fixed_parse(tok->value, tok->value_len, &value)) {
+        return true;
+    }
+    Ticker& out = scan->out[scan->pair];
+    if (scan->field == 'a') {
+        out.ask = value;
+    } else if (scan->field == 'b') {
+        out.bid = value;
+    } else {
+        out.price = value;
+    }
+    return true;
+}
+
+bool ticker_begin(TickerScan* scan, const char* const* pairs, int n, Ticker* out) {
+    if (!scan || !pairs || n <= 0 || !out) {
+        return false;
+    }
+    memset(out, 0, n * sizeof(Ticker));
+    scan->pairs = pairs;
+    scan->n = n;
+    scan->out = out;
+    scan->errors = 0;
+    scan->pair = -1;
+    scan->field = 0;
+    scan->item = 0;
+    json_stream_init(&scan->parser, ticker_token, scan);
+    return true;
+}
+
+bool ticker_chunk(const uint8_t* data, size_t len, void* ctx) {
+    TickerScan* scan = static_cast<TickerScan*>(ctx);
+    return json_stream_feed(&scan->parser, (const char*)data, len);
+}
+
+int ticker_finish(TickerScan* scan) {
+    if (!json_stream_done(&scan->parser)) {
+        DEBUG_PRINTF("[KRAKEN] Ticker body %s after %lu bytes\n",
+                     json_stream_failed(&scan->parser) ? "malformed" : "incomplete",
+                     (unsigned long)scan->parser.bytes);
+        memset(scan->out, 0, scan->n * sizeof(Ticker));
+        return 0;
+    }
+
+    int found = 0;
+    for (int k = 0; k < scan->n; k++) {
+        Ticker& t = scan->out[k];
+        t.valid = t.bid > 0 && t.ask > 0;
+        if (!t.valid) {
+            continue;
+        }
+        if (t.price <= 0) {
+            t.price = fixed_mid(t.bid, t.ask);
+        }
+        found++;
+    }
+    return found;
+}
+
+int parse_ticker(const char* body, size_t len, const char* const* pairs, int n, Ticker* out) {
+    TickerScan scan;
+    if (!body || !ticker_begin(&scan, pairs, n, out)) {
+        return 0;
+    }
+    json_stream_feed(&scan.parser, body, len);
+    return ticker_finish(&scan);
+}
+
+int fetch_tickers(const char* const* pairs, int n, Ticker* out) {
+    if (!pairs || n <= 0 || !out) {
+        DEBUG_PRINTLN("[KRAKEN] ERROR: Invalid parameters");
+        return 0;
+    }
+    memset(out, 0, n * sizeof(Ticker));
+
+    const TickerBatch* batches = nullptr;
+    int num_batches = ticker_requests(pairs, n, &batches);
+    HttpTransport* transport = http_transport_get();
+    if (num_batches == 0 || !transport) {
+        DEBUG_PRINTLN("[KRAKEN] Cannot send ticker request");
+        return 0;
+    }
+
+    DEBUG_PRINTF("[KRAKEN] Fetching %d tickers in %d request(s)...\n", n, num_batches);
+
+    int found = 0;
+    for (int b = 0; b < num_batches; b++) {
+        const TickerBatch& batch = batches[b];
+        TickerScan scan;
+        ticker_begin(&scan, pairs + batch.first, batch.count, out + batch.first);
+        if (!transport->request(&batch.request, ticker_chunk, &scan, 10000)) {
+            DEBUG_PRINTLN("[KRAKEN] HTTP request failed");
+            memset(out + batch.first, 0, batch.count * sizeof(Ticker));
+            continue;
+        }
+        found += ticker_finish(&scan);
+    }
+    for (int k = 0; k < n; k++) {
+        if (out[k].valid) {
+            DEBUG_PRINTF("[KRAKEN] SUCCESS: %s bid $%.2f ask $%.2f\n", pairs[k],
+                         fixed_to_double(out[k].bid), fixed_to_double(out[k].ask));
+        } else {
+            DEBUG_PRINTF("[KRAKEN] %s not in ticker response\n", pairs[k] ? pairs[k] : "(null)");
+        }
+    }
+    return found;
+}
+
+}
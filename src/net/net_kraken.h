@@ -0,0 +1,99 @@
+#ifndef NET_KRAKEN_H
+#define NET_KRAKEN_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#endif
+#include "net_endpoint.h"
+#include "../app/app_fixed.h"
+#include "net_json_stream.h"
+
+/**
+ * @file net_kraken.h
+ * @brief Kraken API adapter for fetching top of book
+ *
+ * Best bid/ask and last trade of many pairs in one request:
+ * https://api.kraken.com/0/public/Ticker?pair=XXBTZUSD,XETHZUSD,SOLUSD
+ * Response format:
+ * {"error":[],"result":{"XXBTZUSD":{"a":["43250.60000","1","1.000"],
+ *  "b":["43250.50000","2","2.000"],"c":["43250.50000","0.00100000"],
+ *  "v":[..],"p":[..],"t":[..],"l":[..],"h":[..],"o":"43000.00000"},...}}
+ * (~300 bytes per pair, filtered while streaming, never buffered)
+ *
+ * Pairs are configured by their result key (e.g. "XXBTZUSD", not the
+ * "XBTUSD" altname): Kraken accepts both in the query but always answers
+ * with the result key.
+ */
+
+namespace net_kraken {
+    // Resolve the API endpoint (called from scheduler_init, or lazily)
+    void init();
+
+    // Requests kept at most (a long pair list is split so each request fits
+    // in HTTP_REQUEST_MAX; MAX_SYMBOLS default pairs need one)
+    const int TICKER_MAX_REQUESTS = 3;
+
+    // One ticker request and the pairs it covers
+    typedef HttpRequestBatch TickerBatch;
+
+    // Pre-rendered ticker requests covering pairs[0..n)
+    // Uses: /0/public/Ticker?pair=XXBTZUSD,XETHZUSD,...
+    // Requests are rendered again only when the pair list changes; they
+    // stay valid until the next call with a different list.
+    // Returns: number of requests in *out_batches, 0 on error
+    int ticker_requests(const char* const* pairs, int n, const TickerBatch** out_batches);
+
+    // Best bid/ask and last trade price of a pair
+    struct Ticker {
+        Fixed price;   // Last trade (mid of bid/ask if absent)
+        Fixed bid;
+        Fixed ask;
+        bool valid;
+    };
+
+    /**
+     * @brief Streaming filter for a ticker body
+     *
+     * The body is tokenized as it arrives (see net_json_stream.h) and only
+     * the first element of "a", "b" and "c" of the wanted pairs is kept.
+     * Feed it with ticker_chunk() as the HttpChunkCallback of a transport
+     * request or async job.
+     */
+    struct TickerScan {
+        JsonStreamParser parser;
+        const char* const* pairs;
+        int n;
+        Ticker* out;
+        int errors;                 // Entries of "error"
+        int pair;                   // Pair of the result entry being parsed, -1 if not wanted
+        char field;                 // 'a', 'b', 'c' while inside that array, else 0
+        int item;                   // Items seen in that array
+    };
+
+    // Start a scan for pairs[0..n) (out cleared); false on invalid arguments
+    bool ticker_begin(TickerScan* scan, const char* const* pairs, int n, Ticker* out);
+
+    // HttpChunkCallback feeding body bytes into a TickerScan (ctx)
+    bool ticker_chunk(const uint8_t* data, size_t len, void* ctx);
+
+    /**
+     * @brief Finish a scan after the whole body was fed
+     * A pair is valid if both bid and ask are positive.
+     * @return Number of pairs with a valid ticker, 0 (all invalid) if the
+     *         body was malformed or incomplete
+     */
+    int ticker_finish(TickerScan* scan);
+
+    // Parse a complete ticker body (same as feeding it to a TickerScan)
+    // Returns: number of pairs with a valid ticker (out[k].valid per pair)
+    int parse_ticker(const char* body, size_t len, const char* const* pairs, int n, Ticker* out);
+
+    // Fetch best bid/ask for pairs[0..n) with as few requests as possible
+    // Returns: number of pairs with a valid ticker
+    int fetch_tickers(const char* const* pairs, int n, Ticker* out);
+}
+
+#endif // NET_KRAKEN_H
@@ -0,0 +1,183 @@
+#include "net_pool.h"
+#include "../config.h"
+#include <string.h>
+
+// Pool slot: one connection object bound to an endpoint
+struct PoolSlot {
+    char host[HTTP_POOL_HOST_MAX];
+    uint16_t port;
+    bool tls;
+    bool in_use;
+    uint32_t last_used_ms;
+    PooledConnection* conn;
+};
+
+static PoolSlot g_slots[HTTP_POOL_MAX_SLOTS];
+static PooledConnectionFactory g_factory = nullptr;
+static HttpPoolStats g_stats;
+
+static bool slot_matches(const PoolSlot& slot, const char* host, uint16_t port, bool tls) {
+    return slot.conn != nullptr && slot.port == port && slot.tls == tls &&
+           strcmp(slot.host, host) == 0;
+}
+
+static void slot_close(PoolSlot& slot) {
+    if (slot.conn) {
+        slot.conn->close();
+    }
+}
+
+static void slot_free(PoolSlot& slot) {
+    if (slot.conn) {
+        slot.conn->close();
+        delete slot.conn;
+    }
+    slot.conn = nullptr;
+    slot.host[0] = '\0';
+    slot.port = 0;
+    slot.tls = false;
+    slot.in_use = false;
+    slot.last_used_ms = 0;
+}
+
+void http_pool_init(PooledConnectionFactory factory) {
+    for (int i = 0; i < HTTP_POOL_MAX_SLOTS; i++) {
+        slot_free(g_slots[i]);
+    }
+    g_factory = factory;
+    memset(&g_stats, 0, sizeof(g_stats));
+}
+
+PooledConnection* http_pool_acquire(const char* host, uint16_t port, bool tls,
+                                    uint32_t timeout_ms, uint32_t now_ms, bool* reused) {
+    if (reused) *reused = false;
+    if (!host || !g_factory) {
+        return nullptr;
+    }
+
+    g_stats.acquires++;
+
+    // 1. Idle slot already bound to this endpoint
+    PoolSlot* slot = nullptr;
+    for (int i = 0; i < HTTP_POOL_MAX_SLOTS; i++) {
+        if (!g_slots[i].in_use && slot_matches(g_slots[i], host, port, tls)) {
+            slot = &g_slots[i];
+            break;
+        }
+    }
+
+    if (slot) {
+        if (slot->conn->is_open()) {
+            if (now_ms - slot->last_used_ms <= HTTP_POOL_IDLE_TIMEOUT_MS) {
+                slot->in_use = true;
+                g_stats.reused++;
+                if (reused) *reused = true;
+                return slot->conn;
+            }
+            // Idled out - server has most likely dropped it already
+            slot_close(*slot);
+            g_stats.idle_evictions++;
+        } else {
+            // Peer closed the connection while it was parked
+            slot_close(*slot);
+            g_stats.dead_evictions++;
+        }
+    } else {
+        // 2. Unused slot, otherwise 3. least recently used idle slot
+        for (int i = 0; i < HTTP_POOL_MAX_SLOTS; i++) {
+            if (g_slots[i].conn == nullptr) {
+                slot = &g_slots[i];
+                break;
+            }
+        }
+        if (!slot) {
+            for (int i = 0; i < HTTP_POOL_MAX_SLOTS; i++) {
+                if (g_slots[i].in_use) continue;
+                if (!slot || (now_ms - g_slots[i].last_used_ms) > (now_ms - slot->last_used_ms)) {
+                    slot = &g_slots[i];
+                }
+            }
+        }
+        if (!slot) {
+            g_stats.exhausted++;
+            DEBUG_PRINTF("[POOL] No free connection slot for %s\n", host);
+            return nullptr;
+        }
+
+        // Re-bind slot: connection objects are TLS- or plain-specific
+        if (slot->conn && slot->tls != tls) {
+            slot_free(*slot);
+        } else {
+            slot_close(*slot);
+        }
+        if (!slot->conn) {
+            slot->conn = g_factory(tls);
+            if (!slot->conn) {
+                DEBUG_PRINTLN("[POOL] ERROR: Connection factory failed");
+                return nullptr;
+            }
+        }
+        strncpy(slot->host, host, sizeof(slot->host) - 1);
+        slot->host[sizeof(slot->host) - 1] = '\0';
+        slot->port = port;
+        slot->tls = tls;
+    }
+
+    // Open a fresh connection on the slot's object
+    g_stats.handshakes++;
+    if (!slot->conn->open(slot->host, port, timeout_ms)) {
+        g_stats.connect_failures++;
+        slot_close(*slot);
+        return nullptr;
+    }
+
+    slot->in_use = true;
+    slot->last_used_ms = now_ms;
+    return slot->conn;
+}
+
+void http_pool_release(PooledConnection* conn, bool keep_alive, uint32_t now_ms) {
+    if (!conn) return;
+
+    for (int i = 0; i < HTTP_POOL_MAX_SLOTS; i++) {
+        if (g_slots[i].conn == conn) {
+            g_slots[i].in_use = false;
+            g_slots[i].last_used_ms = now_ms;
+            if (!keep_alive) {
+                slot_close(g_slots[i]);
+                g_stats.discarded++;
+            }
+            return;
+        }
+    }
+}
+
+int http_pool_evict_idle(uint32_t now_ms) {
+    int evicted = 0;
+    for (int i = 0; i < HTTP_POOL_MAX_SLOTS; i++) {
+        PoolSlot& slot = g_slots[i];
+        if (!slot.conn || slot.in_use) continue;
+        if (now_ms - slot.last_used_ms > HTTP_POOL_IDLE_TIMEOUT_MS && slot.conn->is_open()) {
+            slot_close(slot);
+            g_stats.idle_evictions++;
+            evicted++;
+        }
+    }
+    return evicted;
+}
+
+void http_pool_close_all() {
+    for (int i = 0; i < HTTP_POOL_MAX_SLOTS; i++) {
+        if (!g_slots[i].in_use) {
+            slot_close(g_slots[i]);
+        }
+    }
+}
+
+HttpPoolStats http_pool_get_stats() {
+    return g_stats;
+}
+
+void http_pool_reset_stats() {
+    memset(&g_stats, 0, sizeof(g_stats));
+}
@@ -0,0 +1,116 @@
+#ifndef NET_POOL_H
+#define NET_POOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @file net_pool.h
+ * @brief Persistent keep-alive connection pool for http_get()
+ *
+ * Keeps HTTP/1.1 connections to the exchange hosts (api.binance.com,
+ * fapi.binance.com, api.coinbase.com) open between requests so each fetch
+ * does not pay for a fresh TCP + TLS handshake.
+ *
+ * The pool only does bookkeeping (slot lookup, idle eviction, counters).
+ * Socket/TLS work is delegated to PooledConnection objects created by a
+ * factory, which keeps this module free of Arduino dependencies so it can
+ * be unit tested on the host against a local stand-in server.
+ *
+ * Not thread-safe: all calls are expected from net_task.
+ */
+
+// Number of pooled connections (3 exchange hosts + 1 spare)
+#define HTTP_POOL_MAX_SLOTS 4
+
+// Close connections that have been idle longer than this
+// (exchanges drop idle keep-alive sockets after ~60s; stay well below)
+#define HTTP_POOL_IDLE_TIMEOUT_MS 30000
+
+// Maximum hostname length stored per slot
+#define HTTP_POOL_HOST_MAX 48
+
+/**
+ * @brief A reusable transport connection owned by the pool
+ *
+ * The object lives as long as its slot; open()/close() may be called
+ * repeatedly on the same instance to avoid heap churn on reconnect.
+ */
+class PooledConnection {
+public:
+    virtual ~PooledConnection() {}
+
+    // Connect to host:port, returns true on success
+    virtual bool open(const char* host, uint16_t port, uint32_t timeout_ms) = 0;
+
+    // True while the peer has not closed the connection
+    virtual bool is_open() = 0;
+
+    // Close the socket (object stays allocated for reuse)
+    virtual void close() = 0;
+};
+
+// Creates a connection object for plain (tls=false) or TLS (tls=true) use
+typedef PooledConnection* (*PooledConnectionFactory)(bool tls);
+
+// Pool counters (monotonic since boot or last http_pool_reset_stats())
+struct HttpPoolStats {
+    uint32_t acquires;          // Total http_pool_acquire() calls
+    uint32_t reused;            // Served by an already-open keep-alive connection
+    uint32_t handshakes;        // New connections opened (TCP, plus TLS for https)
+    uint32_t connect_failures;  // open() failed
+    uint32_t idle_evictions;    // Closed after HTTP_POOL_IDLE_TIMEOUT_MS of inactivity
+    uint32_t dead_evictions;    // Found closed by the peer when acquired
+    uint32_t discarded;         // Released as not reusable (Connection: close, error)
+    uint32_t exhausted;         // No free slot available
+};
+
+/**
+ * @brief Initialize (or re-initialize) the pool
+ * @param factory Creates connection objects on demand
+ *
+ * Closes and frees any connections owned by a previous initialization.
+ */
+void http_pool_init(PooledConnectionFactory factory);
+
+/**
+ * @brief Get an open connection to host:port
+ *
+ * Prefers an idle keep-alive connection to the same endpoint. If the cached
+ * connection was closed by the peer or has idled out, it is reconnected.
+ *
+ * @param host Hostname (copied into the slot)
+ * @param port TCP port
+ * @param tls True for HTTPS endpoints
+ * @param timeout_ms Connect timeout
+ * @param now_ms Current time (millis())
+ * @param reused Optional output: true if no new handshake was needed
+ * @return Connection marked in-use, or nullptr on connect failure / pool exhausted
+ */
+PooledConnection* http_pool_acquire(const char* host, uint16_t port, bool tls,
+                                    uint32_t timeout_ms, uint32_t now_ms, bool* reused);
+
+/**
+ * @brief Return a connection to the pool
+ * @param conn Connection obtained from http_pool_acquire()
+ * @param keep_alive True if the response was fully read and the server allows reuse
+ * @param now_ms Current time (millis())
+ */
+void http_pool_release(PooledConnection* conn, bool keep_alive, uint32_t now_ms);
+
+/**
+ * @brief Close connections idle for longer than HTTP_POOL_IDLE_TIMEOUT_MS
+ * @return Number of connections closed
+ */
+int http_pool_evict_idle(uint32_t now_ms);
+
+// Close every pooled connection (e.g. after Wi-Fi loss)
+void http_pool_close_all();
+
+// Get a copy of the pool counters
+HttpPoolStats http_pool_get_stats();
+
+// Reset pool counters to zero
+void http_pool_reset_stats();
+
+#endif // NET_POOL_H
@@ -0,0 +1,139 @@
+#include "net_timing.h"
+#include "../config.h"
+#include <string.h>
+
+// Upper bound (inclusive) of each bucket; the last bucket catches the rest
+static const uint32_t BUCKET_BOUNDS_MS[LATENCY_BUCKETS - 1] = {
+    1, 2, 5, 10, 20, 50, 100, 150, 200, 300, 500, 750, 1000, 1500, 2000, 5000, 10000
+};
+
+static HttpHostTiming g_hosts[HTTP_TIMING_MAX_HOSTS];
+static int g_num_hosts = 0;
+static uint32_t g_dropped = 0;
+
+void latency_hist_add(LatencyHistogram* h, uint32_t ms) {
+    int b = 0;
+    while (b < LATENCY_BUCKETS - 1 && ms > BUCKET_BOUNDS_MS[b]) {
+        b++;
+    }
+    h->buckets[b]++;
+    h->count++;
+    h->sum_ms += ms;
+    if (ms > h->max_ms) {
+        h->max_ms = ms;
+    }
+}
+
+uint32_t latency_hist_percentile(const LatencyHistogram* h, uint8_t pct) {
+    if (!h || h->count == 0) {
+        return 0;
+    }
+    if (pct > 100) {
+        pct = 100;
+    }
+
+    // Rank of the sample at the percentile (1-based, rounded up)
+    uint32_t rank = (uint32_t)(((uint64_t)h->count * pct + 99) / 100);
+    if (rank == 0) {
+        rank = 1;
+    }
+
+    uint32_t seen = 0;
+    for (int b = 0; b < LATENCY_BUCKETS; b++) {
+        if (h->buckets[b] == 0) {
+            continue;
+        }
+        if (seen + h->buckets[b] < rank) {
+            seen += h->buckets[b];
+            continue;
+        }
+        if (b == LATENCY_BUCKETS - 1) {
+            return h->max_ms;
+        }
+        uint32_t lo = b == 0 ? 0 : BUCKET_BOUNDS_MS[b - 1];
+        uint32_t hi = BUCKET_BOUNDS_MS[b];
+        uint32_t value = lo + (uint32_t)((uint64_t)(hi - lo) * (rank - seen) / h->buckets[b]);
+        return value < h->max_ms ? value : h->max_ms;
+    }
+    return h->max_ms;
+}
+
+static HttpHostTiming* host_entry(const char* host) {
+    for (int i = 0; i < g_num_hosts; i++) {
+        if (strcmp(g_hosts[i].host, host) == 0) {
+            return &g_hosts[i];
+        }
+    }
+    if (g_num_hosts >= HTTP_TIMING_MAX_HOSTS || strlen(host) >= HTTP_POOL_HOST_MAX) {
+        return nullptr;
+    }
+    HttpHostTiming* entry = &g_hosts[g_num_hosts];
+    memset(entry, 0, sizeof(*entry));
+    strcpy(entry->host, host);
+    g_num_hosts++;  // Published last: readers only see complete entries
+    return entry;
+}
+
+void http_timing_record(const char* host, HttpPhase phase, uint32_t ms) {
+    if (!host || (int)phase < 0 || phase >= HTTP_PHASE_COUNT) {
+        return;
+    }
+    HttpHostTiming* entry = host_entry(host);
+    if (!entry) {
+        g_dropped++;
+        return;
+    }
+    latency_hist_add(&entry->phases[phase], ms);
+}
+
+int http_timing_host_count() {
+    return g_num_hosts;
+}
+
+bool http_timing_get(int idx, HttpHostTiming* out) {
+    if (!out || idx < 0 || idx >= g_num_hosts) {
+        return false;
+    }
+    memcpy(out, &g_hosts[idx], sizeof(*out));
+    return true;
+}
+
+uint32_t http_timing_dropped() {
+    return g_dropped;
+}
+
+const char* http_phase_name(HttpPhase phase) {
+    switch (phase) {
+        case HTTP_PHASE_DNS:     return "dns";
+        case HTTP_PHASE_CONNECT: return "connect";
+        case HTTP_PHASE_TLS:     return "tls";
+        case HTTP_PHASE_TTFB:    return "ttfb";
+        case HTTP_PHASE_BODY:    return "body";
+        case HTTP_PHASE_TOTAL:   return "total";
+        default:                 return "?";
+    }
+}
+
+void http_timing_log() {
+    for (int i = 0; i < g_num_hosts; i++) {
+        const HttpHostTiming& entry = g_hosts[i];
+        for (int p = 0; p < HTTP_PHASE_COUNT; p++) {
+            const LatencyHistogram& h = entry.phases[p];
+            if (h.count == 0) {
+                continue;
+            }
+            DEBUG_PRINTF("[TIMING] %s %-7s n=%lu p50=%lu p95=%lu p99=%lu max=%lu ms\n",
+                         entry.host, http_phase_name((HttpPhase)p), (unsigned long)h.count,
+                         (unsigned long)latency_hist_percentile(&h, 50),
+                         (unsigned long)latency_hist_percentile(&h, 95),
+                         (unsigned long)latency_hist_percentile(&h, 99),
+                         (unsigned long)h.max_ms);
+        }
+    }
+}
+
+void http_timing_reset() {
+    g_num_hosts = 0;
+    g_dropped = 0;
+    memset(g_hosts, 0, sizeof(g_hosts));
+}
@@ -0,0 +1,89 @@
+#ifndef NET_TIMING_H
+#define NET_TIMING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "net_pool.h"
+
+/**
+ * @file net_timing.h
+ * @brief Per-host, per-phase HTTP latency histograms
+ *
+ * Every request is split into phases and each phase duration is added to
+ * a fixed-bucket histogram for its host, so a slow refresh can be pinned on
+ * DNS, TCP, TLS or the exchange itself:
+ * - DNS:     dns_resolve() (cache hits included, they show up as ~0 ms)
+ * - CONNECT: TCP connect after the address is known
+ * - TLS:     handshake (full or resumed)
+ * - TTFB:    request sent -> first response byte
+ * - BODY:    first response byte -> last body byte
+ * - TOTAL:   whole request, including queueing and reconnects
+ *
+ * Recording is a bucket search plus a few adds (no allocation, no locks).
+ * Samples are written from net_task; readers on other tasks may see a
+ * histogram that is one sample behind, which is fine for monitoring.
+ */
+
+enum HttpPhase {
+    HTTP_PHASE_DNS = 0,
+    HTTP_PHASE_CONNECT,
+    HTTP_PHASE_TLS,
+    HTTP_PHASE_TTFB,
+    HTTP_PHASE_BODY,
+    HTTP_PHASE_TOTAL,
+    HTTP_PHASE_COUNT
+};
+
+// Bucket upper bounds 1 ms .. 10 s, plus one overflow bucket
+#define LATENCY_BUCKETS 18
+
+// Hosts tracked (api/fapi.binance.com, api.coinbase.com + spare)
+#define HTTP_TIMING_MAX_HOSTS 4
+
+struct LatencyHistogram {
+    uint32_t buckets[LATENCY_BUCKETS];
+    uint32_t count;
+    uint32_t sum_ms;
+    uint32_t max_ms;
+};
+
+struct HttpHostTiming {
+    char host[HTTP_POOL_HOST_MAX];
+    LatencyHistogram phases[HTTP_PHASE_COUNT];
+};
+
+// Histogram primitives
+void latency_hist_add(LatencyHistogram* h, uint32_t ms);
+
+/**
+ * @brief Estimate a percentile from the buckets
+ * Interpolates linearly inside the bucket holding the percentile and never
+ * reports more than the largest recorded sample.
+ * @param pct Percentile 1..100
+ * @return Latency in ms (0 if the histogram is empty)
+ */
+uint32_t latency_hist_percentile(const LatencyHistogram* h, uint8_t pct);
+
+// Record one phase duration for host (samples for hosts beyond
+// HTTP_TIMING_MAX_HOSTS are counted in http_timing_dropped())
+void http_timing_record(const char* host, HttpPhase phase, uint32_t ms);
+
+// Number of hosts with recorded samples
+int http_timing_host_count();
+
+// Copy the histograms of the idx-th host, false if idx is out of range
+bool http_timing_get(int idx, HttpHostTiming* out);
+
+// Samples dropped because the host table was full
+uint32_t http_timing_dropped();
+
+// Short phase name ("dns", "connect", "tls", "ttfb", "body", "total")
+const char* http_phase_name(HttpPhase phase);
+
+// Print p50/p95/p99 of every phase with samples to the debug console
+void http_timing_log();
+
+// Forget all samples and hosts
+void http_timing_reset();
+
+#endif // NET_TIMING_H
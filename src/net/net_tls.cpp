@@ -0,0 +1,591 @@
+#include "net_tls.h"
+#include "net_timing.h"
+
+#if ENABLE_HTTPS
+
+#include <mbedtls/entropy.h>
+#include <mbedtls/ctr_drbg.h>
+#include <lwip/sockets.h>
+#include <lwip/netdb.h>
+#include <errno.h>
+
+// Shared mbedTLS state - one RNG and client config for all connections
+static mbedtls_entropy_context g_entropy;
+static mbedtls_ctr_drbg_context g_ctr_drbg;
+static mbedtls_ssl_config g_ssl_conf;
+static bool g_tls_ready = false;
+
+// mbedTLS 3 marks the session fields private
+#ifndef MBEDTLS_PRIVATE
+#define MBEDTLS_PRIVATE(member) member
+#endif
+
+// Per-host session cache
+struct TlsSessionEntry {
+    char host[TLS_SESSION_KEY_MAX];     // Session key (session_key())
+    mbedtls_ssl_session session;
+    bool valid;
+    uint32_t saved_ms;
+};
+
+static TlsSessionEntry g_sessions[TLS_SESSION_CACHE_SIZE];
+static TlsSessionStats g_tls_stats;
+
+bool tls_init() {
+    if (g_tls_ready) {
+        return true;
+    }
+
+    mbedtls_entropy_init(&g_entropy);
+    mbedtls_ctr_drbg_init(&g_ctr_drbg);
+    mbedtls_ssl_config_init(&g_ssl_conf);
+
+    const char* pers = "crypto_dash_tls";
+    int ret = mbedtls_ctr_drbg_seed(&g_ctr_drbg, mbedtls_entropy_func, &g_entropy,
+                                    (const unsigned char*)pers, strlen(pers));
+    if (ret != 0) {
+        DEBUG_PRINTF("[TLS] ERROR: RNG seed failed (-0x%04x)\n", -ret);
+        return false;
+    }
+
+    ret = mbedtls_ssl_config_defaults(&g_ssl_conf, MBEDTLS_SSL_IS_CLIENT,
+                                      MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT);
+    if (ret != 0) {
+        DEBUG_PRINTF("[TLS] ERROR: Config defaults failed (-0x%04x)\n", -ret);
+        return false;
+    }
+
+    // PROTOTYPE: Skip certificate validation (same as WiFiClientSecure::setInsecure)
+    // TODO: For production, load CA certificates with mbedtls_ssl_conf_ca_chain()
+    mbedtls_ssl_conf_authmode(&g_ssl_conf, MBEDTLS_SSL_VERIFY_NONE);
+    mbedtls_ssl_conf_rng(&g_ssl_conf, mbedtls_ctr_drbg_random, &g_ctr_drbg);
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+    mbedtls_ssl_conf_session_tickets(&g_ssl_conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+
+    for (int i = 0; i < TLS_SESSION_CACHE_SIZE; i++) {
+        mbedtls_ssl_session_init(&g_sessions[i].session);
+        g_sessions[i].host[0] = '\0';
+        g_sessions[i].valid = false;
+    }
+
+    g_tls_ready = true;
+    DEBUG_PRINTF("[TLS] Initialized (session cache: %d hosts)\n", TLS_SESSION_CACHE_SIZE);
+    return true;
+}
+
+TlsSessionStats tls_get_stats() {
+    return g_tls_stats;
+}
+
+static void session_drop(TlsSessionEntry& entry) {
+    if (entry.valid) {
+        mbedtls_ssl_session_free(&entry.session);
+        mbedtls_ssl_session_init(&entry.session);
+    }
+    entry.valid = false;
+}
+
+void tls_clear_sessions() {
+    for (int i = 0; i < TLS_SESSION_CACHE_SIZE; i++) {
+        session_drop(g_sessions[i]);
+        g_sessions[i].host[0] = '\0';
+    }
+}
+
+// Find the cache entry for host (valid and not expired), or nullptr
+static TlsSessionEntry* session_lookup(const char* host) {
+    for (int i = 0; i < TLS_SESSION_CACHE_SIZE; i++) {
+        TlsSessionEntry& entry = g_sessions[i];
+        if (entry.valid && strcmp(entry.host, host) == 0) {
+            if (millis() - entry.saved_ms > TLS_SESSION_TTL_MS) {
+                session_drop(entry);
+                return nullptr;
+            }
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+// Entry to store a session for host: same host, free entry, or oldest
+static TlsSessionEntry* session_slot(const char* host) {
+    TlsSessionEntry* oldest = &g_sessions[0];
+    for (int i = 0; i < TLS_SESSION_CACHE_SIZE; i++) {
+        TlsSessionEntry& entry = g_sessions[i];
+        if (strcmp(entry.host, host) == 0 || entry.host[0] == '\0') {
+            return &entry;
+        }
+        if (entry.saved_ms < oldest->saved_ms) {
+            oldest = &entry;
+        }
+    }
+    return oldest;
+}
+
+// True if host is an IPv4 / IPv6 address literal
+static bool host_is_address(const char* host) {
+    struct in_addr v4;
+    struct in6_addr v6;
+    return inet_pton(AF_INET, host, &v4) == 1 || inet_pton(AF_INET6, host, &v6) == 1;
+}
+
+// Set SNI and build the session cache key for host. An address literal is
+// sent without SNI (RFC 6066 3) and cached under "ip:<address>": a server
+// does not resume a session negotiated for a name on a connection without one.
+static bool session_setup(mbedtls_ssl_context* ssl, const char* host, char* key, size_t key_len) {
+    if (host_is_address(host)) {
+        snprintf(key, key_len, "ip:%s", host);
+        return true;
+    }
+    strncpy(key, host, key_len - 1);
+    key[key_len - 1] = '\0';
+    return mbedtls_ssl_set_hostname(ssl, host) == 0;
+}
+
+// Offer the cached session for host to ssl; returns the entry if offered
+static TlsSessionEntry* session_offer(mbedtls_ssl_context* ssl, const char* host) {
+    TlsSessionEntry* cached = session_lookup(host);
+    if (cached && mbedtls_ssl_set_session(ssl, &cached->session) == 0) {
+        g_tls_stats.hits++;
+        return cached;
+    }
+    g_tls_stats.misses++;
+    return nullptr;
+}
+
+// Count a failed handshake; a session the server choked on is dropped
+static void handshake_failed(TlsSessionEntry* offered) {
+    g_tls_stats.handshake_failures++;
+    if (offered) {
+        session_drop(*offered);
+    }
+}
+
+// Remember the session ID of an outgoing ClientHello record: record header
+// (5), handshake header (4), version (2) and random (32) come first
+static void hello_capture(TlsHelloSessionId* hello, const unsigned char* buf, size_t len) {
+    const size_t ID_LEN_AT = 5 + 4 + 2 + 32;
+    if (hello->seen || len <= ID_LEN_AT || buf[0] != 22 || buf[5] != 1) {
+        return;     // Not a handshake record carrying a ClientHello
+    }
+    hello->seen = true;
+    uint8_t n = buf[ID_LEN_AT];
+    if (n > sizeof(hello->id) || len < ID_LEN_AT + 1 + n) {
+        return;
+    }
+    memcpy(hello->id, buf + ID_LEN_AT + 1, n);
+    hello->len = n;
+}
+
+static void hello_reset(TlsHelloSessionId* hello) {
+    hello->len = 0;
+    hello->seen = false;
+}
+
+// Record handshake stats and store the (possibly renewed) session for the
+// next connection. Returns true if the server echoed the session ID of the
+// offered session, i.e. resumed it.
+static bool handshake_finished(mbedtls_ssl_context* ssl, const char* host, bool offered,
+                               const TlsHelloSessionId& hello, uint32_t handshake_ms) {
+    TlsSessionEntry* entry = session_slot(host);
+    session_drop(*entry);
+    bool resumed = false;
+    if (mbedtls_ssl_get_session(ssl, &entry->session) == 0) {
+        strncpy(entry->host, host, sizeof(entry->host) - 1);
+        entry->host[sizeof(entry->host) - 1] = '\0';
+        entry->valid = true;
+        entry->saved_ms = millis();
+
+        const mbedtls_ssl_session& session = entry->session;
+        size_t id_len = session.MBEDTLS_PRIVATE(id_len);
+        // TLS 1.3 echoes any legacy session ID: only a TLS 1.2 echo means resumed
+        resumed = offered && hello.len > 0 && id_len == hello.len &&
+                  strcmp(mbedtls_ssl_get_version(ssl), "TLSv1.2") == 0 &&
+                  memcmp(session.MBEDTLS_PRIVATE(id), hello.id, id_len) == 0;
+    }
+
+    if (resumed) {
+        g_tls_stats.resumed++;
+        g_tls_stats.resumed_handshake_ms = handshake_ms;
+    } else {
+        if (offered) {
+            g_tls_stats.rejected++;
+        }
+        g_tls_stats.full_handshake_ms = handshake_ms;
+    }
+    return resumed;
+}
+
+// ============================================================================
+// TlsClient
+// ============================================================================
+
+TlsClient::TlsClient() : _ssl_ready(false), _connected(false), _resumed(false),
+                         _tcp_failed(false), _peek(-1), _timeout_ms(10000) {
+    mbedtls_net_init(&_net);
+    hello_reset(&_hello_id);
+}
+
+TlsClient::~TlsClient() {
+    stop();
+}
+
+int TlsClient::bio_send(void* ctx, const unsigned char* buf, size_t len) {
+    TlsClient* self = static_cast<TlsClient*>(ctx);
+    hello_capture(&self->_hello_id, buf, len);
+    return mbedtls_net_send(&self->_net, buf, len);
+}
+
+int TlsClient::bio_recv(void* ctx, unsigned char* buf, size_t len) {
+    TlsClient* self = static_cast<TlsClient*>(ctx);
+    return mbedtls_net_recv(&self->_net, buf, len);
+}
+
+// Wait until the socket is readable/writable or the deadline passes
+static bool wait_socket(int fd, bool for_write, uint32_t deadline_ms) {
+    long remaining = (long)(deadline_ms - millis());
+    if (remaining <= 0) {
+        return false;
+    }
+    fd_set fds;
+    FD_ZERO(&fds);
+    FD_SET(fd, &fds);
+    struct timeval tv;
+    tv.tv_sec = remaining / 1000;
+    tv.tv_usec = (remaining % 1000) * 1000;
+    int ret = for_write ? select(fd + 1, nullptr, &fds, nullptr, &tv)
+                        : select(fd + 1, &fds, nullptr, nullptr, &tv);
+    return ret > 0;
+}
+
+bool TlsClient::tcp_connect(const char* host, uint16_t port, uint32_t deadline_ms) {
+    // Non-blocking from the start: connect and handshake are bounded by select()
+    int fd = async_socket_open(host, port);
+    if (fd < 0) {
+        _tcp_failed = fd != ASYNC_SOCKET_NO_ADDRESS;
+        return false;
+    }
+    uint32_t start_ms = millis();
+
+    int err = 0;
+    socklen_t err_len = sizeof(err);
+    if (!wait_socket(fd, true, deadline_ms) ||
+        getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &err_len) != 0 || err != 0) {
+        close(fd);
+        _tcp_failed = true;
+        return false;
+    }
+
+    _net.fd = fd;
+    http_timing_record(host, HTTP_PHASE_CONNECT, millis() - start_ms);
+    return true;
+}
+
+bool TlsClient::handshake(const char* host, uint32_t deadline_ms) {
+    mbedtls_ssl_init(&_ssl);
+    _ssl_ready = true;
+
+    char key[TLS_SESSION_KEY_MAX];
+    if (mbedtls_ssl_setup(&_ssl, &g_ssl_conf) != 0 ||
+        !session_setup(&_ssl, host, key, sizeof(key))) {
+        return false;
+    }
+    mbedtls_ssl_set_bio(&_ssl, this, bio_send, bio_recv, nullptr);
+
+    // Offer the cached session for this host, if any
+    TlsSessionEntry* cached = session_offer(&_ssl, key);
+    bool offered = cached != nullptr;
+
+    uint32_t start_ms = millis();
+    hello_reset(&_hello_id);
+    int ret;
+    while ((ret = mbedtls_ssl_handshake(&_ssl)) != 0) {
+        if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+            DEBUG_PRINTF("[TLS] Handshake with %s failed (-0x%04x)\n", host, -ret);
+            handshake_failed(cached);
+            return false;
+        }
+        if (!wait_socket(_net.fd, ret == MBEDTLS_ERR_SSL_WANT_WRITE, deadline_ms)) {
+            DEBUG_PRINTF("[TLS] Handshake with %s timed out\n", host);
+            handshake_failed(nullptr);
+            return false;
+        }
+    }
+
+    uint32_t handshake_ms = millis() - start_ms;
+    _resumed = handshake_finished(&_ssl, key, offered, _hello_id, handshake_ms);
+    http_timing_record(host, HTTP_PHASE_TLS, handshake_ms);
+    return true;
+}
+
+int TlsClient::connect(IPAddress ip, uint16_t port) {
+    // Connected without SNI and cached under its own key (session_setup())
+    return connect(ip.toString().c_str(), port);
+}
+
+int TlsClient::connect(const char* host, uint16_t port) {
+    stop();
+    _tcp_failed = false;
+    if (!host || !tls_init()) {
+        return 0;
+    }
+
+    uint32_t deadline_ms = millis() + _timeout_ms;
+    if (!tcp_connect(host, port, deadline_ms) || !handshake(host, deadline_ms)) {
+        stop();
+        return 0;
+    }
+
+    _connected = true;
+    return 1;
+}
+
+size_t TlsClient::write(uint8_t b) {
+    return write(&b, 1);
+}
+
+size_t TlsClient::write(const uint8_t* buf, size_t size) {
+    if (!_connected) {
+        return 0;
+    }
+
+    uint32_t deadline_ms = millis() + _timeout_ms;
+    size_t sent = 0;
+    while (sent < size) {
+        int ret = mbedtls_ssl_write(&_ssl, buf + sent, size - sent);
+        if (ret > 0) {
+            sent += ret;
+        } else if (ret == MBEDTLS_ERR_SSL_WANT_WRITE || ret == MBEDTLS_ERR_SSL_WANT_READ) {
+            if (!wait_socket(_net.fd, ret == MBEDTLS_ERR_SSL_WANT_WRITE, deadline_ms)) {
+                break;
+            }
+        } else {
+            stop();
+            break;
+        }
+    }
+    return sent;
+}
+
+// Pull the next TLS record off the socket if nothing is buffered yet.
+// Detects close_notify / FIN so connected() reflects the peer's state.
+void TlsClient::poll_rx() {
+    if (!_connected || mbedtls_ssl_get_bytes_avail(&_ssl) > 0) {
+        return;
+    }
+    int ret = mbedtls_ssl_read(&_ssl, nullptr, 0);
+    if (ret < 0 && ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+        _connected = false;
+    }
+}
+
+int TlsClient::available() {
+    poll_rx();
+    if (!_ssl_ready) {
+        return 0;
+    }
+    return mbedtls_ssl_get_bytes_avail(&_ssl) + (_peek >= 0 ? 1 : 0);
+}
+
+int TlsClient::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int TlsClient::read(uint8_t* buf, size_t size) {
+    if (size == 0 || !_ssl_ready) {
+        return -1;
+    }
+
+    size_t offset = 0;
+    if (_peek >= 0) {
+        buf[0] = (uint8_t)_peek;
+        _peek = -1;
+        offset = 1;
+        if (size == 1) {
+            return 1;
+        }
+    }
+
+    int ret = mbedtls_ssl_read(&_ssl, buf + offset, size - offset);
+    if (ret > 0) {
+        return ret + offset;
+    }
+    if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+        _connected = false;  // close_notify, EOF or error
+    }
+    return offset > 0 ? (int)offset : -1;
+}
+
+int TlsClient::peek() {
+    if (_peek < 0) {
+        uint8_t c;
+        if (read(&c, 1) == 1) {
+            _peek = c;
+        }
+    }
+    return _peek;
+}
+
+void TlsClient::flush() {
+    // Writes are not buffered
+}
+
+void TlsClient::stop() {
+    if (_ssl_ready) {
+        if (_connected) {
+            mbedtls_ssl_close_notify(&_ssl);
+        }
+        mbedtls_ssl_free(&_ssl);
+        _ssl_ready = false;
+    }
+    mbedtls_net_free(&_net);
+    _connected = false;
+    _resumed = false;
+    _peek = -1;
+}
+
+uint8_t TlsClient::connected() {
+    if (_ssl_ready && (mbedtls_ssl_get_bytes_avail(&_ssl) > 0 || _peek >= 0)) {
+        return 1;
+    }
+    poll_rx();
+    return _connected ? 1 : 0;
+}
+
+// ============================================================================
+// TlsAsyncStream
+// ============================================================================
+
+TlsAsyncStream::TlsAsyncStream() : _state(TLS_ASYNC_CLOSED), _ssl_ready(false), _want_write(false),
+                                   _offered(false), _start_ms(0) {
+    mbedtls_net_init(&_net);
+    hello_reset(&_hello_id);
+    _host[0] = '\0';
+    _session_key[0] = '\0';
+}
+
+TlsAsyncStream::~TlsAsyncStream() {
+    close();
+}
+
+int TlsAsyncStream::bio_send(void* ctx, const unsigned char* buf, size_t len) {
+    TlsAsyncStream* self = static_cast<TlsAsyncStream*>(ctx);
+    hello_capture(&self->_hello_id, buf, len);
+    return mbedtls_net_send(&self->_net, buf, len);
+}
+
+int TlsAsyncStream::bio_recv(void* ctx, unsigned char* buf, size_t len) {
+    TlsAsyncStream* self = static_cast<TlsAsyncStream*>(ctx);
+    return mbedtls_net_recv(&self->_net, buf, len);
+}
+
+bool TlsAsyncStream::begin(const char* host, uint16_t port) {
+    close();
+    if (!host || !tls_init()) {
+        return false;
+    }
+    strncpy(_host, host, sizeof(_host) - 1);
+    _host[sizeof(_host) - 1] = '\0';
+
+    _net.fd = async_socket_open(host, port);
+    if (_net.fd < 0) {
+        return false;
+    }
+    _state = TLS_ASYNC_TCP;
+    _start_ms = millis();
+    return true;
+}
+
+int TlsAsyncStream::step_connect() {
+    if (_state == TLS_ASYNC_OPEN) {
+        return 1;
+    }
+
+    if (_state == TLS_ASYNC_TCP) {
+        int r = async_socket_check(_net.fd);
+        if (r < 0) {
+            return ASYNC_CONNECT_TCP_FAILED;
+        }
+        if (r == 0) {
+            return 0;
+        }
+
+        mbedtls_ssl_init(&_ssl);
+        _ssl_ready = true;
+        if (mbedtls_ssl_setup(&_ssl, &g_ssl_conf) != 0 ||
+            !session_setup(&_ssl, _host, _session_key, sizeof(_session_key))) {
+            return ASYNC_CONNECT_TLS_FAILED;
+        }
+        mbedtls_ssl_set_bio(&_ssl, this, bio_send, bio_recv, nullptr);
+        _offered = session_offer(&_ssl, _session_key) != nullptr;
+        hello_reset(&_hello_id);
+        http_timing_record(_host, HTTP_PHASE_CONNECT, millis() - _start_ms);
+        _start_ms = millis();
+        _state = TLS_ASYNC_HANDSHAKE;
+    }
+
+    int ret = mbedtls_ssl_handshake(&_ssl);
+    if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+        _want_write = (ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+        return 0;
+    }
+    if (ret != 0) {
+        DEBUG_PRINTF("[TLS] Async handshake with %s failed (-0x%04x)\n", _host, -ret);
+        // Look the entry up again: other connections may have replaced it meanwhile
+        handshake_failed(_offered ? session_lookup(_session_key) : nullptr);
+        return ASYNC_CONNECT_TLS_FAILED;
+    }
+
+    uint32_t handshake_ms = millis() - _start_ms;
+    handshake_finished(&_ssl, _session_key, _offered, _hello_id, handshake_ms);
+    http_timing_record(_host, HTTP_PHASE_TLS, handshake_ms);
+    _state = TLS_ASYNC_OPEN;
+    return 1;
+}
+
+int TlsAsyncStream::send(const uint8_t* data, size_t len) {
+    if (_state != TLS_ASYNC_OPEN) {
+        return -1;
+    }
+    int ret = mbedtls_ssl_write(&_ssl, data, len);
+    if (ret >= 0) {
+        return ret;
+    }
+    return (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE) ? 0 : -1;
+}
+
+int TlsAsyncStream::recv(uint8_t* buf, size_t len) {
+    if (_state != TLS_ASYNC_OPEN) {
+        return -1;
+    }
+    int ret = mbedtls_ssl_read(&_ssl, buf, len);
+    if (ret > 0) {
+        return ret;
+    }
+    if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+        return 0;
+    }
+    return -1;  // close_notify, EOF or error
+}
+
+bool TlsAsyncStream::has_buffered() const {
+    return _state == TLS_ASYNC_OPEN && mbedtls_ssl_get_bytes_avail(&_ssl) > 0;
+}
+
+void TlsAsyncStream::close() {
+    if (_ssl_ready) {
+        if (_state == TLS_ASYNC_OPEN) {
+            mbedtls_ssl_close_notify(&_ssl);  // Best effort, non-blocking
+        }
+        mbedtls_ssl_free(&_ssl);
+        _ssl_ready = false;
+    }
+    mbedtls_net_free(&_net);
+    _state = TLS_ASYNC_CLOSED;
+    _want_write = false;
+    _offered = false;
+}
+
+#endif // ENABLE_HTTPS
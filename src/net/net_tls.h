@@ -0,0 +1,162 @@
+#ifndef NET_TLS_H
+#define NET_TLS_H
+
+#include "../config.h"
+
+#if ENABLE_HTTPS
+
+#include <Arduino.h>
+#include <Client.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/net_sockets.h>
+#include "net_async.h"
+
+/**
+ * @file net_tls.h
+ * @brief TLS client with per-host session resumption
+ *
+ * WiFiClientSecure always performs a full handshake: its connect() sets up
+ * and runs the mbedTLS handshake in one call, with no way to hand in a
+ * previous session. TlsClient is a drop-in Arduino Client built directly on
+ * lwIP sockets + mbedTLS that offers a cached session (session ID or
+ * session ticket) for the host, so reconnects after Wi-Fi blips and pool
+ * idle evictions use an abbreviated handshake.
+ *
+ * Certificates are not validated (same as WiFiClientSecure::setInsecure()).
+ */
+
+// Number of hosts with a cached session (api/fapi.binance.com, api.coinbase.com)
+#define TLS_SESSION_CACHE_SIZE 4
+
+// Drop cached sessions after this long (servers expire them anyway)
+#define TLS_SESSION_TTL_MS (30UL * 60UL * 1000UL)
+
+// Session cache key: the host name, or "ip:<address>" for an address
+// literal (connected without SNI, so never resumed from a named session)
+#define TLS_SESSION_KEY_MAX 48
+
+// Session ID sent in our ClientHello. The server echoes it back only when
+// it resumes that session (RFC 5246 7.4.1.3, RFC 5077 3.4 for tickets).
+// TLS 1.2 only: a TLS 1.3 server echoes legacy_session_id on every
+// handshake (RFC 8446 4.1.3), so the echo says nothing about resumption.
+struct TlsHelloSessionId {
+    unsigned char id[32];
+    uint8_t len;
+    bool seen;                    // ClientHello of this handshake sent
+};
+
+// Session cache counters (monotonic since boot)
+struct TlsSessionStats {
+    uint32_t hits;                // Cached session offered to the server
+    uint32_t misses;              // No (valid) session cached - full handshake
+    uint32_t resumed;             // Server accepted the offered session (TLS 1.2; TLS 1.3
+                                  // handshakes count as rejected, see TlsHelloSessionId)
+    uint32_t rejected;            // Server ignored the session - full handshake anyway
+    uint32_t handshake_failures;  // Handshake errors (cached session is dropped)
+    uint32_t full_handshake_ms;   // Duration of last full handshake
+    uint32_t resumed_handshake_ms;// Duration of last abbreviated handshake
+};
+
+class TlsClient : public Client {
+public:
+    TlsClient();
+    ~TlsClient();
+
+    // Timeout for TCP connect + handshake and for blocking writes
+    void setHandshakeTimeout(uint32_t timeout_ms) { _timeout_ms = timeout_ms; }
+
+    // True if the current connection was established by session resumption
+    bool resumed() const { return _resumed; }
+
+    // After a failed connect(): true if the TCP connect to the resolved address
+    // failed (false for DNS and handshake failures)
+    bool tcp_failed() const { return _tcp_failed; }
+
+    int connect(IPAddress ip, uint16_t port);
+    int connect(const char* host, uint16_t port);
+    size_t write(uint8_t b);
+    size_t write(const uint8_t* buf, size_t size);
+    int available();
+    int read();
+    int read(uint8_t* buf, size_t size);
+    int peek();
+    void flush();
+    void stop();
+    uint8_t connected();
+    operator bool() { return connected(); }
+
+    using Print::write;
+
+private:
+    bool tcp_connect(const char* host, uint16_t port, uint32_t deadline_ms);
+    bool handshake(const char* host, uint32_t deadline_ms);
+    void poll_rx();
+    static int bio_send(void* ctx, const unsigned char* buf, size_t len);
+    static int bio_recv(void* ctx, unsigned char* buf, size_t len);
+
+    mbedtls_net_context _net;
+    mbedtls_ssl_context _ssl;
+    bool _ssl_ready;
+    bool _connected;
+    bool _resumed;
+    bool _tcp_failed;
+    int _peek;
+    uint32_t _timeout_ms;
+    TlsHelloSessionId _hello_id;
+};
+
+/**
+ * @brief Non-blocking TLS stream for the async HTTP engine (net_async.h)
+ *
+ * Same shared config and per-host session cache as TlsClient, but the TCP
+ * connect and the handshake are advanced step by step from
+ * http_async_run() instead of blocking the caller.
+ */
+class TlsAsyncStream : public AsyncStream {
+public:
+    TlsAsyncStream();
+    ~TlsAsyncStream();
+
+    bool begin(const char* host, uint16_t port);
+    int step_connect();
+    int send(const uint8_t* data, size_t len);
+    int recv(uint8_t* buf, size_t len);
+    int fd() const { return _net.fd; }
+    bool wants_write() const { return _state == TLS_ASYNC_TCP || _want_write; }
+    bool has_buffered() const;
+    void close();
+
+private:
+    enum State { TLS_ASYNC_CLOSED, TLS_ASYNC_TCP, TLS_ASYNC_HANDSHAKE, TLS_ASYNC_OPEN };
+
+    static int bio_send(void* ctx, const unsigned char* buf, size_t len);
+    static int bio_recv(void* ctx, unsigned char* buf, size_t len);
+
+    mbedtls_net_context _net;
+    mbedtls_ssl_context _ssl;
+    State _state;
+    bool _ssl_ready;
+    bool _want_write;
+    bool _offered;               // Cached session offered in this handshake
+    uint32_t _start_ms;
+    TlsHelloSessionId _hello_id;
+    char _host[HTTP_POOL_HOST_MAX];
+    char _session_key[TLS_SESSION_KEY_MAX];
+};
+
+/**
+ * @brief Initialize shared mbedTLS state (RNG, client config)
+ * Called lazily by TlsClient::connect(); safe to call multiple times.
+ * @return true if TLS is usable
+ */
+bool tls_init();
+
+// Get a copy of the session cache counters
+TlsSessionStats tls_get_stats();
+
+// Forget all cached sessions (next handshake to every host is a full one)
+void tls_clear_sessions();
+
+#endif // ENABLE_HTTPS
+
+#endif // NET_TLS_H
@@ -0,0 +1,308 @@
+#include "net_transport.h"
+#include "../config.h"
+#include <stdlib.h>
+#include <string.h>
+
+static HttpTransport* g_transport = nullptr;
+
+void http_transport_set(HttpTransport* transport) {
+    g_transport = transport;
+}
+
+HttpTransport* http_transport_get() {
+    return g_transport;
+}
+
+bool http_transport_request_buf(const HttpRequest* req, char* buf, size_t cap, size_t* out_len,
+                                uint32_t timeout_ms) {
+    if (!buf || cap == 0) {
+        return false;
+    }
+    buf[0] = '\0';
+    if (out_len) {
+        *out_len = 0;
+    }
+    if (!g_transport) {
+        DEBUG_PRINTLN("[TRANSPORT] No transport installed");
+        return false;
+    }
+
+    HttpBufferSink sink(buf, cap);
+    bool ok = g_transport->request(req, http_buffer_sink, &sink, timeout_ms);
+    if (sink.overflow) {
+        DEBUG_PRINTF("[TRANSPORT] Response larger than %u byte buffer\n", (unsigned)cap);
+    }
+    if (out_len) {
+        *out_len = sink.len;
+    }
+    return ok && !sink.overflow;
+}
+
+bool http_record_key(const HttpRequest* req, char* out, size_t cap) {
+    if (!req || !req->endpoint || !out || cap == 0) {
+        return false;
+    }
+    // Request line: "GET <target> HTTP/1.1"
+    const char* target = req->data + 4;
+    const char* end = (const char*)memchr(target, ' ', req->len > 4 ? req->len - 4 : 0);
+    if (req->len <= 4 || memcmp(req->data, "GET ", 4) != 0 || !end) {
+        return false;
+    }
+    int n = snprintf(out, cap, "%s:%u %.*s", req->endpoint->host, req->endpoint->port,
+                     (int)(end - target), target);
+    return n > 0 && (size_t)n < cap;
+}
+
+// ============================================================================
+// RecordingTransport
+// ============================================================================
+
+// RES line with a fixed-width length, rewritten in place once the body is known
+#define RECORD_RES_FORMAT "RES %d %010u\n"
+
+RecordingTransport::RecordingTransport(HttpTransport* inner, const char* path)
+    : _inner(inner), _file(nullptr), _recorded(0),
+      _cb(nullptr), _cb_ctx(nullptr), _writing(false), _body_len(0), _write_failed(false) {
+    if (path) {
+        // Read/write rather than append mode: the RES line is patched after the body
+        _file = fopen(path, "r+b");
+        if (!_file) {
+            _file = fopen(path, "w+b");
+        }
+    }
+    if (!_file) {
+        DEBUG_PRINTF("[TRANSPORT] Cannot open record file %s\n", path ? path : "(null)");
+    }
+}
+
+RecordingTransport::~RecordingTransport() {
+    if (_file) {
+        fclose(_file);
+    }
+}
+
+bool RecordingTransport::tee(const uint8_t* data, size_t len, void* ctx) {
+    RecordingTransport* self = static_cast<RecordingTransport*>(ctx);
+    if (self->_writing && !self->_write_failed) {
+        size_t written = fwrite(data, 1, len, self->_file);
+        self->_body_len += written;
+        self->_write_failed = written < len;
+    }
+    return self->_cb(data, len, self->_cb_ctx);
+}
+
+bool RecordingTransport::request(const HttpRequest* req, HttpChunkCallback cb, void* ctx,
+                                 uint32_t timeout_ms) {
+    if (!_inner || !cb) {
+        return false;
+    }
+    char key[HTTP_RECORD_KEY_MAX];
+    long res_pos = -1;
+    if (_file && http_record_key(req, key, sizeof(key))) {
+        fseek(_file, 0, SEEK_END);
+        fprintf(_file, "REQ %s\n", key);
+        res_pos = ftell(_file);
+        fprintf(_file, RECORD_RES_FORMAT, 0, 0u);
+    }
+
+    _cb = cb;
+    _cb_ctx = ctx;
+    _writing = res_pos >= 0;
+    _body_len = 0;
+    _write_failed = false;
+    bool ok = _inner->request(req, tee, this, timeout_ms);
+    _writing = false;
+
+    if (res_pos >= 0) {
+        if (_write_failed) {
+            DEBUG_PRINTF("[TRANSPORT] Record file full, %s recorded as failed after %u bytes\n",
+                         key, (unsigned)_body_len);
+        }
+        fputc('\n', _file);
+        fseek(_file, res_pos, SEEK_SET);
+        fprintf(_file, RECORD_RES_FORMAT, ok && !_write_failed ? 1 : 0, (unsigned)_body_len);
+        fseek(_file, 0, SEEK_END);
+        fflush(_file);
+        _recorded++;
+    }
+    return ok;
+}
+
+// ============================================================================
+// ReplayTransport
+// ============================================================================
+
+ReplayTransport::ReplayTransport()
+    : _data(nullptr), _data_len(0), _entries(nullptr), _num_entries(0),
+      _loop(false), _served(0), _misses(0) {}
+
+ReplayTransport::~ReplayTransport() {
+    clear();
+}
+
+void ReplayTransport::clear() {
+    free(_data);
+    free(_entries);
+    _data = nullptr;
+    _data_len = 0;
+    _entries = nullptr;
+    _num_entries = 0;
+    _served = 0;
+    _misses = 0;
+}
+
+bool ReplayTransport::load(const char* path) {
+    FILE* f = path ? fopen(path, "rb") : nullptr;
+    if (!f) {
+        DEBUG_PRINTF("[TRANSPORT] Cannot open replay file %s\n", path ? path : "(null)");
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size < 0) {
+        fclose(f);
+        return false;
+    }
+
+    clear();
+    _data = (char*)malloc((size_t)size + 1);
+    if (!_data) {
+        fclose(f);
+        return false;
+    }
+    _data_len = fread(_data, 1, (size_t)size, f);
+    _data[_data_len] = '\0';
+    fclose(f);
+    return parse();
+}
+
+bool ReplayTransport::load_buffer(const char* data, size_t len) {
+    clear();
+    if (!data) {
+        return false;
+    }
+    _data = (char*)malloc(len + 1);
+    if (!_data) {
+        return false;
+    }
+    memcpy(_data, data, len);
+    _data[len] = '\0';
+    _data_len = len;
+    return parse();
+}
+
+// Split the loaded file into entries (bodies and keys point into _data)
+bool ReplayTransport::parse() {
+    size_t cap = 0;
+    const char* p = _data;
+    const char* end = _data + _data_len;
+
+    while (p < end) {
+        if (*p == '\n') {
+            p++;
+            continue;
+        }
+        const char* req_end = (const char*)memchr(p, '\n', end - p);
+        if (!req_end || strncmp(p, "REQ ", 4) != 0) {
+            break;
+        }
+        const char* res = req_end + 1;
+        const char* res_end = (const char*)memchr(res, '\n', end - res);
+        int ok = 0;
+        unsigned len = 0;
+        if (!res_end || sscanf(res, "RES %d %u", &ok, &len) != 2 ||
+            len > (size_t)(end - (res_end + 1))) {
+            break;
+        }
+
+        if (_num_entries == cap) {
+            cap = cap ? cap * 2 : 16;
+            Entry* grown = (Entry*)realloc(_entries, cap * sizeof(Entry));
+            if (!grown) {
+                return false;
+            }
+            _entries = grown;
+        }
+        Entry& e = _entries[_num_entries++];
+        e.key = p + 4;
+        e.key_len = req_end - e.key;
+        e.ok = ok != 0;
+        e.body = res_end + 1;
+        e.body_len = len;
+        e.served = false;
+
+        p = e.body + len;
+    }
+
+    if (p < end) {
+        DEBUG_PRINTF("[TRANSPORT] Replay file malformed after %u entries\n", (unsigned)_num_entries);
+        return false;
+    }
+    return true;
+}
+
+void ReplayTransport::rewind() {
+    for (size_t i = 0; i < _num_entries; i++) {
+        _entries[i].served = false;
+    }
+}
+
+bool ReplayTransport::request(const HttpRequest* req, HttpChunkCallback cb, void* ctx,
+                              uint32_t timeout_ms) {
+    (void)timeout_ms;
+    char key[HTTP_RECORD_KEY_MAX];
+    if (!cb || !http_record_key(req, key, sizeof(key))) {
+        return false;
+    }
+    size_t key_len = strlen(key);
+
+    // First unserved response for this request, in recorded order
+    Entry* match = nullptr;
+    bool seen = false;
+    for (size_t i = 0; i < _num_entries && !match; i++) {
+        Entry& e = _entries[i];
+        if (e.key_len == key_len && memcmp(e.key, key, key_len) == 0) {
+            seen = true;
+            if (!e.served) {
+                match = &e;
+            }
+        }
+    }
+    if (!match && seen && _loop) {
+        for (size_t i = 0; i < _num_entries; i++) {
+            Entry& e = _entries[i];
+            if (e.key_len == key_len && memcmp(e.key, key, key_len) == 0) {
+                e.served = false;
+                if (!match) {
+                    match = &e;
+                }
+            }
+        }
+    }
+    if (!match) {
+        _misses++;
+        DEBUG_PRINTF("[TRANSPORT] No recorded response for %s\n", key);
+        return false;
+    }
+
+    match->served = true;
+    _served++;
+    if (!match->ok) {
+        return false;
+    }
+
+    // Same chunking as a socket read, so consumers see realistic chunk boundaries
+    size_t off = 0;
+    while (off < match->body_len) {
+        size_t n = match->body_len - off;
+        if (n > HTTP_READ_CHUNK_SIZE) {
+            n = HTTP_READ_CHUNK_SIZE;
+        }
+        if (!cb((const uint8_t*)match->body + off, n, ctx)) {
+            return false;
+        }
+        off += n;
+    }
+    return true;
+}
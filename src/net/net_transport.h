@@ -0,0 +1,134 @@
+#ifndef NET_TRANSPORT_H
+#define NET_TRANSPORT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "net_endpoint.h"
+#include "net_http_stream.h"
+
+/**
+ * @file net_transport.h
+ * @brief Pluggable request transport with record / replay backends
+ *
+ * The exchange adapters send their pre-rendered requests through the active
+ * HttpTransport instead of calling the HTTP client directly:
+ * - the Wi-Fi transport (net_http.h, installed by http_init())
+ * - RecordingTransport: forwards to another transport and appends every
+ *   request/response pair to a file
+ * - ReplayTransport: serves a recorded file back deterministically
+ *
+ * With a ReplayTransport the whole fetch -> parse -> model path runs on the
+ * host at full speed (pio test -e native), without a network.
+ *
+ * Record file format (text headers, length-prefixed bodies):
+ *   REQ <host>:<port> <request-target>\n
+ *   RES <1 = ok | 0 = failed> <body length>\n
+ *   <body bytes>\n
+ * The body of a failed request may be partial; replay serves the failure.
+ */
+
+class HttpTransport {
+public:
+    virtual ~HttpTransport() {}
+
+    /**
+     * @brief Send a pre-rendered GET, streaming the body to cb
+     * @return true on success (200 OK and complete body), false on any error
+     */
+    virtual bool request(const HttpRequest* req, HttpChunkCallback cb, void* ctx,
+                         uint32_t timeout_ms) = 0;
+};
+
+// Install the transport used by the adapters (not owned)
+void http_transport_set(HttpTransport* transport);
+
+// Currently installed transport (nullptr before http_init())
+HttpTransport* http_transport_get();
+
+// Request through the installed transport into a caller-provided buffer
+// Returns: false on any error, including a body that does not fit in buf
+bool http_transport_request_buf(const HttpRequest* req, char* buf, size_t cap, size_t* out_len,
+                                uint32_t timeout_ms = 10000);
+
+// Longest "<host>:<port> <request-target>" key
+#define HTTP_RECORD_KEY_MAX 192
+
+// Build the record key of a request, false if it does not fit
+bool http_record_key(const HttpRequest* req, char* out, size_t cap);
+
+/**
+ * Bodies are written to the file as they stream in (no size limit, no body
+ * buffer); the RES line is filled in once the request has finished.
+ */
+class RecordingTransport : public HttpTransport {
+public:
+    // Appends to path; inner performs the actual requests (not owned)
+    RecordingTransport(HttpTransport* inner, const char* path);
+    ~RecordingTransport();
+
+    bool is_open() const { return _file != nullptr; }
+    uint32_t recorded() const { return _recorded; }
+
+    bool request(const HttpRequest* req, HttpChunkCallback cb, void* ctx, uint32_t timeout_ms);
+
+private:
+    static bool tee(const uint8_t* data, size_t len, void* ctx);
+
+    HttpTransport* _inner;
+    FILE* _file;
+    uint32_t _recorded;
+
+    // Per-request state for tee()
+    HttpChunkCallback _cb;
+    void* _cb_ctx;
+    bool _writing;          // Body goes to the file
+    size_t _body_len;       // Body bytes written
+    bool _write_failed;
+};
+
+class ReplayTransport : public HttpTransport {
+public:
+    ReplayTransport();
+    ~ReplayTransport();
+
+    // Load a record file / an in-memory recording (copied), replacing any previous one
+    bool load(const char* path);
+    bool load_buffer(const char* data, size_t len);
+
+    // Serve repeated requests from the start again once every recorded
+    // response for that request was served (default: fail instead)
+    void set_loop(bool loop) { _loop = loop; }
+
+    // Serve every recorded response again from the start
+    void rewind();
+
+    size_t size() const { return _num_entries; }
+    uint32_t served() const { return _served; }
+    uint32_t misses() const { return _misses; }
+
+    bool request(const HttpRequest* req, HttpChunkCallback cb, void* ctx, uint32_t timeout_ms);
+
+private:
+    struct Entry {
+        const char* key;
+        size_t key_len;
+        const char* body;
+        size_t body_len;
+        bool ok;
+        bool served;
+    };
+
+    void clear();
+    bool parse();
+
+    char* _data;
+    size_t _data_len;
+    Entry* _entries;
+    size_t _num_entries;
+    bool _loop;
+    uint32_t _served;
+    uint32_t _misses;
+};
+
+#endif // NET_TRANSPORT_H
@@ -0,0 +1,787 @@
+#include "net_ws.h"
+#include "../config.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#ifdef ARDUINO
+#include <esp_system.h>
+#include <lwip/sockets.h>
+#else
+#include <sys/select.h>
+#endif
+
+// Longest select() sleep, bounds how late a keepalive / reconnect is noticed
+#define WS_POLL_MS 50
+
+// Receive chunk, and chunks read per client per poll round (keeps clients fair)
+#define WS_READ_CHUNK 512
+#define WS_READS_PER_ROUND 8
+
+static const char* WS_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+// ============================================================================
+// SHA-1 / base64 (handshake key only)
+// ============================================================================
+
+static uint32_t rol32(uint32_t v, int n) {
+    return (v << n) | (v >> (32 - n));
+}
+
+static void sha1_block(uint32_t h[5], const uint8_t* block) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; i++) {
+        w[i] = ((uint32_t)block[i * 4] << 24) | ((uint32_t)block[i * 4 + 1] << 16) |
+               ((uint32_t)block[i * 4 + 2] << 8) | block[i * 4 + 3];
+    }
+    for (int i = 16; i < 80; i++) {
+        w[i] = rol32(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; i++) {
+        uint32_t f, k;
+        if (i < 20) {
+            f = (b & c) | (~b & d);
+            k = 0x5A827999;
+        } else if (i < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1;
+        } else if (i < 60) {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8F1BBCDC;
+        } else {
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6;
+        }
+        uint32_t t = rol32(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = rol32(b, 30);
+        b = a;
+        a = t;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+}
+
+// SHA-1 of a short message (< 120 bytes: key + GUID is 60)
+static void sha1_short(const uint8_t* data, size_t len, uint8_t out[20]) {
+    uint32_t h[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+    uint8_t buf[128];
+    memset(buf, 0, sizeof(buf));
+    memcpy(buf, data, len);
+    buf[len] = 0x80;
+    size_t total = (len + 9 <= 64) ? 64 : 128;
+    uint64_t bits = (uint64_t)len * 8;
+    for (int i = 0; i < 8; i++) {
+        buf[total - 1 - i] = (uint8_t)(bits >> (i * 8));
+    }
+    for (size_t off = 0; off < total; off += 64) {
+        sha1_block(h, buf + off);
+    }
+    for (int i = 0; i < 5; i++) {
+        out[i * 4] = (uint8_t)(h[i] >> 24);
+        out[i * 4 + 1] = (uint8_t)(h[i] >> 16);
+        out[i * 4 + 2] = (uint8_t)(h[i] >> 8);
+        out[i * 4 + 3] = (uint8_t)h[i];
+    }
+}
+
+static void base64_encode(const uint8_t* data, size_t len, char* out) {
+    static const char* ALPHABET = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t o = 0;
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t v = (uint32_t)data[i] << 16;
+        if (i + 1 < len) v |= (uint32_t)data[i + 1] << 8;
+        if (i + 2 < len) v |= data[i + 2];
+        out[o++] = ALPHABET[(v >> 18) & 0x3F];
+        out[o++] = ALPHABET[(v >> 12) & 0x3F];
+        out[o++] = (i + 1 < len) ? ALPHABET[(v >> 6) & 0x3F] : '=';
+        out[o++] = (i + 2 < len) ? ALPHABET[v & 0x3F] : '=';
+    }
+    out[o] = '\0';
+}
+
+void ws_accept_key(const char* key, char* out) {
+    uint8_t buf[96];
+    size_t key_len = strlen(key);
+    size_t guid_len = strlen(WS_GUID);
+    if (key_len + guid_len > sizeof(buf) - 24) {
+        out[0] = '\0';
+        return;
+    }
+    memcpy(buf, key, key_len);
+    memcpy(buf + key_len, WS_GUID, guid_len);
+    uint8_t digest[20];
+    sha1_short(buf, key_len + guid_len, digest);
+    base64_encode(digest, sizeof(digest), out);
+}
+
+// Masking keys and handshake nonces (not security sensitive for a client)
+static uint32_t ws_random() {
+#ifdef ARDUINO
+    return esp_random();
+#else
+    return ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+#endif
+}
+
+// ============================================================================
+// Frames
+// ============================================================================
+
+void ws_parser_init(WsFrameParser* p) {
+    p->state = WS_PARSE_HEADER;
+    p->header_len = 0;
+    p->header_need = 2;
+    p->opcode = 0;
+    p->fin = false;
+    p->masked = false;
+    p->remaining = 0;
+    p->payload_pos = 0;
+    p->message_opcode = 0;
+    p->message_overflow = false;
+    p->message_len = 0;
+    p->control_len = 0;
+    p->dropped = 0;
+}
+
+static bool is_control(uint8_t opcode) {
+    return (opcode & 0x8) != 0;
+}
+
+// Current frame's payload is complete
+static bool frame_end(WsFrameParser* p, WsFrameCallback cb, void* ctx) {
+    bool ok = true;
+    if (is_control(p->opcode)) {
+        p->control[p->control_len] = '\0';
+        ok = cb(p->opcode, p->control, p->control_len, ctx);
+    } else if (p->fin) {
+        if (p->message_overflow) {
+            p->dropped++;
+        } else {
+            p->message[p->message_len] = '\0';
+            ok = cb(p->message_opcode, p->message, p->message_len, ctx);
+        }
+        p->message_opcode = 0;
+    }
+    p->state = ok ? WS_PARSE_HEADER : WS_PARSE_ERROR;
+    p->header_len = 0;
+    p->header_need = 2;
+    return ok;
+}
+
+static bool payload_begin(WsFrameParser* p, WsFrameCallback cb, void* ctx) {
+    p->payload_pos = 0;
+    if (is_control(p->opcode)) {
+        p->control_len = 0;
+    } else if (p->opcode != WS_OP_CONTINUATION) {
+        p->message_opcode = p->opcode;
+        p->message_len = 0;
+        p->message_overflow = false;
+    }
+    if (p->remaining == 0) {
+        return frame_end(p, cb, ctx);
+    }
+    p->state = WS_PARSE_PAYLOAD;
+    return true;
+}
+
+// Frame header (first two bytes) complete
+static bool header_done(WsFrameParser* p) {
+    uint8_t b0 = p->header[0];
+    uint8_t b1 = p->header[1];
+    p->fin = (b0 & 0x80) != 0;
+    p->opcode = b0 & 0x0F;
+    p->masked = (b1 & 0x80) != 0;
+    uint8_t len7 = b1 & 0x7F;
+
+    if (b0 & 0x70) {
+        return false;  // No extensions negotiated
+    }
+    switch (p->opcode) {
+        case WS_OP_CONTINUATION:
+            if (p->message_opcode == 0) return false;
+            break;
+        case WS_OP_TEXT:
+        case WS_OP_BINARY:
+            if (p->message_opcode != 0) return false;  // Previous message unfinished
+            break;
+        case WS_OP_CLOSE:
+        case WS_OP_PING:
+        case WS_OP_PONG:
+            if (!p->fin || len7 > 125) return false;
+            break;
+        default:
+            return false;
+    }
+
+    p->header_len = 0;
+    if (len7 == 126) {
+        p->header_need = 2;
+        p->state = WS_PARSE_EXT_LENGTH;
+    } else if (len7 == 127) {
+        p->header_need = 8;
+        p->state = WS_PARSE_EXT_LENGTH;
+    } else {
+        p->remaining = len7;
+        p->header_need = 4;
+        p->state = WS_PARSE_MASK;
+    }
+    return true;
+}
+
+bool ws_parser_feed(WsFrameParser* p, const uint8_t* data, size_t len, WsFrameCallback cb, void* ctx) {
+    size_t i = 0;
+    while (i < len) {
+        switch (p->state) {
+            case WS_PARSE_HEADER:
+                p->header[p->header_len++] = data[i++];
+                if (p->header_len == p->header_need && !header_done(p)) {
+                    p->state = WS_PARSE_ERROR;
+                    return false;
+                }
+                if (p->state == WS_PARSE_MASK && !p->masked &&
+                    !payload_begin(p, cb, ctx)) {
+                    return false;
+                }
+                break;
+
+            case WS_PARSE_EXT_LENGTH:
+                p->header[p->header_len++] = data[i++];
+                if (p->header_len == p->header_need) {
+                    uint64_t n = 0;
+                    for (int k = 0; k < p->header_len; k++) {
+                        n = (n << 8) | p->header[k];
+                    }
+                    p->remaining = n;
+                    p->header_len = 0;
+                    p->header_need = 4;
+                    p->state = WS_PARSE_MASK;
+                    if (!p->masked && !payload_begin(p, cb, ctx)) {
+                        return false;
+                    }
+                }
+                break;
+
+            case WS_PARSE_MASK:
+                p->mask[p->header_len++] = data[i++];
+                if (p->header_len == 4 && !payload_begin(p, cb, ctx)) {
+                    return false;
+                }
+                break;
+
+            case WS_PARSE_PAYLOAD: {
+                size_t n = len - i;
+                if ((uint64_t)n > p->remaining) {
+                    n = (size_t)p->remaining;
+                }
+                char* dst;
+                size_t* dst_len;
+                size_t cap;
+                if (is_control(p->opcode)) {
+                    dst = p->control;
+                    dst_len = &p->control_len;
+                    cap = sizeof(p->control) - 1;
+                } else {
+                    dst = p->message;
+                    dst_len = &p->message_len;
+                    cap = p->message_overflow ? 0 : WS_MESSAGE_MAX;
+                }
+                size_t room = cap - (*dst_len < cap ? *dst_len : cap);
+                size_t copy = n < room ? n : room;
+                if (copy < n && !is_control(p->opcode)) {
+                    p->message_overflow = true;
+                }
+                if (p->masked) {
+                    for (size_t k = 0; k < copy; k++) {
+                        dst[*dst_len + k] = (char)(data[i + k] ^ p->mask[(p->payload_pos + k) & 3]);
+                    }
+                } else {
+                    memcpy(dst + *dst_len, data + i, copy);
+                }
+                *dst_len += copy;
+                p->payload_pos += n;
+                p->remaining -= n;
+                i += n;
+                if (p->remaining == 0 && !frame_end(p, cb, ctx)) {
+                    return false;
+                }
+                break;
+            }
+
+            case WS_PARSE_ERROR:
+            default:
+                return false;
+        }
+    }
+    return p->state != WS_PARSE_ERROR;
+}
+
+size_t ws_frame_encode(uint8_t opcode, const uint8_t* payload, size_t len, const uint8_t mask[4],
+                       uint8_t* out, size_t cap) {
+    size_t header = 2 + 4 + (len > 125 ? (len > 0xFFFF ? 8 : 2) : 0);
+    if (header + len > cap) {
+        return 0;
+    }
+    size_t o = 0;
+    out[o++] = (uint8_t)(0x80 | (opcode & 0x0F));
+    if (len <= 125) {
+        out[o++] = (uint8_t)(0x80 | len);
+    } else if (len <= 0xFFFF) {
+        out[o++] = 0x80 | 126;
+        out[o++] = (uint8_t)(len >> 8);
+        out[o++] = (uint8_t)len;
+    } else {
+        out[o++] = 0x80 | 127;
+        for (int k = 7; k >= 0; k--) {
+            out[o++] = (uint8_t)((uint64_t)len >> (k * 8));
+        }
+    }
+    memcpy(out + o, mask, 4);
+    o += 4;
+    for (size_t k = 0; k < len; k++) {
+        out[o + k] = payload[k] ^ mask[k & 3];
+    }
+    return o + len;
+}
+
+// ============================================================================
+// Client
+// ============================================================================
+
+// Shared receive buffer - clients are serviced one at a time
+static uint8_t g_scratch[WS_READ_CHUNK];
+
+const char* ws_state_name(WsState state) {
+    switch (state) {
+        case WS_CLOSED: return "closed";
+        case WS_CONNECTING: return "connecting";
+        case WS_HANDSHAKE: return "handshake";
+        case WS_OPEN: return "open";
+    }
+    return "?";
+}
+
+void ws_init(WsClient* c, AsyncStreamFactory factory, AsyncClockFn clock,
+             WsMessageCallback on_message, void* ctx) {
+    memset(c, 0, sizeof(*c));
+    c->factory = factory;
+    c->clock = clock;
+    c->on_message = on_message;
+    c->ctx = ctx;
+    c->state = WS_CLOSED;
+    c->backoff_ms = WS_BACKOFF_MIN_MS;
+    ws_parser_init(&c->parser);
+}
+
+bool ws_open(WsClient* c, const char* base_url, const char* path, const char* subscribe) {
+    if (!c || !base_url || !path || path[0] != '/') {
+        return false;
+    }
+    size_t path_len = strlen(path);
+    size_t sub_len = subscribe ? strlen(subscribe) : 0;
+    if (path_len >= sizeof(c->path) || sub_len >= sizeof(c->subscribe)) {
+        DEBUG_PRINTF("[WS] Path or subscribe message too long (%u / %u bytes)\n",
+                     (unsigned)path_len, (unsigned)sub_len);
+        return false;
+    }
+    memcpy(c->path, path, path_len + 1);
+    memcpy(c->subscribe, subscribe ? subscribe : "", sub_len + 1);
+    if (!http_endpoint_init(&c->endpoint, base_url, c->path)) {
+        DEBUG_PRINTF("[WS] Invalid URL %s\n", base_url);
+        return false;
+    }
+    if (c->stream) {
+        ws_close(c);
+    }
+    c->enabled = true;
+    c->backoff_ms = WS_BACKOFF_MIN_MS;
+    c->retry_at_ms = c->clock();
+    return true;
+}
+
+// Drop the connection; reconnect after the backoff if still enabled
+static void ws_drop(WsClient* c, const char* reason) {
+    uint32_t now = c->clock();
+    if (c->state == WS_OPEN) {
+        c->stats.disconnects++;
+        DEBUG_PRINTF("[WS] %s: connection lost (%s) after %lu ms\n", c->endpoint.host, reason,
+                     (unsigned long)(now - c->stats.opened_ms));
+    } else {
+        c->stats.failures++;
+        DEBUG_PRINTF("[WS] %s: %s failed (%s)\n", c->endpoint.host, ws_state_name(c->state), reason);
+    }
+    if (c->stream) {
+        c->stream->close();
+        c->stream = nullptr;
+    }
+    c->state = WS_CLOSED;
+    c->tx_len = 0;
+    c->retry_at_ms = now + c->backoff_ms;
+    c->backoff_ms = c->backoff_ms * 2 > WS_BACKOFF_MAX_MS ? WS_BACKOFF_MAX_MS : c->backoff_ms * 2;
+}
+
+// Append a masked frame to the outgoing buffer
+static bool ws_queue(WsClient* c, uint8_t opcode, const uint8_t* payload, size_t len) {
+    uint32_t r = ws_random();
+    uint8_t mask[4] = { (uint8_t)r, (uint8_t)(r >> 8), (uint8_t)(r >> 16), (uint8_t)(r >> 24) };
+    size_t n = ws_frame_encode(opcode, payload, len, mask, c->tx + c->tx_len, sizeof(c->tx) - c->tx_len);
+    if (n == 0) {
+        return false;
+    }
+    c->tx_len += n;
+    return true;
+}
+
+bool ws_send_text(WsClient* c, const char* text, size_t len) {
+    if (!c || c->state != WS_OPEN) {
+        return false;
+    }
+    return ws_queue(c, WS_OP_TEXT, (const uint8_t*)text, len);
+}
+
+// Send as much of the outgoing buffer as the socket takes
+static bool ws_flush(WsClient* c) {
+    while (c->tx_len > 0) {
+        int n = c->stream->send(c->tx, c->tx_len);
+        if (n < 0) {
+            return false;
+        }
+        if (n == 0) {
+            return true;
+        }
+        memmove(c->tx, c->tx + n, c->tx_len - n);
+        c->tx_len -= n;
+    }
+    return true;
+}
+
+void ws_close(WsClient* c) {
+    if (!c) {
+        return;
+    }
+    if (c->state == WS_OPEN) {
+        // Status 1000 (normal closure), best effort
+        const uint8_t code[2] = { 0x03, 0xE8 };
+        if (ws_queue(c, WS_OP_CLOSE, code, sizeof(code))) {
+            ws_flush(c);
+        }
+    }
+    if (c->stream) {
+        c->stream->close();
+        c->stream = nullptr;
+    }
+    c->state = WS_CLOSED;
+    c->tx_len = 0;
+    c->enabled = false;
+}
+
+static void ws_connect(WsClient* c) {
+    const HttpEndpoint* ep = &c->endpoint;
+    c->stats.connects++;
+    c->state = WS_CONNECTING;
+    c->state_ms = c->clock();
+
+    AsyncStream*& stream = ep->tls ? c->secure : c->plain;
+    if (!stream && c->factory) {
+        stream = c->factory(ep->tls);
+    }
+    if (!stream) {
+        ws_drop(c, "no stream");
+        return;
+    }
+    c->stream = stream;
+    if (!stream->begin(ep->host, ep->port)) {
+        ws_drop(c, "connect");
+    }
+}
+
+// Connected: queue the upgrade request
+static bool ws_start_handshake(WsClient* c) {
+    uint8_t nonce[16];
+    for (int i = 0; i < 16; i += 4) {
+        uint32_t r = ws_random();
+        memcpy(nonce + i, &r, 4);
+    }
+    base64_encode(nonce, sizeof(nonce), c->key);
+
+    const HttpEndpoint* ep = &c->endpoint;
+    char port[8] = "";
+    if (ep->port != (ep->tls ? 443 : 80)) {
+        snprintf(port, sizeof(port), ":%u", (unsigned)ep->port);
+    }
+    int n = snprintf((char*)c->tx, sizeof(c->tx),
+                     "GET %s HTTP/1.1\r\n"
+                     "Host: %s%s\r\n"
+                     "Upgrade: websocket\r\n"
+                     "Connection: Upgrade\r\n"
+                     "Sec-WebSocket-Key: %s\r\n"
+                     "Sec-WebSocket-Version: 13\r\n"
+                     "User-Agent: ESP32-CryptoDash/1.0\r\n"
+                     "\r\n",
+                     c->path, ep->host, port, c->key);
+    if (n <= 0 || (size_t)n >= sizeof(c->tx)) {
+        return false;
+    }
+    c->tx_len = (size_t)n;
+    c->line_len = 0;
+    c->line_overflow = false;
+    c->status_line_seen = false;
+    c->upgraded = false;
+    c->accepted = false;
+    c->state = WS_HANDSHAKE;
+    return true;
+}
+
+// One complete handshake response line (without CRLF)
+static void ws_handshake_line(WsClient* c) {
+    c->line[c->line_len] = '\0';
+    if (!c->status_line_seen) {
+        c->status_line_seen = true;
+        c->upgraded = strncmp(c->line, "HTTP/1.1 101", 12) == 0;
+        return;
+    }
+    static const char* ACCEPT = "sec-websocket-accept:";
+    size_t n = strlen(ACCEPT);
+    if (c->line_len > n && strncasecmp(c->line, ACCEPT, n) == 0) {
+        const char* value = c->line + n;
+        while (*value == ' ') value++;
+        char expected[32];
+        ws_accept_key(c->key, expected);
+        c->accepted = strcmp(value, expected) == 0;
+    }
+}
+
+static bool ws_frame(uint8_t opcode, char* data, size_t len, void* ctx) {
+    WsClient* c = static_cast<WsClient*>(ctx);
+    switch (opcode) {
+        case WS_OP_TEXT:
+            c->stats.messages++;
+            c->stats.last_message_ms = c->clock();
+            c->backoff_ms = WS_BACKOFF_MIN_MS;  // Healthy connection
+            if (c->on_message) {
+                c->on_message(c, data, len, c->ctx);
+            }
+            break;
+        case WS_OP_PING:
+            c->stats.pings++;
+            ws_queue(c, WS_OP_PONG, (const uint8_t*)data, len);
+            break;
+        case WS_OP_CLOSE:
+            c->peer_closed = true;
+            return false;
+        default:
+            break;  // Pong, binary
+    }
+    return true;
+}
+
+// Open: handshake accepted, remaining bytes are frames
+static void ws_opened(WsClient* c) {
+    uint32_t now = c->clock();
+    c->state = WS_OPEN;
+    c->stats.opens++;
+    c->stats.opened_ms = now;
+    c->last_rx_ms = now;
+    c->ping_sent = false;
+    c->peer_closed = false;
+    ws_parser_init(&c->parser);
+    DEBUG_PRINTF("[WS] %s: open (%s)\n", c->endpoint.host, c->path);
+    if (c->subscribe[0]) {
+        ws_queue(c, WS_OP_TEXT, (const uint8_t*)c->subscribe, strlen(c->subscribe));
+    }
+}
+
+// Consume received bytes: handshake lines, then frames
+// Returns false if the connection must be dropped (reason set)
+static bool ws_receive(WsClient* c, const uint8_t* data, size_t len, const char** reason) {
+    size_t i = 0;
+    while (c->state == WS_HANDSHAKE && i < len) {
+        char ch = (char)data[i++];
+        if (ch == '\n') {
+            if (c->line_len == 0 && !c->line_overflow) {
+                // End of headers
+                if (!c->upgraded || !c->accepted) {
+                    *reason = c->upgraded ? "bad accept key" : "not upgraded";
+                    return false;
+                }
+                ws_opened(c);
+                break;
+            }
+            if (!c->line_overflow) {
+                ws_handshake_line(c);
+            }
+            c->line_len = 0;
+            c->line_overflow = false;
+        } else if (ch != '\r') {
+            if (c->line_len < sizeof(c->line) - 1) {
+                c->line[c->line_len++] = ch;
+            } else {
+                c->line_overflow = true;
+            }
+        }
+    }
+    if (c->state == WS_OPEN && i < len) {
+        uint32_t dropped = c->parser.dropped;
+        bool ok = ws_parser_feed(&c->parser, data + i, len - i, ws_frame, c);
+        c->stats.dropped += c->parser.dropped - dropped;
+        if (!ok) {
+            *reason = c->peer_closed ? "closed by server" : "protocol error";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Advance one client: reconnect, connect, send, receive, keepalive
+static void ws_service(WsClient* c, bool readable) {
+    uint32_t now = c->clock();
+
+    if (c->state == WS_CLOSED) {
+        if (c->enabled && (int32_t)(now - c->retry_at_ms) >= 0) {
+            ws_connect(c);
+        }
+        return;
+    }
+
+    if (c->state != WS_OPEN && now - c->state_ms > WS_CONNECT_TIMEOUT_MS) {
+        ws_drop(c, "timeout");
+        return;
+    }
+
+    if (c->state == WS_CONNECTING) {
+        int r = c->stream->step_connect();
+        if (r < 0) {
+            ws_drop(c, "connect");
+            return;
+        }
+        if (r == 0) {
+            return;
+        }
+        if (!ws_start_handshake(c)) {
+            ws_drop(c, "request too long");
+            return;
+        }
+    }
+
+    if (!ws_flush(c)) {
+        ws_drop(c, "send");
+        return;
+    }
+
+    if (readable || c->stream->has_buffered()) {
+        for (int round = 0; round < WS_READS_PER_ROUND; round++) {
+            int n = c->stream->recv(g_scratch, sizeof(g_scratch));
+            if (n < 0) {
+                ws_drop(c, "closed");
+                return;
+            }
+            if (n == 0) {
+                break;
+            }
+            c->stats.bytes += n;
+            c->last_rx_ms = c->clock();
+            c->ping_sent = false;
+            const char* reason = "";
+            if (!ws_receive(c, g_scratch, (size_t)n, &reason)) {
+                ws_drop(c, reason);
+                return;
+            }
+        }
+        // Pongs / subscribe queued while receiving
+        if (!ws_flush(c)) {
+            ws_drop(c, "send");
+            return;
+        }
+    }
+
+    if (c->state == WS_OPEN) {
+        uint32_t idle = c->clock() - c->last_rx_ms;
+        if (idle > WS_STALE_MS) {
+            ws_drop(c, "stale");
+        } else if (idle > WS_PING_IDLE_MS && !c->ping_sent) {
+            c->ping_sent = ws_queue(c, WS_OP_PING, nullptr, 0);
+        }
+    }
+}
+
+int ws_poll(WsClient* const* clients, int n, uint32_t max_wait_ms) {
+    if (!clients || n <= 0) {
+        return 0;
+    }
+    if (n > WS_POLL_MAX_CLIENTS) {
+        n = WS_POLL_MAX_CLIENTS;
+    }
+    AsyncClockFn clock = clients[0]->clock;
+    uint32_t start = clock();
+    uint32_t delivered_before = 0;
+    for (int i = 0; i < n; i++) {
+        delivered_before += clients[i]->stats.messages;
+    }
+    bool readable[WS_POLL_MAX_CLIENTS] = { false };
+    while (true) {
+        for (int i = 0; i < n; i++) {
+            ws_service(clients[i], readable[i]);
+        }
+
+        uint32_t elapsed = clock() - start;
+        if (elapsed >= max_wait_ms) {
+            break;
+        }
+
+        fd_set rfds, wfds;
+        FD_ZERO(&rfds);
+        FD_ZERO(&wfds);
+        int max_fd = -1;
+        bool buffered = false;
+        for (int i = 0; i < n; i++) {
+            const WsClient* c = clients[i];
+            int fd = c->stream ? c->stream->fd() : -1;
+            if (fd < 0) {
+                continue;
+            }
+            if (c->state == WS_CONNECTING) {
+                FD_SET(fd, c->stream->wants_write() ? &wfds : &rfds);
+            } else {
+                FD_SET(fd, &rfds);
+                if (c->tx_len > 0) {
+                    FD_SET(fd, &wfds);
+                }
+                buffered = buffered || c->stream->has_buffered();
+            }
+            if (fd > max_fd) {
+                max_fd = fd;
+            }
+        }
+        if (max_fd < 0) {
+            break;  // Nothing to wait on
+        }
+
+        uint32_t wait = max_wait_ms - elapsed;
+        if (wait > WS_POLL_MS) {
+            wait = WS_POLL_MS;
+        }
+        if (buffered) {
+            wait = 0;
+        }
+        struct timeval tv = { (long)(wait / 1000), (long)((wait % 1000) * 1000) };
+        int ret = select(max_fd + 1, &rfds, &wfds, nullptr, &tv);
+        for (int i = 0; i < n; i++) {
+            const WsClient* c = clients[i];
+            int fd = c->stream ? c->stream->fd() : -1;
+            readable[i] = ret > 0 && fd >= 0 && FD_ISSET(fd, &rfds);
+        }
+    }
+
+    uint32_t delivered = 0;
+    for (int i = 0; i < n; i++) {
+        delivered += clients[i]->stats.messages;
+    }
+    return (int)(delivered - delivered_before);
+}
@@ -0,0 +1,242 @@
+#ifndef NET_WS_H
+#define NET_WS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "net_async.h"
+#include "net_endpoint.h"
+
+/**
+ * @file net_ws.h
+ * @brief WebSocket client (RFC 6455) for exchange market-data streams
+ *
+ * A WsClient keeps one long-lived connection open and delivers each
+ * complete text message to a callback as soon as it arrives, so quotes
+ * are pushed instead of polled. Connections are made through the same
+ * AsyncStream objects as the async HTTP engine (plain TCP or TLS) and
+ * several clients are multiplexed by ws_poll() with select().
+ *
+ * The client answers pings, pings an idle server itself, treats a
+ * connection without traffic for WS_STALE_MS as dead and reconnects with
+ * exponential backoff after any failure.
+ *
+ * Frame parsing and encoding, the handshake key and the client itself
+ * are Arduino-independent and tested on the host against a local
+ * stand-in server.
+ *
+ * Not thread-safe: all calls are expected from net_task.
+ */
+
+// Largest message delivered (longer messages are dropped and counted)
+#define WS_MESSAGE_MAX 1024
+
+// Outgoing bytes buffered (handshake request, subscribe message, pongs)
+#define WS_TX_MAX 512
+
+// Longest request path incl. query (combined stream names)
+#define WS_PATH_MAX 256
+
+// Longest text sent right after the handshake (subscribe message)
+#define WS_SUBSCRIBE_MAX 320
+
+// Ping the server after this long without receiving anything
+#define WS_PING_IDLE_MS 15000
+
+// Reconnect after this long without receiving anything (not even a pong)
+#define WS_STALE_MS 30000
+
+// Clients driven by one ws_poll() call
+#define WS_POLL_MAX_CLIENTS 4
+
+// Connect + handshake deadline
+#define WS_CONNECT_TIMEOUT_MS 10000
+
+// Reconnect backoff
+#define WS_BACKOFF_MIN_MS 1000
+#define WS_BACKOFF_MAX_MS 60000
+
+enum WsOpcode {
+    WS_OP_CONTINUATION = 0x0,
+    WS_OP_TEXT = 0x1,
+    WS_OP_BINARY = 0x2,
+    WS_OP_CLOSE = 0x8,
+    WS_OP_PING = 0x9,
+    WS_OP_PONG = 0xA
+};
+
+// ============================================================================
+// Frames
+// ============================================================================
+
+enum WsParseState {
+    WS_PARSE_HEADER = 0,    // First two bytes
+    WS_PARSE_EXT_LENGTH,    // 16 / 64 bit payload length
+    WS_PARSE_MASK,          // Masking key (servers must not mask, accepted anyway)
+    WS_PARSE_PAYLOAD,
+    WS_PARSE_ERROR
+};
+
+/**
+ * @brief Called for each complete message and each control frame
+ * data is NUL-terminated and may be modified in place (e.g. by ArduinoJson).
+ * Return false to stop parsing (the parser enters WS_PARSE_ERROR).
+ */
+typedef bool (*WsFrameCallback)(uint8_t opcode, char* data, size_t len, void* ctx);
+
+/**
+ * @brief Incremental frame parser, reassembles fragmented messages
+ */
+struct WsFrameParser {
+    WsParseState state;
+    uint8_t header[8];
+    uint8_t header_len;
+    uint8_t header_need;
+    uint8_t opcode;             // Opcode of the current frame
+    bool fin;
+    bool masked;
+    uint8_t mask[4];
+    uint64_t remaining;         // Payload bytes left in the current frame
+    uint64_t payload_pos;       // Payload bytes seen in the current frame (for unmasking)
+
+    // Message being assembled (data frames) / control payload
+    uint8_t message_opcode;     // WS_OP_TEXT / WS_OP_BINARY, 0 if none in progress
+    bool message_overflow;
+    size_t message_len;
+    char message[WS_MESSAGE_MAX + 1];
+    size_t control_len;
+    char control[126];
+
+    uint32_t dropped;           // Messages over WS_MESSAGE_MAX
+};
+
+void ws_parser_init(WsFrameParser* p);
+
+/**
+ * @brief Feed received bytes into the parser
+ * @return false on a protocol error or when the callback stopped parsing
+ */
+bool ws_parser_feed(WsFrameParser* p, const uint8_t* data, size_t len, WsFrameCallback cb, void* ctx);
+
+/**
+ * @brief Encode one complete (FIN) client frame, masked with mask
+ * @return Bytes written to out, 0 if it does not fit
+ */
+size_t ws_frame_encode(uint8_t opcode, const uint8_t* payload, size_t len, const uint8_t mask[4],
+                       uint8_t* out, size_t cap);
+
+/**
+ * @brief Sec-WebSocket-Accept value expected for a Sec-WebSocket-Key
+ * @param out At least 29 bytes (28 base64 chars + NUL)
+ */
+void ws_accept_key(const char* key, char* out);
+
+// ============================================================================
+// Client
+// ============================================================================
+
+enum WsState {
+    WS_CLOSED = 0,          // Not connected (waiting to reconnect if enabled)
+    WS_CONNECTING,          // TCP / TLS connect in progress
+    WS_HANDSHAKE,           // Upgrade request sent, waiting for 101
+    WS_OPEN                 // Messages flowing
+};
+
+// Client counters (monotonic since ws_init)
+struct WsStats {
+    uint32_t connects;          // Connection attempts
+    uint32_t opens;             // Successful handshakes
+    uint32_t failures;          // Connect / handshake failures
+    uint32_t disconnects;       // Open connections lost (error, close, stale)
+    uint32_t messages;          // Messages delivered
+    uint32_t dropped;           // Messages over WS_MESSAGE_MAX
+    uint32_t pings;             // Pings answered
+    uint32_t bytes;             // Bytes received
+    uint32_t last_message_ms;   // Clock at the last delivered message (0 = none)
+    uint32_t opened_ms;         // Clock at the last successful handshake
+};
+
+struct WsClient;
+
+// Receives each complete text message (NUL-terminated, modifiable in place)
+typedef void (*WsMessageCallback)(WsClient* client, char* data, size_t len, void* ctx);
+
+struct WsClient {
+    // Target
+    HttpEndpoint endpoint;
+    char path[WS_PATH_MAX];
+    char subscribe[WS_SUBSCRIBE_MAX];
+    bool enabled;               // Reconnect after failures (cleared by ws_close)
+
+    // Callbacks
+    WsMessageCallback on_message;
+    void* ctx;
+    AsyncStreamFactory factory;
+    AsyncClockFn clock;
+
+    // Connection
+    WsState state;
+    AsyncStream* plain;
+    AsyncStream* secure;
+    AsyncStream* stream;        // Active stream, nullptr while closed
+    char key[25];               // Sec-WebSocket-Key of the current handshake
+    WsFrameParser parser;
+    uint8_t tx[WS_TX_MAX];
+    size_t tx_len;
+    bool peer_closed;           // Close frame received
+
+    // Handshake response, read line by line (long header lines are skipped)
+    char line[96];
+    size_t line_len;
+    bool line_overflow;
+    bool status_line_seen;
+    bool upgraded;              // "HTTP/1.1 101"
+    bool accepted;              // Sec-WebSocket-Accept matches key
+
+    // Timing
+    uint32_t state_ms;          // Entered the current state
+    uint32_t last_rx_ms;
+    bool ping_sent;
+    uint32_t backoff_ms;
+    uint32_t retry_at_ms;
+
+    WsStats stats;
+};
+
+/**
+ * @brief Initialize a client (closed, no target)
+ * @param factory Creates plain / TLS streams (the async engine's factory on the device)
+ * @param clock Millisecond clock for timeouts and backoff
+ * @param on_message Receives text messages
+ */
+void ws_init(WsClient* c, AsyncStreamFactory factory, AsyncClockFn clock,
+             WsMessageCallback on_message, void* ctx);
+
+/**
+ * @brief Connect to base_url + path and keep the connection open
+ *
+ * @param base_url "ws[s]://host[:port]" (or http[s]://)
+ * @param path Request path incl. query, e.g. "/stream?streams=btcusdt@bookTicker"
+ * @param subscribe Text message sent once the connection is open (nullptr = none)
+ * @return false if the URL, path or subscribe message is invalid or too long
+ */
+bool ws_open(WsClient* c, const char* base_url, const char* path, const char* subscribe);
+
+// Close the connection (sends a close frame if open) and stop reconnecting
+void ws_close(WsClient* c);
+
+// Queue a text message (only while open)
+bool ws_send_text(WsClient* c, const char* text, size_t len);
+
+/**
+ * @brief Drive clients[0..n) for max_wait_ms, sleeping in select() while idle
+ * Returns early when no client has a socket (the caller sleeps instead).
+ * @return Number of messages delivered
+ */
+int ws_poll(WsClient* const* clients, int n, uint32_t max_wait_ms);
+
+inline bool ws_is_open(const WsClient* c) { return c->state == WS_OPEN; }
+
+// Human-readable state name for logs
+const char* ws_state_name(WsState state);
+
+#endif // NET_WS_H
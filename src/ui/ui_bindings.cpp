@@ -14,28 +14,36 @@ static struct {
     bool wifi_connected;
     int wifi_rssi;
     char time_str[16];
-    double binance_price;
-    double coinbase_price;
-    double spread_pct;
-    double spread_abs;
-    double funding_rate;
+    Fixed binance_price;
+    Fixed coinbase_price;
+    float spread_pct;
+    Fixed spread_abs;
+    Fixed funding_rate;
     bool data_stale;
     bool alert_active;
     bool initialized;
-} g_cache = { -1, false, 0, "", -1.0, -1.0, -999.0, -999.0, -999.0, true, false, false };
+} g_cache = { -1, false, 0, "", -1, -1, -999.0f, FIXED_UNITS(-999), FIXED_UNITS(-999), true, false, false };
 
 // Epsilon for floating point comparison
-#define FLOAT_EPSILON 0.001
+#define FLOAT_EPSILON 0.001f
 
 // Helper: compare floats with epsilon
-static bool float_changed(double old_val, double new_val) {
-    return fabs(old_val - new_val) > FLOAT_EPSILON;
+static bool float_changed(float old_val, float new_val) {
+    return fabsf(old_val - new_val) > FLOAT_EPSILON;
+}
+
+// Helper: "$%.2f" of a fixed-point amount without soft-float formatting
+static void format_usd(Fixed value, char* buf, size_t cap) {
+    buf[0] = '$';
+    fixed_format(value, 2, buf + 1, cap - 1);
 }
 
 // Periodic timer callback to update UI from model
 static void ui_update_timer_cb(lv_timer_t* timer) {
-    // Get current model snapshot (thread-safe)
-    AppState state = model_snapshot();
+    // Get current model snapshot (thread-safe); static keeps the copy off
+    // the loop task stack (the timer only runs from lv_timer_handler())
+    static AppState state;
+    model_snapshot(&state);
     
     // Apply to UI (only updates changed values)
     ui_bindings_apply(state);
@@ -130,9 +138,9 @@ void ui_bindings_apply(const AppState& state) {
     
     // === UPDATE BINANCE PRICE ===
     if (g_widgets.lbl_binance_price && sym.binance_quote.valid) {
-        if (!g_cache.initialized || float_changed(g_cache.binance_price, sym.binance_quote.price)) {
+        if (!g_cache.initialized || g_cache.binance_price != sym.binance_quote.price) {
             char buf[32];
-            snprintf(buf, sizeof(buf), "$%.2f", sym.binance_quote.price);
+            format_usd(sym.binance_quote.price, buf, sizeof(buf));
             lv_label_set_text(g_widgets.lbl_binance_price, buf);
             g_cache.binance_price = sym.binance_quote.price;
         }
@@ -142,9 +150,9 @@ void ui_bindings_apply(const AppState& state) {
     
     // === UPDATE COINBASE PRICE ===
     if (g_widgets.lbl_coinbase_price && sym.coinbase_quote.valid) {
-        if (!g_cache.initialized || float_changed(g_cache.coinbase_price, sym.coinbase_quote.price)) {
+        if (!g_cache.initialized || g_cache.coinbase_price != sym.coinbase_quote.price) {
             char buf[32];
-            snprintf(buf, sizeof(buf), "$%.2f", sym.coinbase_quote.price);
+            format_usd(sym.coinbase_quote.price, buf, sizeof(buf));
             lv_label_set_text(g_widgets.lbl_coinbase_price, buf);
             g_cache.coinbase_price = sym.coinbase_quote.price;
         }
@@ -171,9 +179,9 @@ void ui_bindings_apply(const AppState& state) {
     
     // === UPDATE SPREAD $ ===
     if (g_widgets.lbl_spread_abs && sym.spread_valid) {
-        if (!g_cache.initialized || float_changed(g_cache.spread_abs, sym.spread_abs)) {
+        if (!g_cache.initialized || g_cache.spread_abs != sym.spread_abs) {
             char buf[32];
-            snprintf(buf, sizeof(buf), "$%.2f", sym.spread_abs);
+            format_usd(sym.spread_abs, buf, sizeof(buf));
             lv_label_set_text(g_widgets.lbl_spread_abs, buf);
             
             // Color code: green if positive, red if negative
@@ -188,9 +196,11 @@ void ui_bindings_apply(const AppState& state) {
     
     // === UPDATE FUNDING RATE ===
     if (g_widgets.lbl_funding && sym.funding.valid) {
-        if (!g_cache.initialized || float_changed(g_cache.funding_rate, sym.funding.rate)) {
+        if (!g_cache.initialized || g_cache.funding_rate != sym.funding.rate) {
             char buf[32];
-            snprintf(buf, sizeof(buf), "%.4f%%", sym.funding.rate * 100.0); // Convert to percentage
+            int n = fixed_format(sym.funding.rate * 100, 4, buf, sizeof(buf) - 1); // Convert to percentage
+            buf[n] = '%';
+            buf[n + 1] = '\0';
             lv_label_set_text(g_widgets.lbl_funding, buf);
             
             // Color code: yellow for positive, red for negative
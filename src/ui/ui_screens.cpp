@@ -15,6 +15,7 @@ static lv_obj_t* screen_dashboard = NULL;
 static lv_obj_t* screen_alerts = NULL;
 static lv_obj_t* screen_settings = NULL;
 static lv_obj_t* screen_chart = NULL;
+static lv_obj_t* screen_spreads = NULL;
 static lv_obj_t* screen_ota = NULL;
 
 // Dashboard widget references (exposed for ui_bindings)
@@ -84,6 +85,22 @@ static void btn_chart_clicked(lv_event_t* e) {
     }
 }
 
+static void spreads_clicked(lv_event_t* e) {
+    DEBUG_PRINTLN("[UI] Price cards clicked - switching to Spreads screen");
+    
+    // Recreate with the current spreads, as the chart screen
+    if (screen_spreads) {
+        lv_obj_del(screen_spreads);
+        screen_spreads = NULL;
+    }
+    
+    ui_screens_create_spreads();
+    
+    if (screen_spreads) {
+        lv_scr_load(screen_spreads);
+    }
+}
+
 static void btn_settings_clicked(lv_event_t* e) {
     DEBUG_PRINTLN("[UI] Settings button clicked - switching to Settings screen");
     if (screen_settings) {
@@ -156,6 +173,8 @@ lv_obj_t* ui_screens_create_dashboard() {
     lv_obj_set_style_border_width(data_container, 0, 0);
     lv_obj_set_style_pad_all(data_container, 8, 0);
     lv_obj_clear_flag(data_container, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_flag(data_container, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(data_container, spreads_clicked, LV_EVENT_CLICKED, NULL);
 
     // Binance Price Card
     lv_obj_t* lbl_binance_title = lv_label_create(data_container);
@@ -727,9 +746,11 @@ lv_obj_t* ui_screens_create_chart() {
     lv_obj_center(lbl_back);
     
     // Title - get current symbol
-    AppState state = model_snapshot();
-    const char* symbol = state.symbols[state.selected_symbol_idx].symbol_name;
-    const SymbolState& sym = state.symbols[state.selected_symbol_idx];
+    // Only the selected symbol is needed; static keeps it off the loop task stack
+    int idx = model_get_selected();
+    static SymbolState sym;
+    model_get_symbol(idx, &sym);
+    const char* symbol = sym.symbol_name;
     
     lv_obj_t* lbl_title = lv_label_create(screen);
     char title[32];
@@ -743,7 +764,8 @@ lv_obj_t* ui_screens_create_chart() {
     lv_obj_t* lbl_price = lv_label_create(screen);
     char price_text[32];
     if (sym.binance_quote.valid) {
-        snprintf(price_text, sizeof(price_text), "$%.2f", sym.binance_quote.price);
+        price_text[0] = '$';
+        fixed_format(sym.binance_quote.price, 2, price_text + 1, sizeof(price_text) - 1);
     } else {
         snprintf(price_text, sizeof(price_text), "---");
     }
@@ -770,12 +792,12 @@ lv_obj_t* ui_screens_create_chart() {
     
     // Populate with history data
     DEBUG_PRINTF("[CHART] Drawing chart for symbol %d: history_count=%d, history_head=%d\n", 
-                  state.selected_symbol_idx, sym.history_count, sym.history_head);
+                  idx, sym.history_count, sym.history_head);
     
     if (sym.history_count > 0) {
         // Find min/max for auto-scaling
-        double min_price = sym.price_history[0];
-        double max_price = sym.price_history[0];
+        Fixed min_price = sym.price_history[0];
+        Fixed max_price = sym.price_history[0];
         
         for (int i = 0; i < sym.history_count; i++) {
             if (sym.price_history[i] < min_price) min_price = sym.price_history[i];
@@ -783,22 +805,24 @@ lv_obj_t* ui_screens_create_chart() {
         }
         
         // Add 5% padding
-        double range = max_price - min_price;
-        min_price -= range * 0.05;
-        max_price += range * 0.05;
+        Fixed range = max_price - min_price;
+        min_price -= range / 20;
+        max_price += range / 20;
         
-        DEBUG_PRINTF("[CHART] Y-axis range: %.2f to %.2f (range: %.2f)\n", min_price, max_price, range);
+        DEBUG_PRINTF("[CHART] Y-axis range: %.2f to %.2f (range: %.2f)\n", fixed_to_double(min_price),
+                     fixed_to_double(max_price), fixed_to_double(range));
         
-        lv_chart_set_range(chart, LV_CHART_AXIS_PRIMARY_Y, (int)min_price, (int)max_price);
+        lv_chart_set_range(chart, LV_CHART_AXIS_PRIMARY_Y, (int)(min_price / FIXED_SCALE),
+                           (int)(max_price / FIXED_SCALE));
         
         // Populate data points
         for (int i = 0; i < PRICE_HISTORY_SIZE; i++) {
             if (i < sym.history_count) {
                 int idx = (sym.history_head - sym.history_count + i + PRICE_HISTORY_SIZE) % PRICE_HISTORY_SIZE;
-                series->y_points[i] = (lv_coord_t)sym.price_history[idx];
+                series->y_points[i] = (lv_coord_t)(sym.price_history[idx] / FIXED_SCALE);
                 if (i < 5 || i >= sym.history_count - 5) {
                     DEBUG_PRINTF("[CHART] Point[%d] = %.2f (from history[%d])\n", 
-                                  i, sym.price_history[idx], idx);
+                                  i, fixed_to_double(sym.price_history[idx]), idx);
                 }
             } else {
                 series->y_points[i] = LV_CHART_POINT_NONE;
@@ -810,7 +834,11 @@ lv_obj_t* ui_screens_create_chart() {
         // Show price range (at bottom of screen)
         lv_obj_t* lbl_range = lv_label_create(screen);
         char range_text[64];
-        snprintf(range_text, sizeof(range_text), "Range: $%.2f - $%.2f", min_price, max_price);
+        char min_text[24];
+        char max_text[24];
+        fixed_format(min_price, 2, min_text, sizeof(min_text));
+        fixed_format(max_price, 2, max_text, sizeof(max_text));
+        snprintf(range_text, sizeof(range_text), "Range: $%s - $%s", min_text, max_text);
         lv_label_set_text(lbl_range, range_text);
         lv_obj_set_style_text_color(lbl_range, lv_color_hex(0xEAECEF), 0);
         lv_obj_set_style_text_font(lbl_range, &lv_font_montserrat_14, 0);
@@ -828,6 +856,109 @@ lv_obj_t* ui_screens_create_chart() {
     return screen;
 }
 
+// Spread matrix screen: mid spread of buying on the row venue and selling on
+// the column venue, plus the widest and best executable pairs
+lv_obj_t* ui_screens_create_spreads() {
+    lv_obj_t* screen = lv_obj_create(NULL);
+    lv_obj_set_style_bg_color(screen, lv_color_hex(0x181A20), 0);
+    screen_spreads = screen;
+    
+    // Back button
+    lv_obj_t* btn_back = lv_btn_create(screen);
+    lv_obj_set_size(btn_back, 80, 40);
+    lv_obj_set_pos(btn_back, 5, 5);
+    lv_obj_set_style_bg_color(btn_back, lv_color_hex(0x2B3139), 0);
+    lv_obj_add_event_cb(btn_back, btn_back_clicked, LV_EVENT_CLICKED, NULL);
+    lv_obj_t* lbl_back = lv_label_create(btn_back);
+    lv_label_set_text(lbl_back, "Back");
+    lv_obj_center(lbl_back);
+    
+    static SymbolState sym;
+    model_get_symbol(model_get_selected(), &sym);
+    const SpreadMatrix& m = sym.spreads;
+    
+    lv_obj_t* lbl_title = lv_label_create(screen);
+    char title[32];
+    snprintf(title, sizeof(title), "%s Spreads", sym.symbol_name);
+    lv_label_set_text(lbl_title, title);
+    lv_obj_set_style_text_color(lbl_title, lv_color_hex(0xF0B90B), 0);
+    lv_obj_set_style_text_font(lbl_title, &lv_font_montserrat_14, 0);
+    lv_obj_set_pos(lbl_title, 90, 5);
+    
+    // Grid of labels (lv_table is disabled in lv_conf.h): 80px venue column
+    // on the left, one 75px column per sell venue
+    const int col_x = 85;
+    const int col_w = 75;
+    const int row_y = 60;
+    const int row_h = 25;
+    
+    lv_obj_t* lbl_axes = lv_label_create(screen);
+    lv_label_set_text(lbl_axes, "Buy/Sell");
+    lv_obj_set_style_text_color(lbl_axes, lv_color_hex(0x888888), 0);
+    lv_obj_set_pos(lbl_axes, 5, row_y);
+    
+    for (int v = 0; v < VENUE_COUNT; v++) {
+        lv_obj_t* lbl_col = lv_label_create(screen);
+        lv_label_set_text(lbl_col, quote_venue_name(v));
+        lv_obj_set_style_text_color(lbl_col, lv_color_hex(0x888888), 0);
+        lv_obj_set_pos(lbl_col, col_x + v * col_w, row_y);
+        
+        lv_obj_t* lbl_row = lv_label_create(screen);
+        lv_label_set_text(lbl_row, quote_venue_name(v));
+        lv_obj_set_style_text_color(lbl_row, lv_color_hex(0x888888), 0);
+        lv_obj_set_pos(lbl_row, 5, row_y + (v + 1) * row_h);
+    }
+    
+    for (int i = 0; i < VENUE_COUNT; i++) {
+        for (int j = 0; j < VENUE_COUNT; j++) {
+            lv_obj_t* lbl_cell = lv_label_create(screen);
+            char buf[16];
+            lv_color_t color = lv_color_hex(0x888888);
+            if (i != j && spread_matrix_mid_valid(m, i, j)) {
+                float pct = m.mid_pct[i][j];
+                snprintf(buf, sizeof(buf), "%.3f%%", pct);
+                color = (pct >= 0) ? lv_color_hex(0x0ECB81) : lv_color_hex(0xF6465D);
+            } else {
+                snprintf(buf, sizeof(buf), i == j ? "-" : "--");
+            }
+            lv_label_set_text(lbl_cell, buf);
+            lv_obj_set_style_text_color(lbl_cell, color, 0);
+            lv_obj_set_pos(lbl_cell, col_x + j * col_w, row_y + (i + 1) * row_h);
+        }
+    }
+    
+    // Widest mid spread and best executable round trip
+    char line[64];
+    char abs_text[24];
+    lv_obj_t* lbl_widest = lv_label_create(screen);
+    if (m.widest_valid) {
+        fixed_format(m.widest_abs, 2, abs_text, sizeof(abs_text));
+        snprintf(line, sizeof(line), "Widest: %s > %s %.3f%% $%s",
+                 quote_venue_name(m.widest_low), quote_venue_name(m.widest_high),
+                 m.widest_pct, abs_text);
+    } else {
+        snprintf(line, sizeof(line), "Widest: --");
+    }
+    lv_label_set_text(lbl_widest, line);
+    lv_obj_set_style_text_color(lbl_widest, lv_color_hex(0xEAECEF), 0);
+    lv_obj_set_pos(lbl_widest, 5, row_y + (VENUE_COUNT + 1) * row_h + 10);
+    
+    lv_obj_t* lbl_best = lv_label_create(screen);
+    if (m.best_valid) {
+        fixed_format(m.best_abs, 2, abs_text, sizeof(abs_text));
+        snprintf(line, sizeof(line), "Exec: %s > %s %.3f%% $%s",
+                 quote_venue_name(m.best_buy), quote_venue_name(m.best_sell),
+                 m.best_pct, abs_text);
+    } else {
+        snprintf(line, sizeof(line), "Exec: --");
+    }
+    lv_label_set_text(lbl_best, line);
+    lv_obj_set_style_text_color(lbl_best, lv_color_hex(0xEAECEF), 0);
+    lv_obj_set_pos(lbl_best, 5, row_y + (VENUE_COUNT + 2) * row_h + 10);
+    
+    return screen;
+}
+
 #if ENABLE_OTA
 lv_obj_t* ui_screens_create_ota() {
     DEBUG_PRINTLN("[UI] Creating OTA screen...");
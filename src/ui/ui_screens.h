@@ -27,6 +27,9 @@ lv_obj_t* ui_screens_create_alerts();
 lv_obj_t* ui_screens_create_settings();
 lv_obj_t* ui_screens_create_chart();
 
+// Spread matrix of the selected symbol (opened from the dashboard price cards)
+lv_obj_t* ui_screens_create_spreads();
+
 #if ENABLE_OTA
 lv_obj_t* ui_screens_create_ota();
 #endif
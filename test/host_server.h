@@ -0,0 +1,83 @@
+#ifndef TEST_HOST_SERVER_H
+#define TEST_HOST_SERVER_H
+
+/**
+ * @file host_server.h
+ * @brief Loopback stand-in server shared by the host network suites
+ *
+ * Linux only. start_server() listens on an ephemeral loopback port
+ * (g_port) and hands every accepted socket to serve_connection() on its
+ * own thread. Each suite defines serve_connection() with its scenario and
+ * closes the socket when done.
+ *
+ * Suites that drive the async engine (net_async.h included first) also get
+ * its clock and a plain-socket stream factory.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Defined by the suite: serve one accepted connection (arg is the fd)
+static void* serve_connection(void* arg);
+
+static int g_listen_fd = -1;
+static uint16_t g_port = 0;
+static volatile int g_accepts = 0;
+
+static void* accept_loop(void*) {
+    while (true) {
+        int fd = accept(g_listen_fd, nullptr, nullptr);
+        if (fd < 0) break;
+        g_accepts++;
+        pthread_t t;
+        pthread_create(&t, nullptr, serve_connection, (void*)(intptr_t)fd);
+        pthread_detach(t);
+    }
+    return nullptr;
+}
+
+static void start_server() {
+    g_listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(g_listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    bind(g_listen_fd, (sockaddr*)&addr, sizeof(addr));
+    listen(g_listen_fd, 16);
+
+    socklen_t len = sizeof(addr);
+    getsockname(g_listen_fd, (sockaddr*)&addr, &len);
+    g_port = ntohs(addr.sin_port);
+
+    pthread_t t;
+    pthread_create(&t, nullptr, accept_loop, nullptr);
+    pthread_detach(t);
+}
+
+#ifdef NET_ASYNC_H
+#include <chrono>
+
+// Real clock plus a skew the tests advance to skip backoff / ageing
+static uint32_t g_skew_ms = 0;
+
+static uint32_t test_clock() {
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count() + g_skew_ms;
+}
+
+// Plain sockets only (no TLS on the host)
+static AsyncStream* test_factory(bool tls) {
+    return tls ? nullptr : new SocketStream();
+}
+#endif
+
+#endif // TEST_HOST_SERVER_H
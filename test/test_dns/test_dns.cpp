@@ -0,0 +1,197 @@
+/**
+ * @file test_dns.cpp
+ * @brief Unit tests for the DNS cache (net_dns)
+ *
+ * Tests cover:
+ * - Hits within the TTL, re-resolution after it
+ * - Negative caching of failed lookups
+ * - Serving the last good address through resolver outages
+ * - LRU replacement, invalidation and literal IPv4 addresses
+ * - Pre-resolving registered hosts
+ */
+
+#include <unity.h>
+#include <net/net_dns.h>
+#include <stdio.h>
+#include <string.h>
+
+// Fake clock and resolver
+static uint32_t g_now = 1000;
+static int g_resolver_calls = 0;
+static bool g_resolver_up = true;
+static uint32_t g_next_ip = 0x0100000A;  // 10.0.0.1
+
+static uint32_t fake_clock() {
+    return g_now;
+}
+
+static bool fake_resolver(const char* host, uint32_t* out_ipv4) {
+    g_resolver_calls++;
+    if (!g_resolver_up || strstr(host, "invalid") != nullptr) {
+        return false;
+    }
+    *out_ipv4 = g_next_ip;
+    return true;
+}
+
+void setUp() {
+    g_now = 1000;
+    g_resolver_calls = 0;
+    g_resolver_up = true;
+    g_next_ip = 0x0100000A;
+    dns_cache_init(fake_resolver, fake_clock);
+}
+
+void test_hit_within_ttl() {
+    uint32_t ip = 0;
+    TEST_ASSERT_TRUE(dns_resolve("api.binance.com", &ip));
+    TEST_ASSERT_EQUAL_HEX32(0x0100000A, ip);
+
+    g_now += DNS_CACHE_TTL_MS - 1;
+    ip = 0;
+    TEST_ASSERT_TRUE(dns_resolve("api.binance.com", &ip));
+    TEST_ASSERT_EQUAL_HEX32(0x0100000A, ip);
+    TEST_ASSERT_EQUAL(1, g_resolver_calls);
+
+    DnsStats stats = dns_get_stats();
+    TEST_ASSERT_EQUAL(2, stats.lookups);
+    TEST_ASSERT_EQUAL(1, stats.hits);
+    TEST_ASSERT_EQUAL(1, stats.resolves);
+}
+
+void test_reresolves_after_ttl() {
+    uint32_t ip = 0;
+    TEST_ASSERT_TRUE(dns_resolve("api.binance.com", &ip));
+
+    g_now += DNS_CACHE_TTL_MS;
+    g_next_ip = 0x0200000A;
+    TEST_ASSERT_TRUE(dns_resolve("api.binance.com", &ip));
+    TEST_ASSERT_EQUAL_HEX32(0x0200000A, ip);
+    TEST_ASSERT_EQUAL(2, g_resolver_calls);
+}
+
+void test_negative_caching() {
+    uint32_t ip = 0;
+    TEST_ASSERT_FALSE(dns_resolve("invalid.example", &ip));
+    TEST_ASSERT_FALSE(dns_resolve("invalid.example", &ip));
+    TEST_ASSERT_EQUAL(1, g_resolver_calls);
+
+    // Retried once the negative TTL has passed
+    g_now += DNS_NEGATIVE_TTL_MS;
+    TEST_ASSERT_FALSE(dns_resolve("invalid.example", &ip));
+    TEST_ASSERT_EQUAL(2, g_resolver_calls);
+
+    DnsStats stats = dns_get_stats();
+    TEST_ASSERT_EQUAL(1, stats.negative_hits);
+    TEST_ASSERT_EQUAL(2, stats.failures);
+}
+
+void test_stale_address_served_during_outage() {
+    uint32_t ip = 0;
+    TEST_ASSERT_TRUE(dns_resolve("api.coinbase.com", &ip));
+
+    g_now += DNS_CACHE_TTL_MS;
+    g_resolver_up = false;
+    ip = 0;
+    TEST_ASSERT_TRUE(dns_resolve("api.coinbase.com", &ip));
+    TEST_ASSERT_EQUAL_HEX32(0x0100000A, ip);
+
+    // Within the negative TTL the resolver is not asked again
+    TEST_ASSERT_TRUE(dns_resolve("api.coinbase.com", &ip));
+    TEST_ASSERT_EQUAL(2, g_resolver_calls);
+    TEST_ASSERT_EQUAL(2, dns_get_stats().stale_served);
+
+    // Too old to trust any more
+    g_now += DNS_STALE_MAX_MS;
+    TEST_ASSERT_FALSE(dns_resolve("api.coinbase.com", &ip));
+
+    // Recovers as soon as the resolver does
+    g_now += DNS_NEGATIVE_TTL_MS;
+    g_resolver_up = true;
+    TEST_ASSERT_TRUE(dns_resolve("api.coinbase.com", &ip));
+}
+
+void test_lru_replacement() {
+    char host[32];
+    uint32_t ip;
+    for (int i = 0; i < DNS_CACHE_SIZE; i++) {
+        snprintf(host, sizeof(host), "host%d.example", i);
+        TEST_ASSERT_TRUE(dns_resolve(host, &ip));
+        g_now += 10;
+    }
+    // Touch host0 so host1 becomes least recently used
+    TEST_ASSERT_TRUE(dns_resolve("host0.example", &ip));
+    TEST_ASSERT_TRUE(dns_resolve("another.example", &ip));
+    int calls = g_resolver_calls;
+
+    TEST_ASSERT_TRUE(dns_resolve("host0.example", &ip));
+    TEST_ASSERT_EQUAL(calls, g_resolver_calls);
+    TEST_ASSERT_TRUE(dns_resolve("host1.example", &ip));
+    TEST_ASSERT_EQUAL(calls + 1, g_resolver_calls);
+}
+
+void test_invalidate_forces_lookup() {
+    uint32_t ip;
+    TEST_ASSERT_TRUE(dns_resolve("fapi.binance.com", &ip));
+    dns_invalidate("fapi.binance.com");
+    TEST_ASSERT_TRUE(dns_resolve("fapi.binance.com", &ip));
+    TEST_ASSERT_EQUAL(2, g_resolver_calls);
+}
+
+void test_literal_address_bypasses_cache() {
+    uint32_t ip = 0;
+    TEST_ASSERT_TRUE(dns_resolve("192.168.1.10", &ip));
+    const uint8_t* b = (const uint8_t*)&ip;
+    TEST_ASSERT_EQUAL(192, b[0]);
+    TEST_ASSERT_EQUAL(168, b[1]);
+    TEST_ASSERT_EQUAL(1, b[2]);
+    TEST_ASSERT_EQUAL(10, b[3]);
+    TEST_ASSERT_EQUAL(0, g_resolver_calls);
+    TEST_ASSERT_EQUAL(0, dns_get_stats().lookups);
+
+    // Not an address: goes to the resolver
+    TEST_ASSERT_TRUE(dns_resolve("1.2.3.4.example", &ip));
+    TEST_ASSERT_EQUAL(1, g_resolver_calls);
+}
+
+void test_preresolve_registered_hosts() {
+    dns_register("api.binance.com");
+    dns_register("api.coinbase.com");
+    dns_register("api.binance.com");  // Duplicate ignored
+    TEST_ASSERT_EQUAL(2, dns_preresolve_all());
+    TEST_ASSERT_EQUAL(2, g_resolver_calls);
+
+    uint32_t ip;
+    TEST_ASSERT_TRUE(dns_resolve("api.coinbase.com", &ip));
+    TEST_ASSERT_EQUAL(2, g_resolver_calls);
+    TEST_ASSERT_EQUAL(1, dns_get_stats().hits);
+}
+
+int run_dns_tests() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_hit_within_ttl);
+    RUN_TEST(test_reresolves_after_ttl);
+    RUN_TEST(test_negative_caching);
+    RUN_TEST(test_stale_address_served_during_outage);
+    RUN_TEST(test_lru_replacement);
+    RUN_TEST(test_invalidate_forces_lookup);
+    RUN_TEST(test_literal_address_bypasses_cache);
+    RUN_TEST(test_preresolve_registered_hosts);
+
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    run_dns_tests();
+}
+
+void loop() {
+    // Tests run once in setup
+}
+#else
+int main() {
+    return run_dns_tests();
+}
+#endif
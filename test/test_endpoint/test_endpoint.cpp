@@ -0,0 +1,246 @@
+/**
+ * @file test_endpoint.cpp
+ * @brief Unit tests for precompiled endpoints and rendered requests (net_endpoint)
+ *
+ * Tests cover:
+ * - URL resolution (scheme, host, port, path), incl. ws:// and wss://
+ * - Malformed URLs
+ * - Request rendering with and without a path argument
+ * - Request cache hits, misses and replacement
+ * - Batched list requests: list format, split, re-render on change
+ */
+
+#include <unity.h>
+#include <net/net_endpoint.h>
+#include <stdio.h>
+#include <string.h>
+
+void test_endpoint_https_default_port() {
+    HttpEndpoint ep;
+    TEST_ASSERT_TRUE(http_endpoint_init(&ep, "https://api.binance.com", "/api/v3/ticker/price?symbol={}"));
+    TEST_ASSERT_TRUE(ep.tls);
+    TEST_ASSERT_EQUAL(443, ep.port);
+    TEST_ASSERT_EQUAL_STRING("api.binance.com", ep.host);
+    TEST_ASSERT_EQUAL_STRING("/api/v3/ticker/price?symbol={}", ep.path_template);
+}
+
+void test_endpoint_http_explicit_port_and_url_path() {
+    HttpEndpoint ep;
+    const char* url = "http://192.168.1.10:8080/v2/prices/BTC-USD/spot";
+    TEST_ASSERT_TRUE(http_endpoint_init(&ep, url, nullptr));
+    TEST_ASSERT_FALSE(ep.tls);
+    TEST_ASSERT_EQUAL(8080, ep.port);
+    TEST_ASSERT_EQUAL_STRING("192.168.1.10", ep.host);
+    TEST_ASSERT_EQUAL_STRING("/v2/prices/BTC-USD/spot", ep.path_template);
+
+    TEST_ASSERT_TRUE(http_endpoint_init(&ep, "http://example.com", nullptr));
+    TEST_ASSERT_EQUAL_STRING("/", ep.path_template);
+}
+
+void test_endpoint_websocket_schemes() {
+    HttpEndpoint ep;
+    TEST_ASSERT_TRUE(http_endpoint_init(&ep, "wss://stream.binance.com:9443", "/stream"));
+    TEST_ASSERT_TRUE(ep.tls);
+    TEST_ASSERT_EQUAL(9443, ep.port);
+    TEST_ASSERT_EQUAL_STRING("stream.binance.com", ep.host);
+
+    TEST_ASSERT_TRUE(http_endpoint_init(&ep, "ws://127.0.0.1", "/"));
+    TEST_ASSERT_FALSE(ep.tls);
+    TEST_ASSERT_EQUAL(80, ep.port);
+}
+
+void test_endpoint_rejects_malformed() {
+    HttpEndpoint ep;
+    TEST_ASSERT_FALSE(http_endpoint_init(&ep, "ftp://example.com", nullptr));
+    TEST_ASSERT_FALSE(http_endpoint_init(&ep, "https://", nullptr));
+    TEST_ASSERT_FALSE(http_endpoint_init(&ep, "http://host:/x", nullptr));
+    TEST_ASSERT_FALSE(http_endpoint_init(&ep, "http://host:99999/x", nullptr));
+    TEST_ASSERT_FALSE(http_endpoint_init(&ep, "http://host:80x/", nullptr));
+    TEST_ASSERT_FALSE(http_endpoint_init(&ep, "https://api.binance.com/api", "/v3/{}"));
+    TEST_ASSERT_FALSE(http_endpoint_init(&ep,
+        "https://a-very-long-hostname-that-does-not-fit-the-pool-slot.example.com/", nullptr));
+}
+
+void test_render_with_argument() {
+    HttpEndpoint ep;
+    HttpRequest req;
+    http_endpoint_init(&ep, "https://fapi.binance.com", "/fapi/v1/fundingRate?symbol={}&limit=1");
+    TEST_ASSERT_TRUE(http_request_render(&req, &ep, "BTCUSDT"));
+
+    const char* expected =
+        "GET /fapi/v1/fundingRate?symbol=BTCUSDT&limit=1 HTTP/1.1\r\n"
+        "Host: fapi.binance.com\r\n"
+        "Connection: keep-alive\r\n"
+        "User-Agent: ESP32-CryptoDash/1.0\r\n"
+        "\r\n";
+    TEST_ASSERT_EQUAL_STRING(expected, req.data);
+    TEST_ASSERT_EQUAL(strlen(expected), req.len);
+    TEST_ASSERT_EQUAL_PTR(&ep, req.endpoint);
+}
+
+void test_render_non_default_port_in_host_header() {
+    HttpEndpoint ep;
+    HttpRequest req;
+    http_endpoint_init(&ep, "http://localhost:8080/status", nullptr);
+    TEST_ASSERT_TRUE(http_request_render(&req, &ep, nullptr));
+    TEST_ASSERT_NOT_NULL(strstr(req.data, "GET /status HTTP/1.1\r\n"));
+    TEST_ASSERT_NOT_NULL(strstr(req.data, "Host: localhost:8080\r\n"));
+}
+
+void test_render_overflow_fails() {
+    static char path[HTTP_REQUEST_MAX];
+    memset(path, 'a', sizeof(path) - 1);
+    path[0] = '/';
+    path[sizeof(path) - 1] = '\0';
+
+    HttpEndpoint ep;
+    HttpRequest req;
+    http_endpoint_init(&ep, "https://api.coinbase.com", path);
+    TEST_ASSERT_FALSE(http_request_render(&req, &ep, nullptr));
+    TEST_ASSERT_EQUAL(0, req.len);
+}
+
+void test_cache_renders_once_per_argument() {
+    HttpEndpoint ep;
+    HttpRequestCache cache;
+    http_endpoint_init(&ep, "https://api.coinbase.com", "/v2/prices/{}/spot");
+    http_request_cache_init(&cache, &ep);
+
+    const HttpRequest* a = http_request_cache_get(&cache, "BTC-USD");
+    const HttpRequest* b = http_request_cache_get(&cache, "ETH-USD");
+    const HttpRequest* a2 = http_request_cache_get(&cache, "BTC-USD");
+
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_EQUAL_PTR(a, a2);
+    TEST_ASSERT_EQUAL(2, cache.renders);
+    TEST_ASSERT_NOT_NULL(strstr(a->data, "GET /v2/prices/BTC-USD/spot HTTP/1.1"));
+    TEST_ASSERT_NOT_NULL(strstr(b->data, "GET /v2/prices/ETH-USD/spot HTTP/1.1"));
+}
+
+void test_cache_replaces_when_full() {
+    HttpEndpoint ep;
+    HttpRequestCache cache;
+    http_endpoint_init(&ep, "https://api.binance.com", "/api/v3/ticker/price?symbol={}");
+    http_request_cache_init(&cache, &ep);
+
+    char sym[HTTP_REQUEST_KEY_MAX];
+    for (int i = 0; i < HTTP_REQUEST_CACHE_SIZE + 2; i++) {
+        snprintf(sym, sizeof(sym), "SYM%dUSDT", i);
+        TEST_ASSERT_NOT_NULL(http_request_cache_get(&cache, sym));
+    }
+    TEST_ASSERT_EQUAL(HTTP_REQUEST_CACHE_SIZE, cache.count);
+
+    // Newest entries are served from the cache
+    const HttpRequest* r = http_request_cache_get(&cache, sym);
+    TEST_ASSERT_NOT_NULL(strstr(r->data, sym));
+    TEST_ASSERT_EQUAL(HTTP_REQUEST_CACHE_SIZE + 2, cache.renders);
+}
+
+void test_cache_rejects_bad_keys() {
+    HttpEndpoint ep;
+    HttpRequestCache cache;
+    http_endpoint_init(&ep, "https://api.binance.com", "/api/v3/ticker/price?symbol={}");
+    http_request_cache_init(&cache, &ep);
+
+    TEST_ASSERT_NULL(http_request_cache_get(&cache, ""));
+    TEST_ASSERT_NULL(http_request_cache_get(&cache, nullptr));
+    TEST_ASSERT_NULL(http_request_cache_get(&cache, "AVERYLONGSYMBOLNAMEUSDT"));
+}
+
+void test_batches_format_and_reuse() {
+    static const HttpListFormat array = { "%5B", "%22", "%5D" };
+    HttpEndpoint ep;
+    HttpRequestBatches set;
+    http_endpoint_init(&ep, "https://api.binance.com", "/api/v3/ticker/price?symbols={}");
+    http_request_batches_init(&set, &ep, &array, 2);
+
+    const char* symbols[] = { "BTCUSDT", "ETHUSDT" };
+    const HttpRequestBatch* batches = nullptr;
+    TEST_ASSERT_EQUAL(1, http_request_batches(&set, symbols, 2, &batches));
+    TEST_ASSERT_NOT_NULL(strstr(batches[0].request.data,
+                                "GET /api/v3/ticker/price?symbols=%5B%22BTCUSDT%22,%22ETHUSDT%22%5D HTTP/1.1"));
+    TEST_ASSERT_EQUAL(0, batches[0].first);
+    TEST_ASSERT_EQUAL(2, batches[0].count);
+    TEST_ASSERT_EQUAL_STRING("BTCUSDT,ETHUSDT", set.key);
+
+    // Same list: served as rendered; invalid item: no requests
+    const HttpRequestBatch* again = nullptr;
+    TEST_ASSERT_EQUAL(1, http_request_batches(&set, symbols, 2, &again));
+    TEST_ASSERT_EQUAL_PTR(batches, again);
+    const char* bad[] = { "BTCUSDT", "" };
+    TEST_ASSERT_EQUAL(0, http_request_batches(&set, bad, 2, &again));
+}
+
+void test_batches_split_long_list() {
+    static const HttpListFormat plain = { "", "", "" };
+    HttpEndpoint ep;
+    HttpRequestBatches set;
+    http_endpoint_init(&ep, "https://api.kraken.com", "/0/public/Ticker?pair={}");
+    http_request_batches_init(&set, &ep, &plain, 3);
+
+    char names[24][12];
+    const char* pairs[24];
+    for (int i = 0; i < 24; i++) {
+        snprintf(names[i], sizeof(names[i]), "PAIR%02dZUSD", i);
+        pairs[i] = names[i];
+    }
+
+    const HttpRequestBatch* batches = nullptr;
+    int num = http_request_batches(&set, pairs, 24, &batches);
+    TEST_ASSERT_TRUE(num >= 2 && num <= 3);
+
+    // Every pair covered once, in order, and each request fits
+    int next = 0;
+    for (int b = 0; b < num; b++) {
+        TEST_ASSERT_EQUAL(next, batches[b].first);
+        TEST_ASSERT_TRUE(batches[b].request.len > 0 && batches[b].request.len < HTTP_REQUEST_MAX);
+        TEST_ASSERT_NOT_NULL(strstr(batches[b].request.data, pairs[batches[b].first]));
+        next += batches[b].count;
+    }
+    TEST_ASSERT_EQUAL(24, next);
+
+    // More requests than allowed
+    http_request_batches_init(&set, &ep, &plain, 1);
+    TEST_ASSERT_EQUAL(0, http_request_batches(&set, pairs, 24, &batches));
+}
+
+int run_endpoint_tests() {
+    UNITY_BEGIN();
+
+    // Endpoint resolution
+    RUN_TEST(test_endpoint_https_default_port);
+    RUN_TEST(test_endpoint_http_explicit_port_and_url_path);
+    RUN_TEST(test_endpoint_websocket_schemes);
+    RUN_TEST(test_endpoint_rejects_malformed);
+
+    // Request rendering
+    RUN_TEST(test_render_with_argument);
+    RUN_TEST(test_render_non_default_port_in_host_header);
+    RUN_TEST(test_render_overflow_fails);
+
+    // Request cache
+    RUN_TEST(test_cache_renders_once_per_argument);
+    RUN_TEST(test_cache_replaces_when_full);
+    RUN_TEST(test_cache_rejects_bad_keys);
+
+    // Batched list requests
+    RUN_TEST(test_batches_format_and_reuse);
+    RUN_TEST(test_batches_split_long_list);
+
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    run_endpoint_tests();
+}
+
+void loop() {
+    // Tests run once in setup
+}
+#else
+int main() {
+    return run_endpoint_tests();
+}
+#endif
@@ -0,0 +1,270 @@
+/**
+ * @file test_exchange.cpp
+ * @brief Unit tests for the exchange adapter registry and quote planning (app_exchange)
+ *
+ * Tests cover:
+ * - Registry order, reset and capacity
+ * - One request per batch-capable venue regardless of the number of symbols
+ * - Per-market requests for other venues and for a single due symbol
+ * - Streamed and unlisted markets are not requested
+ * - Batch splitting at batch_max()
+ * - Two-phase begin/end and the quote scatter back to due symbols
+ */
+
+#include <unity.h>
+#include <app/app_exchange.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+
+// Venue mock: quotes every market at bid = 100 * (k + 1), ask = bid + 1
+class MockAdapter : public ExchangeAdapter {
+public:
+    MockAdapter(const char* name, QuoteVenue venue, uint8_t caps, bool coinbase_markets)
+        : _name(name), _venue(venue), _caps(caps), _coinbase_markets(coinbase_markets),
+          _batch_max(MAX_SYMBOLS), _streamed_mask(0), _num(0), _out(nullptr),
+          begin_calls(0), end_calls(0), last_batched(false) {}
+
+    const char* name() const { return _name; }
+    QuoteVenue venue() const { return _venue; }
+    uint8_t capabilities() const { return _caps; }
+    int batch_max() const { return _batch_max; }
+
+    const char* market(const SymbolConfig& sym) const {
+        return _coinbase_markets ? sym.coinbase_product : sym.binance_symbol;
+    }
+
+    bool streamed(int idx, uint32_t now_ms) const {
+        (void)now_ms;
+        return (_streamed_mask >> idx) & 1;
+    }
+
+    int begin_quotes(const char* const* markets, int n, bool batched, ExchangeQuote* out) {
+        begin_calls++;
+        last_batched = batched;
+        _num = n;
+        _out = out;
+        for (int k = 0; k < n; k++) {
+            last_markets[k] = markets[k];
+        }
+        if (!batched) {
+            return n;
+        }
+        return (n + _batch_max - 1) / _batch_max;
+    }
+
+    int end_quotes() {
+        end_calls++;
+        for (int k = 0; k < _num; k++) {
+            _out[k].bid = FIXED_UNITS(100 * (k + 1));
+            _out[k].ask = _out[k].bid + FIXED_UNITS(1);
+            _out[k].price = fixed_mid(_out[k].bid, _out[k].ask);
+            _out[k].valid = true;
+        }
+        return _num;
+    }
+
+    void set_batch_max(int n) { _batch_max = n; }
+    void set_streamed(uint32_t mask) { _streamed_mask = mask; }
+
+private:
+    const char* _name;
+    QuoteVenue _venue;
+    uint8_t _caps;
+    bool _coinbase_markets;
+    int _batch_max;
+    uint32_t _streamed_mask;
+    int _num;
+    ExchangeQuote* _out;
+
+public:
+    int begin_calls;
+    int end_calls;
+    bool last_batched;
+    const char* last_markets[MAX_SYMBOLS];
+};
+
+static const SymbolConfig SYMBOLS[] = {
+    { "BTC/USDT", "BTCUSDT", "BTC-USD", "XXBTZUSD", true },
+    { "ETH/USDT", "ETHUSDT", "ETH-USD", "XETHZUSD", true },
+    { "SOL/USDT", "SOLUSDT", "SOL-USD", "SOLUSD", true },
+    { "BNB/USDT", "BNBUSDT", "", "", true },        // Not on Coinbase
+    { "XRP/USDT", "XRPUSDT", nullptr, nullptr, true },
+};
+
+static const int ALL_DUE[] = { 0, 1, 2, 3, 4 };
+
+static ExchangePlan plan;
+
+void setUp() {
+    exchange_reset();
+    memset(&plan, 0, sizeof(plan));
+}
+
+void tearDown() {
+    exchange_reset();
+}
+
+void test_registry_order_and_capacity() {
+    MockAdapter a("a", VENUE_BINANCE, 0, false);
+    TEST_ASSERT_EQUAL(0, exchange_count());
+    TEST_ASSERT_NULL(exchange_get(0));
+    TEST_ASSERT_FALSE(exchange_register(nullptr));
+
+    for (int k = 0; k < EXCHANGE_MAX; k++) {
+        TEST_ASSERT_TRUE(exchange_register(&a));
+    }
+    TEST_ASSERT_FALSE(exchange_register(&a));
+    TEST_ASSERT_EQUAL(EXCHANGE_MAX, exchange_count());
+    TEST_ASSERT_TRUE(exchange_get(0) == &a);
+    TEST_ASSERT_NULL(exchange_get(EXCHANGE_MAX));
+    TEST_ASSERT_NULL(exchange_get(-1));
+
+    exchange_reset();
+    TEST_ASSERT_EQUAL(0, exchange_count());
+}
+
+void test_batch_venue_one_request_for_all_symbols() {
+    MockAdapter batch("batch", VENUE_BINANCE, EXCHANGE_CAP_BATCH_QUOTES | EXCHANGE_CAP_BOOK, false);
+    exchange_register(&batch);
+
+    TEST_ASSERT_EQUAL(1, exchange_plan_build(&plan, SYMBOLS, ALL_DUE, 5, 0));
+    TEST_ASSERT_EQUAL(1, plan.num_venues);
+    TEST_ASSERT_EQUAL(5, plan.venues[0].num);
+    TEST_ASSERT_TRUE(plan.venues[0].batched);
+
+    TEST_ASSERT_EQUAL(1, exchange_plan_build(&plan, SYMBOLS, ALL_DUE, 2, 0));
+    TEST_ASSERT_EQUAL(2, plan.venues[0].num);
+
+    // A single due market is requested on its own
+    TEST_ASSERT_EQUAL(1, exchange_plan_build(&plan, SYMBOLS, ALL_DUE, 1, 0));
+    TEST_ASSERT_FALSE(plan.venues[0].batched);
+}
+
+void test_per_market_venue_and_unlisted() {
+    MockAdapter batch("batch", VENUE_BINANCE, EXCHANGE_CAP_BATCH_QUOTES, false);
+    MockAdapter single("single", VENUE_COINBASE, EXCHANGE_CAP_BOOK, true);
+    exchange_register(&batch);
+    exchange_register(&single);
+
+    // 1 batched + 3 listed tickers (BNB and XRP have no Coinbase product)
+    TEST_ASSERT_EQUAL(4, exchange_plan_build(&plan, SYMBOLS, ALL_DUE, 5, 0));
+    TEST_ASSERT_EQUAL(3, plan.venues[1].num);
+    TEST_ASSERT_FALSE(plan.venues[1].batched);
+    TEST_ASSERT_EQUAL(EXCHANGE_SLOT_UNLISTED, plan.slot[3][1]);
+    TEST_ASSERT_EQUAL(EXCHANGE_SLOT_UNLISTED, plan.slot[4][1]);
+    TEST_ASSERT_NULL(exchange_plan_quote(&plan, 3, 1));
+}
+
+void test_streamed_markets_not_requested() {
+    MockAdapter streamed("streamed", VENUE_BINANCE,
+                         EXCHANGE_CAP_BATCH_QUOTES | EXCHANGE_CAP_STREAM, false);
+    MockAdapter no_cap("no_cap", VENUE_COINBASE, EXCHANGE_CAP_BOOK, true);
+    streamed.set_streamed(0x1F & ~0x04);        // All but SOL live
+    no_cap.set_streamed(0x1F);                  // Ignored without EXCHANGE_CAP_STREAM
+    exchange_register(&streamed);
+    exchange_register(&no_cap);
+
+    TEST_ASSERT_EQUAL(1 + 3, exchange_plan_build(&plan, SYMBOLS, ALL_DUE, 5, 0));
+    TEST_ASSERT_EQUAL(1, plan.venues[0].num);
+    TEST_ASSERT_EQUAL(4, plan.venues[0].streamed);
+    TEST_ASSERT_FALSE(plan.venues[0].batched);
+    TEST_ASSERT_EQUAL(EXCHANGE_SLOT_STREAMED, plan.slot[0][0]);
+    TEST_ASSERT_EQUAL(0, plan.slot[2][0]);
+    TEST_ASSERT_EQUAL(0, plan.venues[1].streamed);
+
+    // Fully streamed venue: nothing to request
+    streamed.set_streamed(0x1F);
+    exchange_plan_build(&plan, SYMBOLS, ALL_DUE, 5, 0);
+    TEST_ASSERT_EQUAL(0, plan.venues[0].requests);
+    exchange_plan_begin(&plan);
+    exchange_plan_end(&plan);
+    TEST_ASSERT_EQUAL(0, streamed.begin_calls);
+    TEST_ASSERT_EQUAL(0, streamed.end_calls);
+}
+
+void test_batch_max_splits_requests() {
+    MockAdapter batch("batch", VENUE_BINANCE, EXCHANGE_CAP_BATCH_QUOTES, false);
+    batch.set_batch_max(2);
+    exchange_register(&batch);
+
+    TEST_ASSERT_EQUAL(3, exchange_plan_build(&plan, SYMBOLS, ALL_DUE, 5, 0));
+    TEST_ASSERT_EQUAL(2, exchange_plan_build(&plan, SYMBOLS, ALL_DUE, 4, 0));
+}
+
+void test_begin_end_scatter_quotes() {
+    MockAdapter batch("batch", VENUE_BINANCE, EXCHANGE_CAP_BATCH_QUOTES | EXCHANGE_CAP_BOOK, false);
+    MockAdapter single("single", VENUE_COINBASE, EXCHANGE_CAP_BOOK, true);
+    exchange_register(&batch);
+    exchange_register(&single);
+
+    // Due: ETH, BNB, SOL (config order is not required)
+    const int due[] = { 1, 3, 2 };
+    exchange_plan_build(&plan, SYMBOLS, due, 3, 0);
+    TEST_ASSERT_EQUAL(1 + 2, exchange_plan_begin(&plan));
+    TEST_ASSERT_TRUE(batch.last_batched);
+    TEST_ASSERT_EQUAL_STRING("BNBUSDT", batch.last_markets[1]);
+    TEST_ASSERT_EQUAL_STRING("SOL-USD", single.last_markets[1]);
+
+    // Nothing is written before end_quotes()
+    TEST_ASSERT_FALSE(exchange_plan_quote(&plan, 0, 0)->valid);
+    TEST_ASSERT_EQUAL(3 + 2, exchange_plan_end(&plan));
+    TEST_ASSERT_EQUAL(1, batch.end_calls);
+    TEST_ASSERT_EQUAL(1, single.end_calls);
+
+    const ExchangeQuote* sol_batch = exchange_plan_quote(&plan, 2, 0);
+    const ExchangeQuote* sol_single = exchange_plan_quote(&plan, 2, 1);
+    TEST_ASSERT_NOT_NULL(sol_batch);
+    TEST_ASSERT_NOT_NULL(sol_single);
+    TEST_ASSERT_TRUE(sol_batch->bid == FIXED_UNITS(300));   // Third batched market
+    TEST_ASSERT_TRUE(sol_single->bid == FIXED_UNITS(200));  // Second ticker (BNB unlisted)
+    TEST_ASSERT_NULL(exchange_plan_quote(&plan, 1, 1));
+    TEST_ASSERT_NULL(exchange_plan_quote(&plan, 3, 0));
+}
+
+void test_plan_tracks_registry() {
+    MockAdapter batch("batch", VENUE_BINANCE, EXCHANGE_CAP_BATCH_QUOTES, false);
+    TEST_ASSERT_EQUAL(0, exchange_plan_build(&plan, SYMBOLS, ALL_DUE, 5, 0));
+    TEST_ASSERT_EQUAL(0, plan.num_venues);
+    TEST_ASSERT_EQUAL(5, plan.num_due);
+
+    exchange_register(&batch);
+    TEST_ASSERT_EQUAL(0, exchange_plan_build(&plan, SYMBOLS, ALL_DUE, 0, 0));
+    TEST_ASSERT_EQUAL(0, exchange_plan_begin(&plan));
+    TEST_ASSERT_EQUAL(0, batch.begin_calls);
+}
+
+int run_exchange_tests() {
+    UNITY_BEGIN();
+
+    // Registry
+    RUN_TEST(test_registry_order_and_capacity);
+    RUN_TEST(test_plan_tracks_registry);
+
+    // Planning
+    RUN_TEST(test_batch_venue_one_request_for_all_symbols);
+    RUN_TEST(test_per_market_venue_and_unlisted);
+    RUN_TEST(test_streamed_markets_not_requested);
+    RUN_TEST(test_batch_max_splits_requests);
+
+    // Execution
+    RUN_TEST(test_begin_end_scatter_quotes);
+
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    run_exchange_tests();
+}
+
+void loop() {
+    // Tests run once in setup
+}
+#else
+int main() {
+    return run_exchange_tests();
+}
+#endif
@@ -0,0 +1,235 @@
+/**
+ * @file test_fixed.cpp
+ * @brief Unit tests for the fixed-point price type (app_fixed)
+ *
+ * Tests cover:
+ * - Exact decimal parse, rounding past 8 decimals, rejected forms, range
+ * - Conversions to/from double
+ * - Mid, percentage and "%.*f"-style formatting
+ * - Fixed-point vs double cost of one price update (parse, mid, spread,
+ *   percentage, format), reported on the host and on the device
+ */
+
+#include <unity.h>
+#include <app/app_fixed.h>
+#include <app/app_math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+static bool parse(const char* s, Fixed* out) {
+    return fixed_parse(s, strlen(s), out);
+}
+
+void test_parse_exact() {
+    Fixed v = 0;
+    TEST_ASSERT_TRUE(parse("43250.50000000", &v));
+    TEST_ASSERT_TRUE(v == 4325050000000LL);
+    TEST_ASSERT_TRUE(parse("2245.3", &v));
+    TEST_ASSERT_TRUE(v == 224530000000LL);
+    TEST_ASSERT_TRUE(parse("-0.00012000", &v));
+    TEST_ASSERT_TRUE(v == -12000);
+    TEST_ASSERT_TRUE(parse("0.00000001", &v));
+    TEST_ASSERT_TRUE(v == 1);
+    TEST_ASSERT_TRUE(parse("7", &v));
+    TEST_ASSERT_TRUE(v == FIXED_UNITS(7));
+    TEST_ASSERT_TRUE(parse(".5", &v));
+    TEST_ASSERT_TRUE(v == FIXED_SCALE / 2);
+}
+
+void test_parse_rounds_extra_decimals() {
+    Fixed v = 0;
+    TEST_ASSERT_TRUE(parse("0.000000015", &v));
+    TEST_ASSERT_TRUE(v == 2);
+    TEST_ASSERT_TRUE(parse("0.0000000149", &v));
+    TEST_ASSERT_TRUE(v == 1);
+    TEST_ASSERT_TRUE(parse("-0.000000015", &v));
+    TEST_ASSERT_TRUE(v == -2);
+}
+
+void test_parse_rejects_other_forms() {
+    const char* values[] = {
+        "", "-", ".", "1e5", "1.2.3", "12a", " 1", "+1", "0x10", "92233720369"
+    };
+    for (size_t k = 0; k < sizeof(values) / sizeof(values[0]); k++) {
+        Fixed out;
+        TEST_ASSERT_FALSE_MESSAGE(parse(values[k], &out), values[k]);
+    }
+    Fixed v;
+    TEST_ASSERT_TRUE(parse("92233720368.54775807", &v));
+    TEST_ASSERT_TRUE(v == INT64_MAX);
+    TEST_ASSERT_FALSE(parse("92233720368.54775808", &v));
+}
+
+void test_from_string_falls_back_to_strtod() {
+    TEST_ASSERT_TRUE(fixed_from_string("43250.5") == 4325050000000LL);
+    TEST_ASSERT_TRUE(fixed_from_string("4.32505e4") == 4325050000000LL);
+    TEST_ASSERT_TRUE(fixed_from_string("abc") == 0);
+    TEST_ASSERT_TRUE(fixed_from_string(nullptr) == 0);
+}
+
+void test_double_conversions() {
+    TEST_ASSERT_TRUE(fixed_from_double(43250.5) == 4325050000000LL);
+    TEST_ASSERT_TRUE(fixed_from_double(-0.000025) == -2500);
+    TEST_ASSERT_TRUE(fixed_from_double(1e30) == INT64_MAX);
+    TEST_ASSERT_TRUE(fixed_to_double(4325050000000LL) == 43250.5);
+    TEST_ASSERT_TRUE(fixed_to_double(-12000) == -0.00012);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 43250.5f, fixed_to_float(4325050000000LL));
+}
+
+void test_mid_and_pct() {
+    TEST_ASSERT_TRUE(fixed_mid(FIXED_UNITS(100), FIXED_UNITS(102)) == FIXED_UNITS(101));
+    TEST_ASSERT_TRUE(fixed_mid(3, 4) == 4);         // 3.5 rounds away from zero
+    TEST_ASSERT_TRUE(fixed_mid(-3, -4) == -4);
+    TEST_ASSERT_TRUE(fixed_mid(-3, 4) == 1);        // 0.5
+    TEST_ASSERT_TRUE(fixed_mid(INT64_MAX, INT64_MAX) == INT64_MAX);
+
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.0f, fixed_pct(FIXED_UNITS(1), FIXED_UNITS(100)));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, -2.0f, fixed_pct(FIXED_UNITS(-2), FIXED_UNITS(100)));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, fixed_pct(FIXED_UNITS(1), 0));
+}
+
+void test_format() {
+    struct { const char* value; int decimals; const char* expected; } cases[] = {
+        { "43250.5", 2, "43250.50" },
+        { "43250.495", 2, "43250.50" },     // Half away from zero
+        { "43250.494", 2, "43250.49" },
+        { "43250.5", 0, "43251" },
+        { "0", 2, "0.00" },
+        { "-4.75", 2, "-4.75" },
+        { "-0.004", 2, "0.00" },            // No "-0.00"
+        { "0.00012", 4, "0.0001" },
+        { "-0.0025", 4, "-0.0025" },
+        { "104999.999", 2, "105000.00" },
+        { "0.00000001", 8, "0.00000001" },
+        { "92233720368.54775807", 2, "92233720368.55" },
+    };
+    for (size_t k = 0; k < sizeof(cases) / sizeof(cases[0]); k++) {
+        char out[32];
+        int n = fixed_format(fixed_from_string(cases[k].value), cases[k].decimals, out, sizeof(out));
+        TEST_ASSERT_EQUAL_STRING_MESSAGE(cases[k].expected, out, cases[k].value);
+        TEST_ASSERT_EQUAL((int)strlen(cases[k].expected), n);
+    }
+
+    char small[4];
+    TEST_ASSERT_EQUAL(0, fixed_format(FIXED_UNITS(1000), 2, small, sizeof(small)));
+    TEST_ASSERT_EQUAL_STRING("", small);
+}
+
+void test_fixed_spread_matches_double() {
+    Fixed abs_fixed;
+    float pct_fixed;
+    double abs_double, pct_double;
+    TEST_ASSERT_TRUE(calc_spread(fixed_from_string("43250.50"), fixed_from_string("43245.75"),
+                                 &abs_fixed, &pct_fixed));
+    TEST_ASSERT_TRUE(calc_spread(43250.50, 43245.75, &abs_double, &pct_double));
+    TEST_ASSERT_TRUE(abs_fixed == fixed_from_string("-4.75"));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, pct_double, pct_fixed);
+    TEST_ASSERT_FALSE(calc_spread((Fixed)0, FIXED_UNITS(1), &abs_fixed, &pct_fixed));
+}
+
+// Monotonic microseconds for the benchmark
+static double now_us() {
+#ifdef ARDUINO
+    return (double)micros();
+#else
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count() / 1000.0;
+#endif
+}
+
+static const char* BENCH_QUOTES[4] = { "43250.49000000", "43250.50000000", "43245.70", "43245.80" };
+
+// One price update with doubles: atof, mid, spread, percentage, "$%.2f"
+static int update_double(char* out, size_t cap) {
+    double b_bid = atof(BENCH_QUOTES[0]);
+    double b_ask = atof(BENCH_QUOTES[1]);
+    double c_bid = atof(BENCH_QUOTES[2]);
+    double c_ask = atof(BENCH_QUOTES[3]);
+    double abs_spread, pct;
+    calc_spread((b_bid + b_ask) / 2.0, (c_bid + c_ask) / 2.0, &abs_spread, &pct);
+    return snprintf(out, cap, "$%.2f", abs_spread);
+}
+
+// The same update in fixed point
+static int update_fixed(char* out, size_t cap) {
+    Fixed q[4];
+    for (int k = 0; k < 4; k++) {
+        fixed_parse(BENCH_QUOTES[k], strlen(BENCH_QUOTES[k]), &q[k]);
+    }
+    Fixed abs_spread;
+    float pct;
+    calc_spread(fixed_mid(q[0], q[1]), fixed_mid(q[2], q[3]), &abs_spread, &pct);
+    out[0] = '$';
+    return fixed_format(abs_spread, 2, out + 1, cap - 1) + 1;
+}
+
+void test_benchmark_fixed_vs_double() {
+#ifdef ARDUINO
+    const int ROUNDS = 2000;
+#else
+    const int ROUNDS = 200000;
+#endif
+    char buf[48];
+    volatile int sink = 0;
+
+    double t0 = now_us();
+    for (int n = 0; n < ROUNDS; n++) {
+        sink += update_double(buf, sizeof(buf));
+    }
+    double double_us = (now_us() - t0) / ROUNDS;
+
+    t0 = now_us();
+    for (int n = 0; n < ROUNDS; n++) {
+        sink += update_fixed(buf, sizeof(buf));
+    }
+    double fixed_us = (now_us() - t0) / ROUNDS;
+    TEST_ASSERT_EQUAL_STRING("$-4.75", buf);
+    (void)sink;
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "price update: double %.3f us, fixed %.3f us (%.1fx)",
+             double_us, fixed_us, fixed_us > 0 ? double_us / fixed_us : 0.0);
+    TEST_MESSAGE(msg);
+}
+
+int run_fixed_tests() {
+    UNITY_BEGIN();
+
+    // Parse and conversions
+    RUN_TEST(test_parse_exact);
+    RUN_TEST(test_parse_rounds_extra_decimals);
+    RUN_TEST(test_parse_rejects_other_forms);
+    RUN_TEST(test_from_string_falls_back_to_strtod);
+    RUN_TEST(test_double_conversions);
+
+    // Arithmetic and formatting
+    RUN_TEST(test_mid_and_pct);
+    RUN_TEST(test_format);
+    RUN_TEST(test_fixed_spread_matches_double);
+
+    // Cost
+    RUN_TEST(test_benchmark_fixed_vs_double);
+
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    run_fixed_tests();
+}
+
+void loop() {
+    // Tests run once in setup
+}
+#else
+int main() {
+    return run_fixed_tests();
+}
+#endif
@@ -0,0 +1,177 @@
+/**
+ * @file test_funding_schedule.cpp
+ * @brief Unit tests for funding-epoch aware scheduling (app_funding)
+ *
+ * Tests cover:
+ * - First fetch due immediately, interval mode
+ * - Epoch mode: due right after the epoch (+ settle delay)
+ * - Fallback to interval polling when the epoch is unknown / not rolled over
+ * - Predicted-rate polling between epochs
+ * - millis() wrap-around
+ * - Simulated day: request count vs interval mode and freshness after epochs
+ */
+
+#include <unity.h>
+#include <app/app_funding.h>
+#include <stdio.h>
+
+static const uint32_t MINUTE = 60UL * 1000;
+static const uint32_t HOUR = 60 * MINUTE;
+static const uint32_t INTERVAL = MINUTE;
+
+static uint32_t wait(const FundingSchedule* s, FundingScheduleMode mode, uint32_t predicted, uint32_t now) {
+    return funding_schedule_wait_ms(s, mode, INTERVAL, predicted, now);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_first_fetch_due_immediately() {
+    FundingSchedule s;
+    funding_schedule_reset(&s);
+    TEST_ASSERT_EQUAL(0, wait(&s, FUNDING_SCHEDULE_EPOCH, 0, 12345));
+    TEST_ASSERT_EQUAL(0, wait(&s, FUNDING_SCHEDULE_INTERVAL, 0, 12345));
+}
+
+void test_interval_mode() {
+    FundingSchedule s;
+    funding_schedule_reset(&s);
+    funding_schedule_on_fetch(&s, 1000, 2 * HOUR);
+    TEST_ASSERT_EQUAL(INTERVAL, wait(&s, FUNDING_SCHEDULE_INTERVAL, 0, 1000));
+    TEST_ASSERT_EQUAL(1, wait(&s, FUNDING_SCHEDULE_INTERVAL, 0, 1000 + INTERVAL - 1));
+    TEST_ASSERT_EQUAL(0, wait(&s, FUNDING_SCHEDULE_INTERVAL, 0, 1000 + INTERVAL));
+}
+
+void test_epoch_mode_waits_for_epoch() {
+    FundingSchedule s;
+    funding_schedule_reset(&s);
+    funding_schedule_on_fetch(&s, 1000, 2 * HOUR);
+    TEST_ASSERT_TRUE(s.epoch_known);
+    TEST_ASSERT_EQUAL(2 * HOUR + FUNDING_SETTLE_DELAY_MS, wait(&s, FUNDING_SCHEDULE_EPOCH, 0, 1000));
+    TEST_ASSERT_EQUAL(FUNDING_SETTLE_DELAY_MS, wait(&s, FUNDING_SCHEDULE_EPOCH, 0, 1000 + 2 * HOUR));
+    TEST_ASSERT_EQUAL(0, wait(&s, FUNDING_SCHEDULE_EPOCH, 0, 1000 + 2 * HOUR + FUNDING_SETTLE_DELAY_MS));
+    TEST_ASSERT_EQUAL(0, wait(&s, FUNDING_SCHEDULE_EPOCH, 0, 1000 + 3 * HOUR));
+}
+
+void test_unknown_epoch_falls_back_to_interval() {
+    FundingSchedule s;
+    funding_schedule_reset(&s);
+
+    // Not sent
+    funding_schedule_on_fetch(&s, 0, 0);
+    TEST_ASSERT_FALSE(s.epoch_known);
+    TEST_ASSERT_EQUAL(INTERVAL, wait(&s, FUNDING_SCHEDULE_EPOCH, 0, 0));
+
+    // Exchange has not rolled over to the next epoch yet
+    funding_schedule_on_fetch(&s, 0, -500);
+    TEST_ASSERT_EQUAL(INTERVAL, wait(&s, FUNDING_SCHEDULE_EPOCH, 0, 0));
+
+    // Implausibly far away
+    funding_schedule_on_fetch(&s, 0, (int64_t)FUNDING_EPOCH_MAX_MS + 1);
+    TEST_ASSERT_EQUAL(INTERVAL, wait(&s, FUNDING_SCHEDULE_EPOCH, 0, 0));
+}
+
+void test_predicted_polling_between_epochs() {
+    FundingSchedule s;
+    funding_schedule_reset(&s);
+    funding_schedule_on_fetch(&s, 0, 8 * HOUR);
+    TEST_ASSERT_EQUAL(30 * MINUTE, wait(&s, FUNDING_SCHEDULE_EPOCH, 30 * MINUTE, 0));
+
+    // Epoch comes before the next predicted poll
+    funding_schedule_on_fetch(&s, 0, 10 * MINUTE);
+    TEST_ASSERT_EQUAL(10 * MINUTE + FUNDING_SETTLE_DELAY_MS, wait(&s, FUNDING_SCHEDULE_EPOCH, 30 * MINUTE, 0));
+}
+
+void test_millis_wraparound() {
+    FundingSchedule s;
+    funding_schedule_reset(&s);
+    uint32_t now = 0xFFFFFFFFUL - HOUR;
+    funding_schedule_on_fetch(&s, now, 2 * HOUR);
+    TEST_ASSERT_EQUAL(HOUR + FUNDING_SETTLE_DELAY_MS, wait(&s, FUNDING_SCHEDULE_EPOCH, 0, now + HOUR));
+    TEST_ASSERT_EQUAL(0, wait(&s, FUNDING_SCHEDULE_EPOCH, 0, now + 2 * HOUR + FUNDING_SETTLE_DELAY_MS));
+}
+
+// Simulate one day with 8 h epochs; returns requests made.
+// max_lag_ms: longest delay between an epoch and the first fetch after it
+// (UINT32_MAX if the last epoch was never followed by a fetch).
+static int simulate_day(FundingScheduleMode mode, uint32_t predicted_ms, uint32_t* max_lag_ms) {
+    const uint64_t EPOCH = 8ULL * HOUR;
+    const uint64_t server_offset = 1700000000000ULL + 3 * HOUR + 17 * MINUTE;  // Exchange clock at millis() 0
+    const uint32_t STEP = 1000;                                                // net_task loop period
+
+    FundingSchedule s;
+    funding_schedule_reset(&s);
+    int requests = 0;
+    uint64_t pending_epoch = 0;  // Server time of an epoch not yet followed by a fetch
+    *max_lag_ms = 0;
+
+    for (uint32_t now = 0; now <= 24 * HOUR; now += STEP) {
+        uint64_t server_now = server_offset + now;
+        uint64_t next_epoch = (server_now / EPOCH + 1) * EPOCH;
+        if (server_now % EPOCH < STEP) {
+            pending_epoch = server_now - server_now % EPOCH;
+        }
+        if (funding_schedule_wait_ms(&s, mode, INTERVAL, predicted_ms, now) == 0) {
+            requests++;
+            funding_schedule_on_fetch(&s, now, (int64_t)(next_epoch - server_now));
+            if (pending_epoch) {
+                uint32_t lag = (uint32_t)(server_now - pending_epoch);
+                if (lag > *max_lag_ms) *max_lag_ms = lag;
+                pending_epoch = 0;
+            }
+        }
+    }
+    if (pending_epoch) {
+        *max_lag_ms = UINT32_MAX;
+    }
+    return requests;
+}
+
+void test_simulated_day_cuts_requests() {
+    uint32_t lag_interval = 0, lag_epoch = 0, lag_predicted = 0;
+    int interval = simulate_day(FUNDING_SCHEDULE_INTERVAL, 0, &lag_interval);
+    int epoch = simulate_day(FUNDING_SCHEDULE_EPOCH, 0, &lag_epoch);
+    int predicted = simulate_day(FUNDING_SCHEDULE_EPOCH, 30 * MINUTE, &lag_predicted);
+
+    // Every epoch is picked up within the settle delay (plus one loop period)
+    TEST_ASSERT_TRUE(lag_epoch <= FUNDING_SETTLE_DELAY_MS + 1000);
+    TEST_ASSERT_TRUE(lag_predicted <= FUNDING_SETTLE_DELAY_MS + 1000);
+
+    // Initial fetch + 3 epochs
+    TEST_ASSERT_EQUAL(4, epoch);
+    TEST_ASSERT_TRUE(epoch * 100 < interval * 5);
+    TEST_ASSERT_TRUE(predicted * 100 < interval * 5);
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "Funding requests/day: interval %d | epoch %d | epoch + predicted/30min %d",
+             interval, epoch, predicted);
+    TEST_MESSAGE(msg);
+}
+
+int run_funding_schedule_tests() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_first_fetch_due_immediately);
+    RUN_TEST(test_interval_mode);
+    RUN_TEST(test_epoch_mode_waits_for_epoch);
+    RUN_TEST(test_unknown_epoch_falls_back_to_interval);
+    RUN_TEST(test_predicted_polling_between_epochs);
+    RUN_TEST(test_millis_wraparound);
+    RUN_TEST(test_simulated_day_cuts_requests);
+
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    run_funding_schedule_tests();
+}
+
+void loop() {
+    // Tests run once in setup
+}
+#else
+int main() {
+    return run_funding_schedule_tests();
+}
+#endif
@@ -0,0 +1,347 @@
+/**
+ * @file test_net_async.cpp
+ * @brief Host tests for the concurrent non-blocking HTTP engine (net_async)
+ *
+ * Runs on Linux only (pio test -e native). A local plain-HTTP stand-in
+ * server answers each request after a latency taken from the path
+ * ("/delay/<ms>"), one thread per connection, so overlapping requests
+ * really overlap.
+ *
+ * Tests cover:
+ * - Requests in flight concurrently (wall time ~ slowest, not the sum)
+ * - More jobs than connections are queued and still overlap
+ * - Keep-alive reuse across runs
+ * - Timeout, connection refused, non-200 status
+ * - Retry when the server closed a kept-alive connection
+ * - Done callbacks
+ * - Price-cycle benchmark: sequential vs concurrent
+ */
+
+#include <unity.h>
+#include <net/net_async.h>
+#include <net/net_timing.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "../host_server.h"
+
+// ============================================================================
+// Stand-in server
+// ============================================================================
+
+// Request path handling:
+//   /delay/<ms>   200 after <ms>
+//   /status/<n>   status n, small body
+//   /hang         never answers
+//   /bye          200, then the server closes the (keep-alive) connection
+static void* serve_connection(void* arg) {
+    int fd = (int)(intptr_t)arg;
+    char buf[2048];
+    size_t have = 0;
+
+    while (true) {
+        ssize_t n = recv(fd, buf + have, sizeof(buf) - 1 - have, 0);
+        if (n <= 0) break;
+        have += n;
+        buf[have] = '\0';
+
+        char* end;
+        while ((end = strstr(buf, "\r\n\r\n")) != nullptr) {
+            char path[128] = "";
+            sscanf(buf, "GET %127s", path);
+
+            int status = 200;
+            bool close_after = false;
+            if (strncmp(path, "/delay/", 7) == 0) {
+                usleep(atoi(path + 7) * 1000);
+            } else if (strncmp(path, "/status/", 8) == 0) {
+                status = atoi(path + 8);
+            } else if (strcmp(path, "/hang") == 0) {
+                usleep(2000 * 1000);
+                close(fd);
+                return nullptr;
+            } else if (strcmp(path, "/bye") == 0) {
+                close_after = true;
+            }
+
+            char body[160];
+            int body_len = snprintf(body, sizeof(body), "{\"path\":\"%s\"}", path);
+            char resp[320];
+            int len = snprintf(resp, sizeof(resp),
+                               "HTTP/1.1 %d X\r\nContent-Type: application/json\r\n"
+                               "Content-Length: %d\r\n\r\n%s", status, body_len, body);
+            send(fd, resp, len, MSG_NOSIGNAL);
+
+            size_t consumed = (end + 4) - buf;
+            memmove(buf, end + 4, have - consumed + 1);
+            have -= consumed;
+
+            if (close_after) {
+                usleep(20 * 1000);
+                close(fd);
+                return nullptr;
+            }
+        }
+    }
+    close(fd);
+    return nullptr;
+}
+
+// Port with nothing listening
+static uint16_t closed_port() {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(fd, (sockaddr*)&addr, sizeof(addr));
+    socklen_t len = sizeof(addr);
+    getsockname(fd, (sockaddr*)&addr, &len);
+    close(fd);
+    return ntohs(addr.sin_port);
+}
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static HttpEndpoint g_endpoint;
+
+struct Fetch {
+    HttpRequest req;
+    HttpAsyncJob job;
+    HttpBufferSink sink;
+    char body[128];
+};
+
+static void submit(Fetch& f, const char* path, uint32_t timeout_ms = 2000,
+                   HttpAsyncDoneCallback done = nullptr, void* done_ctx = nullptr) {
+    // One endpoint per request, the path is the template itself (no argument)
+    static char paths[64][48];
+    static HttpEndpoint endpoints[64];
+    static int next = 0;
+    int slot = next++ % 64;
+    snprintf(paths[slot], sizeof(paths[slot]), "%s", path);
+    endpoints[slot] = g_endpoint;
+    endpoints[slot].path_template = paths[slot];
+
+    TEST_ASSERT_TRUE(http_request_render(&f.req, &endpoints[slot], nullptr));
+    f.sink = HttpBufferSink(f.body, sizeof(f.body));
+    TEST_ASSERT_TRUE(http_async_submit(&f.job, &f.req, timeout_ms, http_buffer_sink, &f.sink,
+                                       done, done_ctx));
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+void setUp() {
+    char base[48];
+    snprintf(base, sizeof(base), "http://127.0.0.1:%u", g_port);
+    http_endpoint_init(&g_endpoint, base, "/");
+    http_async_init(test_factory, test_clock);
+}
+
+void tearDown() {
+    http_async_close_all();
+}
+
+void test_requests_overlap() {
+    Fetch f[4];
+    for (int i = 0; i < 4; i++) submit(f[i], "/delay/200");
+
+    uint32_t t0 = test_clock();
+    TEST_ASSERT_EQUAL(0, http_async_run(5000));
+    uint32_t wall = test_clock() - t0;
+
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL(HTTP_ASYNC_OK, f[i].job.status);
+        TEST_ASSERT_EQUAL(200, f[i].job.status_code);
+        TEST_ASSERT_EQUAL_STRING("{\"path\":\"/delay/200\"}", f[i].body);
+    }
+    TEST_ASSERT_LESS_THAN(400, wall);  // Sequential would be >= 800
+    TEST_ASSERT_EQUAL(4, http_async_get_stats().max_in_flight);
+}
+
+void test_more_jobs_than_connections_are_queued() {
+    const int N = HTTP_ASYNC_MAX_CONNS * 2;
+    Fetch f[N];
+    for (int i = 0; i < N; i++) submit(f[i], "/delay/100");
+
+    uint32_t t0 = test_clock();
+    TEST_ASSERT_EQUAL(0, http_async_run(5000));
+    uint32_t wall = test_clock() - t0;
+
+    for (int i = 0; i < N; i++) {
+        TEST_ASSERT_EQUAL(HTTP_ASYNC_OK, f[i].job.status);
+    }
+    // Two waves of HTTP_ASYNC_MAX_CONNS, not N sequential requests
+    TEST_ASSERT_LESS_THAN(100 * N / 2, wall);
+    TEST_ASSERT_EQUAL(HTTP_ASYNC_MAX_CONNS, http_async_get_stats().max_in_flight);
+}
+
+void test_keep_alive_reuse_across_runs() {
+    Fetch f[3];
+    int accepts_before = g_accepts;
+    for (int i = 0; i < 3; i++) submit(f[i], "/delay/10");
+    TEST_ASSERT_EQUAL(0, http_async_run(2000));
+    for (int i = 0; i < 3; i++) submit(f[i], "/delay/10");
+    TEST_ASSERT_EQUAL(0, http_async_run(2000));
+
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL(HTTP_ASYNC_OK, f[i].job.status);
+    }
+    HttpAsyncStats stats = http_async_get_stats();
+    TEST_ASSERT_EQUAL(3, stats.connects);
+    TEST_ASSERT_EQUAL(3, stats.reused);
+    TEST_ASSERT_EQUAL(3, g_accepts - accepts_before);
+}
+
+void test_timeout() {
+    Fetch slow, fast;
+    submit(slow, "/hang", 150);
+    submit(fast, "/delay/10", 150);
+
+    TEST_ASSERT_EQUAL(0, http_async_run(2000));
+    TEST_ASSERT_EQUAL(HTTP_ASYNC_TIMEOUT, slow.job.status);
+    TEST_ASSERT_EQUAL(HTTP_ASYNC_OK, fast.job.status);
+    TEST_ASSERT_LESS_THAN(400, slow.job.elapsed_ms);
+    TEST_ASSERT_EQUAL(1, http_async_get_stats().timeouts);
+}
+
+void test_connect_refused() {
+    char base[48];
+    snprintf(base, sizeof(base), "http://127.0.0.1:%u", closed_port());
+    http_endpoint_init(&g_endpoint, base, "/");
+
+    Fetch f;
+    submit(f, "/delay/0");
+    TEST_ASSERT_EQUAL(0, http_async_run(2000));
+    TEST_ASSERT_EQUAL(HTTP_ASYNC_CONNECT_FAILED, f.job.status);
+}
+
+void test_non_200_keeps_connection() {
+    Fetch f;
+    submit(f, "/status/429");
+    TEST_ASSERT_EQUAL(0, http_async_run(2000));
+    TEST_ASSERT_EQUAL(HTTP_ASYNC_HTTP_ERROR, f.job.status);
+    TEST_ASSERT_EQUAL(429, f.job.status_code);
+    TEST_ASSERT_EQUAL(0, f.sink.len);  // Error bodies are not delivered
+
+    submit(f, "/delay/0");
+    TEST_ASSERT_EQUAL(0, http_async_run(2000));
+    TEST_ASSERT_EQUAL(HTTP_ASYNC_OK, f.job.status);
+    TEST_ASSERT_EQUAL(1, http_async_get_stats().reused);
+}
+
+void test_stale_keep_alive_is_retried() {
+    Fetch f;
+    submit(f, "/bye");
+    TEST_ASSERT_EQUAL(0, http_async_run(2000));
+    TEST_ASSERT_EQUAL(HTTP_ASYNC_OK, f.job.status);
+
+    usleep(100 * 1000);  // Server has closed the parked connection by now
+
+    submit(f, "/delay/0");
+    TEST_ASSERT_EQUAL(0, http_async_run(2000));
+    TEST_ASSERT_EQUAL(HTTP_ASYNC_OK, f.job.status);
+    TEST_ASSERT_EQUAL(1, http_async_get_stats().stale_retries);
+}
+
+static void count_done(HttpAsyncJob* job, void* ctx) {
+    (void)job;
+    (*(int*)ctx)++;
+}
+
+void test_done_callback_once_per_job() {
+    int done = 0;
+    Fetch f[3];
+    submit(f[0], "/delay/10", 2000, count_done, &done);
+    submit(f[1], "/status/404", 2000, count_done, &done);
+    submit(f[2], "/hang", 50, count_done, &done);
+
+    TEST_ASSERT_EQUAL(0, http_async_run(2000));
+    TEST_ASSERT_EQUAL(3, done);
+    TEST_ASSERT_TRUE(http_async_done(&f[0].job));
+    TEST_ASSERT_TRUE(http_async_done(&f[2].job));
+}
+
+// 10 symbols x 2 venues with 40-130 ms latency, like one price cycle
+void test_phase_timing_recorded() {
+    http_timing_reset();
+    Fetch f[2];
+    for (int i = 0; i < 2; i++) submit(f[i], "/delay/100");
+    TEST_ASSERT_EQUAL(0, http_async_run(2000));
+
+    HttpHostTiming t;
+    TEST_ASSERT_TRUE(http_timing_get(0, &t));
+    TEST_ASSERT_EQUAL_STRING("127.0.0.1", t.host);
+    TEST_ASSERT_EQUAL(2, t.phases[HTTP_PHASE_CONNECT].count);
+    TEST_ASSERT_EQUAL(0, t.phases[HTTP_PHASE_TLS].count);
+    TEST_ASSERT_EQUAL(2, t.phases[HTTP_PHASE_TTFB].count);
+    TEST_ASSERT_EQUAL(2, t.phases[HTTP_PHASE_BODY].count);
+    TEST_ASSERT_EQUAL(2, t.phases[HTTP_PHASE_TOTAL].count);
+    // The server delay shows up as time to first byte (50..100 ms bucket)
+    TEST_ASSERT_GREATER_OR_EQUAL(90, t.phases[HTTP_PHASE_TTFB].max_ms);
+    TEST_ASSERT_GREATER_OR_EQUAL(50, latency_hist_percentile(&t.phases[HTTP_PHASE_TTFB], 50));
+    TEST_ASSERT_LESS_THAN(50, t.phases[HTTP_PHASE_CONNECT].max_ms);
+}
+
+void test_benchmark_price_cycle() {
+    const int N = 20;
+    static Fetch f[N];
+    char path[32];
+    uint32_t latency_sum = 0;
+    uint32_t latency_max = 0;
+
+    // Sequential: one request at a time (old fetch_all_prices)
+    uint32_t t0 = test_clock();
+    for (int i = 0; i < N; i++) {
+        uint32_t latency = 40 + (i * 37) % 91;
+        latency_sum += latency;
+        if (latency > latency_max) latency_max = latency;
+        snprintf(path, sizeof(path), "/delay/%u", latency);
+        submit(f[i], path);
+        http_async_run(5000);
+    }
+    uint32_t sequential = test_clock() - t0;
+
+    // Concurrent: everything submitted up front
+    t0 = test_clock();
+    for (int i = 0; i < N; i++) {
+        snprintf(path, sizeof(path), "/delay/%u", 40 + (i * 37) % 91);
+        submit(f[i], path);
+    }
+    TEST_ASSERT_EQUAL(0, http_async_run(5000));
+    uint32_t concurrent = test_clock() - t0;
+
+    for (int i = 0; i < N; i++) {
+        TEST_ASSERT_EQUAL(HTTP_ASYNC_OK, f[i].job.status);
+    }
+
+    char msg[160];
+    snprintf(msg, sizeof(msg),
+             "%d requests: sequential %u ms (sum of latencies %u) | concurrent %u ms (slowest %u, %d conns)",
+             N, sequential, latency_sum, concurrent, latency_max, HTTP_ASYNC_MAX_CONNS);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_LESS_THAN(sequential / 2, concurrent);
+}
+
+int main() {
+    start_server();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_requests_overlap);
+    RUN_TEST(test_more_jobs_than_connections_are_queued);
+    RUN_TEST(test_keep_alive_reuse_across_runs);
+    RUN_TEST(test_timeout);
+    RUN_TEST(test_connect_refused);
+    RUN_TEST(test_non_200_keeps_connection);
+    RUN_TEST(test_stale_keep_alive_is_retried);
+    RUN_TEST(test_done_callback_once_per_job);
+    RUN_TEST(test_phase_timing_recorded);
+    RUN_TEST(test_benchmark_price_cycle);
+    return UNITY_END();
+}
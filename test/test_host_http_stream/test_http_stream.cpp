@@ -0,0 +1,189 @@
+/**
+ * @file test_http_stream.cpp
+ * @brief Host benchmark of the streaming response reader (net_http_stream,
+ *        http_read_response)
+ *
+ * Runs on Linux only (pio test -e native). Canned Binance/Coinbase
+ * responses are served from memory in TCP-segment sized pieces.
+ *
+ * Benchmark compares:
+ * - legacy: one read() per byte appended to a growing string (old http_get)
+ * - stream: bulk reads through a fixed scratch buffer into a fixed buffer
+ * and reports bytes/s and heap allocations per request. Framing and sink
+ * behaviour are unit tested in test_http_parser.
+ */
+
+#include <unity.h>
+#include <net/net_http_parser.h>
+#include <chrono>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <string.h>
+
+// ============================================================================
+// Allocation counting
+// ============================================================================
+
+static size_t g_allocs = 0;
+
+void* operator new(size_t size) {
+    g_allocs++;
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+// ============================================================================
+// Canned payloads
+// ============================================================================
+
+static const char* BINANCE_TICKER = "{\"symbol\":\"BTCUSDT\",\"price\":\"87478.90000000\"}";
+static const char* COINBASE_SPOT = "{\"data\":{\"amount\":\"87409.7\",\"base\":\"BTC\",\"currency\":\"USD\"}}";
+
+static std::string g_binance_batch;   // 10-symbol ticker/price array (~500 B)
+static std::string g_coinbase_rates;  // exchange-rates style object (~8 KB)
+
+static void build_payloads() {
+    static const char* syms[] = { "BTC", "ETH", "SOL", "XRP", "ADA", "DOGE", "MATIC", "DOT", "LINK", "AVAX" };
+    g_binance_batch = "[";
+    for (int i = 0; i < 10; i++) {
+        char item[80];
+        snprintf(item, sizeof(item), "%s{\"symbol\":\"%sUSDT\",\"price\":\"%d.12345678\"}",
+                 i ? "," : "", syms[i], 1000 + i * 37);
+        g_binance_batch += item;
+    }
+    g_binance_batch += "]";
+
+    g_coinbase_rates = "{\"data\":{\"currency\":\"USD\",\"rates\":{";
+    for (int i = 0; i < 400; i++) {
+        char item[48];
+        snprintf(item, sizeof(item), "%s\"A%03d\":\"0.%012d\"", i ? "," : "", i, i * 7919);
+        g_coinbase_rates += item;
+    }
+    g_coinbase_rates += "}}}";
+}
+
+// ============================================================================
+// In-memory byte source (serves data in segments, like a TCP stream)
+// ============================================================================
+
+class MemorySource : public HttpByteSource {
+public:
+    MemorySource(const char* d, size_t n, size_t seg, bool close_at_end)
+        : data(d), len(n), pos(0), segment(seg), close(close_at_end), clock(0), idles(0) {}
+
+    int read_some(uint8_t* buf, size_t want) {
+        if (pos >= len) return close ? -1 : 0;
+        size_t seg_left = segment - (pos % segment);
+        size_t n = want;
+        if (n > seg_left) n = seg_left;
+        if (n > len - pos) n = len - pos;
+        memcpy(buf, data + pos, n);
+        pos += n;
+        return (int)n;
+    }
+
+    void idle() { idles++; clock++; }
+    uint32_t now_ms() { return clock; }
+
+    const char* data;
+    size_t len;
+    size_t pos;
+    size_t segment;
+    bool close;
+    uint32_t clock;
+    int idles;
+};
+
+// Old http_get() body loop: one read per byte, appended to a growing string
+static bool legacy_read(HttpByteSource& src, long length, std::string& out) {
+    uint8_t c;
+    long remaining = length;
+    while (remaining > 0) {
+        int n = src.read_some(&c, 1);
+        if (n < 0) return false;
+        if (n == 0) { src.idle(); continue; }
+        out += (char)c;
+        remaining--;
+    }
+    return true;
+}
+
+// ============================================================================
+// Benchmark
+// ============================================================================
+
+static void bench_payload(const char* name, const char* payload, size_t len) {
+    const int iterations = 2000;
+    static char out[16384];
+    uint8_t scratch[HTTP_READ_CHUNK_SIZE];
+
+    // Same response for both readers: headers, then the payload
+    char head[96];
+    snprintf(head, sizeof(head), "HTTP/1.1 200 OK\r\nContent-Length: %u\r\n\r\n", (unsigned)len);
+    std::string response = std::string(head) + std::string(payload, len);
+    size_t response_len = response.size();
+
+    // Legacy: byte-wise into growing string
+    size_t allocs_before = g_allocs;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        MemorySource src(response.data(), response_len, 1460, false);
+        std::string body;
+        legacy_read(src, response_len, body);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double legacy_allocs = (double)(g_allocs - allocs_before) / iterations;
+
+    // Streaming: bulk reads into fixed buffer
+    allocs_before = g_allocs;
+    for (int i = 0; i < iterations; i++) {
+        MemorySource src(response.data(), response_len, 1460, false);
+        HttpResponseParser parser;
+        http_parser_init(&parser);
+        HttpBufferSink sink(out, sizeof(out));
+        http_read_response(src, &parser, http_buffer_sink, &sink, scratch, sizeof(scratch), 0, 1000);
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    double stream_allocs = (double)(g_allocs - allocs_before) / iterations;
+
+    double legacy_s = std::chrono::duration<double>(t1 - t0).count();
+    double stream_s = std::chrono::duration<double>(t2 - t1).count();
+    double total_bytes = (double)len * iterations;
+
+    char msg[200];
+    snprintf(msg, sizeof(msg),
+             "%-16s %6u B | legacy %8.1f MB/s %5.1f allocs/req | stream %8.1f MB/s %4.1f allocs/req",
+             name, (unsigned)len,
+             total_bytes / legacy_s / 1e6, legacy_allocs,
+             total_bytes / stream_s / 1e6, stream_allocs);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_EQUAL(0, (int)stream_allocs);
+    TEST_ASSERT_EQUAL_MEMORY(payload, out, len);
+}
+
+void test_benchmark_stream_vs_legacy() {
+    bench_payload("binance ticker", BINANCE_TICKER, strlen(BINANCE_TICKER));
+    bench_payload("coinbase spot", COINBASE_SPOT, strlen(COINBASE_SPOT));
+    bench_payload("binance batch", g_binance_batch.c_str(), g_binance_batch.size());
+    bench_payload("coinbase rates", g_coinbase_rates.c_str(), g_coinbase_rates.size());
+}
+
+int main() {
+    build_payloads();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_benchmark_stream_vs_legacy);
+    return UNITY_END();
+}
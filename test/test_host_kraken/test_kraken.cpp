@@ -0,0 +1,219 @@
+/**
+ * @file test_kraken.cpp
+ * @brief Kraken Ticker adapter: requests and golden-body parsing (net_kraken)
+ *
+ * Tests cover:
+ * - One pre-rendered request for every configured pair, re-rendered only
+ *   when the pair list changes, split only when it does not fit
+ * - Golden Ticker bodies (as returned by api.kraken.com) parsed whole,
+ *   byte by byte and in uneven chunks with identical results
+ * - Result keys matched in any order; unwanted pairs ignored
+ * - Last trade fallback, missing book, API errors, malformed and
+ *   truncated bodies
+ * - fetch_tickers() through a replayed recording
+ *
+ * Host-only: uses ReplayTransport.
+ */
+
+#include <unity.h>
+#include <net/net_kraken.h>
+#include <net/net_transport.h>
+#include <stdio.h>
+#include <string.h>
+
+// Golden body: GET /0/public/Ticker?pair=XXBTZUSD,XETHZUSD,SOLUSD
+// Result keys come back sorted by Kraken, not in request order
+static const char* GOLDEN_TICKER =
+    "{\"error\":[],\"result\":{"
+    "\"SOLUSD\":{\"a\":[\"98.43000\",\"112\",\"112.000\"],\"b\":[\"98.42000\",\"35\",\"35.000\"],"
+    "\"c\":[\"98.42000\",\"0.51000000\"],\"v\":[\"51093.39\",\"120733.56\"],"
+    "\"p\":[\"97.95\",\"98.10\"],\"t\":[3511,8930],\"l\":[\"96.71000\",\"96.71000\"],"
+    "\"h\":[\"99.12000\",\"99.50000\"],\"o\":\"97.60000\"},"
+    "\"XETHZUSD\":{\"a\":[\"2246.12000\",\"3\",\"3.000\"],\"b\":[\"2246.11000\",\"1\",\"1.000\"],"
+    "\"c\":[\"2246.11000\",\"0.02500000\"],\"v\":[\"8812.21\",\"20931.04\"],"
+    "\"p\":[\"2241.56\",\"2239.87\"],\"t\":[11023,25877],\"l\":[\"2221.50000\",\"2219.00000\"],"
+    "\"h\":[\"2260.00000\",\"2260.00000\"],\"o\":\"2230.15000\"},"
+    "\"XXBTZUSD\":{\"a\":[\"43250.60000\",\"1\",\"1.000\"],\"b\":[\"43250.50000\",\"2\",\"2.000\"],"
+    "\"c\":[\"43250.50000\",\"0.00100000\"],\"v\":[\"1532.22\",\"3790.11\"],"
+    "\"p\":[\"43180.22\",\"43102.75\"],\"t\":[20441,51002],\"l\":[\"42950.10000\",\"42800.00000\"],"
+    "\"h\":[\"43399.90000\",\"43399.90000\"],\"o\":\"43011.40000\"}}}";
+
+static const char* GOLDEN_UNKNOWN_PAIR = "{\"error\":[\"EQuery:Unknown asset pair\"]}";
+
+static const char* PAIRS[] = { "XXBTZUSD", "XETHZUSD", "SOLUSD" };
+
+static const char* TICKER_KEY = "api.kraken.com:443 /0/public/Ticker?pair=XXBTZUSD,XETHZUSD,SOLUSD";
+
+void setUp() {
+    net_kraken::init();
+}
+
+void tearDown() {
+    http_transport_set(nullptr);
+}
+
+static int parse_chunked(const char* body, size_t chunk, const char* const* pairs, int n,
+                         net_kraken::Ticker* out) {
+    net_kraken::TickerScan scan;
+    if (!net_kraken::ticker_begin(&scan, pairs, n, out)) {
+        return -1;
+    }
+    size_t len = strlen(body);
+    for (size_t pos = 0; pos < len; pos += chunk) {
+        size_t part = len - pos < chunk ? len - pos : chunk;
+        net_kraken::ticker_chunk((const uint8_t*)body + pos, part, &scan);
+    }
+    return net_kraken::ticker_finish(&scan);
+}
+
+void test_one_request_for_all_pairs() {
+    const net_kraken::TickerBatch* batches = nullptr;
+    TEST_ASSERT_EQUAL(1, net_kraken::ticker_requests(PAIRS, 3, &batches));
+    TEST_ASSERT_EQUAL(0, batches[0].first);
+    TEST_ASSERT_EQUAL(3, batches[0].count);
+    const char* line = "GET /0/public/Ticker?pair=XXBTZUSD,XETHZUSD,SOLUSD HTTP/1.1\r\n";
+    TEST_ASSERT_EQUAL(0, strncmp(batches[0].request.data, line, strlen(line)));
+    TEST_ASSERT_NOT_NULL(strstr(batches[0].request.data, "Host: api.kraken.com\r\n"));
+
+    // Same list: the rendered request is reused
+    const HttpRequest* first = &batches[0].request;
+    TEST_ASSERT_EQUAL(1, net_kraken::ticker_requests(PAIRS, 3, &batches));
+    TEST_ASSERT_TRUE(first == &batches[0].request);
+
+    // Every default symbol still fits in one request
+    const char* defaults[] = { "XXBTZUSD", "XETHZUSD", "SOLUSD", "XXRPZUSD", "ADAUSD",
+                               "XDGUSD", "MATICUSD", "DOTUSD", "LINKUSD", "AVAXUSD" };
+    TEST_ASSERT_EQUAL(1, net_kraken::ticker_requests(defaults, 10, &batches));
+    TEST_ASSERT_EQUAL(10, batches[0].count);
+}
+
+void test_long_list_is_split() {
+    const char* pairs[] = { "XXBTZUSDXXBTZUSD1", "XXBTZUSDXXBTZUSD2", "XXBTZUSDXXBTZUSD3",
+                            "XXBTZUSDXXBTZUSD4", "XXBTZUSDXXBTZUSD5", "XXBTZUSDXXBTZUSD6",
+                            "XXBTZUSDXXBTZUSD7", "XXBTZUSDXXBTZUSD8" };
+    const net_kraken::TickerBatch* batches = nullptr;
+    int num = net_kraken::ticker_requests(pairs, 8, &batches);
+    TEST_ASSERT_TRUE(num >= 2);
+    int covered = 0;
+    for (int b = 0; b < num; b++) {
+        TEST_ASSERT_EQUAL(covered, batches[b].first);
+        TEST_ASSERT_TRUE(batches[b].request.len > 0);
+        covered += batches[b].count;
+    }
+    TEST_ASSERT_EQUAL(8, covered);
+
+    const char* bad[] = { "XXBTZUSD", "" };
+    TEST_ASSERT_EQUAL(0, net_kraken::ticker_requests(bad, 2, &batches));
+}
+
+void test_golden_body_any_chunking() {
+    net_kraken::Ticker whole[3];
+    TEST_ASSERT_EQUAL(3, net_kraken::parse_ticker(GOLDEN_TICKER, strlen(GOLDEN_TICKER), PAIRS, 3, whole));
+    TEST_ASSERT_TRUE(whole[0].valid && whole[1].valid && whole[2].valid);
+    TEST_ASSERT_TRUE(whole[0].bid == fixed_from_string("43250.5"));
+    TEST_ASSERT_TRUE(whole[0].ask == fixed_from_string("43250.6"));
+    TEST_ASSERT_TRUE(whole[0].price == fixed_from_string("43250.5"));
+    TEST_ASSERT_TRUE(whole[1].bid == fixed_from_string("2246.11"));
+    TEST_ASSERT_TRUE(whole[1].ask == fixed_from_string("2246.12"));
+    TEST_ASSERT_TRUE(whole[2].bid == fixed_from_string("98.42"));
+    TEST_ASSERT_TRUE(whole[2].ask == fixed_from_string("98.43"));
+
+    const size_t chunks[] = { 1, 7, 64, 1460 };
+    for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++) {
+        net_kraken::Ticker out[3];
+        TEST_ASSERT_EQUAL(3, parse_chunked(GOLDEN_TICKER, chunks[c], PAIRS, 3, out));
+        for (int k = 0; k < 3; k++) {
+            TEST_ASSERT_TRUE(out[k].valid);
+            TEST_ASSERT_TRUE(out[k].bid == whole[k].bid);
+            TEST_ASSERT_TRUE(out[k].ask == whole[k].ask);
+            TEST_ASSERT_TRUE(out[k].price == whole[k].price);
+        }
+    }
+}
+
+void test_unwanted_and_missing_pairs() {
+    // ETH not wanted, DOT not in the body
+    const char* pairs[] = { "SOLUSD", "DOTUSD", "XXBTZUSD" };
+    net_kraken::Ticker out[3];
+    TEST_ASSERT_EQUAL(2, net_kraken::parse_ticker(GOLDEN_TICKER, strlen(GOLDEN_TICKER), pairs, 3, out));
+    TEST_ASSERT_TRUE(out[0].valid);
+    TEST_ASSERT_FALSE(out[1].valid);
+    TEST_ASSERT_TRUE(out[2].valid);
+    TEST_ASSERT_TRUE(out[2].bid == fixed_from_string("43250.5"));
+}
+
+void test_last_trade_and_book_fields() {
+    // No last trade: price falls back to the mid
+    const char* no_last = "{\"error\":[],\"result\":{\"SOLUSD\":{\"a\":[\"98.44000\",\"1\",\"1.000\"],"
+                          "\"b\":[\"98.42000\",\"1\",\"1.000\"]}}}";
+    net_kraken::Ticker out;
+    const char* sol[] = { "SOLUSD" };
+    TEST_ASSERT_EQUAL(1, net_kraken::parse_ticker(no_last, strlen(no_last), sol, 1, &out));
+    TEST_ASSERT_TRUE(out.price == fixed_from_string("98.43"));
+
+    // No bid: invalid
+    const char* no_bid = "{\"error\":[],\"result\":{\"SOLUSD\":{\"a\":[\"98.44000\",\"1\",\"1.000\"],"
+                         "\"c\":[\"98.42000\",\"0.1\"]}}}";
+    TEST_ASSERT_EQUAL(0, net_kraken::parse_ticker(no_bid, strlen(no_bid), sol, 1, &out));
+    TEST_ASSERT_FALSE(out.valid);
+
+    // Only the first element is the price; "o" and other arrays are ignored
+    const char* zero_ask = "{\"error\":[],\"result\":{\"SOLUSD\":{\"a\":[\"0\",\"98.44000\"],"
+                           "\"b\":[\"98.42000\",\"1\"],\"o\":\"1.0\",\"h\":[\"5.0\",\"5.0\"]}}}";
+    TEST_ASSERT_EQUAL(0, net_kraken::parse_ticker(zero_ask, strlen(zero_ask), sol, 1, &out));
+}
+
+void test_error_malformed_and_truncated() {
+    net_kraken::Ticker out[3];
+    TEST_ASSERT_EQUAL(0, net_kraken::parse_ticker(GOLDEN_UNKNOWN_PAIR, strlen(GOLDEN_UNKNOWN_PAIR),
+                                                  PAIRS, 3, out));
+    TEST_ASSERT_FALSE(out[0].valid);
+
+    // Cut mid-body: nothing is trusted, even pairs already complete
+    size_t half = strlen(GOLDEN_TICKER) * 3 / 4;
+    TEST_ASSERT_EQUAL(0, net_kraken::parse_ticker(GOLDEN_TICKER, half, PAIRS, 3, out));
+    TEST_ASSERT_FALSE(out[1].valid || out[2].valid);
+
+    const char* html = "<html><body>502 Bad Gateway</body></html>";
+    TEST_ASSERT_EQUAL(0, net_kraken::parse_ticker(html, strlen(html), PAIRS, 3, out));
+    TEST_ASSERT_EQUAL(0, net_kraken::parse_ticker(nullptr, 0, PAIRS, 3, out));
+}
+
+void test_fetch_through_replay() {
+    static char recording[4096];
+    size_t len = snprintf(recording, sizeof(recording), "REQ %s\nRES 1 %u\n%s\nREQ %s\nRES 0 0\n\n",
+                          TICKER_KEY, (unsigned)strlen(GOLDEN_TICKER), GOLDEN_TICKER, TICKER_KEY);
+    TEST_ASSERT_TRUE(len < sizeof(recording));
+    ReplayTransport replay;
+    TEST_ASSERT_TRUE(replay.load_buffer(recording, len));
+    http_transport_set(&replay);
+
+    net_kraken::Ticker out[3];
+    TEST_ASSERT_EQUAL(3, net_kraken::fetch_tickers(PAIRS, 3, out));
+    TEST_ASSERT_EQUAL(1, replay.served());
+    TEST_ASSERT_TRUE(out[2].ask == fixed_from_string("98.43"));
+
+    // Failed request: every pair invalid
+    TEST_ASSERT_EQUAL(0, net_kraken::fetch_tickers(PAIRS, 3, out));
+    TEST_ASSERT_FALSE(out[0].valid || out[1].valid || out[2].valid);
+    TEST_ASSERT_EQUAL(0, replay.misses());
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    // Requests
+    RUN_TEST(test_one_request_for_all_pairs);
+    RUN_TEST(test_long_list_is_split);
+
+    // Golden bodies
+    RUN_TEST(test_golden_body_any_chunking);
+    RUN_TEST(test_unwanted_and_missing_pairs);
+    RUN_TEST(test_last_trade_and_book_fields);
+    RUN_TEST(test_error_malformed_and_truncated);
+
+    // Transport
+    RUN_TEST(test_fetch_through_replay);
+
+    return UNITY_END();
+}
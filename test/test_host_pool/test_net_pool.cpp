@@ -0,0 +1,270 @@
+/**
+ * @file test_net_pool.cpp
+ * @brief Host tests for the keep-alive connection pool (net_pool)
+ *
+ * Runs on Linux only (pio test -e native). A local plain-HTTP stand-in
+ * server runs in a background thread; pooled connections are real TCP
+ * sockets, so reuse is verified by counting accepted connections.
+ *
+ * Tests cover:
+ * - Sequential requests reuse one connection
+ * - Idle eviction after HTTP_POOL_IDLE_TIMEOUT_MS
+ * - Reconnect when the server closed the parked connection
+ * - Non-reusable release closes the socket
+ * - Separate slots per host
+ */
+
+#include <unity.h>
+#include <net/net_pool.h>
+#include <netdb.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "../host_server.h"
+
+// ============================================================================
+// Stand-in server
+// ============================================================================
+
+static volatile bool g_close_after_response = false;
+
+static void* serve_connection(void* arg) {
+    int fd = (int)(intptr_t)arg;
+    char buf[1024];
+    size_t have = 0;
+
+    while (true) {
+        ssize_t n = recv(fd, buf + have, sizeof(buf) - 1 - have, 0);
+        if (n <= 0) break;
+        have += n;
+        buf[have] = '\0';
+
+        // Answer every complete request in the buffer
+        char* end;
+        while ((end = strstr(buf, "\r\n\r\n")) != nullptr) {
+            const char* resp = g_close_after_response
+                ? "HTTP/1.1 200 OK\r\nContent-Length: 2\r\nConnection: close\r\n\r\nok"
+                : "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok";
+            send(fd, resp, strlen(resp), 0);
+            size_t consumed = (end + 4) - buf;
+            memmove(buf, end + 4, have - consumed + 1);
+            have -= consumed;
+            if (g_close_after_response) {
+                close(fd);
+                return nullptr;
+            }
+        }
+    }
+    close(fd);
+    return nullptr;
+}
+
+// ============================================================================
+// POSIX pooled connection
+// ============================================================================
+
+class PosixConnection : public PooledConnection {
+public:
+    PosixConnection() : fd(-1) {}
+    ~PosixConnection() { close(); }
+
+    bool open(const char* host, uint16_t port, uint32_t timeout_ms) {
+        addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* res = nullptr;
+        char port_str[8];
+        snprintf(port_str, sizeof(port_str), "%u", port);
+        if (getaddrinfo(host, port_str, &hints, &res) != 0) return false;
+
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        bool ok = ::connect(fd, res->ai_addr, res->ai_addrlen) == 0;
+        freeaddrinfo(res);
+        if (!ok) close();
+        return ok;
+    }
+
+    bool is_open() {
+        if (fd < 0) return false;
+        char c;
+        ssize_t n = recv(fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+        return n != 0;  // 0 = orderly shutdown by peer
+    }
+
+    void close() {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+
+    // Minimal request/response over the pooled socket
+    bool get(const char* host) {
+        char req[128];
+        int len = snprintf(req, sizeof(req), "GET / HTTP/1.1\r\nHost: %s\r\n\r\n", host);
+        if (send(fd, req, len, MSG_NOSIGNAL) != len) return false;
+
+        char resp[256];
+        size_t have = 0;
+        while (have < sizeof(resp) - 1) {
+            ssize_t n = recv(fd, resp + have, sizeof(resp) - 1 - have, 0);
+            if (n <= 0) return false;
+            have += n;
+            resp[have] = '\0';
+            const char* body = strstr(resp, "\r\n\r\n");
+            if (body && strcmp(body + 4, "ok") == 0) return true;
+        }
+        return false;
+    }
+
+    int fd;
+};
+
+static PooledConnection* posix_factory(bool tls) {
+    (void)tls;
+    return new PosixConnection();
+}
+
+static PosixConnection* acquire(const char* host, uint32_t now_ms, bool* reused) {
+    return static_cast<PosixConnection*>(
+        http_pool_acquire(host, g_port, false, 1000, now_ms, reused));
+}
+
+static void wait_for_accepts(int expected) {
+    for (int i = 0; i < 200 && g_accepts < expected; i++) {
+        usleep(1000);
+    }
+}
+
+void setUp() {
+    g_close_after_response = false;
+    http_pool_init(posix_factory);
+    g_accepts = 0;
+}
+
+void tearDown() {
+    http_pool_init(posix_factory);  // Closes and frees all slots
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+// Two sequential requests share one TCP connection
+void test_pool_reuses_keep_alive_connection() {
+    bool reused = true;
+    PosixConnection* c = acquire("127.0.0.1", 0, &reused);
+    TEST_ASSERT_NOT_NULL(c);
+    TEST_ASSERT_FALSE(reused);
+    TEST_ASSERT_TRUE(c->get("127.0.0.1"));
+    http_pool_release(c, true, 10);
+
+    PosixConnection* c2 = acquire("127.0.0.1", 20, &reused);
+    TEST_ASSERT_TRUE(c2 == c);
+    TEST_ASSERT_TRUE(reused);
+    TEST_ASSERT_TRUE(c2->get("127.0.0.1"));
+    http_pool_release(c2, true, 30);
+
+    wait_for_accepts(1);
+    HttpPoolStats stats = http_pool_get_stats();
+    TEST_ASSERT_EQUAL(1, g_accepts);
+    TEST_ASSERT_EQUAL(2, stats.acquires);
+    TEST_ASSERT_EQUAL(1, stats.reused);
+    TEST_ASSERT_EQUAL(1, stats.handshakes);
+}
+
+// Connections idle past the timeout are closed and re-established
+void test_pool_evicts_idle_connection() {
+    bool reused;
+    PosixConnection* c = acquire("127.0.0.1", 0, &reused);
+    TEST_ASSERT_TRUE(c->get("127.0.0.1"));
+    http_pool_release(c, true, 0);
+
+    TEST_ASSERT_EQUAL(0, http_pool_evict_idle(HTTP_POOL_IDLE_TIMEOUT_MS));
+    TEST_ASSERT_EQUAL(1, http_pool_evict_idle(HTTP_POOL_IDLE_TIMEOUT_MS + 1));
+
+    c = acquire("127.0.0.1", HTTP_POOL_IDLE_TIMEOUT_MS + 2, &reused);
+    TEST_ASSERT_NOT_NULL(c);
+    TEST_ASSERT_FALSE(reused);
+    TEST_ASSERT_TRUE(c->get("127.0.0.1"));
+    http_pool_release(c, true, HTTP_POOL_IDLE_TIMEOUT_MS + 3);
+
+    wait_for_accepts(2);
+    HttpPoolStats stats = http_pool_get_stats();
+    TEST_ASSERT_EQUAL(2, g_accepts);
+    TEST_ASSERT_EQUAL(1, stats.idle_evictions);
+    TEST_ASSERT_EQUAL(2, stats.handshakes);
+}
+
+// A connection closed by the server while parked is replaced on acquire
+void test_pool_reconnects_after_server_close() {
+    g_close_after_response = true;
+
+    bool reused;
+    PosixConnection* c = acquire("127.0.0.1", 0, &reused);
+    TEST_ASSERT_TRUE(c->get("127.0.0.1"));
+    http_pool_release(c, true, 1);  // Caller ignored Connection: close
+    usleep(20000);                  // Let the FIN arrive
+
+    c = acquire("127.0.0.1", 2, &reused);
+    TEST_ASSERT_NOT_NULL(c);
+    TEST_ASSERT_FALSE(reused);
+    TEST_ASSERT_TRUE(c->get("127.0.0.1"));
+    http_pool_release(c, false, 3);
+
+    HttpPoolStats stats = http_pool_get_stats();
+    TEST_ASSERT_EQUAL(1, stats.dead_evictions);
+    TEST_ASSERT_EQUAL(2, stats.handshakes);
+    TEST_ASSERT_EQUAL(1, stats.discarded);
+}
+
+// Releasing without keep-alive closes the socket
+void test_pool_release_without_keep_alive_closes() {
+    bool reused;
+    PosixConnection* c = acquire("127.0.0.1", 0, &reused);
+    TEST_ASSERT_TRUE(c->get("127.0.0.1"));
+    http_pool_release(c, false, 1);
+    TEST_ASSERT_EQUAL(-1, c->fd);
+
+    c = acquire("127.0.0.1", 2, &reused);
+    TEST_ASSERT_FALSE(reused);
+    http_pool_release(c, true, 3);
+    TEST_ASSERT_EQUAL(2, http_pool_get_stats().handshakes);
+}
+
+// Different hosts get their own slots and both stay open
+void test_pool_separate_slots_per_host() {
+    bool reused;
+    PosixConnection* a = acquire("127.0.0.1", 0, &reused);
+    PosixConnection* b = acquire("localhost", 0, &reused);
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_TRUE(a != b);
+    http_pool_release(a, true, 1);
+    http_pool_release(b, true, 1);
+
+    TEST_ASSERT_TRUE(acquire("127.0.0.1", 2, &reused) == a);
+    TEST_ASSERT_TRUE(reused);
+    TEST_ASSERT_TRUE(acquire("localhost", 2, &reused) == b);
+    TEST_ASSERT_TRUE(reused);
+}
+
+// Connect failure is counted and returns nullptr
+void test_pool_connect_failure() {
+    bool reused;
+    PooledConnection* c = http_pool_acquire("127.0.0.1", 1, false, 100, 0, &reused);
+    TEST_ASSERT_NULL(c);
+    TEST_ASSERT_EQUAL(1, http_pool_get_stats().connect_failures);
+}
+
+int main() {
+    start_server();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_pool_reuses_keep_alive_connection);
+    RUN_TEST(test_pool_evicts_idle_connection);
+    RUN_TEST(test_pool_reconnects_after_server_close);
+    RUN_TEST(test_pool_release_without_keep_alive_closes);
+    RUN_TEST(test_pool_separate_slots_per_host);
+    RUN_TEST(test_pool_connect_failure);
+    return UNITY_END();
+}
@@ -0,0 +1,824 @@
+/**
+ * @file test_replay.cpp
+ * @brief Record/replay transport and the offline fetch -> parse -> model pipeline
+ *
+ * Tests cover:
+ * - Replay of recorded responses (order, failures, misses, looping)
+ * - Malformed record files
+ * - Record -> replay round trip through a file (also bodies of tens of KB)
+ * - Batched Binance ticker requests (single request, scatter, splitting)
+ * - Top of book: batched Binance bookTicker and Coinbase Exchange ticker
+ * - premiumIndex for every perpetual, filtered while streaming
+ * - Coinbase exchange rates for every asset, filtered while streaming
+ * - Document size and parse time of the adapters' filtered parses
+ * - In-place scan of fixed-shape bodies, ArduinoJson fallback and their cost
+ * - Binance/Coinbase adapters, spread calculation and model_update_symbol
+ *   driven entirely by a replayed recording, plus a throughput benchmark
+ *
+ * Host-only: record files live in /tmp.
+ */
+
+#include <unity.h>
+#include <net/net_transport.h>
+#include <net/net_binance.h>
+#include <net/net_coinbase.h>
+#include <app/app_config.h>
+#include <app/app_model.h>
+#include <app/app_math.h>
+#include <ArduinoJson.h>
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+static const char* RECORD_PATH = "/tmp/test_replay_record.txt";
+
+static const char* BTC_SPOT_KEY = "api.binance.com:443 /api/v3/ticker/price?symbol=BTCUSDT";
+static const char* ETH_SPOT_KEY = "api.binance.com:443 /api/v3/ticker/price?symbol=ETHUSDT";
+static const char* BTC_CB_KEY = "api.coinbase.com:443 /v2/prices/BTC-USD/spot";
+static const char* ETH_CB_KEY = "api.coinbase.com:443 /v2/prices/ETH-USD/spot";
+static const char* BATCH_SPOT_KEY =
+    "api.binance.com:443 /api/v3/ticker/price?symbols=%5B%22BTCUSDT%22,%22ETHUSDT%22,%22SOLUSDT%22%5D";
+static const char* BATCH_BOOK_KEY =
+    "api.binance.com:443 /api/v3/ticker/bookTicker?symbols=%5B%22BTCUSDT%22,%22ETHUSDT%22,%22SOLUSDT%22%5D";
+static const char* BTC_CB_TICKER_KEY = "api.exchange.coinbase.com:443 /products/BTC-USD/ticker";
+static const char* PREMIUM_INDEX_KEY = "fapi.binance.com:443 /fapi/v1/premiumIndex";
+static const char* CB_RATES_KEY = "api.coinbase.com:443 /v2/exchange-rates?currency=USD";
+static const char* BTC_FUNDING_KEY = "fapi.binance.com:443 /fapi/v1/fundingRate?symbol=BTCUSDT&limit=1";
+
+// Recording built in memory (same format RecordingTransport writes)
+static char g_recording[4096];
+static size_t g_recording_len = 0;
+
+static void record(const char* key, bool ok, const char* body) {
+    size_t len = ok ? strlen(body) : 0;
+    g_recording_len += snprintf(g_recording + g_recording_len, sizeof(g_recording) - g_recording_len,
+                                "REQ %s\nRES %d %u\n%s\n", key, ok ? 1 : 0, (unsigned)len, ok ? body : "");
+}
+
+static void build_recording() {
+    g_recording_len = 0;
+    record(BTC_SPOT_KEY, true, "{\"symbol\":\"BTCUSDT\",\"price\":\"43250.50000000\"}");
+    record(BTC_CB_KEY, true, "{\"data\":{\"base\":\"BTC\",\"currency\":\"USD\",\"amount\":\"43245.75\"}}");
+    record(ETH_SPOT_KEY, true, "{\"symbol\":\"ETHUSDT\",\"price\":\"2245.30000000\"}");
+    record(ETH_CB_KEY, true, "{\"data\":{\"base\":\"ETH\",\"currency\":\"USD\",\"amount\":\"2246.10\"}}");
+    // Second cycle: BTC moved, ETH Coinbase request failed
+    record(BTC_SPOT_KEY, true, "{\"symbol\":\"BTCUSDT\",\"price\":\"43300.00000000\"}");
+    record(ETH_CB_KEY, false, "");
+    record(BTC_FUNDING_KEY, true,
+           "[{\"symbol\":\"BTCUSDT\",\"fundingRate\":\"0.00010000\",\"fundingTime\":1609459200000}]");
+}
+
+static ReplayTransport* g_replay = nullptr;
+
+void setUp() {
+    build_recording();
+    g_replay = new ReplayTransport();
+    TEST_ASSERT_TRUE(g_replay->load_buffer(g_recording, g_recording_len));
+    http_transport_set(g_replay);
+    net_binance::init();
+    net_coinbase::init();
+}
+
+void tearDown() {
+    http_transport_set(nullptr);
+    delete g_replay;
+    g_replay = nullptr;
+}
+
+void test_replay_serves_in_recorded_order() {
+    TEST_ASSERT_EQUAL(7, g_replay->size());
+
+    Fixed price = 0;
+    TEST_ASSERT_TRUE(net_binance::fetch_spot("BTCUSDT", &price));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 43250.5, fixed_to_double(price));
+    TEST_ASSERT_TRUE(net_binance::fetch_spot("BTCUSDT", &price));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 43300.0, fixed_to_double(price));
+
+    // Exhausted: fails unless looping
+    TEST_ASSERT_FALSE(net_binance::fetch_spot("BTCUSDT", &price));
+    TEST_ASSERT_EQUAL(1, g_replay->misses());
+
+    g_replay->set_loop(true);
+    TEST_ASSERT_TRUE(net_binance::fetch_spot("BTCUSDT", &price));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 43250.5, fixed_to_double(price));
+}
+
+void test_replay_reproduces_failures() {
+    Fixed price = 0;
+    TEST_ASSERT_TRUE(net_coinbase::fetch_spot("ETH-USD", &price));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 2246.10, fixed_to_double(price));
+    TEST_ASSERT_FALSE(net_coinbase::fetch_spot("ETH-USD", &price));
+    TEST_ASSERT_EQUAL(0, g_replay->misses());
+
+    g_replay->rewind();
+    TEST_ASSERT_TRUE(net_coinbase::fetch_spot("ETH-USD", &price));
+}
+
+void test_replay_unknown_request_is_a_miss() {
+    Fixed price = 0;
+    TEST_ASSERT_FALSE(net_binance::fetch_spot("SOLUSDT", &price));
+    TEST_ASSERT_EQUAL(1, g_replay->misses());
+    TEST_ASSERT_EQUAL(0, g_replay->served());
+}
+
+void test_replay_rejects_malformed_file() {
+    ReplayTransport replay;
+    const char* truncated = "REQ api.binance.com:443 /x\nRES 1 50\n{\"short\":1}\n";
+    TEST_ASSERT_FALSE(replay.load_buffer(truncated, strlen(truncated)));
+    const char* garbage = "hello\n";
+    TEST_ASSERT_FALSE(replay.load_buffer(garbage, strlen(garbage)));
+    TEST_ASSERT_TRUE(replay.load_buffer("", 0));
+    TEST_ASSERT_EQUAL(0, replay.size());
+}
+
+void test_record_then_replay_round_trip() {
+    remove(RECORD_PATH);
+    {
+        // The replayed recording stands in for the network
+        RecordingTransport recorder(g_replay, RECORD_PATH);
+        TEST_ASSERT_TRUE(recorder.is_open());
+        http_transport_set(&recorder);
+
+        Fixed price = 0, rate = 0;
+        TEST_ASSERT_TRUE(net_binance::fetch_spot("ETHUSDT", &price));
+        TEST_ASSERT_FALSE(net_binance::fetch_spot("ETHUSDT", &price));  // Not recorded twice
+        TEST_ASSERT_TRUE(net_binance::fetch_funding("BTCUSDT", &rate));
+        TEST_ASSERT_EQUAL(3, recorder.recorded());
+        http_transport_set(g_replay);
+    }
+
+    ReplayTransport replay;
+    TEST_ASSERT_TRUE(replay.load(RECORD_PATH));
+    TEST_ASSERT_EQUAL(3, replay.size());
+    http_transport_set(&replay);
+
+    Fixed price = 0, rate = 0;
+    TEST_ASSERT_TRUE(net_binance::fetch_spot("ETHUSDT", &price));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 2245.3, fixed_to_double(price));
+    TEST_ASSERT_FALSE(net_binance::fetch_spot("ETHUSDT", &price));
+    TEST_ASSERT_TRUE(net_binance::fetch_funding("BTCUSDT", &rate));
+    TEST_ASSERT_FLOAT_WITHIN(1e-7, 0.0001, fixed_to_double(rate));
+    http_transport_set(g_replay);
+    remove(RECORD_PATH);
+}
+
+void test_batch_fetches_all_symbols_in_one_request() {
+    ReplayTransport replay;
+    g_recording_len = 0;
+    // Response order differs from request order
+    record(BATCH_SPOT_KEY, true,
+           "[{\"symbol\":\"SOLUSDT\",\"price\":\"98.12000000\"},"
+           "{\"symbol\":\"BTCUSDT\",\"price\":\"43250.50000000\"},"
+           "{\"symbol\":\"ETHUSDT\",\"price\":\"2245.30000000\"}]");
+    TEST_ASSERT_TRUE(replay.load_buffer(g_recording, g_recording_len));
+    http_transport_set(&replay);
+
+    const char* symbols[] = { "BTCUSDT", "ETHUSDT", "SOLUSDT" };
+    Fixed prices[3] = { 0 };
+    bool ok[3] = { false };
+    TEST_ASSERT_EQUAL(3, net_binance::fetch_spot_batch(symbols, 3, prices, ok));
+    TEST_ASSERT_EQUAL(1, replay.served());
+    TEST_ASSERT_EQUAL(0, replay.misses());
+    TEST_ASSERT_TRUE(ok[0] && ok[1] && ok[2]);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 43250.5, fixed_to_double(prices[0]));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 2245.3, fixed_to_double(prices[1]));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 98.12, fixed_to_double(prices[2]));
+
+    // Failed request: every symbol invalid
+    TEST_ASSERT_EQUAL(0, net_binance::fetch_spot_batch(symbols, 3, prices, ok));
+    TEST_ASSERT_FALSE(ok[0] || ok[1] || ok[2]);
+    http_transport_set(g_replay);
+}
+
+void test_batch_parse_scatters_partial_response() {
+    const char* symbols[] = { "BTCUSDT", "ETHUSDT", "SOLUSDT" };
+    Fixed prices[3] = { 0 };
+    bool ok[3] = { true, true, true };
+
+    // ETH missing, SOL price invalid, unknown symbol ignored
+    char body[] = "[{\"symbol\":\"XRPUSDT\",\"price\":\"0.55\"},"
+                  "{\"symbol\":\"SOLUSDT\",\"price\":\"0\"},"
+                  "{\"symbol\":\"BTCUSDT\",\"price\":\"43250.5\"}]";
+    TEST_ASSERT_EQUAL(1, net_binance::parse_spot_batch(body, strlen(body), symbols, 3, prices, ok));
+    TEST_ASSERT_TRUE(ok[0]);
+    TEST_ASSERT_FALSE(ok[1]);
+    TEST_ASSERT_FALSE(ok[2]);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 43250.5, fixed_to_double(prices[0]));
+
+    // Error object instead of an array
+    char error[] = "{\"code\":-1121,\"msg\":\"Invalid symbol.\"}";
+    TEST_ASSERT_EQUAL(0, net_binance::parse_spot_batch(error, strlen(error), symbols, 3, prices, ok));
+    TEST_ASSERT_FALSE(ok[0]);
+}
+
+void test_batch_requests_split_and_reused() {
+    const char* symbols[] = { "BTCUSDT", "ETHUSDT", "SOLUSDT", "XRPUSDT", "ADAUSDT",
+                              "DOGEUSDT", "MATICUSDT", "DOTUSDT", "LINKUSDT", "AVAXUSDT" };
+    const net_binance::SpotBatch* batches = nullptr;
+
+    // Default three symbols: one request
+    TEST_ASSERT_EQUAL(1, net_binance::spot_batch_requests(symbols, 3, &batches));
+    char key[HTTP_RECORD_KEY_MAX];
+    TEST_ASSERT_TRUE(http_record_key(&batches[0].request, key, sizeof(key)));
+    TEST_ASSERT_EQUAL_STRING(BATCH_SPOT_KEY, key);
+    const net_binance::SpotBatch* again = nullptr;
+    TEST_ASSERT_EQUAL(1, net_binance::spot_batch_requests(symbols, 3, &again));
+    TEST_ASSERT_EQUAL_PTR(batches, again);
+
+    // All ten: split into requests that each fit, covering every symbol in order
+    int n = net_binance::spot_batch_requests(symbols, 10, &batches);
+    TEST_ASSERT_TRUE(n >= 2 && n <= net_binance::SPOT_BATCH_MAX_REQUESTS);
+    int next = 0;
+    for (int b = 0; b < n; b++) {
+        TEST_ASSERT_EQUAL(next, batches[b].first);
+        TEST_ASSERT_TRUE(batches[b].count > 0);
+        TEST_ASSERT_TRUE(batches[b].request.len > 0 && batches[b].request.len < HTTP_REQUEST_MAX);
+        TEST_ASSERT_NOT_NULL(strstr(batches[b].request.data, symbols[next]));
+        next += batches[b].count;
+    }
+    TEST_ASSERT_EQUAL(10, next);
+
+    // Invalid symbol
+    const char* bad[] = { "BTCUSDT", "" };
+    TEST_ASSERT_EQUAL(0, net_binance::spot_batch_requests(bad, 2, &batches));
+}
+
+void test_book_batch_fetches_bid_ask_in_one_request() {
+    ReplayTransport replay;
+    g_recording_len = 0;
+    record(BATCH_BOOK_KEY, true,
+           "[{\"symbol\":\"ETHUSDT\",\"bidPrice\":\"2245.29000000\",\"bidQty\":\"12.5\","
+           "\"askPrice\":\"2245.30000000\",\"askQty\":\"3.1\"},"
+           "{\"symbol\":\"BTCUSDT\",\"bidPrice\":\"43250.49000000\",\"bidQty\":\"1.2\","
+           "\"askPrice\":\"43250.50000000\",\"askQty\":\"0.8\"},"
+           "{\"symbol\":\"SOLUSDT\",\"bidPrice\":\"0.00000000\",\"bidQty\":\"0\","
+           "\"askPrice\":\"98.12000000\",\"askQty\":\"40\"}]");
+    TEST_ASSERT_TRUE(replay.load_buffer(g_recording, g_recording_len));
+    http_transport_set(&replay);
+
+    // Same request budget as the price batch: one request
+    const char* symbols[] = { "BTCUSDT", "ETHUSDT", "SOLUSDT" };
+    net_binance::BookTicker books[3];
+    TEST_ASSERT_EQUAL(2, net_binance::fetch_book_batch(symbols, 3, books));
+    TEST_ASSERT_EQUAL(1, replay.served());
+    TEST_ASSERT_EQUAL(0, replay.misses());
+    TEST_ASSERT_TRUE(books[0].valid && books[1].valid);
+    TEST_ASSERT_FALSE(books[2].valid);  // Empty bid side
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 43250.49, fixed_to_double(books[0].bid));
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 43250.50, fixed_to_double(books[0].ask));
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 2245.29, fixed_to_double(books[1].bid));
+
+    // Single symbol form
+    char one[] = "{\"symbol\":\"BTCUSDT\",\"bidPrice\":\"43250.49\",\"bidQty\":\"1\","
+                 "\"askPrice\":\"43250.50\",\"askQty\":\"1\"}";
+    net_binance::BookTicker book;
+    TEST_ASSERT_TRUE(net_binance::parse_book(one, strlen(one), "BTCUSDT", &book));
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 43250.50, fixed_to_double(book.ask));
+    char other[] = "{\"symbol\":\"ETHUSDT\",\"bidPrice\":\"1\",\"askPrice\":\"2\"}";
+    TEST_ASSERT_FALSE(net_binance::parse_book(other, strlen(other), "BTCUSDT", &book));
+    http_transport_set(g_replay);
+}
+
+void test_coinbase_ticker_bid_ask() {
+    ReplayTransport replay;
+    g_recording_len = 0;
+    record(BTC_CB_TICKER_KEY, true,
+           "{\"ask\":\"43245.80\",\"bid\":\"43245.70\",\"volume\":\"8311.53046208\","
+           "\"trade_id\":612345678,\"price\":\"43245.75\",\"size\":\"0.00120000\","
+           "\"time\":\"2024-01-15T12:00:00.123456Z\"}");
+    TEST_ASSERT_TRUE(replay.load_buffer(g_recording, g_recording_len));
+    http_transport_set(&replay);
+
+    net_coinbase::Ticker ticker;
+    TEST_ASSERT_TRUE(net_coinbase::fetch_ticker("BTC-USD", &ticker));
+    TEST_ASSERT_EQUAL(0, replay.misses());
+    TEST_ASSERT_TRUE(ticker.valid);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 43245.70, fixed_to_double(ticker.bid));
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 43245.80, fixed_to_double(ticker.ask));
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 43245.75, fixed_to_double(ticker.price));
+
+    // Executable spread against the Binance book above: buy Coinbase at the ask, sell Binance at the bid
+    SymbolState s;
+    s.binance_quote.bid = fixed_from_string("43250.49");
+    s.binance_quote.ask = fixed_from_string("43250.50");
+    s.binance_quote.price = fixed_mid(s.binance_quote.bid, s.binance_quote.ask);
+    s.binance_quote.valid = true;
+    s.coinbase_quote.bid = ticker.bid;
+    s.coinbase_quote.ask = ticker.ask;
+    s.coinbase_quote.price = ticker.price;
+    s.coinbase_quote.valid = true;
+    symbol_update_spreads(s, VENUE_COINBASE);
+    TEST_ASSERT_TRUE(s.exec_spread_valid);
+    TEST_ASSERT_EQUAL(SPREAD_BUY_COINBASE, s.exec_direction);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 4.69, fixed_to_double(s.exec_spread_abs));
+
+    // Error body
+    char error[] = "{\"message\":\"NotFound\"}";
+    TEST_ASSERT_FALSE(net_coinbase::parse_ticker(error, strlen(error), "BTC-USD", &ticker));
+    TEST_ASSERT_FALSE(ticker.valid);
+    http_transport_set(g_replay);
+}
+
+// premiumIndex body listing `filler` other perpetuals around BTC and ETH
+static size_t build_premium_index(char* out, size_t cap, int filler) {
+    size_t len = snprintf(out, cap, "[");
+    for (int i = 0; i < filler; i++) {
+        len += snprintf(out + len, cap - len,
+                        "{\"symbol\":\"COIN%dUSDT\",\"markPrice\":\"%d.5\",\"indexPrice\":\"%d.4\","
+                        "\"estimatedSettlePrice\":\"%d.45\",\"lastFundingRate\":\"0.00010000\","
+                        "\"interestRate\":\"0.00010000\",\"nextFundingTime\":1700006400000,"
+                        "\"time\":1700000000000},", i, i + 1, i + 1, i + 1);
+        if (i == filler / 2) {
+            len += snprintf(out + len, cap - len,
+                            "{\"symbol\":\"ETHUSDT\",\"markPrice\":\"2246.01\",\"indexPrice\":\"2245.80\","
+                            "\"lastFundingRate\":\"-0.00002500\",\"nextFundingTime\":1700006400000},");
+        }
+    }
+    len += snprintf(out + len, cap - len,
+                    "{\"time\":1700000000000,\"nextFundingTime\":1700006400000,\"lastFundingRate\":\"0.00012000\","
+                    "\"indexPrice\":\"43255.40\",\"markPrice\":\"43260.10\",\"symbol\":\"BTCUSDT\"}]");
+    return len;
+}
+
+void test_premium_index_filters_while_streaming() {
+    // ~50 KB: far larger than any body buffer, arrives in many chunks
+    static char body[64 * 1024];
+    size_t body_len = build_premium_index(body, sizeof(body), 200);
+    TEST_ASSERT_TRUE(body_len > 40000 && body_len < sizeof(body) - 1);
+
+    static char recording[sizeof(body) + 256];
+    size_t rec_len = snprintf(recording, sizeof(recording), "REQ %s\nRES 1 %u\n%s\n",
+                              PREMIUM_INDEX_KEY, (unsigned)body_len, body);
+    ReplayTransport replay;
+    TEST_ASSERT_TRUE(replay.load_buffer(recording, rec_len));
+    http_transport_set(&replay);
+
+    const char* symbols[] = { "BTCUSDT", "ETHUSDT", "SOLUSDT" };
+    net_binance::PremiumIndex out[3];
+    TEST_ASSERT_EQUAL(2, net_binance::fetch_premium_index(symbols, 3, out));
+    TEST_ASSERT_EQUAL(1, replay.served());
+
+    // Field order within an entry does not matter
+    TEST_ASSERT_TRUE(out[0].valid);
+    TEST_ASSERT_FLOAT_WITHIN(1e-7, 0.00012, fixed_to_double(out[0].funding_rate));
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 43260.10, fixed_to_double(out[0].mark_price));
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 43255.40, fixed_to_double(out[0].index_price));
+    TEST_ASSERT_TRUE(out[0].next_funding_ms == 1700006400000ULL);
+
+    TEST_ASSERT_TRUE(out[1].valid);
+    TEST_ASSERT_FLOAT_WITHIN(1e-8, -0.000025, fixed_to_double(out[1].funding_rate));
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 2246.01, fixed_to_double(out[1].mark_price));
+
+    // Not listed
+    TEST_ASSERT_FALSE(out[2].valid);
+    http_transport_set(g_replay);
+}
+
+void test_premium_index_rejects_truncated_body() {
+    char body[2048];
+    size_t body_len = build_premium_index(body, sizeof(body), 3);
+    body_len -= 20;  // Cut off inside the BTC entry
+
+    char recording[sizeof(body) + 256];
+    size_t rec_len = snprintf(recording, sizeof(recording), "REQ %s\nRES 1 %u\n%.*s\n",
+                              PREMIUM_INDEX_KEY, (unsigned)body_len, (int)body_len, body);
+    ReplayTransport replay;
+    TEST_ASSERT_TRUE(replay.load_buffer(recording, rec_len));
+    http_transport_set(&replay);
+
+    const char* symbols[] = { "BTCUSDT", "ETHUSDT" };
+    net_binance::PremiumIndex out[2];
+    TEST_ASSERT_EQUAL(0, net_binance::fetch_premium_index(symbols, 2, out));
+    TEST_ASSERT_FALSE(out[0].valid);
+    TEST_ASSERT_FALSE(out[1].valid);
+    http_transport_set(g_replay);
+}
+
+// One price cycle for symbol i, as the scheduler does it
+static bool run_price_cycle(int i) {
+    const SymbolConfig* sym = config_get_symbol(i);
+    Fixed b = 0, c = 0;
+    bool b_ok = net_binance::fetch_spot(sym->binance_symbol, &b);
+    bool c_ok = net_coinbase::fetch_spot(sym->coinbase_product, &c);
+
+    SymbolState state;
+    model_get_symbol(i, &state);
+    state.binance_quote.price = b;
+    state.binance_quote.valid = b_ok;
+    state.coinbase_quote.price = c;
+    state.coinbase_quote.valid = c_ok;
+    state.spread_valid = b_ok && c_ok && calc_spread(b, c, &state.spread_abs, &state.spread_pct);
+    model_update_symbol(i, state);
+    return b_ok && c_ok;
+}
+
+void test_pipeline_updates_model() {
+    config_init();
+    model_init();
+
+    TEST_ASSERT_TRUE(run_price_cycle(0));  // BTC
+    TEST_ASSERT_TRUE(run_price_cycle(1));  // ETH
+
+    AppState s = model_snapshot();
+    TEST_ASSERT_EQUAL_STRING("BTC/USDT", s.symbols[0].symbol_name);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 43250.5, fixed_to_double(s.symbols[0].binance_quote.price));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 43245.75, fixed_to_double(s.symbols[0].coinbase_quote.price));
+    TEST_ASSERT_TRUE(s.symbols[0].spread_valid);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, -4.75, fixed_to_double(s.symbols[0].spread_abs));
+    TEST_ASSERT_EQUAL(1, s.symbols[0].history_count);
+    TEST_ASSERT_TRUE(s.symbols[1].spread_valid);
+
+    // Second cycle: Coinbase ETH failure invalidates only the ETH spread
+    TEST_ASSERT_FALSE(run_price_cycle(1));
+    s = model_snapshot();
+    TEST_ASSERT_FALSE(s.symbols[1].spread_valid);
+    TEST_ASSERT_TRUE(s.symbols[0].spread_valid);
+}
+
+void test_benchmark_replayed_pipeline() {
+    config_init();
+    model_init();
+    g_replay->set_loop(true);
+
+    const int CYCLES = 20000;
+    using namespace std::chrono;
+    steady_clock::time_point t0 = steady_clock::now();
+    int ok = 0;
+    for (int n = 0; n < CYCLES; n++) {
+        if (run_price_cycle(0)) ok++;
+    }
+    double us = duration_cast<microseconds>(steady_clock::now() - t0).count();
+
+    TEST_ASSERT_EQUAL(CYCLES, ok);
+    char msg[96];
+    snprintf(msg, sizeof(msg), "%d BTC price cycles: %.2f us/cycle (fetch x2, parse x2, spread, model)",
+             CYCLES, us / CYCLES);
+    TEST_MESSAGE(msg);
+}
+
+// Recorded bodies as served by the exchanges, with the filter shape their parser uses
+struct FilterBench {
+    const char* name;
+    const char* body;
+    const char* shape;
+};
+
+static const char* BENCH_SYMBOLS[] = { "BTCUSDT", "ETHUSDT", "SOLUSDT" };
+static const char* BENCH_PRODUCTS[] = { "BTC-USD" };
+
+static bool bench_parse(int which, char* body, size_t len) {
+    switch (which) {
+        case 0: {
+            net_binance::BookTicker book;
+            return net_binance::parse_book(body, len, "BTCUSDT", &book);
+        }
+        case 1: {
+            net_binance::BookTicker books[3];
+            return net_binance::parse_book_batch(body, len, BENCH_SYMBOLS, 3, books) == 3;
+        }
+        case 2: {
+            net_coinbase::Ticker ticker;
+            return net_coinbase::parse_ticker(body, len, "BTC-USD", &ticker);
+        }
+        default: {
+            net_coinbase::Ticker ticker;
+            int64_t sequence;
+            return net_coinbase::parse_ticker_stream(body, len, BENCH_PRODUCTS, 1, &ticker, &sequence) == 0;
+        }
+    }
+}
+
+void test_benchmark_filtered_parse() {
+    static const FilterBench benches[] = {
+        { "binance book",
+          "{\"symbol\":\"BTCUSDT\",\"bidPrice\":\"43250.49000000\",\"bidQty\":\"1.20000000\","
+          "\"askPrice\":\"43250.50000000\",\"askQty\":\"0.80000000\"}",
+          "{\"symbol\":true,\"bidPrice\":true,\"askPrice\":true}" },
+        { "binance book x3",
+          "[{\"symbol\":\"BTCUSDT\",\"bidPrice\":\"43250.49000000\",\"bidQty\":\"1.20000000\","
+          "\"askPrice\":\"43250.50000000\",\"askQty\":\"0.80000000\"},"
+          "{\"symbol\":\"ETHUSDT\",\"bidPrice\":\"2245.29000000\",\"bidQty\":\"10.50000000\","
+          "\"askPrice\":\"2245.30000000\",\"askQty\":\"3.10000000\"},"
+          "{\"symbol\":\"SOLUSDT\",\"bidPrice\":\"98.11000000\",\"bidQty\":\"120.00000000\","
+          "\"askPrice\":\"98.12000000\",\"askQty\":\"45.00000000\"}]",
+          "[{\"symbol\":true,\"bidPrice\":true,\"askPrice\":true}]" },
+        { "coinbase ticker",
+          "{\"ask\":\"43245.80\",\"bid\":\"43245.70\",\"volume\":\"8311.53046208\","
+          "\"trade_id\":612345678,\"price\":\"43245.75\",\"size\":\"0.00120000\","
+          "\"time\":\"2024-01-15T12:00:00.123456Z\"}",
+          "{\"bid\":true,\"ask\":true,\"price\":true}" },
+        { "coinbase stream",
+          "{\"type\":\"ticker\",\"sequence\":37475248783,\"product_id\":\"BTC-USD\","
+          "\"price\":\"43245.75\",\"open_24h\":\"42810.01\",\"volume_24h\":\"8311.53046208\","
+          "\"low_24h\":\"42650.00\",\"high_24h\":\"43380.12\",\"volume_30d\":\"301234.12345678\","
+          "\"best_bid\":\"43245.70\",\"best_bid_size\":\"0.41000000\",\"best_ask\":\"43245.80\","
+          "\"best_ask_size\":\"0.05000000\",\"side\":\"buy\",\"time\":\"2024-01-15T12:00:00.123456Z\","
+          "\"trade_id\":612345678,\"last_size\":\"0.0012\"}",
+          "{\"type\":true,\"message\":true,\"product_id\":true,\"price\":true,"
+          "\"best_bid\":true,\"best_ask\":true,\"sequence\":true}" },
+    };
+    const int ROUNDS = 20000;
+    using namespace std::chrono;
+
+    for (int b = 0; b < (int)(sizeof(benches) / sizeof(benches[0])); b++) {
+        const FilterBench& bench = benches[b];
+        size_t len = strlen(bench.body);
+        char body[1024];
+        TEST_ASSERT_TRUE(len < sizeof(body));
+
+        // Document size: whole body vs the filtered fields
+        DynamicJsonDocument full(4096);
+        DynamicJsonDocument filter(512);
+        DynamicJsonDocument kept(4096);
+        TEST_ASSERT_FALSE(deserializeJson(filter, bench.shape));
+        memcpy(body, bench.body, len);
+        TEST_ASSERT_FALSE(deserializeJson(full, body, len));
+        memcpy(body, bench.body, len);
+        TEST_ASSERT_FALSE(deserializeJson(kept, body, len, DeserializationOption::Filter(filter)));
+        TEST_ASSERT_TRUE(kept.memoryUsage() < full.memoryUsage());
+
+        // Parse time with and without the filter (same document, reused)
+        DynamicJsonDocument doc(4096);
+        steady_clock::time_point t0 = steady_clock::now();
+        for (int n = 0; n < ROUNDS; n++) {
+            memcpy(body, bench.body, len);
+            deserializeJson(doc, body, len);
+        }
+        double before_us = duration_cast<nanoseconds>(steady_clock::now() - t0).count() / 1000.0;
+        t0 = steady_clock::now();
+        for (int n = 0; n < ROUNDS; n++) {
+            memcpy(body, bench.body, len);
+            deserializeJson(doc, body, len, DeserializationOption::Filter(filter));
+        }
+        double after_us = duration_cast<nanoseconds>(steady_clock::now() - t0).count() / 1000.0;
+
+        // The adapter's own filtered parse accepts the body
+        memcpy(body, bench.body, len);
+        TEST_ASSERT_TRUE(bench_parse(b, body, len));
+
+        char msg[160];
+        snprintf(msg, sizeof(msg), "%s (%u B): document %u -> %u B, parse %.2f -> %.2f us",
+                 bench.name, (unsigned)len, (unsigned)full.memoryUsage(), (unsigned)kept.memoryUsage(),
+                 before_us / ROUNDS, after_us / ROUNDS);
+        TEST_MESSAGE(msg);
+    }
+}
+
+void test_scan_fast_path_and_fallback() {
+    Fixed price = 0;
+
+    // Fixed shapes: scanned in place
+    char spot[] = "{\"symbol\":\"BTCUSDT\",\"price\":\"43250.50000000\"}";
+    TEST_ASSERT_TRUE(net_binance::parse_spot(spot, strlen(spot), "BTCUSDT", &price));
+    TEST_ASSERT_TRUE(price == fixed_from_string("43250.5"));
+    char cb_spot[] = "{\"data\":{\"amount\":\"43245.75\",\"base\":\"BTC\",\"currency\":\"USD\"}}";
+    TEST_ASSERT_TRUE(net_coinbase::parse_spot(cb_spot, strlen(cb_spot), "BTC-USD", &price));
+    TEST_ASSERT_TRUE(price == fixed_from_string("43245.75"));
+    Fixed rate = 0;
+    char funding[] = "[{\"symbol\":\"BTCUSDT\",\"fundingTime\":1700006400000,\"fundingRate\":\"-0.00002500\","
+                     "\"markPrice\":\"43260.10\"}]";
+    TEST_ASSERT_TRUE(net_binance::parse_funding(funding, strlen(funding), "BTCUSDT", &rate));
+    TEST_ASSERT_TRUE(rate == fixed_from_string("-0.000025"));
+
+    // Unexpected forms fall back to ArduinoJson with the same result
+    char escaped[] = "{\"symbol\":\"BTCUSDT\",\"note\":\"a\\/b\",\"price\":\"43250.50000000\"}";
+    TEST_ASSERT_TRUE(net_binance::parse_spot(escaped, strlen(escaped), "BTCUSDT", &price));
+    TEST_ASSERT_TRUE(price == fixed_from_string("43250.5"));
+    char exponent[] = "{\"symbol\":\"BTCUSDT\",\"price\":\"4.32505e4\"}";
+    TEST_ASSERT_TRUE(net_binance::parse_spot(exponent, strlen(exponent), "BTCUSDT", &price));
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 43250.5, fixed_to_double(price));
+    char cb_other[] = "{\"data\":{\"amount\":\"2246.10\",\"base\":\"ETH\",\"currency\":\"USD\"}}";
+    TEST_ASSERT_TRUE(net_coinbase::parse_spot(cb_other, strlen(cb_other), "BTC-USD", &price));
+
+    // Failures still fail after the fallback
+    char mismatch[] = "{\"symbol\":\"ETHUSDT\",\"price\":\"2245.30000000\"}";
+    TEST_ASSERT_FALSE(net_binance::parse_spot(mismatch, strlen(mismatch), "BTCUSDT", &price));
+    char truncated[] = "{\"symbol\":\"BTCUSDT\",\"price\":\"43250.5\"";
+    TEST_ASSERT_FALSE(net_binance::parse_spot(truncated, strlen(truncated), "BTCUSDT", &price));
+    char zero[] = "{\"symbol\":\"BTCUSDT\",\"price\":\"0.00000000\"}";
+    TEST_ASSERT_FALSE(net_binance::parse_spot(zero, strlen(zero), "BTCUSDT", &price));
+    char other_funding[] = "[{\"symbol\":\"ETHUSDT\",\"fundingRate\":\"0.0001\"}]";
+    TEST_ASSERT_FALSE(net_binance::parse_funding(other_funding, strlen(other_funding), "BTCUSDT", &rate));
+}
+
+void test_benchmark_scan_vs_arduinojson() {
+    // The escaped member forces the ArduinoJson fallback on an otherwise identical body
+    static const char* SCANNED = "{\"symbol\":\"BTCUSDT\",\"price\":\"43250.50000000\"}";
+    static const char* FALLBACK = "{\"symbol\":\"BTCUSDT\",\"price\":\"43250.50000000\",\"x\":\"\\/\"}";
+    const int ROUNDS = 200000;
+    using namespace std::chrono;
+
+    const char* bodies[] = { SCANNED, FALLBACK };
+    double us[2];
+    for (int b = 0; b < 2; b++) {
+        size_t len = strlen(bodies[b]);
+        char body[128];
+        Fixed price = 0;
+        int ok = 0;
+        steady_clock::time_point t0 = steady_clock::now();
+        for (int n = 0; n < ROUNDS; n++) {
+            memcpy(body, bodies[b], len + 1);
+            if (net_binance::parse_spot(body, len, "BTCUSDT", &price)) ok++;
+        }
+        us[b] = duration_cast<nanoseconds>(steady_clock::now() - t0).count() / 1000.0 / ROUNDS;
+        TEST_ASSERT_EQUAL(ROUNDS, ok);
+        TEST_ASSERT_TRUE(price == fixed_from_string("43250.5"));
+    }
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "Binance spot parse: scan %.3f us, ArduinoJson %.3f us (%.1fx)",
+             us[0], us[1], us[1] / us[0]);
+    TEST_MESSAGE(msg);
+}
+
+// Exchange-rates body with `filler` unrelated assets around BTC / ETH
+static size_t build_exchange_rates(char* out, size_t cap, int filler) {
+    size_t len = snprintf(out, cap, "{\"data\":{\"currency\":\"USD\",\"rates\":{");
+    for (int k = 0; k < filler && len < cap; k++) {
+        len += snprintf(out + len, cap - len, "\"A%03d\":\"%d.125\",", k, k + 1);
+        if (k == filler / 2) {
+            len += snprintf(out + len, cap - len, "\"ETH\":\"0.0004452\",\"BTC\":\"0.00002312\",");
+        }
+    }
+    len += snprintf(out + len, cap - len, "\"USD\":\"1.0\"}}}");
+    return len < cap ? len : 0;
+}
+
+void test_coinbase_rates_filters_while_streaming() {
+    // ~12 KB, several hundred assets: only the wanted ones are kept
+    static char body[16 * 1024];
+    size_t body_len = build_exchange_rates(body, sizeof(body), 700);
+    TEST_ASSERT_TRUE(body_len > 10000);
+
+    static char recording[sizeof(body) + 256];
+    size_t rec_len = snprintf(recording, sizeof(recording), "REQ %s\nRES 1 %u\n%s\n",
+                              CB_RATES_KEY, (unsigned)body_len, body);
+    ReplayTransport replay;
+    TEST_ASSERT_TRUE(replay.load_buffer(recording, rec_len));
+    http_transport_set(&replay);
+
+    // SOL not listed, BTC-EUR in another quote currency
+    const char* products[] = { "BTC-USD", "ETH-USD", "SOL-USD", "BTC-EUR" };
+    Fixed prices[4] = { 0 };
+    bool ok[4] = { false };
+    TEST_ASSERT_EQUAL(2, net_coinbase::fetch_spot_batch(products, 4, prices, ok));
+    TEST_ASSERT_EQUAL(1, replay.served());
+    TEST_ASSERT_EQUAL(0, replay.misses());
+    TEST_ASSERT_TRUE(ok[0] && ok[1]);
+    TEST_ASSERT_FALSE(ok[2] || ok[3]);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 1.0 / 0.00002312, fixed_to_double(prices[0]));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 1.0 / 0.0004452, fixed_to_double(prices[1]));
+    http_transport_set(g_replay);
+
+    // Same result fed one byte at a time
+    net_coinbase::SpotRatesScan scan;
+    Fixed again[4] = { 0 };
+    TEST_ASSERT_TRUE(net_coinbase::spot_rates_begin(&scan, products, 4, again, ok));
+    for (size_t k = 0; k < body_len; k++) {
+        TEST_ASSERT_TRUE(net_coinbase::spot_rates_chunk((const uint8_t*)body + k, 1, &scan));
+    }
+    TEST_ASSERT_EQUAL(2, net_coinbase::spot_rates_finish(&scan));
+    TEST_ASSERT_EQUAL_INT64(prices[0], again[0]);
+    TEST_ASSERT_EQUAL_INT64(prices[1], again[1]);
+}
+
+void test_coinbase_rates_rejects_bad_body() {
+    const char* products[] = { "BTC-USD", "ETH-USD" };
+    Fixed prices[2] = { 0 };
+    bool ok[2] = { false };
+    net_coinbase::SpotRatesScan scan;
+
+    // Cut off after the BTC rate: nothing is trusted
+    const char* cut = "{\"data\":{\"currency\":\"USD\",\"rates\":{\"BTC\":\"0.00002312\",\"ETH\":";
+    TEST_ASSERT_TRUE(net_coinbase::spot_rates_begin(&scan, products, 2, prices, ok));
+    net_coinbase::spot_rates_chunk((const uint8_t*)cut, strlen(cut), &scan);
+    TEST_ASSERT_EQUAL(0, net_coinbase::spot_rates_finish(&scan));
+    TEST_ASSERT_FALSE(ok[0] || ok[1]);
+
+    // Rates for another currency
+    const char* eur = "{\"data\":{\"currency\":\"EUR\",\"rates\":{\"BTC\":\"0.000025\"}}}";
+    TEST_ASSERT_TRUE(net_coinbase::spot_rates_begin(&scan, products, 2, prices, ok));
+    net_coinbase::spot_rates_chunk((const uint8_t*)eur, strlen(eur), &scan);
+    TEST_ASSERT_EQUAL(0, net_coinbase::spot_rates_finish(&scan));
+    TEST_ASSERT_FALSE(ok[0]);
+
+    // Error object, zero rate
+    const char* error = "{\"errors\":[{\"id\":\"not_found\",\"message\":\"Invalid currency\"}]}";
+    TEST_ASSERT_TRUE(net_coinbase::spot_rates_begin(&scan, products, 2, prices, ok));
+    net_coinbase::spot_rates_chunk((const uint8_t*)error, strlen(error), &scan);
+    TEST_ASSERT_EQUAL(0, net_coinbase::spot_rates_finish(&scan));
+    const char* zero = "{\"data\":{\"currency\":\"USD\",\"rates\":{\"BTC\":\"0\",\"ETH\":\"0.0004452\"}}}";
+    TEST_ASSERT_TRUE(net_coinbase::spot_rates_begin(&scan, products, 2, prices, ok));
+    net_coinbase::spot_rates_chunk((const uint8_t*)zero, strlen(zero), &scan);
+    TEST_ASSERT_EQUAL(1, net_coinbase::spot_rates_finish(&scan));
+    TEST_ASSERT_FALSE(ok[0]);
+    TEST_ASSERT_TRUE(ok[1]);
+
+    // Invalid product id
+    const char* bad[] = { "BTCUSD" };
+    TEST_ASSERT_FALSE(net_coinbase::spot_rates_begin(&scan, bad, 1, prices, ok));
+
+    // Request is rendered once per currency
+    const HttpRequest* req = net_coinbase::spot_rates_request("USD");
+    TEST_ASSERT_NOT_NULL(req);
+    TEST_ASSERT_EQUAL_PTR(req, net_coinbase::spot_rates_request("USD"));
+    char key[HTTP_RECORD_KEY_MAX];
+    TEST_ASSERT_TRUE(http_record_key(req, key, sizeof(key)));
+    TEST_ASSERT_EQUAL_STRING(CB_RATES_KEY, key);
+}
+
+// Bodies far over any fixed buffer are recorded whole and replay the same
+void test_record_then_replay_large_bodies() {
+    static char premium[64 * 1024];
+    static char rates[16 * 1024];
+    size_t premium_len = build_premium_index(premium, sizeof(premium), 200);
+    size_t rates_len = build_exchange_rates(rates, sizeof(rates), 700);
+    TEST_ASSERT_TRUE(premium_len > 40000 && rates_len > 10000);
+
+    static char source[sizeof(premium) + sizeof(rates) + 512];
+    size_t source_len = snprintf(source, sizeof(source), "REQ %s\nRES 1 %u\n%s\nREQ %s\nRES 1 %u\n%s\n",
+                                 PREMIUM_INDEX_KEY, (unsigned)premium_len, premium,
+                                 CB_RATES_KEY, (unsigned)rates_len, rates);
+    ReplayTransport network;
+    TEST_ASSERT_TRUE(network.load_buffer(source, source_len));
+
+    const char* symbols[] = { "BTCUSDT", "ETHUSDT" };
+    const char* products[] = { "BTC-USD", "ETH-USD" };
+    net_binance::PremiumIndex index[2];
+    Fixed prices[2] = { 0 };
+    bool ok[2] = { false };
+
+    remove(RECORD_PATH);
+    {
+        RecordingTransport recorder(&network, RECORD_PATH);
+        TEST_ASSERT_TRUE(recorder.is_open());
+        http_transport_set(&recorder);
+        TEST_ASSERT_EQUAL(2, net_binance::fetch_premium_index(symbols, 2, index));
+        TEST_ASSERT_EQUAL(2, net_coinbase::fetch_spot_batch(products, 2, prices, ok));
+        net_binance::PremiumIndex none[2];
+        TEST_ASSERT_FALSE(net_binance::fetch_premium_index(symbols, 2, none) > 0);  // Exhausted
+        TEST_ASSERT_EQUAL(3, recorder.recorded());
+    }
+
+    ReplayTransport replay;
+    TEST_ASSERT_TRUE(replay.load(RECORD_PATH));
+    TEST_ASSERT_EQUAL(3, replay.size());
+    http_transport_set(&replay);
+
+    net_binance::PremiumIndex again[2];
+    Fixed again_prices[2] = { 0 };
+    TEST_ASSERT_EQUAL(2, net_binance::fetch_premium_index(symbols, 2, again));
+    TEST_ASSERT_EQUAL_INT64(index[0].funding_rate, again[0].funding_rate);
+    TEST_ASSERT_EQUAL_INT64(index[1].mark_price, again[1].mark_price);
+    TEST_ASSERT_EQUAL(2, net_coinbase::fetch_spot_batch(products, 2, again_prices, ok));
+    TEST_ASSERT_EQUAL_INT64(prices[0], again_prices[0]);
+    TEST_ASSERT_EQUAL_INT64(prices[1], again_prices[1]);
+    TEST_ASSERT_FALSE(net_binance::fetch_premium_index(symbols, 2, again) > 0);  // Recorded failure
+    TEST_ASSERT_EQUAL(0, replay.misses());
+    http_transport_set(g_replay);
+    remove(RECORD_PATH);
+}
+
+int run_replay_tests() {
+    UNITY_BEGIN();
+
+    // Replay transport
+    RUN_TEST(test_replay_serves_in_recorded_order);
+    RUN_TEST(test_replay_reproduces_failures);
+    RUN_TEST(test_replay_unknown_request_is_a_miss);
+    RUN_TEST(test_replay_rejects_malformed_file);
+    RUN_TEST(test_record_then_replay_round_trip);
+
+    // Batched Binance ticker
+    RUN_TEST(test_batch_fetches_all_symbols_in_one_request);
+    RUN_TEST(test_batch_parse_scatters_partial_response);
+    RUN_TEST(test_batch_requests_split_and_reused);
+
+    // Top of book
+    RUN_TEST(test_book_batch_fetches_bid_ask_in_one_request);
+    RUN_TEST(test_coinbase_ticker_bid_ask);
+
+    // premiumIndex
+    RUN_TEST(test_premium_index_filters_while_streaming);
+    RUN_TEST(test_premium_index_rejects_truncated_body);
+
+    // Coinbase exchange rates
+    RUN_TEST(test_coinbase_rates_filters_while_streaming);
+    RUN_TEST(test_coinbase_rates_rejects_bad_body);
+    RUN_TEST(test_record_then_replay_large_bodies);
+
+    // In-place scan
+    RUN_TEST(test_scan_fast_path_and_fallback);
+
+    // Offline pipeline
+    RUN_TEST(test_pipeline_updates_model);
+    RUN_TEST(test_benchmark_replayed_pipeline);
+    RUN_TEST(test_benchmark_filtered_parse);
+    RUN_TEST(test_benchmark_scan_vs_arduinojson);
+
+    return UNITY_END();
+}
+
+int main() {
+    return run_replay_tests();
+}
@@ -0,0 +1,682 @@
+/**
+ * @file test_ws.cpp
+ * @brief Host tests for the WebSocket client (net_ws) and streamed quotes (app_stream)
+ *
+ * Runs on Linux only (pio test -e native). A local plain ws:// stand-in
+ * server completes the handshake and then plays a scenario chosen by the
+ * request path, one thread per connection:
+ *   /stream?...   recorded Binance bookTicker frames, one message fragmented
+ *                 around a ping; records the client's pong
+ *                 (markPrice streams: recorded futures markPriceUpdate frames)
+ *   /echo         echoes every text frame back; records whether it was masked
+ *   /drop         one message, then the socket is closed
+ *   /close        one message, then a close frame
+ *   /badkey       101 response with a wrong Sec-WebSocket-Accept
+ *   /             Coinbase feed: waits for the subscribe message, then plays
+ *                 recorded ticker frames with one sequence gap
+ *
+ * Tests cover:
+ * - Handshake key (RFC 6455 example)
+ * - Frame encode / parse round trip, fragmentation, byte-at-a-time input
+ * - Protocol errors and oversize messages
+ * - Recorded stream delivered in order, ping answered
+ * - Subscribe message sent masked
+ * - Reconnect after a drop, rejected handshake, server close
+ * - Stream path / subscribe message / message parsing
+ * - app_stream feeding both venues and streamed funding into the model,
+ *   sequence gaps, funding listener
+ */
+
+#include <unity.h>
+#include <net/net_ws.h>
+#include <net/net_binance.h>
+#include <net/net_coinbase.h>
+#include <app/app_config.h>
+#include <app/app_math.h>
+#include <app/app_model.h>
+#include <app/app_stream.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "../host_server.h"
+
+// ============================================================================
+// Recorded frames (Binance combined stream)
+// ============================================================================
+
+static const char* BTC_BOOK_1 =
+    "{\"stream\":\"btcusdt@bookTicker\",\"data\":{\"u\":40285643991,\"s\":\"BTCUSDT\","
+    "\"b\":\"43250.49000000\",\"B\":\"1.20410000\",\"a\":\"43250.50000000\",\"A\":\"0.81320000\"}}";
+static const char* ETH_BOOK_1 =
+    "{\"stream\":\"ethusdt@bookTicker\",\"data\":{\"u\":31873420112,\"s\":\"ETHUSDT\","
+    "\"b\":\"2245.29000000\",\"B\":\"14.51230000\",\"a\":\"2245.30000000\",\"A\":\"3.10050000\"}}";
+static const char* BTC_BOOK_2 =
+    "{\"stream\":\"btcusdt@bookTicker\",\"data\":{\"u\":40285644007,\"s\":\"BTCUSDT\","
+    "\"b\":\"43251.10000000\",\"B\":\"0.50000000\",\"a\":\"43251.11000000\",\"A\":\"2.04000000\"}}";
+
+// Recorded frames (Binance futures markPrice@1s)
+static const char* BTC_MARK_1 =
+    "{\"stream\":\"btcusdt@markPrice@1s\",\"data\":{\"e\":\"markPriceUpdate\",\"E\":1704067200000,"
+    "\"s\":\"BTCUSDT\",\"p\":\"43270.00000000\",\"P\":\"43268.51000000\",\"i\":\"43253.70000000\","
+    "\"r\":\"0.00012000\",\"T\":1704096000000}}";
+static const char* BTC_MARK_2 =
+    "{\"stream\":\"btcusdt@markPrice@1s\",\"data\":{\"e\":\"markPriceUpdate\",\"E\":1704067201000,"
+    "\"s\":\"BTCUSDT\",\"p\":\"43275.00000000\",\"P\":\"43270.02000000\",\"i\":\"43250.00000000\","
+    "\"r\":\"0.00031000\",\"T\":1704096000000}}";
+
+// Recorded frames (Coinbase ticker channel); BTC sequence jumps 100 -> 103
+static const char* CB_SUBSCRIPTIONS =
+    "{\"type\":\"subscriptions\",\"channels\":[{\"name\":\"ticker\",\"product_ids\":[\"BTC-USD\",\"ETH-USD\"]}]}";
+static const char* CB_BTC_1 =
+    "{\"type\":\"ticker\",\"sequence\":100,\"product_id\":\"BTC-USD\",\"price\":\"43259.99\","
+    "\"open_24h\":\"42810.01\",\"volume_24h\":\"11025.31\",\"best_bid\":\"43259.98\","
+    "\"best_bid_size\":\"0.05\",\"best_ask\":\"43260.00\",\"best_ask_size\":\"0.31\","
+    "\"side\":\"buy\",\"time\":\"2024-01-01T00:00:00.120000Z\",\"trade_id\":1,\"last_size\":\"0.01\"}";
+static const char* CB_ETH_1 =
+    "{\"type\":\"ticker\",\"sequence\":500,\"product_id\":\"ETH-USD\",\"price\":\"2245.10\","
+    "\"best_bid\":\"2245.09\",\"best_ask\":\"2245.11\",\"time\":\"2024-01-01T00:00:00.150000Z\"}";
+static const char* CB_BTC_2 =
+    "{\"type\":\"ticker\",\"sequence\":103,\"product_id\":\"BTC-USD\",\"price\":\"43260.01\","
+    "\"best_bid\":\"43260.00\",\"best_ask\":\"43260.02\",\"time\":\"2024-01-01T00:00:00.300000Z\"}";
+static const char* CB_BTC_OLD =
+    "{\"type\":\"ticker\",\"sequence\":102,\"product_id\":\"BTC-USD\",\"price\":\"43000.00\","
+    "\"best_bid\":\"43000.00\",\"best_ask\":\"43000.02\",\"time\":\"2024-01-01T00:00:00.250000Z\"}";
+
+// ============================================================================
+// Frame helpers
+// ============================================================================
+
+// Unmasked (server) frame
+static size_t server_frame(uint8_t first, const char* payload, size_t len, uint8_t* out) {
+    size_t o = 0;
+    out[o++] = first;
+    if (len <= 125) {
+        out[o++] = (uint8_t)len;
+    } else {
+        out[o++] = 126;
+        out[o++] = (uint8_t)(len >> 8);
+        out[o++] = (uint8_t)len;
+    }
+    memcpy(out + o, payload, len);
+    return o + len;
+}
+
+static void send_frame(int fd, uint8_t first, const char* payload) {
+    uint8_t buf[2048];
+    size_t n = server_frame(first, payload, strlen(payload), buf);
+    send(fd, buf, n, MSG_NOSIGNAL);
+}
+
+static bool recv_all(int fd, uint8_t* buf, size_t len) {
+    size_t have = 0;
+    while (have < len) {
+        ssize_t n = recv(fd, buf + have, len - have, 0);
+        if (n <= 0) return false;
+        have += n;
+    }
+    return true;
+}
+
+// Read one client frame; returns opcode (-1 on EOF), payload unmasked into out
+static int read_frame(int fd, char* out, size_t cap, size_t* out_len, bool* masked) {
+    uint8_t h[2];
+    if (!recv_all(fd, h, 2)) return -1;
+    size_t len = h[1] & 0x7F;
+    if (len == 126) {
+        uint8_t ext[2];
+        if (!recv_all(fd, ext, 2)) return -1;
+        len = ((size_t)ext[0] << 8) | ext[1];
+    }
+    *masked = (h[1] & 0x80) != 0;
+    uint8_t mask[4] = { 0, 0, 0, 0 };
+    if (*masked && !recv_all(fd, mask, 4)) return -1;
+    if (len >= cap || !recv_all(fd, (uint8_t*)out, len)) return -1;
+    for (size_t i = 0; i < len; i++) {
+        out[i] ^= mask[i & 3];
+    }
+    out[len] = '\0';
+    *out_len = len;
+    return h[0] & 0x0F;
+}
+
+// ============================================================================
+// Stand-in server
+// ============================================================================
+
+static volatile bool g_pong_ok = false;
+static volatile bool g_client_masked = false;
+static char g_subscribed[512];
+
+static void* serve_connection(void* arg) {
+    int fd = (int)(intptr_t)arg;
+    char req[1024];
+    size_t have = 0;
+    while (have < sizeof(req) - 1) {
+        ssize_t n = recv(fd, req + have, sizeof(req) - 1 - have, 0);
+        if (n <= 0) {
+            close(fd);
+            return nullptr;
+        }
+        have += n;
+        req[have] = '\0';
+        if (strstr(req, "\r\n\r\n")) break;
+    }
+
+    char path[256] = "";
+    sscanf(req, "GET %255s", path);
+    char key[64] = "";
+    const char* k = strcasestr(req, "Sec-WebSocket-Key:");
+    if (k) sscanf(k + 18, " %63s", key);
+
+    char accept[32];
+    ws_accept_key(key, accept);
+    if (strcmp(path, "/badkey") == 0) {
+        strcpy(accept, "AAAAAAAAAAAAAAAAAAAAAAAAAAA=");
+    }
+    char resp[256];
+    int len = snprintf(resp, sizeof(resp),
+                       "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\n"
+                       "Connection: Upgrade\r\nSec-WebSocket-Accept: %s\r\n\r\n", accept);
+    send(fd, resp, len, MSG_NOSIGNAL);
+
+    if (strncmp(path, "/stream", 7) == 0 && strstr(path, "@markPrice@1s")) {
+        send_frame(fd, 0x81, BTC_MARK_1);
+        send_frame(fd, 0x81, BTC_MARK_2);
+    } else if (strncmp(path, "/stream", 7) == 0) {
+        send_frame(fd, 0x81, BTC_BOOK_1);
+        send_frame(fd, 0x81, ETH_BOOK_1);
+        // Third message split in two fragments with a ping in between
+        size_t half = strlen(BTC_BOOK_2) / 2;
+        uint8_t buf[512];
+        size_t n = server_frame(0x01, BTC_BOOK_2, half, buf);
+        n += server_frame(0x89, "hb", 2, buf + n);
+        n += server_frame(0x80, BTC_BOOK_2 + half, strlen(BTC_BOOK_2) - half, buf + n);
+        send(fd, buf, n, MSG_NOSIGNAL);
+    } else if (strcmp(path, "/drop") == 0) {
+        send_frame(fd, 0x81, "{\"n\":1}");
+        usleep(20 * 1000);
+        close(fd);
+        return nullptr;
+    } else if (strcmp(path, "/") == 0) {
+        // Coinbase: nothing is sent before the subscribe message
+        char sub[512];
+        size_t sub_len;
+        bool sub_masked;
+        if (read_frame(fd, sub, sizeof(sub), &sub_len, &sub_masked) == WS_OP_TEXT) {
+            memcpy(g_subscribed, sub, sub_len + 1);
+            send_frame(fd, 0x81, CB_SUBSCRIPTIONS);
+            send_frame(fd, 0x81, CB_BTC_1);
+            send_frame(fd, 0x81, CB_ETH_1);
+            send_frame(fd, 0x81, CB_BTC_2);
+            send_frame(fd, 0x81, CB_BTC_OLD);
+        }
+    } else if (strcmp(path, "/close") == 0) {
+        send_frame(fd, 0x81, "{\"n\":1}");
+        uint8_t close_frame[4] = { 0x88, 0x02, 0x03, 0xE8 };
+        send(fd, close_frame, sizeof(close_frame), MSG_NOSIGNAL);
+    }
+
+    // Answer / record client frames until the client goes away
+    char payload[1024];
+    size_t payload_len;
+    bool masked;
+    int op;
+    while ((op = read_frame(fd, payload, sizeof(payload), &payload_len, &masked)) >= 0) {
+        if (op == WS_OP_PONG) {
+            g_pong_ok = masked && payload_len == 2 && memcmp(payload, "hb", 2) == 0;
+        } else if (op == WS_OP_TEXT && strcmp(path, "/echo") == 0) {
+            g_client_masked = masked;
+            send_frame(fd, 0x81, payload);
+        } else if (op == WS_OP_CLOSE) {
+            break;
+        }
+    }
+    close(fd);
+    return nullptr;
+}
+
+// ============================================================================
+// Client helpers
+// ============================================================================
+
+static char g_base[48];
+
+struct Received {
+    int count;
+    char last[WS_MESSAGE_MAX + 1];
+    char all[4][WS_MESSAGE_MAX + 1];
+};
+
+static void on_message(WsClient* c, char* data, size_t len, void* ctx) {
+    (void)c;
+    Received* r = static_cast<Received*>(ctx);
+    memcpy(r->last, data, len + 1);
+    if (r->count < 4) {
+        memcpy(r->all[r->count], data, len + 1);
+    }
+    r->count++;
+}
+
+// Poll one client until done() holds or 3 s pass
+template <typename Pred>
+static bool poll_until(WsClient* c, Pred done) {
+    WsClient* clients[1] = { c };
+    for (int i = 0; i < 60; i++) {
+        if (done()) return true;
+        if (ws_poll(clients, 1, 50) == 0 && c->stream == nullptr) {
+            usleep(5 * 1000);
+        }
+    }
+    return done();
+}
+
+// Parser callback collecting messages
+struct Collected {
+    int count;
+    uint8_t ops[8];
+    char last[WS_MESSAGE_MAX + 1];
+    size_t last_len;
+};
+
+static bool collect(uint8_t opcode, char* data, size_t len, void* ctx) {
+    Collected* c = static_cast<Collected*>(ctx);
+    if (c->count < 8) c->ops[c->count] = opcode;
+    c->count++;
+    memcpy(c->last, data, len + 1);
+    c->last_len = len;
+    return true;
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+void setUp() {
+    g_skew_ms = 0;
+    snprintf(g_base, sizeof(g_base), "ws://127.0.0.1:%u", g_port);
+}
+
+void tearDown() {
+}
+
+void test_accept_key_rfc_example() {
+    char accept[32];
+    ws_accept_key("dGhlIHNhbXBsZSBub25jZQ==", accept);
+    TEST_ASSERT_EQUAL_STRING("s3pPLMBiTxaQ9kYGzzhZRbK+xOo=", accept);
+}
+
+void test_frame_round_trip_masked() {
+    const char* text = "{\"method\":\"SUBSCRIBE\",\"id\":1}";
+    const uint8_t mask[4] = { 0x12, 0x34, 0x56, 0x78 };
+    uint8_t frame[64];
+    size_t n = ws_frame_encode(WS_OP_TEXT, (const uint8_t*)text, strlen(text), mask, frame, sizeof(frame));
+    TEST_ASSERT_EQUAL(2 + 4 + strlen(text), n);
+    TEST_ASSERT_EQUAL_HEX32(0x81, frame[0]);
+    TEST_ASSERT_EQUAL_HEX32(0x80 | strlen(text), frame[1]);
+    TEST_ASSERT_NOT_EQUAL(0, memcmp(frame + 6, text, strlen(text)));
+
+    // Too small an output buffer
+    TEST_ASSERT_EQUAL(0, ws_frame_encode(WS_OP_TEXT, (const uint8_t*)text, strlen(text), mask, frame, 10));
+
+    static WsFrameParser p;
+    ws_parser_init(&p);
+    Collected c = {};
+    TEST_ASSERT_TRUE(ws_parser_feed(&p, frame, n, collect, &c));
+    TEST_ASSERT_EQUAL(1, c.count);
+    TEST_ASSERT_EQUAL_STRING(text, c.last);
+}
+
+void test_parser_fragments_byte_at_a_time() {
+    // Fragmented text message with a ping in between, then a 200-byte message (16-bit length)
+    static char long_text[201];
+    memset(long_text, 'x', 200);
+    long_text[200] = '\0';
+    uint8_t stream[512];
+    size_t n = server_frame(0x01, "{\"a\":", 5, stream);
+    n += server_frame(0x89, "p", 1, stream + n);
+    n += server_frame(0x00, "1", 1, stream + n);
+    n += server_frame(0x80, "}", 1, stream + n);
+    n += server_frame(0x81, long_text, 200, stream + n);
+
+    static WsFrameParser p;
+    ws_parser_init(&p);
+    Collected c = {};
+    for (size_t i = 0; i < n; i++) {
+        TEST_ASSERT_TRUE(ws_parser_feed(&p, stream + i, 1, collect, &c));
+        if (c.count == 2) {
+            TEST_ASSERT_EQUAL_STRING("{\"a\":1}", c.last);
+        }
+    }
+    TEST_ASSERT_EQUAL(3, c.count);
+    TEST_ASSERT_EQUAL(WS_OP_PING, c.ops[0]);
+    TEST_ASSERT_EQUAL(WS_OP_TEXT, c.ops[1]);
+    TEST_ASSERT_EQUAL(WS_OP_TEXT, c.ops[2]);
+    TEST_ASSERT_EQUAL(200, c.last_len);
+}
+
+void test_parser_rejects_protocol_errors() {
+    static WsFrameParser p;
+    Collected c = {};
+    const uint8_t rsv[] = { 0xC1, 0x00 };              // RSV1 set
+    const uint8_t opcode[] = { 0x83, 0x00 };           // Reserved opcode
+    const uint8_t orphan[] = { 0x80, 0x01, 'x' };      // Continuation without a message
+    const uint8_t split_ping[] = { 0x09, 0x00 };       // Fragmented control frame
+    const uint8_t long_ping[] = { 0x89, 126, 0x00, 0x80 };  // Control payload > 125
+    const uint8_t* cases[] = { rsv, opcode, orphan, split_ping, long_ping };
+    const size_t lens[] = { sizeof(rsv), sizeof(opcode), sizeof(orphan), sizeof(split_ping), sizeof(long_ping) };
+
+    for (int i = 0; i < 5; i++) {
+        ws_parser_init(&p);
+        TEST_ASSERT_FALSE_MESSAGE(ws_parser_feed(&p, cases[i], lens[i], collect, &c), "case accepted");
+        TEST_ASSERT_EQUAL(WS_PARSE_ERROR, p.state);
+    }
+    TEST_ASSERT_EQUAL(0, c.count);
+}
+
+void test_parser_drops_oversize_message() {
+    static char big[WS_MESSAGE_MAX + 200];
+    memset(big, 'y', sizeof(big));
+    static uint8_t stream[sizeof(big) + 64];
+    size_t n = server_frame(0x81, big, sizeof(big), stream);
+    n += server_frame(0x81, "ok", 2, stream + n);
+
+    static WsFrameParser p;
+    ws_parser_init(&p);
+    Collected c = {};
+    TEST_ASSERT_TRUE(ws_parser_feed(&p, stream, n, collect, &c));
+    TEST_ASSERT_EQUAL(1, p.dropped);
+    TEST_ASSERT_EQUAL(1, c.count);
+    TEST_ASSERT_EQUAL_STRING("ok", c.last);
+}
+
+void test_book_stream_path_and_message() {
+    const char* symbols[] = { "BTCUSDT", "ETHUSDT" };
+    char path[WS_PATH_MAX];
+    TEST_ASSERT_TRUE(net_binance::book_stream_path(symbols, 2, path, sizeof(path)));
+    TEST_ASSERT_EQUAL_STRING("/stream?streams=btcusdt@bookTicker/ethusdt@bookTicker", path);
+    TEST_ASSERT_FALSE(net_binance::book_stream_path(symbols, 2, path, 40));
+
+    char msg[256];
+    strcpy(msg, ETH_BOOK_1);
+    net_binance::BookTicker book;
+    TEST_ASSERT_EQUAL(1, net_binance::parse_book_stream(msg, strlen(msg), symbols, 2, &book));
+    TEST_ASSERT_TRUE(book.valid);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 2245.29, fixed_to_double(book.bid));
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 2245.30, fixed_to_double(book.ask));
+
+    // Subscription replies and unknown symbols are ignored
+    strcpy(msg, "{\"result\":null,\"id\":1}");
+    TEST_ASSERT_EQUAL(-1, net_binance::parse_book_stream(msg, strlen(msg), symbols, 2, &book));
+    strcpy(msg, BTC_BOOK_1);
+    TEST_ASSERT_EQUAL(-1, net_binance::parse_book_stream(msg, strlen(msg), symbols + 1, 1, &book));
+}
+
+void test_mark_stream_path_and_message() {
+    const char* symbols[] = { "BTCUSDT", "ETHUSDT" };
+    char path[WS_PATH_MAX];
+    TEST_ASSERT_TRUE(net_binance::mark_stream_path(symbols, 2, path, sizeof(path)));
+    TEST_ASSERT_EQUAL_STRING("/stream?streams=btcusdt@markPrice@1s/ethusdt@markPrice@1s", path);
+
+    char msg[384];
+    strcpy(msg, BTC_MARK_1);
+    net_binance::PremiumIndex mark;
+    TEST_ASSERT_EQUAL(0, net_binance::parse_mark_stream(msg, strlen(msg), symbols, 2, &mark));
+    TEST_ASSERT_TRUE(mark.valid);
+    TEST_ASSERT_FLOAT_WITHIN(1e-9, 0.00012, fixed_to_double(mark.funding_rate));
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 43270.00, fixed_to_double(mark.mark_price));
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 43253.70, fixed_to_double(mark.index_price));
+    TEST_ASSERT_EQUAL_UINT64(1704096000000ULL, mark.next_funding_ms);
+    TEST_ASSERT_EQUAL_UINT64(1704067200000ULL, mark.server_time_ms);
+
+    // Book tickers are not mark updates
+    strcpy(msg, BTC_BOOK_1);
+    TEST_ASSERT_EQUAL(-1, net_binance::parse_mark_stream(msg, strlen(msg), symbols, 2, &mark));
+}
+
+void test_funding_basis() {
+    Funding f;
+    f.mark_price = FIXED_UNITS(101);
+    f.index_price = FIXED_UNITS(100);
+    funding_update_basis(f);
+    TEST_ASSERT_TRUE(f.basis_valid);
+    TEST_ASSERT_TRUE(f.basis_abs == FIXED_UNITS(1));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 1.0, f.basis_pct);
+
+    f.index_price = 0;
+    funding_update_basis(f);
+    TEST_ASSERT_FALSE(f.basis_valid);
+}
+
+void test_ticker_subscribe_and_message() {
+    const char* products[] = { "BTC-USD", "ETH-USD" };
+    char sub[WS_SUBSCRIBE_MAX];
+    TEST_ASSERT_TRUE(net_coinbase::ticker_subscribe_message(products, 2, sub, sizeof(sub)));
+    TEST_ASSERT_EQUAL_STRING(
+        "{\"type\":\"subscribe\",\"product_ids\":[\"BTC-USD\",\"ETH-USD\"],\"channels\":[\"ticker\"]}", sub);
+    TEST_ASSERT_FALSE(net_coinbase::ticker_subscribe_message(products, 2, sub, 50));
+
+    char msg[512];
+    strcpy(msg, CB_BTC_1);
+    net_coinbase::Ticker ticker;
+    int64_t seq = 0;
+    TEST_ASSERT_EQUAL(0, net_coinbase::parse_ticker_stream(msg, strlen(msg), products, 2, &ticker, &seq));
+    TEST_ASSERT_TRUE(ticker.valid);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 43259.98, fixed_to_double(ticker.bid));
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 43260.00, fixed_to_double(ticker.ask));
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 43259.99, fixed_to_double(ticker.price));
+    TEST_ASSERT_EQUAL(100, seq);
+
+    // Subscription replies, errors and unknown products are ignored
+    strcpy(msg, CB_SUBSCRIPTIONS);
+    TEST_ASSERT_EQUAL(-1, net_coinbase::parse_ticker_stream(msg, strlen(msg), products, 2, &ticker, &seq));
+    strcpy(msg, "{\"type\":\"error\",\"message\":\"Failed to subscribe\"}");
+    TEST_ASSERT_EQUAL(-1, net_coinbase::parse_ticker_stream(msg, strlen(msg), products, 2, &ticker, &seq));
+    strcpy(msg, CB_ETH_1);
+    TEST_ASSERT_EQUAL(-1, net_coinbase::parse_ticker_stream(msg, strlen(msg), products, 1, &ticker, &seq));
+}
+
+void test_client_receives_recorded_stream() {
+    static WsClient c;
+    static Received r;
+    memset(&r, 0, sizeof(r));
+    g_pong_ok = false;
+    ws_init(&c, test_factory, test_clock, on_message, &r);
+    TEST_ASSERT_TRUE(ws_open(&c, g_base, "/stream?streams=btcusdt@bookTicker/ethusdt@bookTicker", nullptr));
+
+    TEST_ASSERT_TRUE(poll_until(&c, [&] { return r.count >= 3 && g_pong_ok; }));
+    TEST_ASSERT_EQUAL(WS_OPEN, c.state);
+    TEST_ASSERT_EQUAL_STRING(BTC_BOOK_1, r.all[0]);
+    TEST_ASSERT_EQUAL_STRING(ETH_BOOK_1, r.all[1]);
+    TEST_ASSERT_EQUAL_STRING(BTC_BOOK_2, r.all[2]);
+    TEST_ASSERT_EQUAL(1, c.stats.opens);
+    TEST_ASSERT_EQUAL(1, c.stats.pings);
+    TEST_ASSERT_EQUAL(3, c.stats.messages);
+
+    ws_close(&c);
+    TEST_ASSERT_EQUAL(WS_CLOSED, c.state);
+}
+
+void test_client_subscribe_is_masked() {
+    static WsClient c;
+    static Received r;
+    memset(&r, 0, sizeof(r));
+    g_client_masked = false;
+    const char* subscribe = "{\"method\":\"SUBSCRIBE\",\"params\":[\"btcusdt@bookTicker\"],\"id\":1}";
+    ws_init(&c, test_factory, test_clock, on_message, &r);
+    TEST_ASSERT_TRUE(ws_open(&c, g_base, "/echo", subscribe));
+
+    TEST_ASSERT_TRUE(poll_until(&c, [&] { return r.count >= 1; }));
+    TEST_ASSERT_EQUAL_STRING(subscribe, r.last);
+    TEST_ASSERT_TRUE(g_client_masked);
+
+    TEST_ASSERT_TRUE(ws_send_text(&c, "ping?", 5));
+    TEST_ASSERT_TRUE(poll_until(&c, [&] { return r.count >= 2; }));
+    TEST_ASSERT_EQUAL_STRING("ping?", r.last);
+    ws_close(&c);
+}
+
+void test_client_reconnects_after_drop() {
+    static WsClient c;
+    static Received r;
+    memset(&r, 0, sizeof(r));
+    ws_init(&c, test_factory, test_clock, on_message, &r);
+    TEST_ASSERT_TRUE(ws_open(&c, g_base, "/drop", nullptr));
+    int accepts_before = g_accepts;
+
+    TEST_ASSERT_TRUE(poll_until(&c, [&] { return c.stats.disconnects == 1; }));
+    TEST_ASSERT_EQUAL(1, r.count);
+    TEST_ASSERT_EQUAL(WS_CLOSED, c.state);
+
+    // Nothing happens before the backoff expires
+    WsClient* clients[1] = { &c };
+    ws_poll(clients, 1, 20);
+    TEST_ASSERT_EQUAL(1, c.stats.connects);
+
+    g_skew_ms += WS_BACKOFF_MIN_MS;
+    TEST_ASSERT_TRUE(poll_until(&c, [&] { return c.stats.opens == 2 && r.count == 2; }));
+    TEST_ASSERT_EQUAL(2, g_accepts - accepts_before);
+    ws_close(&c);
+}
+
+void test_client_rejects_bad_accept_key() {
+    static WsClient c;
+    static Received r;
+    memset(&r, 0, sizeof(r));
+    ws_init(&c, test_factory, test_clock, on_message, &r);
+    TEST_ASSERT_TRUE(ws_open(&c, g_base, "/badkey", nullptr));
+
+    TEST_ASSERT_TRUE(poll_until(&c, [&] { return c.stats.failures == 1; }));
+    TEST_ASSERT_EQUAL(0, c.stats.opens);
+    TEST_ASSERT_EQUAL(WS_CLOSED, c.state);
+    TEST_ASSERT_EQUAL(2 * WS_BACKOFF_MIN_MS, c.backoff_ms);
+    ws_close(&c);
+}
+
+void test_client_server_close() {
+    static WsClient c;
+    static Received r;
+    memset(&r, 0, sizeof(r));
+    ws_init(&c, test_factory, test_clock, on_message, &r);
+    TEST_ASSERT_TRUE(ws_open(&c, g_base, "/close", nullptr));
+
+    TEST_ASSERT_TRUE(poll_until(&c, [&] { return c.stats.disconnects == 1; }));
+    TEST_ASSERT_EQUAL(1, r.count);
+    TEST_ASSERT_TRUE(c.peer_closed);
+    TEST_ASSERT_TRUE(c.enabled);    // Still reconnecting
+    ws_close(&c);
+}
+
+// Funding listener calls (model_set_funding_listener)
+static int g_funding_calls = 0;
+static Fixed g_funding_rate = 0;
+
+static void on_funding(int idx, const Funding& funding) {
+    (void)idx;
+    g_funding_calls++;
+    g_funding_rate = funding.rate;
+}
+
+void test_stream_feeds_model() {
+    config_init();
+    model_init();
+    stream_init(test_factory, test_clock);
+    stream_set_url(STREAM_BINANCE_BOOK, g_base);
+    stream_set_url(STREAM_COINBASE_TICKER, g_base);
+    stream_set_url(STREAM_BINANCE_MARK, g_base);
+    stream_set_enabled(STREAM_BINANCE_MARK, true);
+    model_set_funding_listener(on_funding);
+    g_funding_calls = 0;
+    g_subscribed[0] = '\0';
+
+    TEST_ASSERT_EQUAL(3, stream_start());
+    TEST_ASSERT_FALSE(stream_is_live(STREAM_BINANCE_BOOK, 0, test_clock()));
+    TEST_ASSERT_FALSE(stream_is_live(STREAM_COINBASE_TICKER, 0, test_clock()));
+    for (int i = 0; i < 60 && (stream_get_stats(STREAM_BINANCE_BOOK).ws.messages < 3 ||
+                               stream_get_stats(STREAM_COINBASE_TICKER).ws.messages < 5 ||
+                               stream_get_stats(STREAM_BINANCE_MARK).ws.messages < 2); i++) {
+        stream_poll(50);
+    }
+    model_set_funding_listener(nullptr);
+    TEST_ASSERT_EQUAL(3, stream_get_stats(STREAM_BINANCE_BOOK).ws.messages);
+    TEST_ASSERT_EQUAL(5, stream_get_stats(STREAM_COINBASE_TICKER).ws.messages);
+    TEST_ASSERT_NOT_NULL(strstr(g_subscribed, "\"product_ids\":[\"BTC-USD\",\"ETH-USD\""));
+
+    AppState s = model_snapshot();
+    TEST_ASSERT_TRUE(s.symbols[0].binance_quote.valid);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 43251.10, fixed_to_double(s.symbols[0].binance_quote.bid));
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 43251.11, fixed_to_double(s.symbols[0].binance_quote.ask));
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 2245.29, fixed_to_double(s.symbols[1].binance_quote.bid));
+
+    // Latest Coinbase book; the out-of-order message (sequence 102) is dropped
+    TEST_ASSERT_TRUE(s.symbols[0].coinbase_quote.valid);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 43260.00, fixed_to_double(s.symbols[0].coinbase_quote.bid));
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 43260.02, fixed_to_double(s.symbols[0].coinbase_quote.ask));
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 2245.11, fixed_to_double(s.symbols[1].coinbase_quote.ask));
+    TEST_ASSERT_TRUE(s.symbols[0].exec_spread_valid);
+    TEST_ASSERT_EQUAL(SPREAD_BUY_BINANCE, s.symbols[0].exec_direction);
+    TEST_ASSERT_EQUAL(0, s.symbols[0].history_count);    // History keeps the REST pace
+
+    // Predicted funding and basis from the latest mark update
+    TEST_ASSERT_TRUE(s.symbols[0].funding.valid);
+    TEST_ASSERT_FLOAT_WITHIN(1e-9, 0.00031, fixed_to_double(s.symbols[0].funding.rate));
+    TEST_ASSERT_EQUAL_UINT64(1704096000000ULL, s.symbols[0].funding.next_funding_ms);
+    TEST_ASSERT_TRUE(s.symbols[0].funding.basis_valid);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 25.0, fixed_to_double(s.symbols[0].funding.basis_abs));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5, 25.0 / 43250.0 * 100.0, s.symbols[0].funding.basis_pct);
+    TEST_ASSERT_FALSE(s.symbols[1].funding.valid);
+    TEST_ASSERT_EQUAL(2, g_funding_calls);
+    TEST_ASSERT_FLOAT_WITHIN(1e-9, 0.00031, fixed_to_double(g_funding_rate));
+
+    StreamStats cb = stream_get_stats(STREAM_COINBASE_TICKER);
+    TEST_ASSERT_EQUAL(1, cb.gaps);
+    TEST_ASSERT_EQUAL(2, cb.missed);
+    TEST_ASSERT_EQUAL(1, cb.out_of_order);
+    TEST_ASSERT_EQUAL(0, stream_get_stats(STREAM_BINANCE_BOOK).gaps);
+
+    // Rate over a closed window
+    g_skew_ms += STREAM_RATE_WINDOW_MS;
+    stream_poll(0);
+    cb = stream_get_stats(STREAM_COINBASE_TICKER);
+    TEST_ASSERT_GREATER_THAN(0.0f, cb.rate);
+    TEST_ASSERT_LESS_OR_EQUAL(5 * 1000.0f / STREAM_RATE_WINDOW_MS, cb.rate);
+
+    // Live per symbol and venue, and only while recent
+    uint32_t now = test_clock() - STREAM_RATE_WINDOW_MS;
+    TEST_ASSERT_TRUE(stream_is_live(STREAM_BINANCE_BOOK, 0, now));
+    TEST_ASSERT_TRUE(stream_is_live(STREAM_BINANCE_BOOK, 1, now));
+    TEST_ASSERT_FALSE(stream_is_live(STREAM_BINANCE_BOOK, 2, now));
+    TEST_ASSERT_TRUE(stream_is_live(STREAM_COINBASE_TICKER, 0, now));
+    TEST_ASSERT_FALSE(stream_is_live(STREAM_COINBASE_TICKER, 2, now));
+    TEST_ASSERT_TRUE(stream_is_live(STREAM_BINANCE_MARK, 0, now));
+    TEST_ASSERT_FALSE(stream_is_live(STREAM_BINANCE_MARK, 1, now));
+    TEST_ASSERT_FALSE(stream_is_live(STREAM_BINANCE_BOOK, 0, now + STREAM_QUOTE_MAX_AGE_MS + 1));
+
+    stream_stop();
+    TEST_ASSERT_FALSE(stream_is_live(STREAM_BINANCE_BOOK, 0, now));
+    TEST_ASSERT_FALSE(stream_is_live(STREAM_COINBASE_TICKER, 0, now));
+}
+
+int main() {
+    start_server();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_accept_key_rfc_example);
+    RUN_TEST(test_frame_round_trip_masked);
+    RUN_TEST(test_parser_fragments_byte_at_a_time);
+    RUN_TEST(test_parser_rejects_protocol_errors);
+    RUN_TEST(test_parser_drops_oversize_message);
+    RUN_TEST(test_book_stream_path_and_message);
+    RUN_TEST(test_ticker_subscribe_and_message);
+    RUN_TEST(test_mark_stream_path_and_message);
+    RUN_TEST(test_funding_basis);
+    RUN_TEST(test_client_receives_recorded_stream);
+    RUN_TEST(test_client_subscribe_is_masked);
+    RUN_TEST(test_client_reconnects_after_drop);
+    RUN_TEST(test_client_rejects_bad_accept_key);
+    RUN_TEST(test_client_server_close);
+    RUN_TEST(test_stream_feeds_model);
+    return UNITY_END();
+}
@@ -0,0 +1,410 @@
+/**
+ * @file test_http_parser.cpp
+ * @brief Unit tests for the incremental HTTP response parser (net_http_parser)
+ *
+ * Canned byte streams are fed both in one piece and one byte at a time.
+ *
+ * Tests cover:
+ * - Content-Length bodies (complete on last byte, no FIN needed)
+ * - Chunked bodies with extensions and trailers
+ * - Close-delimited bodies
+ * - Connection: close / HTTP/1.0 keep-alive rules
+ * - Non-2xx bodies consumed but not delivered
+ * - Malformed input and callback abort
+ * - Bytes after the response are not consumed
+ * - Reading from a byte source into a fixed buffer sink
+ * - Whole-response deadline, also while the server trickles bytes
+ */
+
+#include <unity.h>
+#include <net/net_http_parser.h>
+#include <stdio.h>
+#include <string.h>
+
+static char g_body[512];
+static size_t g_body_len;
+
+static bool collect(const uint8_t* data, size_t len, void* ctx) {
+    (void)ctx;
+    if (g_body_len + len >= sizeof(g_body)) return false;
+    memcpy(g_body + g_body_len, data, len);
+    g_body_len += len;
+    g_body[g_body_len] = '\0';
+    return true;
+}
+
+static bool abort_cb(const uint8_t* data, size_t len, void* ctx) {
+    (void)data; (void)len; (void)ctx;
+    return false;
+}
+
+// Feed whole stream at once; returns bytes consumed
+static size_t feed_all(HttpResponseParser* p, const char* s) {
+    g_body_len = 0;
+    g_body[0] = '\0';
+    http_parser_init(p);
+    return http_parser_feed(p, (const uint8_t*)s, strlen(s), collect, nullptr);
+}
+
+// Feed stream one byte at a time; returns bytes consumed
+static size_t feed_bytewise(HttpResponseParser* p, const char* s) {
+    g_body_len = 0;
+    g_body[0] = '\0';
+    http_parser_init(p);
+    size_t consumed = 0;
+    for (size_t i = 0; s[i]; i++) {
+        consumed += http_parser_feed(p, (const uint8_t*)s + i, 1, collect, nullptr);
+    }
+    return consumed;
+}
+
+static const char* CONTENT_LENGTH_RESPONSE =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: application/json;charset=UTF-8\r\n"
+    "Content-Length: 45\r\n"
+    "Connection: keep-alive\r\n"
+    "\r\n"
+    "{\"symbol\":\"BTCUSDT\",\"price\":\"87478.90000000\"}";
+
+static const char* CHUNKED_RESPONSE =
+    "HTTP/1.1 200 OK\r\n"
+    "transfer-encoding: Chunked\r\n"
+    "\r\n"
+    "10;ext=1\r\n"
+    "{\"data\":{\"amount\r\n"
+    "1a\r\n"
+    "\":\"87409.7\",\"base\":\"BTC\"}}\r\n"
+    "0\r\n"
+    "X-Trailer: yes\r\n"
+    "\r\n";
+
+static const char* CHUNKED_BODY = "{\"data\":{\"amount\":\"87409.7\",\"base\":\"BTC\"}}";
+
+void test_content_length_complete_without_close() {
+    HttpResponseParser p;
+    size_t n = feed_all(&p, CONTENT_LENGTH_RESPONSE);
+    TEST_ASSERT_EQUAL(strlen(CONTENT_LENGTH_RESPONSE), n);
+    TEST_ASSERT_TRUE(http_parser_done(&p));
+    TEST_ASSERT_TRUE(http_parser_keep_alive(&p));
+    TEST_ASSERT_EQUAL(200, p.status_code);
+    TEST_ASSERT_EQUAL(45, p.content_length);
+    TEST_ASSERT_EQUAL_STRING("{\"symbol\":\"BTCUSDT\",\"price\":\"87478.90000000\"}", g_body);
+}
+
+void test_content_length_bytewise() {
+    HttpResponseParser p;
+    feed_bytewise(&p, CONTENT_LENGTH_RESPONSE);
+    TEST_ASSERT_TRUE(http_parser_done(&p));
+    TEST_ASSERT_EQUAL(45, g_body_len);
+}
+
+void test_not_done_until_last_byte() {
+    HttpResponseParser p;
+    size_t len = strlen(CONTENT_LENGTH_RESPONSE);
+    g_body_len = 0;
+    http_parser_init(&p);
+    http_parser_feed(&p, (const uint8_t*)CONTENT_LENGTH_RESPONSE, len - 1, collect, nullptr);
+    TEST_ASSERT_FALSE(http_parser_done(&p));
+    http_parser_feed(&p, (const uint8_t*)CONTENT_LENGTH_RESPONSE + len - 1, 1, collect, nullptr);
+    TEST_ASSERT_TRUE(http_parser_done(&p));
+}
+
+void test_chunked_with_extension_and_trailer() {
+    HttpResponseParser p;
+    feed_all(&p, CHUNKED_RESPONSE);
+    TEST_ASSERT_TRUE(http_parser_done(&p));
+    TEST_ASSERT_TRUE(p.chunked);
+    TEST_ASSERT_TRUE(http_parser_keep_alive(&p));
+    TEST_ASSERT_EQUAL_STRING(CHUNKED_BODY, g_body);
+}
+
+void test_chunked_bytewise() {
+    HttpResponseParser p;
+    size_t n = feed_bytewise(&p, CHUNKED_RESPONSE);
+    TEST_ASSERT_EQUAL(strlen(CHUNKED_RESPONSE), n);
+    TEST_ASSERT_TRUE(http_parser_done(&p));
+    TEST_ASSERT_EQUAL_STRING(CHUNKED_BODY, g_body);
+}
+
+void test_chunked_bad_size_is_error() {
+    HttpResponseParser p;
+    feed_all(&p, "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\nzz\r\n");
+    TEST_ASSERT_TRUE(http_parser_failed(&p));
+}
+
+void test_chunked_missing_crlf_is_error() {
+    HttpResponseParser p;
+    feed_all(&p, "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n2\r\nabXX\r\n");
+    TEST_ASSERT_TRUE(http_parser_failed(&p));
+}
+
+void test_close_delimited_body() {
+    HttpResponseParser p;
+    feed_all(&p, "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\n\r\nhello ");
+    TEST_ASSERT_FALSE(http_parser_done(&p));
+    http_parser_feed(&p, (const uint8_t*)"world", 5, collect, nullptr);
+    http_parser_eof(&p);
+    TEST_ASSERT_TRUE(http_parser_done(&p));
+    TEST_ASSERT_FALSE(http_parser_keep_alive(&p));
+    TEST_ASSERT_EQUAL_STRING("hello world", g_body);
+}
+
+void test_eof_mid_body_is_error() {
+    HttpResponseParser p;
+    feed_all(&p, "HTTP/1.1 200 OK\r\nContent-Length: 10\r\n\r\nabc");
+    http_parser_eof(&p);
+    TEST_ASSERT_TRUE(http_parser_failed(&p));
+}
+
+void test_connection_close_header() {
+    HttpResponseParser p;
+    feed_all(&p, "HTTP/1.1 200 OK\r\nCONNECTION: Close\r\nContent-Length: 2\r\n\r\nok");
+    TEST_ASSERT_TRUE(http_parser_done(&p));
+    TEST_ASSERT_FALSE(http_parser_keep_alive(&p));
+}
+
+void test_http10_defaults_to_close() {
+    HttpResponseParser p;
+    feed_all(&p, "HTTP/1.0 200 OK\r\nContent-Length: 2\r\n\r\nok");
+    TEST_ASSERT_FALSE(http_parser_keep_alive(&p));
+    feed_all(&p, "HTTP/1.0 200 OK\r\nConnection: keep-alive\r\nContent-Length: 2\r\n\r\nok");
+    TEST_ASSERT_TRUE(http_parser_keep_alive(&p));
+}
+
+void test_status_without_reason_phrase() {
+    HttpResponseParser p;
+    feed_all(&p, "HTTP/1.1 200\r\nContent-Length: 0\r\n\r\n");
+    TEST_ASSERT_TRUE(http_parser_done(&p));
+    TEST_ASSERT_EQUAL(200, p.status_code);
+    TEST_ASSERT_EQUAL(0, g_body_len);
+}
+
+void test_non_200_body_consumed_not_delivered() {
+    HttpResponseParser p;
+    const char* resp = "HTTP/1.1 429 Too Many Requests\r\nContent-Length: 20\r\n\r\n{\"code\":-1003,\"x\":1}";
+    size_t n = feed_all(&p, resp);
+    TEST_ASSERT_EQUAL(strlen(resp), n);
+    TEST_ASSERT_TRUE(http_parser_done(&p));
+    TEST_ASSERT_TRUE(http_parser_keep_alive(&p));
+    TEST_ASSERT_EQUAL(429, p.status_code);
+    TEST_ASSERT_EQUAL(0, g_body_len);
+    TEST_ASSERT_EQUAL(20, p.body_bytes);
+}
+
+void test_interim_100_continue_skipped() {
+    HttpResponseParser p;
+    feed_all(&p, "HTTP/1.1 100 Continue\r\n\r\nHTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok");
+    TEST_ASSERT_TRUE(http_parser_done(&p));
+    TEST_ASSERT_EQUAL(200, p.status_code);
+    TEST_ASSERT_EQUAL_STRING("ok", g_body);
+}
+
+void test_malformed_status_line() {
+    HttpResponseParser p;
+    feed_all(&p, "garbage\r\n\r\n");
+    TEST_ASSERT_TRUE(http_parser_failed(&p));
+    feed_all(&p, "HTTP/1.1 abc OK\r\n\r\n");
+    TEST_ASSERT_TRUE(http_parser_failed(&p));
+}
+
+void test_long_header_line_skipped() {
+    char resp[600];
+    char cookie[300];
+    memset(cookie, 'c', sizeof(cookie) - 1);
+    cookie[sizeof(cookie) - 1] = '\0';
+    snprintf(resp, sizeof(resp), "HTTP/1.1 200 OK\r\nSet-Cookie: %s\r\nContent-Length: 2\r\n\r\nok", cookie);
+
+    HttpResponseParser p;
+    feed_all(&p, resp);
+    TEST_ASSERT_TRUE(http_parser_done(&p));
+    TEST_ASSERT_EQUAL_STRING("ok", g_body);
+}
+
+void test_trailing_bytes_not_consumed() {
+    HttpResponseParser p;
+    const char* two = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nokHTTP/1.1 200 OK\r\n";
+    size_t n = feed_all(&p, two);
+    TEST_ASSERT_EQUAL(strlen(two) - strlen("HTTP/1.1 200 OK\r\n"), n);
+    TEST_ASSERT_EQUAL_STRING("ok", g_body);
+}
+
+void test_callback_abort() {
+    HttpResponseParser p;
+    http_parser_init(&p);
+    http_parser_feed(&p, (const uint8_t*)CONTENT_LENGTH_RESPONSE, strlen(CONTENT_LENGTH_RESPONSE),
+                     abort_cb, nullptr);
+    TEST_ASSERT_TRUE(http_parser_failed(&p));
+    TEST_ASSERT_TRUE(p.aborted);
+}
+
+// Serves a canned stream in fixed segments, then reports close or stalls
+class SegmentSource : public HttpByteSource {
+public:
+    SegmentSource(const char* d, size_t seg, bool close_at_end)
+        : data(d), len(strlen(d)), pos(0), segment(seg), close(close_at_end), clock(0), ms_per_read(0) {}
+
+    int read_some(uint8_t* buf, size_t want) {
+        if (pos >= len) return close ? -1 : 0;
+        clock += ms_per_read;
+        size_t n = want < segment ? want : segment;
+        if (n > len - pos) n = len - pos;
+        memcpy(buf, data + pos, n);
+        pos += n;
+        return (int)n;
+    }
+
+    void idle() { clock++; }
+    uint32_t now_ms() { return clock; }
+
+    const char* data;
+    size_t len;
+    size_t pos;
+    size_t segment;
+    bool close;
+    uint32_t clock;
+    uint32_t ms_per_read;   // Server trickling: each segment costs this much time
+};
+
+void test_read_response_keep_alive_no_fin() {
+    SegmentSource src(CONTENT_LENGTH_RESPONSE, 13, false);
+    HttpResponseParser p;
+    http_parser_init(&p);
+    uint8_t scratch[32];
+    g_body_len = 0;
+
+    HttpReadResult r = http_read_response(src, &p, collect, nullptr, scratch, sizeof(scratch), 0, 1000);
+    TEST_ASSERT_EQUAL(HTTP_READ_OK, r);
+    TEST_ASSERT_EQUAL(0, src.clock);  // Never waited for the server to close
+    TEST_ASSERT_EQUAL(45, g_body_len);
+}
+
+void test_read_response_timeout_and_truncation() {
+    HttpResponseParser p;
+    uint8_t scratch[32];
+    const char* partial = "HTTP/1.1 200 OK\r\nContent-Length: 10\r\n\r\nabc";
+
+    SegmentSource stall(partial, 512, false);
+    http_parser_init(&p);
+    TEST_ASSERT_EQUAL(HTTP_READ_TIMEOUT,
+                      http_read_response(stall, &p, collect, nullptr, scratch, sizeof(scratch), 0, 20));
+
+    SegmentSource closed(partial, 512, true);
+    http_parser_init(&p);
+    TEST_ASSERT_EQUAL(HTTP_READ_CLOSED,
+                      http_read_response(closed, &p, collect, nullptr, scratch, sizeof(scratch), 0, 20));
+}
+
+// One byte per millisecond never idles, but still hits the deadline
+void test_read_response_trickle_times_out() {
+    char stream[256];
+    int n = snprintf(stream, sizeof(stream), "HTTP/1.1 200 OK\r\nContent-Length: 150\r\n\r\n");
+    memset(stream + n, 'x', 150);
+    stream[n + 150] = '\0';
+    HttpResponseParser p;
+    uint8_t scratch[32];
+
+    SegmentSource slow(stream, 1, false);
+    slow.ms_per_read = 1;
+    http_parser_init(&p);
+    TEST_ASSERT_EQUAL(HTTP_READ_TIMEOUT,
+                      http_read_response(slow, &p, collect, nullptr, scratch, sizeof(scratch), 0, 100));
+    TEST_ASSERT_TRUE(slow.pos < slow.len);
+    TEST_ASSERT_TRUE(slow.clock <= 101);
+
+    // Same trickle inside the deadline completes
+    SegmentSource in_time(stream, 1, false);
+    in_time.ms_per_read = 1;
+    http_parser_init(&p);
+    TEST_ASSERT_EQUAL(HTTP_READ_OK,
+                      http_read_response(in_time, &p, collect, nullptr, scratch, sizeof(scratch), 0, 1000));
+}
+
+// Body lands in a fixed buffer; reads stop at Content-Length (the next
+// keep-alive response stays unread)
+void test_read_response_bulk_into_buffer_sink() {
+    char stream[256];
+    snprintf(stream, sizeof(stream), "%sHTTP/1.1 200 OK\r\n", CONTENT_LENGTH_RESPONSE);
+    SegmentSource src(stream, 7, false);
+    HttpResponseParser p;
+    http_parser_init(&p);
+    char buf[64];
+    HttpBufferSink sink(buf, sizeof(buf));
+    uint8_t scratch[16];
+
+    TEST_ASSERT_EQUAL(HTTP_READ_OK, http_read_response(src, &p, http_buffer_sink, &sink,
+                                                       scratch, sizeof(scratch), 0, 1000));
+    TEST_ASSERT_EQUAL_STRING("{\"symbol\":\"BTCUSDT\",\"price\":\"87478.90000000\"}", buf);
+    TEST_ASSERT_EQUAL(45, sink.len);
+    TEST_ASSERT_EQUAL(strlen(CONTENT_LENGTH_RESPONSE), src.pos);
+}
+
+void test_buffer_sink_overflow_aborts() {
+    SegmentSource src(CONTENT_LENGTH_RESPONSE, 512, false);
+    HttpResponseParser p;
+    http_parser_init(&p);
+    char buf[16];
+    HttpBufferSink sink(buf, sizeof(buf));
+    uint8_t scratch[8];
+
+    TEST_ASSERT_EQUAL(HTTP_READ_ABORTED, http_read_response(src, &p, http_buffer_sink, &sink,
+                                                            scratch, sizeof(scratch), 0, 1000));
+    TEST_ASSERT_TRUE(sink.overflow);
+    TEST_ASSERT_EQUAL('\0', buf[sink.len]);
+}
+
+int run_http_parser_tests() {
+    UNITY_BEGIN();
+
+    // Content-Length framing
+    RUN_TEST(test_content_length_complete_without_close);
+    RUN_TEST(test_content_length_bytewise);
+    RUN_TEST(test_not_done_until_last_byte);
+
+    // Chunked framing
+    RUN_TEST(test_chunked_with_extension_and_trailer);
+    RUN_TEST(test_chunked_bytewise);
+    RUN_TEST(test_chunked_bad_size_is_error);
+    RUN_TEST(test_chunked_missing_crlf_is_error);
+
+    // Close-delimited framing
+    RUN_TEST(test_close_delimited_body);
+    RUN_TEST(test_eof_mid_body_is_error);
+
+    // Connection reuse rules
+    RUN_TEST(test_connection_close_header);
+    RUN_TEST(test_http10_defaults_to_close);
+
+    // Status line / headers
+    RUN_TEST(test_status_without_reason_phrase);
+    RUN_TEST(test_non_200_body_consumed_not_delivered);
+    RUN_TEST(test_interim_100_continue_skipped);
+    RUN_TEST(test_malformed_status_line);
+    RUN_TEST(test_long_header_line_skipped);
+
+    // Stream boundaries
+    RUN_TEST(test_trailing_bytes_not_consumed);
+    RUN_TEST(test_callback_abort);
+
+    // Reading from a byte source
+    RUN_TEST(test_read_response_keep_alive_no_fin);
+    RUN_TEST(test_read_response_timeout_and_truncation);
+    RUN_TEST(test_read_response_trickle_times_out);
+    RUN_TEST(test_read_response_bulk_into_buffer_sink);
+    RUN_TEST(test_buffer_sink_overflow_aborts);
+
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    run_http_parser_tests();
+}
+
+void loop() {
+    // Tests run once in setup
+}
+#else
+int main() {
+    return run_http_parser_tests();
+}
+#endif
@@ -0,0 +1,269 @@
+/**
+ * @file test_jobs.cpp
+ * @brief Unit tests for the deadline-ordered job queue (app_jobs)
+ *
+ * A virtual clock stands in for millis(): the simulated task sleeps
+ * exactly job_queue_wait_ms() and each job "runs" for a set time.
+ *
+ * Tests cover:
+ * - Heap order: deadline, then priority; cancel and re-arm
+ * - Periodic jobs run exactly on their deadlines, no idle wakeups
+ * - Slow runs keep the phase and do not replay missed periods
+ * - Period changes (config change) keep the last start
+ * - One-shot jobs re-armed by the caller (funding epochs)
+ * - millis() wrap-around
+ */
+
+#include <unity.h>
+#include <app/app_jobs.h>
+#include <stdlib.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+
+static const uint32_t SECOND = 1000;
+static const uint32_t MINUTE = 60 * SECOND;
+
+static JobQueue q;
+
+// Simulated net_task: virtual clock, run log and per-type run time
+struct Sim {
+    uint32_t now;
+    uint32_t cost[JOB_TYPE_COUNT];
+    uint32_t runs[JOB_TYPE_COUNT][256];
+    int num_runs[JOB_TYPE_COUNT];
+    int wakeups;
+    int idle_wakeups;
+};
+
+static Sim sim;
+
+// Run the task loop for duration_ms of virtual time
+static void sim_run(uint32_t duration_ms) {
+    uint32_t end = sim.now + duration_ms;
+    while ((int32_t)(end - sim.now) > 0) {
+        uint32_t wait = job_queue_wait_ms(&q, sim.now);
+        if (wait == JOB_WAIT_FOREVER || wait >= end - sim.now) {
+            sim.now = end;
+            return;
+        }
+        sim.now += wait;
+        sim.wakeups++;
+
+        Job job;
+        bool ran = false;
+        while ((int32_t)(end - sim.now) > 0 && job_queue_pop_due(&q, sim.now, &job)) {
+            int& n = sim.num_runs[job.type];
+            if (n < 256) {
+                sim.runs[job.type][n] = sim.now;
+            }
+            n++;
+            sim.now += sim.cost[job.type];
+            ran = true;
+        }
+        if (!ran) {
+            sim.idle_wakeups++;
+        }
+    }
+}
+
+void setUp() {
+    job_queue_init(&q);
+    sim = Sim();
+}
+
+void tearDown() {}
+
+void test_empty_queue_waits_forever() {
+    Job job;
+    TEST_ASSERT_EQUAL_UINT32(JOB_WAIT_FOREVER, job_queue_wait_ms(&q, 1234));
+    TEST_ASSERT_FALSE(job_queue_pop_due(&q, 1234, &job));
+    TEST_ASSERT_FALSE(job_queue_armed(&q, JOB_PRICES));
+    TEST_ASSERT_FALSE(job_queue_schedule(&q, JOB_TYPE_COUNT, 0, 0, 0));
+}
+
+void test_order_by_deadline_then_priority() {
+    job_queue_schedule(&q, JOB_STABILITY_LOG, 3, 500, 0);
+    job_queue_schedule(&q, JOB_FUNDING, 1, 200, 0);
+    job_queue_schedule(&q, JOB_STALE_CHECK, 2, 200, 0);
+    job_queue_schedule(&q, JOB_PRICES, 0, 300, 0);
+
+    TEST_ASSERT_EQUAL_UINT32(100, job_queue_wait_ms(&q, 100));
+    TEST_ASSERT_EQUAL_UINT32(200, job_queue_wait_type_ms(&q, JOB_PRICES, 100));
+
+    Job job;
+    TEST_ASSERT_FALSE(job_queue_pop_due(&q, 199, &job));
+    const uint8_t expected[] = { JOB_FUNDING, JOB_STALE_CHECK, JOB_PRICES, JOB_STABILITY_LOG };
+    for (int k = 0; k < 4; k++) {
+        TEST_ASSERT_TRUE(job_queue_pop_due(&q, 1000, &job));
+        TEST_ASSERT_EQUAL(expected[k], job.type);
+    }
+    TEST_ASSERT_FALSE(job_queue_pop_due(&q, 1000, &job));
+}
+
+void test_cancel_and_rearm_keep_heap_order() {
+    srand(7);
+    for (int round = 0; round < 200; round++) {
+        job_queue_init(&q);
+        bool armed[JOB_TYPE_COUNT] = {};
+        uint32_t deadline[JOB_TYPE_COUNT] = {};
+        for (int op = 0; op < 12; op++) {
+            JobType type = (JobType)(rand() % JOB_TYPE_COUNT);
+            if (rand() % 4 == 0) {
+                job_queue_cancel(&q, type);
+                armed[type] = false;
+            } else {
+                deadline[type] = (uint32_t)(rand() % 1000);
+                job_queue_schedule(&q, type, (uint8_t)type, deadline[type], 0);
+                armed[type] = true;
+            }
+        }
+        // Pops come out sorted and cover exactly the armed types
+        Job job;
+        uint32_t last = 0;
+        int popped = 0;
+        while (job_queue_pop_due(&q, 1000, &job)) {
+            TEST_ASSERT_TRUE(armed[job.type]);
+            TEST_ASSERT_EQUAL_UINT32(deadline[job.type], job.deadline_ms);
+            TEST_ASSERT_TRUE(job.deadline_ms >= last);
+            last = job.deadline_ms;
+            armed[job.type] = false;
+            popped++;
+        }
+        for (int t = 0; t < JOB_TYPE_COUNT; t++) {
+            TEST_ASSERT_FALSE(armed[t]);
+        }
+        TEST_ASSERT_EQUAL(0, q.size);
+        (void)popped;
+    }
+}
+
+void test_periodic_jobs_run_on_deadline() {
+    job_queue_schedule(&q, JOB_PRICES, 0, 0, 5 * SECOND);
+    job_queue_schedule(&q, JOB_STABILITY_LOG, 3, MINUTE, MINUTE);
+    sim.cost[JOB_PRICES] = 1200;                // A fetch takes a while
+
+    sim_run(10 * MINUTE);
+
+    TEST_ASSERT_EQUAL(120, sim.num_runs[JOB_PRICES]);
+    for (int k = 0; k < sim.num_runs[JOB_PRICES]; k++) {
+        TEST_ASSERT_EQUAL_UINT32(k * 5 * SECOND, sim.runs[JOB_PRICES][k]);
+    }
+    // The log shares a deadline with a price fetch every minute: runs after it
+    TEST_ASSERT_EQUAL(9, sim.num_runs[JOB_STABILITY_LOG]);
+    TEST_ASSERT_EQUAL_UINT32(MINUTE + 1200, sim.runs[JOB_STABILITY_LOG][0]);
+
+    // Woken only when something was due
+    TEST_ASSERT_EQUAL(0, sim.idle_wakeups);
+    TEST_ASSERT_EQUAL(120, sim.wakeups);
+}
+
+void test_slow_runs_do_not_replay_missed_periods() {
+    job_queue_schedule(&q, JOB_PRICES, 0, 0, 5 * SECOND);
+    sim.cost[JOB_PRICES] = 7 * SECOND;          // Slower than its period
+
+    sim_run(MINUTE);
+    // Back to back, one run per 7 s, no burst of catch-up runs
+    int slow_runs = sim.num_runs[JOB_PRICES];
+    TEST_ASSERT_EQUAL(9, slow_runs);
+    for (int k = 1; k < slow_runs; k++) {
+        TEST_ASSERT_EQUAL_UINT32(7 * SECOND, sim.runs[JOB_PRICES][k] - sim.runs[JOB_PRICES][k - 1]);
+    }
+
+    // Fast again: back on the original 5 s grid
+    sim.cost[JOB_PRICES] = 100;
+    sim_run(MINUTE);
+    int n = sim.num_runs[JOB_PRICES];
+    TEST_ASSERT_EQUAL_UINT32(0, sim.runs[JOB_PRICES][n - 1] % (5 * SECOND));
+    TEST_ASSERT_EQUAL_UINT32(0, sim.runs[JOB_PRICES][n - 2] % (5 * SECOND));
+}
+
+void test_interval_change_keeps_last_start() {
+    job_queue_schedule(&q, JOB_PRICES, 0, 0, 5 * SECOND);
+    sim_run(7 * SECOND);                        // Ran at 0 and 5 s
+    TEST_ASSERT_EQUAL(2, sim.num_runs[JOB_PRICES]);
+
+    // Faster: last start 5 s + 2 s = now, runs at once
+    job_queue_set_interval(&q, JOB_PRICES, 2 * SECOND, sim.now);
+    TEST_ASSERT_EQUAL_UINT32(0, job_queue_wait_ms(&q, sim.now));
+    sim_run(5 * SECOND);                        // 7, 9, 11 s
+    TEST_ASSERT_EQUAL(5, sim.num_runs[JOB_PRICES]);
+    TEST_ASSERT_EQUAL_UINT32(11 * SECOND, sim.runs[JOB_PRICES][4]);
+
+    // Slower: last start 11 s + 10 s
+    job_queue_set_interval(&q, JOB_PRICES, 10 * SECOND, sim.now);
+    TEST_ASSERT_EQUAL_UINT32(9 * SECOND, job_queue_wait_ms(&q, sim.now));
+
+    // Already overdue under the new period: due now, not in the past
+    job_queue_set_interval(&q, JOB_PRICES, SECOND, sim.now);
+    TEST_ASSERT_EQUAL_UINT32(sim.now, q.jobs[JOB_PRICES].deadline_ms);
+}
+
+void test_one_shot_rearmed_by_caller() {
+    job_queue_schedule(&q, JOB_FUNDING, 1, 3 * SECOND, 0);
+    Job job;
+    TEST_ASSERT_TRUE(job_queue_pop_due(&q, 3 * SECOND, &job));
+    TEST_ASSERT_FALSE(job_queue_armed(&q, JOB_FUNDING));
+
+    // Next funding epoch reported by the exchange
+    job_queue_schedule(&q, JOB_FUNDING, 1, 8 * 60 * MINUTE, 0);
+    TEST_ASSERT_EQUAL_UINT32(8 * 60 * MINUTE - 3 * SECOND, job_queue_wait_ms(&q, 3 * SECOND));
+
+    // Re-arming an armed job moves it (earlier here)
+    job_queue_schedule(&q, JOB_FUNDING, 1, 4 * SECOND, 0);
+    TEST_ASSERT_EQUAL_UINT32(SECOND, job_queue_wait_ms(&q, 3 * SECOND));
+    TEST_ASSERT_EQUAL(1, q.size);
+}
+
+void test_millis_wraparound() {
+    sim.now = 0xFFFFFFFFu - 12 * SECOND + 1;
+    job_queue_schedule(&q, JOB_PRICES, 0, sim.now, 5 * SECOND);
+    job_queue_schedule(&q, JOB_STALE_CHECK, 2, sim.now + 30 * SECOND, 0);   // Past the wrap
+
+    // The deadline past the wrap is later, not earlier
+    Job job;
+    TEST_ASSERT_TRUE(job_queue_pop_due(&q, sim.now, &job));
+    TEST_ASSERT_EQUAL(JOB_PRICES, job.type);
+
+    sim.now += 1;
+    sim_run(40 * SECOND);
+    TEST_ASSERT_EQUAL(8, sim.num_runs[JOB_PRICES]);
+    for (int k = 1; k < sim.num_runs[JOB_PRICES]; k++) {
+        TEST_ASSERT_EQUAL_UINT32(5 * SECOND, sim.runs[JOB_PRICES][k] - sim.runs[JOB_PRICES][k - 1]);
+    }
+    TEST_ASSERT_EQUAL(1, sim.num_runs[JOB_STALE_CHECK]);
+    TEST_ASSERT_EQUAL(0, sim.idle_wakeups);
+}
+
+int run_jobs_tests() {
+    UNITY_BEGIN();
+
+    // Queue
+    RUN_TEST(test_empty_queue_waits_forever);
+    RUN_TEST(test_order_by_deadline_then_priority);
+    RUN_TEST(test_cancel_and_rearm_keep_heap_order);
+
+    // Virtual clock
+    RUN_TEST(test_periodic_jobs_run_on_deadline);
+    RUN_TEST(test_slow_runs_do_not_replay_missed_periods);
+    RUN_TEST(test_interval_change_keeps_last_start);
+    RUN_TEST(test_one_shot_rearmed_by_caller);
+    RUN_TEST(test_millis_wraparound);
+
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    run_jobs_tests();
+}
+
+void loop() {
+    // Tests run once in setup
+}
+#else
+int main() {
+    return run_jobs_tests();
+}
+#endif
@@ -0,0 +1,117 @@
+/**
+ * @file test_json_scan.cpp
+ * @brief Unit tests for the in-place field extractor (net_json_scan)
+ *
+ * Tests cover:
+ * - Body shape check (enclosing brackets, escapes)
+ * - Member lookup: names vs equal values, whitespace, non-string values
+ * - Fixed-point member values
+ * - Symbol byte compare
+ */
+
+#include <unity.h>
+#include <net/net_json_scan.h>
+#include <stdlib.h>
+#include <string.h>
+
+static char shape(const char* body) {
+    return json_scan_shape(body, strlen(body));
+}
+
+static const char* find(const char* body, const char* key, size_t* len) {
+    return json_scan_string(body, strlen(body), key, len);
+}
+
+void test_shape() {
+    TEST_ASSERT_EQUAL('{', shape("{\"symbol\":\"BTCUSDT\",\"price\":\"1.5\"}"));
+    TEST_ASSERT_EQUAL('[', shape("  [{\"symbol\":\"BTCUSDT\"}]\r\n"));
+
+    // Truncated, empty, escaped or not a container
+    TEST_ASSERT_EQUAL(0, shape("{\"symbol\":\"BTCUSDT\",\"price\":\"1.5\""));
+    TEST_ASSERT_EQUAL(0, shape(""));
+    TEST_ASSERT_EQUAL(0, shape("{"));
+    TEST_ASSERT_EQUAL(0, shape("{\"symbol\":\"BTC\\\"USDT\"}"));
+    TEST_ASSERT_EQUAL(0, shape("\"price\""));
+    TEST_ASSERT_EQUAL(0, shape("{\"a\":1]"));
+}
+
+void test_find_member() {
+    const char* body = "{\"symbol\":\"BTCUSDT\",\"price\" : \"43250.50000000\"}";
+    size_t len = 0;
+    const char* value = find(body, "price", &len);
+    TEST_ASSERT_NOT_NULL(value);
+    TEST_ASSERT_EQUAL(14, len);
+    TEST_ASSERT_EQUAL_PTR(strstr(body, "43250"), value);     // Points into the body
+    TEST_ASSERT_EQUAL(0, strncmp(value, "43250.50000000", len));
+
+    // Nested member
+    const char* nested = "{\"data\":{\"base\":\"BTC\",\"currency\":\"USD\",\"amount\":\"43245.75\"}}";
+    value = find(nested, "amount", &len);
+    TEST_ASSERT_NOT_NULL(value);
+    TEST_ASSERT_EQUAL(0, strncmp(value, "43245.75", len));
+
+    // Missing, prefix of another name
+    TEST_ASSERT_NULL(find(body, "bidPrice", &len));
+    TEST_ASSERT_NULL(find(body, "pri", &len));
+}
+
+void test_value_equal_to_name_is_skipped() {
+    // "price" appears as a value first: only a name followed by ':' matches
+    const char* body = "{\"note\":\"price\",\"price\":\"2.5\"}";
+    size_t len = 0;
+    const char* value = find(body, "price", &len);
+    TEST_ASSERT_NOT_NULL(value);
+    TEST_ASSERT_EQUAL(0, strncmp(value, "2.5", len));
+}
+
+void test_non_string_value_rejected() {
+    size_t len = 0;
+    TEST_ASSERT_NULL(find("{\"price\":43250.5}", "price", &len));
+    TEST_ASSERT_NULL(find("{\"price\":null}", "price", &len));
+    TEST_ASSERT_NULL(find("{\"price\":{\"v\":\"1\"}}", "price", &len));
+    TEST_ASSERT_NULL(find("{\"price\":\"43250.5", "price", &len));
+}
+
+void test_equals_and_fixed_field() {
+    const char* body = "[{\"symbol\":\"BTCUSDT\",\"fundingTime\":1700000000000,\"fundingRate\":\"-0.00012000\"}]";
+    size_t len = strlen(body);
+    TEST_ASSERT_TRUE(json_scan_equals(body, len, "symbol", "BTCUSDT"));
+    TEST_ASSERT_FALSE(json_scan_equals(body, len, "symbol", "BTCUSD"));
+    TEST_ASSERT_FALSE(json_scan_equals(body, len, "symbol", "BTCUSDTX"));
+    TEST_ASSERT_FALSE(json_scan_equals(body, len, "symbol", nullptr));
+
+    Fixed rate = 0;
+    TEST_ASSERT_TRUE(json_scan_fixed_field(body, len, "fundingRate", &rate));
+    TEST_ASSERT_TRUE(rate == -12000);
+    TEST_ASSERT_FALSE(json_scan_fixed_field(body, len, "fundingTime", &rate));
+    TEST_ASSERT_FALSE(json_scan_fixed_field(body, len, "missing", &rate));
+}
+
+int run_json_scan_tests() {
+    UNITY_BEGIN();
+
+    // Lookup
+    RUN_TEST(test_shape);
+    RUN_TEST(test_find_member);
+    RUN_TEST(test_value_equal_to_name_is_skipped);
+    RUN_TEST(test_non_string_value_rejected);
+
+    // Conversion
+    RUN_TEST(test_equals_and_fixed_field);
+
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    run_json_scan_tests();
+}
+
+void loop() {
+    // Tests run once in setup
+}
+#else
+int main() {
+    return run_json_scan_tests();
+}
+#endif
@@ -0,0 +1,232 @@
+/**
+ * @file test_json_stream.cpp
+ * @brief Unit tests for the incremental JSON tokenizer (net_json_stream)
+ *
+ * Documents are fed both in one piece and one byte at a time; the token
+ * sequence is recorded as a compact trace and compared.
+ *
+ * Tests cover:
+ * - Objects, arrays, nesting, member names and depths
+ * - Strings with escapes, numbers and literals
+ * - Empty containers
+ * - Over-long values (truncated) and nesting limit
+ * - Malformed input and callback stop
+ */
+
+#include <unity.h>
+#include <net/net_json_stream.h>
+#include <stdio.h>
+#include <string.h>
+
+static char g_trace[1024];
+static size_t g_trace_len;
+static int g_stop_after;  // Stop after this many tokens (0 = never)
+static int g_tokens;
+static bool g_truncated;
+
+static void trace(const char* s) {
+    g_trace_len += snprintf(g_trace + g_trace_len, sizeof(g_trace) - g_trace_len, "%s", s);
+}
+
+// Trace format: "{" "}" "[" "]" for containers, key= before members,
+// s:/n:/t/f/z for string, number, true, false, null values, then the depth
+static bool record(const JsonStreamToken* tok, void* ctx) {
+    (void)ctx;
+    char buf[96];
+    const char* key = tok->key ? tok->key : "";
+    const char* eq = tok->key ? "=" : "";
+    switch (tok->event) {
+        case JSON_EVENT_OBJECT_START: snprintf(buf, sizeof(buf), "%s%s{", key, eq); break;
+        case JSON_EVENT_OBJECT_END: snprintf(buf, sizeof(buf), "}"); break;
+        case JSON_EVENT_ARRAY_START: snprintf(buf, sizeof(buf), "%s%s[", key, eq); break;
+        case JSON_EVENT_ARRAY_END: snprintf(buf, sizeof(buf), "]"); break;
+        case JSON_EVENT_VALUE: {
+            const char* type = tok->type == JSON_TYPE_STRING ? "s:" :
+                               tok->type == JSON_TYPE_NUMBER ? "n:" :
+                               tok->type == JSON_TYPE_TRUE ? "t" :
+                               tok->type == JSON_TYPE_FALSE ? "f" : "z";
+            bool scalar_text = tok->type == JSON_TYPE_STRING || tok->type == JSON_TYPE_NUMBER;
+            snprintf(buf, sizeof(buf), "%s%s%s%s%s%d ", key, eq, type, scalar_text ? tok->value : "",
+                     scalar_text ? " " : "", tok->depth);
+            break;
+        }
+    }
+    trace(buf);
+    if (tok->truncated) g_truncated = true;
+    g_tokens++;
+    return g_stop_after == 0 || g_tokens < g_stop_after;
+}
+
+static void reset_trace() {
+    g_trace_len = 0;
+    g_trace[0] = '\0';
+    g_tokens = 0;
+    g_truncated = false;
+}
+
+static bool parse_whole(JsonStreamParser* p, const char* doc) {
+    reset_trace();
+    json_stream_init(p, record, nullptr);
+    return json_stream_feed(p, doc, strlen(doc));
+}
+
+static bool parse_bytewise(JsonStreamParser* p, const char* doc) {
+    reset_trace();
+    json_stream_init(p, record, nullptr);
+    bool ok = true;
+    for (size_t i = 0; doc[i] && ok; i++) {
+        ok = json_stream_feed(p, doc + i, 1);
+    }
+    return ok;
+}
+
+void setUp() {
+    g_stop_after = 0;
+}
+
+void tearDown() {}
+
+static const char* PREMIUM_DOC =
+    "[{\"symbol\":\"BTCUSDT\",\"markPrice\":\"43260.1\",\"lastFundingRate\":\"0.00010000\","
+    "\"nextFundingTime\":1597392000000,\"time\":1597370495002},\n"
+    " {\"symbol\":\"ETHUSDT\", \"markPrice\" : \"2245.3\", \"nested\":{\"a\":[1,-2.5e3]}}]";
+
+static const char* PREMIUM_TRACE =
+    "[{symbol=s:BTCUSDT 2 markPrice=s:43260.1 2 lastFundingRate=s:0.00010000 2 "
+    "nextFundingTime=n:1597392000000 2 time=n:1597370495002 2 }"
+    "{symbol=s:ETHUSDT 2 markPrice=s:2245.3 2 nested={a=[n:1 4 n:-2.5e3 4 ]}}]";
+
+void test_array_of_objects() {
+    JsonStreamParser p;
+    TEST_ASSERT_TRUE(parse_whole(&p, PREMIUM_DOC));
+    TEST_ASSERT_TRUE(json_stream_done(&p));
+    TEST_ASSERT_EQUAL_STRING(PREMIUM_TRACE, g_trace);
+    TEST_ASSERT_EQUAL(strlen(PREMIUM_DOC), p.bytes);
+}
+
+void test_bytewise_matches_whole() {
+    JsonStreamParser p;
+    TEST_ASSERT_TRUE(parse_bytewise(&p, PREMIUM_DOC));
+    TEST_ASSERT_TRUE(json_stream_done(&p));
+    TEST_ASSERT_EQUAL_STRING(PREMIUM_TRACE, g_trace);
+}
+
+void test_strings_and_literals() {
+    JsonStreamParser p;
+    TEST_ASSERT_TRUE(parse_bytewise(&p,
+        "{\"q\":\"a\\\"b\\\\c\\/d\\n\",\"u\":\"\\u0041\\u00e9\",\"t\":true,\"f\":false,\"z\":null}"));
+    TEST_ASSERT_TRUE(json_stream_done(&p));
+    TEST_ASSERT_EQUAL_STRING("{q=s:a\"b\\c/d\n 1 u=s:A? 1 t=t1 f=f1 z=z1 }", g_trace);
+}
+
+void test_empty_containers() {
+    JsonStreamParser p;
+    TEST_ASSERT_TRUE(parse_whole(&p, "{\"a\":[],\"b\":{},\"c\":[{}]}"));
+    TEST_ASSERT_TRUE(json_stream_done(&p));
+    TEST_ASSERT_EQUAL_STRING("{a=[]b={}c=[{}]}", g_trace);
+
+    TEST_ASSERT_TRUE(parse_whole(&p, " [ ] "));
+    TEST_ASSERT_TRUE(json_stream_done(&p));
+}
+
+void test_trailing_bytes_ignored() {
+    JsonStreamParser p;
+    TEST_ASSERT_TRUE(parse_whole(&p, "[1,2]\r\n garbage"));
+    TEST_ASSERT_TRUE(json_stream_done(&p));
+    TEST_ASSERT_EQUAL_STRING("[n:1 1 n:2 1 ]", g_trace);
+}
+
+void test_long_value_truncated() {
+    JsonStreamParser p;
+    char doc[160];
+    char longval[100];
+    memset(longval, 'x', sizeof(longval) - 1);
+    longval[sizeof(longval) - 1] = '\0';
+    snprintf(doc, sizeof(doc), "{\"k\":\"%s\",\"n\":1}", longval);
+    TEST_ASSERT_TRUE(parse_whole(&p, doc));
+    TEST_ASSERT_TRUE(json_stream_done(&p));
+    TEST_ASSERT_TRUE(g_truncated);
+    TEST_ASSERT_NOT_NULL(strstr(g_trace, "n=n:1 1"));
+}
+
+void test_malformed_fails() {
+    const char* bad[] = {
+        "[1,]",
+        "{\"a\" 1}",
+        "{\"a\":1,}",
+        "{1:2}",
+        "[1 2]",
+        "[\"unterminated\n\"]",
+        "{\"a\":\"\\x\"}",
+        "[tru]",
+        "[1}",
+        "}",
+    };
+    JsonStreamParser p;
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        bool ok = parse_whole(&p, bad[i]);
+        TEST_ASSERT_FALSE_MESSAGE(ok && json_stream_done(&p), bad[i]);
+        TEST_ASSERT_TRUE_MESSAGE(json_stream_failed(&p), bad[i]);
+    }
+}
+
+void test_nesting_limit() {
+    char doc[2 * JSON_STREAM_DEPTH_MAX + 8];
+    size_t n = 0;
+    for (int i = 0; i < JSON_STREAM_DEPTH_MAX; i++) doc[n++] = '[';
+    for (int i = 0; i < JSON_STREAM_DEPTH_MAX; i++) doc[n++] = ']';
+    doc[n] = '\0';
+    JsonStreamParser p;
+    TEST_ASSERT_TRUE(parse_whole(&p, doc));
+    TEST_ASSERT_TRUE(json_stream_done(&p));
+
+    // One level deeper
+    char deeper[sizeof(doc) + 2];
+    snprintf(deeper, sizeof(deeper), "[%s]", doc);
+    TEST_ASSERT_FALSE(parse_whole(&p, deeper));
+}
+
+void test_callback_stop() {
+    JsonStreamParser p;
+    g_stop_after = 3;
+    TEST_ASSERT_FALSE(parse_whole(&p, PREMIUM_DOC));
+    TEST_ASSERT_TRUE(json_stream_failed(&p));
+    TEST_ASSERT_TRUE(p.aborted);
+    TEST_ASSERT_EQUAL(3, g_tokens);
+
+    // Further input is refused
+    TEST_ASSERT_FALSE(json_stream_feed(&p, "[]", 2));
+}
+
+int run_json_stream_tests() {
+    UNITY_BEGIN();
+
+    // Tokens
+    RUN_TEST(test_array_of_objects);
+    RUN_TEST(test_bytewise_matches_whole);
+    RUN_TEST(test_strings_and_literals);
+    RUN_TEST(test_empty_containers);
+    RUN_TEST(test_trailing_bytes_ignored);
+
+    // Limits and errors
+    RUN_TEST(test_long_value_truncated);
+    RUN_TEST(test_malformed_fails);
+    RUN_TEST(test_nesting_limit);
+    RUN_TEST(test_callback_stop);
+
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    run_json_stream_tests();
+}
+
+void loop() {
+    // Tests run once in setup
+}
+#else
+int main() {
+    return run_json_stream_tests();
+}
+#endif
@@ -161,7 +161,7 @@ void test_spread_both_null_pointers() {
     TEST_ASSERT_FALSE(result);
 }
 
-void setup() {
+int run_spread_tests() {
     UNITY_BEGIN();
     
     // Normal cases
@@ -191,9 +191,19 @@ void setup() {
     RUN_TEST(test_spread_null_pct_pointer);
     RUN_TEST(test_spread_both_null_pointers);
     
-    UNITY_END();
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    run_spread_tests();
 }
 
 void loop() {
     // Tests run once in setup
 }
+#else
+int main() {
+    return run_spread_tests();
+}
+#endif
@@ -0,0 +1,321 @@
+/**
+ * @file test_spread_matrix.cpp
+ * @brief Unit tests for the cross-venue spread matrix (app_spread_matrix)
+ *
+ * Tests cover:
+ * - Incremental row/column updates match a full rebuild over random ticks
+ * - Cells recomputed per tick: 2(N-1), not N^2
+ * - Widest mid spread and best executable venue pair
+ * - Better executable direction of one venue pair (spread_matrix_pair_exec)
+ * - Invalid legs, quotes without a book, crossed books
+ * - The Binance/Coinbase fields of the model (symbol_update_spreads)
+ */
+
+#include <unity.h>
+#include <app/app_spread_matrix.h>
+#include <app/app_math.h>
+#include <app/app_model.h>
+#include <stdlib.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+
+static SpreadLeg book(double bid, double ask) {
+    Fixed b = fixed_from_double(bid);
+    Fixed a = fixed_from_double(ask);
+    return spread_leg(true, fixed_mid(b, a), b, a);
+}
+
+static void assert_same_matrix(const SpreadMatrix& a, const SpreadMatrix& b) {
+    TEST_ASSERT_EQUAL_HEX(a.mid_valid, b.mid_valid);
+    TEST_ASSERT_EQUAL_HEX(a.exec_valid, b.exec_valid);
+    for (int i = 0; i < SPREAD_VENUES_MAX; i++) {
+        for (int j = 0; j < SPREAD_VENUES_MAX; j++) {
+            TEST_ASSERT_EQUAL_FLOAT(a.mid_pct[i][j], b.mid_pct[i][j]);
+            TEST_ASSERT_EQUAL_FLOAT(a.exec_pct[i][j], b.exec_pct[i][j]);
+        }
+    }
+    TEST_ASSERT_EQUAL(a.widest_valid, b.widest_valid);
+    TEST_ASSERT_EQUAL(a.widest_low, b.widest_low);
+    TEST_ASSERT_EQUAL(a.widest_high, b.widest_high);
+    TEST_ASSERT_TRUE(a.widest_abs == b.widest_abs);
+    TEST_ASSERT_EQUAL(a.best_valid, b.best_valid);
+    TEST_ASSERT_EQUAL(a.best_buy, b.best_buy);
+    TEST_ASSERT_EQUAL(a.best_sell, b.best_sell);
+    TEST_ASSERT_TRUE(a.best_abs == b.best_abs);
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_leg_requires_valid_book() {
+    SpreadLeg leg = spread_leg(false, FIXED_UNITS(100), FIXED_UNITS(99), FIXED_UNITS(101));
+    TEST_ASSERT_FALSE(leg.valid);
+    TEST_ASSERT_TRUE(leg.ask == 0);
+
+    // Reference price only (no book): mid spreads but no executable ones
+    leg = spread_leg(true, FIXED_UNITS(100), 0, 0);
+    TEST_ASSERT_TRUE(leg.valid);
+    TEST_ASSERT_TRUE(leg.bid == 0 && leg.ask == 0);
+
+    // Crossed book is dropped, the price is kept
+    leg = spread_leg(true, FIXED_UNITS(100), FIXED_UNITS(101), FIXED_UNITS(99));
+    TEST_ASSERT_TRUE(leg.valid);
+    TEST_ASSERT_TRUE(leg.bid == 0 && leg.ask == 0);
+}
+
+void test_update_recomputes_row_and_column_only() {
+    SpreadMatrix m;
+    SpreadLeg legs[3] = { book(100, 101), book(102, 103), book(104, 105) };
+    TEST_ASSERT_EQUAL(2 * (3 - 1), spread_matrix_update(&m, legs, 3, 1));
+    TEST_ASSERT_EQUAL(2, spread_matrix_update(&m, legs, 2, 0));
+
+    // Row and column of venue 1 only: the 0<->2 cells are still unset
+    SpreadMatrix fresh;
+    spread_matrix_update(&fresh, legs, 3, 1);
+    TEST_ASSERT_TRUE(spread_matrix_mid_valid(fresh, 0, 1));
+    TEST_ASSERT_TRUE(spread_matrix_mid_valid(fresh, 2, 1));
+    TEST_ASSERT_FALSE(spread_matrix_mid_valid(fresh, 0, 2));
+    TEST_ASSERT_FALSE(spread_matrix_mid_valid(fresh, 2, 0));
+
+    // Invalid arguments
+    TEST_ASSERT_EQUAL(0, spread_matrix_update(&m, legs, 3, 3));
+    TEST_ASSERT_EQUAL(0, spread_matrix_update(&m, legs, 4, 0));
+    TEST_ASSERT_EQUAL(0, spread_matrix_update(nullptr, legs, 3, 0));
+}
+
+void test_incremental_matches_rebuild() {
+    SpreadMatrix inc;
+    SpreadLeg legs[3] = { book(100, 101), book(100, 101), book(100, 101) };
+    for (int v = 0; v < 3; v++) {
+        spread_matrix_update(&inc, legs, 3, v);
+    }
+
+    srand(42);
+    for (int tick = 0; tick < 500; tick++) {
+        int v = rand() % 3;
+        int kind = rand() % 8;
+        double bid = 95.0 + (rand() % 1000) / 100.0;
+        double ask = bid + (rand() % 50) / 100.0;
+        if (kind == 0) {
+            legs[v] = spread_leg(false, 0, 0, 0);                           // Venue down
+        } else if (kind == 1) {
+            legs[v] = spread_leg(true, fixed_from_double(bid), 0, 0);      // No book
+        } else if (kind == 2) {
+            legs[v] = spread_leg(true, fixed_from_double(bid),             // Crossed
+                                 fixed_from_double(ask + 1.0), fixed_from_double(bid));
+        } else {
+            legs[v] = book(bid, ask);
+        }
+        spread_matrix_update(&inc, legs, 3, v);
+
+        SpreadMatrix full;
+        spread_matrix_rebuild(&full, legs, 3);
+        assert_same_matrix(full, inc);
+    }
+}
+
+void test_widest_is_cheapest_to_dearest() {
+    SpreadMatrix m;
+    SpreadLeg legs[3] = { book(100, 100.2), book(99, 99.2), book(101.5, 101.7) };
+    spread_matrix_rebuild(&m, legs, 3);
+
+    TEST_ASSERT_TRUE(m.widest_valid);
+    TEST_ASSERT_EQUAL(1, m.widest_low);
+    TEST_ASSERT_EQUAL(2, m.widest_high);
+    TEST_ASSERT_TRUE(m.widest_abs == fixed_from_double(2.5));
+
+    // No cell exceeds it
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            if (spread_matrix_mid_valid(m, i, j)) {
+                TEST_ASSERT_TRUE(m.mid_pct[i][j] <= m.widest_pct);
+            }
+        }
+    }
+
+    // A single valid venue has no spread
+    legs[0].valid = false;
+    legs[2].valid = false;
+    spread_matrix_rebuild(&m, legs, 3);
+    TEST_ASSERT_FALSE(m.widest_valid);
+    TEST_ASSERT_EQUAL(-1, m.widest_low);
+}
+
+void test_best_exec_lowest_ask_highest_bid() {
+    SpreadMatrix m;
+    SpreadLeg legs[3] = { book(100, 101), book(102, 102.5), book(99, 99.5) };
+    spread_matrix_rebuild(&m, legs, 3);
+
+    // Buy at 99.5 (venue 2), sell at 102 (venue 1)
+    TEST_ASSERT_TRUE(m.best_valid);
+    TEST_ASSERT_EQUAL(2, m.best_buy);
+    TEST_ASSERT_EQUAL(1, m.best_sell);
+    TEST_ASSERT_TRUE(m.best_abs == fixed_from_double(2.5));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 2.5f / 99.5f * 100.0f, m.best_pct);
+
+    // No cell beats it
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            if (spread_matrix_exec_valid(m, i, j)) {
+                TEST_ASSERT_TRUE(m.exec_pct[i][j] <= m.best_pct + 0.0001f);
+            }
+        }
+    }
+}
+
+void test_best_exec_when_one_venue_has_both_extremes() {
+    // Venue 0 has the lowest ask and the highest bid (tightest book):
+    // the round trip must use two venues
+    SpreadMatrix m;
+    SpreadLeg legs[3] = { book(100.4, 100.5), book(100, 101), book(99.8, 100.9) };
+    spread_matrix_rebuild(&m, legs, 3);
+
+    // Buy 0 sell 1: 100 - 100.5 = -0.5; buy 2 sell 0: 100.4 - 100.9 = -0.5;
+    // equal in $, the lowest ask is kept
+    TEST_ASSERT_TRUE(m.best_valid);
+    TEST_ASSERT_EQUAL(0, m.best_buy);
+    TEST_ASSERT_EQUAL(1, m.best_sell);
+
+    legs[2] = book(99.8, 100.7);    // Buy 2 sell 0: -0.3
+    spread_matrix_rebuild(&m, legs, 3);
+    TEST_ASSERT_EQUAL(2, m.best_buy);
+    TEST_ASSERT_EQUAL(0, m.best_sell);
+    TEST_ASSERT_TRUE(m.best_abs == fixed_from_double(-0.3));
+}
+
+void test_no_book_has_mid_but_no_exec() {
+    SpreadMatrix m;
+    SpreadLeg legs[3] = { book(100, 101), spread_leg(true, FIXED_UNITS(102), 0, 0),
+                          spread_leg(false, 0, 0, 0) };
+    spread_matrix_rebuild(&m, legs, 3);
+
+    TEST_ASSERT_TRUE(spread_matrix_mid_valid(m, 0, 1));
+    TEST_ASSERT_FALSE(spread_matrix_exec_valid(m, 0, 1));
+    TEST_ASSERT_FALSE(spread_matrix_mid_valid(m, 0, 2));
+    TEST_ASSERT_FALSE(m.best_valid);
+    TEST_ASSERT_TRUE(m.widest_valid);
+    TEST_ASSERT_EQUAL(0, m.widest_low);
+    TEST_ASSERT_EQUAL(1, m.widest_high);
+}
+
+void test_pair_exec_better_direction() {
+    SpreadMatrix m;
+    int buy;
+    Fixed abs;
+    float pct;
+
+    // 99.9/100 vs 101/101.1: buy 0 at 100, sell 1 at 101
+    SpreadLeg legs[2] = { book(99.9, 100.0), book(101.0, 101.1) };
+    spread_matrix_rebuild(&m, legs, 2);
+    TEST_ASSERT_TRUE(spread_matrix_pair_exec(m, legs, 0, 1, &buy, &abs, &pct));
+    TEST_ASSERT_EQUAL(0, buy);
+    TEST_ASSERT_TRUE(abs == fixed_from_double(1.0));
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 1.0f, pct);
+
+    // 102/102.2 vs 99.8/100: buy 1 at 100, sell 0 at 102
+    legs[0] = book(102.0, 102.2);
+    legs[1] = book(99.8, 100.0);
+    spread_matrix_rebuild(&m, legs, 2);
+    TEST_ASSERT_TRUE(spread_matrix_pair_exec(m, legs, 0, 1, &buy, &abs, &pct));
+    TEST_ASSERT_EQUAL(1, buy);
+    TEST_ASSERT_TRUE(abs == fixed_from_double(2.0));
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 2.0f, pct);
+
+    // Same book on both: the round trip loses the spread, tie buys on a
+    legs[0] = book(100.0, 100.5);
+    legs[1] = book(100.0, 100.5);
+    spread_matrix_rebuild(&m, legs, 2);
+    TEST_ASSERT_TRUE(spread_matrix_pair_exec(m, legs, 0, 1, &buy, &abs, &pct));
+    TEST_ASSERT_EQUAL(0, buy);
+    TEST_ASSERT_TRUE(abs == fixed_from_double(-0.5));
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, -0.4975f, pct);
+
+    // One side without a book: no executable direction, outputs untouched
+    legs[1] = spread_leg(true, FIXED_UNITS(101), 0, 0);
+    spread_matrix_rebuild(&m, legs, 2);
+    buy = -1;
+    TEST_ASSERT_FALSE(spread_matrix_pair_exec(m, legs, 0, 1, &buy, &abs, &pct));
+    TEST_ASSERT_EQUAL(-1, buy);
+}
+
+void test_model_binance_coinbase_fields() {
+    SymbolState s;
+    Fixed bb = fixed_from_double(100.0), ba = fixed_from_double(100.5);
+    Fixed cb = fixed_from_double(101.0), ca = fixed_from_double(101.2);
+    s.binance_quote.bid = bb;
+    s.binance_quote.ask = ba;
+    s.binance_quote.price = fixed_mid(bb, ba);
+    s.binance_quote.valid = true;
+    symbol_update_spreads(s, VENUE_BINANCE);
+    TEST_ASSERT_FALSE(s.spread_valid);
+    TEST_ASSERT_FALSE(s.exec_spread_valid);
+
+    s.coinbase_quote.bid = cb;
+    s.coinbase_quote.ask = ca;
+    s.coinbase_quote.price = fixed_mid(cb, ca);
+    s.coinbase_quote.valid = true;
+    symbol_update_spreads(s, VENUE_COINBASE);
+
+    Fixed spread_abs;
+    float spread_pct;
+    TEST_ASSERT_TRUE(calc_spread(s.binance_quote.price, s.coinbase_quote.price, &spread_abs, &spread_pct));
+    TEST_ASSERT_TRUE(s.spread_valid);
+    TEST_ASSERT_TRUE(s.spread_abs == spread_abs);
+    TEST_ASSERT_EQUAL_FLOAT(spread_pct, s.spread_pct);
+
+    // Buy Binance (101.0 - 100.5) beats buy Coinbase (100.0 - 101.2)
+    TEST_ASSERT_TRUE(s.exec_spread_valid);
+    TEST_ASSERT_TRUE(s.exec_spread_abs == cb - ba);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, fixed_pct(cb - ba, ba), s.exec_spread_pct);
+    TEST_ASSERT_EQUAL(SPREAD_BUY_BINANCE, s.exec_direction);
+
+    // Kraken far above: widest pair moves, the Binance/Coinbase fields do not
+    s.kraken_quote.price = fixed_from_double(103.0);
+    s.kraken_quote.valid = true;
+    symbol_update_spreads(s, VENUE_KRAKEN);
+    TEST_ASSERT_TRUE(s.spread_abs == spread_abs);
+    TEST_ASSERT_EQUAL(VENUE_BINANCE, s.spreads.widest_low);
+    TEST_ASSERT_EQUAL(VENUE_KRAKEN, s.spreads.widest_high);
+    TEST_ASSERT_TRUE(s.spreads.widest_pct > s.spread_pct);
+}
+
+int run_spread_matrix_tests() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_leg_requires_valid_book);
+
+    // Incremental updates
+    RUN_TEST(test_update_recomputes_row_and_column_only);
+    RUN_TEST(test_incremental_matches_rebuild);
+
+    // Extremes
+    RUN_TEST(test_widest_is_cheapest_to_dearest);
+    RUN_TEST(test_best_exec_lowest_ask_highest_bid);
+    RUN_TEST(test_best_exec_when_one_venue_has_both_extremes);
+    RUN_TEST(test_no_book_has_mid_but_no_exec);
+    RUN_TEST(test_pair_exec_better_direction);
+
+    // Model
+    RUN_TEST(test_model_binance_coinbase_fields);
+
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    run_spread_matrix_tests();
+}
+
+void loop() {
+    // Tests run once in setup
+}
+#else
+int main() {
+    return run_spread_matrix_tests();
+}
+#endif
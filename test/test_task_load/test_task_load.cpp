@@ -0,0 +1,143 @@
+/**
+ * @file test_task_load.cpp
+ * @brief Unit tests for per-task CPU load tracking (app_task_load)
+ *
+ * Tests cover:
+ * - No load before the second sample
+ * - Load as the share of the run-time window, per task
+ * - Counter wrap-around
+ * - Tasks created, deleted and recreated between samples
+ * - Table capacity
+ */
+
+#include <unity.h>
+#include <app/app_task_load.h>
+#include <stdio.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+
+static TaskLoadTracker tracker;
+
+static TaskLoadSample task(const char* name, uint32_t run_time, int8_t core) {
+    TaskLoadSample s;
+    s.name = name;
+    s.run_time = run_time;
+    s.core = core;
+    s.priority = 1;
+    s.stack_free = 1024;
+    return s;
+}
+
+void setUp() {
+    task_load_reset(&tracker);
+}
+
+void tearDown() {}
+
+void test_first_sample_not_measured() {
+    TaskLoadSample s[] = { task("net_task", 5000, 0), task("IDLE0", 95000, 0) };
+    TEST_ASSERT_EQUAL(0, task_load_update(&tracker, s, 2, 100000));
+    TEST_ASSERT_EQUAL(2, tracker.num);
+    TEST_ASSERT_FALSE(task_load_find(&tracker, "net_task")->measured);
+    TEST_ASSERT_NULL(task_load_find(&tracker, "loopTask"));
+}
+
+void test_load_is_share_of_window() {
+    TaskLoadSample s[] = { task("net_task", 0, 0), task("IDLE0", 0, 0),
+                           task("loopTask", 0, 1), task("IDLE1", 0, 1) };
+    task_load_update(&tracker, s, 4, 0);
+
+    // 1 s window: net_task 250 ms on core 0, the UI loop 600 ms on core 1
+    s[0].run_time = 250000;
+    s[1].run_time = 750000;
+    s[2].run_time = 600000;
+    s[3].run_time = 400000;
+    TEST_ASSERT_EQUAL(4, task_load_update(&tracker, s, 4, 1000000));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 25.0f, task_load_find(&tracker, "net_task")->cpu_pct);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 75.0f, task_load_find(&tracker, "IDLE0")->cpu_pct);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 60.0f, task_load_find(&tracker, "loopTask")->cpu_pct);
+    TEST_ASSERT_EQUAL(1, task_load_find(&tracker, "loopTask")->core);
+
+    // Next window only counts what ran since
+    s[0].run_time = 300000;
+    task_load_update(&tracker, s, 4, 2000000);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 5.0f, task_load_find(&tracker, "net_task")->cpu_pct);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, task_load_find(&tracker, "loopTask")->cpu_pct);
+}
+
+void test_counter_wrap() {
+    TaskLoadSample s[] = { task("net_task", 0xFFFFF000u, 0) };
+    task_load_update(&tracker, s, 1, 0xFFFFFF00u);
+
+    // Both counters wrap: ran 0x2000 of a 0x4000 window
+    s[0].run_time = 0x00001000u;
+    task_load_update(&tracker, s, 1, 0x00003F00u);
+    TEST_ASSERT_TRUE(task_load_find(&tracker, "net_task")->measured);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 50.0f, task_load_find(&tracker, "net_task")->cpu_pct);
+}
+
+void test_tasks_come_and_go() {
+    TaskLoadSample first[] = { task("a", 0, 0), task("b", 0, 0), task("c", 0, 1) };
+    task_load_update(&tracker, first, 3, 0);
+
+    // b deleted, d created
+    TaskLoadSample second[] = { task("c", 100, 1), task("d", 50, 0), task("a", 300, 0) };
+    TEST_ASSERT_EQUAL(2, task_load_update(&tracker, second, 3, 1000));
+    TEST_ASSERT_EQUAL(3, tracker.num);
+    TEST_ASSERT_NULL(task_load_find(&tracker, "b"));
+    TEST_ASSERT_FALSE(task_load_find(&tracker, "d")->measured);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 30.0f, task_load_find(&tracker, "a")->cpu_pct);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 10.0f, task_load_find(&tracker, "c")->cpu_pct);
+
+    // a recreated: its counter restarts below the previous one
+    TaskLoadSample third[] = { task("a", 20, 0), task("c", 200, 1), task("d", 150, 0) };
+    TEST_ASSERT_EQUAL(2, task_load_update(&tracker, third, 3, 2000));
+    TEST_ASSERT_FALSE(task_load_find(&tracker, "a")->measured);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 10.0f, task_load_find(&tracker, "d")->cpu_pct);
+}
+
+void test_capacity_and_long_names() {
+    static char names[TASK_LOAD_MAX + 2][8];
+    TaskLoadSample s[TASK_LOAD_MAX + 2];
+    for (int k = 0; k < TASK_LOAD_MAX + 2; k++) {
+        snprintf(names[k], sizeof(names[k]), "t%d", k);
+        s[k] = task(names[k], 0, 0);
+    }
+    task_load_update(&tracker, s, TASK_LOAD_MAX + 2, 0);
+    TEST_ASSERT_EQUAL(TASK_LOAD_MAX, tracker.num);
+    TEST_ASSERT_EQUAL(2, tracker.dropped);
+
+    task_load_reset(&tracker);
+    TaskLoadSample long_name[] = { task("a_very_long_task_name", 0, 0) };
+    task_load_update(&tracker, long_name, 1, 0);
+    TEST_ASSERT_EQUAL_STRING("a_very_long_tas", tracker.tasks[0].name);
+    TEST_ASSERT_NOT_NULL(task_load_find(&tracker, "a_very_long_task_name"));
+}
+
+int run_task_load_tests() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_first_sample_not_measured);
+    RUN_TEST(test_load_is_share_of_window);
+    RUN_TEST(test_counter_wrap);
+    RUN_TEST(test_tasks_come_and_go);
+    RUN_TEST(test_capacity_and_long_names);
+
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    run_task_load_tests();
+}
+
+void loop() {
+    // Tests run once in setup
+}
+#else
+int main() {
+    return run_task_load_tests();
+}
+#endif
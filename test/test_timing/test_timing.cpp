@@ -0,0 +1,150 @@
+/**
+ * @file test_timing.cpp
+ * @brief Unit tests for HTTP phase latency histograms (net_timing)
+ *
+ * Tests cover:
+ * - Bucket placement and summary fields
+ * - Percentile estimates (single sample, mixed, overflow bucket)
+ * - Per-host/per-phase separation and the host table limit
+ */
+
+#include <unity.h>
+#include <net/net_timing.h>
+#include <stdio.h>
+#include <string.h>
+
+void setUp() {
+    http_timing_reset();
+}
+
+void test_hist_empty() {
+    LatencyHistogram h;
+    memset(&h, 0, sizeof(h));
+    TEST_ASSERT_EQUAL(0, latency_hist_percentile(&h, 50));
+    TEST_ASSERT_EQUAL(0, latency_hist_percentile(&h, 99));
+}
+
+void test_hist_add_summary() {
+    LatencyHistogram h;
+    memset(&h, 0, sizeof(h));
+    latency_hist_add(&h, 0);
+    latency_hist_add(&h, 1);
+    latency_hist_add(&h, 3);
+    latency_hist_add(&h, 250);
+
+    TEST_ASSERT_EQUAL(4, h.count);
+    TEST_ASSERT_EQUAL(254, h.sum_ms);
+    TEST_ASSERT_EQUAL(250, h.max_ms);
+    TEST_ASSERT_EQUAL(2, h.buckets[0]);  // <= 1 ms
+    TEST_ASSERT_EQUAL(1, h.buckets[2]);  // 2..5 ms
+}
+
+void test_percentile_single_sample_is_exact() {
+    LatencyHistogram h;
+    memset(&h, 0, sizeof(h));
+    latency_hist_add(&h, 137);
+    TEST_ASSERT_EQUAL(137, latency_hist_percentile(&h, 50));
+    TEST_ASSERT_EQUAL(137, latency_hist_percentile(&h, 99));
+}
+
+void test_percentile_tail() {
+    LatencyHistogram h;
+    memset(&h, 0, sizeof(h));
+    // 90 fast requests, 9 slow, 1 very slow
+    for (int i = 0; i < 90; i++) latency_hist_add(&h, 40);
+    for (int i = 0; i < 9; i++) latency_hist_add(&h, 400);
+    latency_hist_add(&h, 1800);
+
+    uint32_t p50 = latency_hist_percentile(&h, 50);
+    uint32_t p95 = latency_hist_percentile(&h, 95);
+    uint32_t p99 = latency_hist_percentile(&h, 99);
+
+    // Estimates stay inside the bucket of the true value
+    TEST_ASSERT_TRUE(p50 > 20 && p50 <= 50);
+    TEST_ASSERT_TRUE(p95 > 300 && p95 <= 500);
+    TEST_ASSERT_TRUE(p99 > 300 && p99 <= 500);
+    TEST_ASSERT_EQUAL(1800, latency_hist_percentile(&h, 100));
+    TEST_ASSERT_TRUE(p50 <= p95 && p95 <= p99);
+}
+
+void test_percentile_overflow_bucket_reports_max() {
+    LatencyHistogram h;
+    memset(&h, 0, sizeof(h));
+    latency_hist_add(&h, 15000);
+    latency_hist_add(&h, 25000);
+    TEST_ASSERT_EQUAL(25000, latency_hist_percentile(&h, 50));
+}
+
+void test_record_per_host_and_phase() {
+    http_timing_record("api.binance.com", HTTP_PHASE_TLS, 300);
+    http_timing_record("api.binance.com", HTTP_PHASE_TTFB, 60);
+    http_timing_record("api.coinbase.com", HTTP_PHASE_TTFB, 90);
+    http_timing_record("api.binance.com", HTTP_PHASE_TTFB, 70);
+
+    TEST_ASSERT_EQUAL(2, http_timing_host_count());
+
+    HttpHostTiming t;
+    TEST_ASSERT_TRUE(http_timing_get(0, &t));
+    TEST_ASSERT_EQUAL_STRING("api.binance.com", t.host);
+    TEST_ASSERT_EQUAL(1, t.phases[HTTP_PHASE_TLS].count);
+    TEST_ASSERT_EQUAL(2, t.phases[HTTP_PHASE_TTFB].count);
+    TEST_ASSERT_EQUAL(0, t.phases[HTTP_PHASE_DNS].count);
+
+    TEST_ASSERT_TRUE(http_timing_get(1, &t));
+    TEST_ASSERT_EQUAL_STRING("api.coinbase.com", t.host);
+    TEST_ASSERT_EQUAL(90, t.phases[HTTP_PHASE_TTFB].max_ms);
+
+    TEST_ASSERT_FALSE(http_timing_get(2, &t));
+}
+
+void test_host_table_full_drops_samples() {
+    char host[32];
+    for (int i = 0; i < HTTP_TIMING_MAX_HOSTS + 2; i++) {
+        snprintf(host, sizeof(host), "host%d.example", i);
+        http_timing_record(host, HTTP_PHASE_TOTAL, 10);
+    }
+    TEST_ASSERT_EQUAL(HTTP_TIMING_MAX_HOSTS, http_timing_host_count());
+    TEST_ASSERT_EQUAL(2, http_timing_dropped());
+
+    http_timing_reset();
+    TEST_ASSERT_EQUAL(0, http_timing_host_count());
+    TEST_ASSERT_EQUAL(0, http_timing_dropped());
+}
+
+void test_phase_names() {
+    TEST_ASSERT_EQUAL_STRING("dns", http_phase_name(HTTP_PHASE_DNS));
+    TEST_ASSERT_EQUAL_STRING("tls", http_phase_name(HTTP_PHASE_TLS));
+    TEST_ASSERT_EQUAL_STRING("total", http_phase_name(HTTP_PHASE_TOTAL));
+}
+
+int run_timing_tests() {
+    UNITY_BEGIN();
+
+    // Histogram
+    RUN_TEST(test_hist_empty);
+    RUN_TEST(test_hist_add_summary);
+    RUN_TEST(test_percentile_single_sample_is_exact);
+    RUN_TEST(test_percentile_tail);
+    RUN_TEST(test_percentile_overflow_bucket_reports_max);
+
+    // Per-host recording
+    RUN_TEST(test_record_per_host_and_phase);
+    RUN_TEST(test_host_table_full_drops_samples);
+    RUN_TEST(test_phase_names);
+
+    return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+    run_timing_tests();
+}
+
+void loop() {
+    // Tests run once in setup
+}
+#else
+int main() {
+    return run_timing_tests();
+}
+#endif